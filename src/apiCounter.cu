@@ -0,0 +1,89 @@
+/***************************************************************************//**
+ * \file apiCounter.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Implementation of the methods of the class \c apiCounter
+ */
+
+
+#include "apiCounter.h"
+#include <generated_cuda_runtime_api_meta.h>
+#include <iostream>
+
+apiCounter::apiCounter()
+{
+	active = false;
+	numMallocs = 0;
+	numCopies = 0;
+}
+
+apiCounter::~apiCounter()
+{
+	if (active)
+		cuptiUnsubscribe(subscriber);
+}
+
+/*
+ * Subscribes to the runtime callbacks, a failure (no CUPTI on the machine) is reported and the counts stay at zero
+ */
+void apiCounter::start()
+{
+	if (active)
+		return;
+	if (cuptiSubscribe(&subscriber, (CUpti_CallbackFunc) callback, this) != CUPTI_SUCCESS
+		|| cuptiEnableCallback(1, subscriber, CUPTI_CB_DOMAIN_RUNTIME_API, CUPTI_RUNTIME_TRACE_CBID_cudaMalloc_v3020) != CUPTI_SUCCESS
+		|| cuptiEnableCallback(1, subscriber, CUPTI_CB_DOMAIN_RUNTIME_API, CUPTI_RUNTIME_TRACE_CBID_cudaMemcpy_v3020) != CUPTI_SUCCESS
+		|| cuptiEnableCallback(1, subscriber, CUPTI_CB_DOMAIN_RUNTIME_API, CUPTI_RUNTIME_TRACE_CBID_cudaMemcpyAsync_v3020) != CUPTI_SUCCESS)
+	{
+		std::cout << "WARNING: could not subscribe to the CUPTI callbacks, the device allocations and copies are not counted" << std::endl;
+		return;
+	}
+	active = true;
+}
+
+/*
+ * Counts each call once, when it is entered
+ * a copy is counted by the kind it was called with, copies made with cudaMemcpyDefault can't be told apart and aren't counted
+ */
+void CUPTIAPI apiCounter::callback(void *userdata, CUpti_CallbackDomain domain, CUpti_CallbackId cbid, const CUpti_CallbackData *info)
+{
+	if (domain != CUPTI_CB_DOMAIN_RUNTIME_API || info->callbackSite != CUPTI_API_ENTER)
+		return;
+	apiCounter *counter = (apiCounter *) userdata;
+	if (cbid == CUPTI_RUNTIME_TRACE_CBID_cudaMalloc_v3020)
+		counter->numMallocs++;
+	else if (cbid == CUPTI_RUNTIME_TRACE_CBID_cudaMemcpy_v3020)
+	{
+		if (((const cudaMemcpy_v3020_params *) info->functionParams)->kind == cudaMemcpyDeviceToHost)
+			counter->numCopies++;
+	}
+	else if (cbid == CUPTI_RUNTIME_TRACE_CBID_cudaMemcpyAsync_v3020)
+	{
+		if (((const cudaMemcpyAsync_v3020_params *) info->functionParams)->kind == cudaMemcpyDeviceToHost)
+			counter->numCopies++;
+	}
+}
+
+int apiCounter::mallocs()
+{
+	return numMallocs;
+}
+
+int apiCounter::deviceToHost()
+{
+	return numCopies;
+}
+
+void apiCounter::reset()
+{
+	numMallocs = 0;
+	numCopies = 0;
+}
+
+/*
+ * The counter shared by the solvers
+ */
+apiCounter &cudaCalls()
+{
+	static apiCounter counter;
+	return counter;
+}
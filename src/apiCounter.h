@@ -0,0 +1,41 @@
+/***************************************************************************//**
+ * \file apiCounter.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the class \c apiCounter, counts the cuda runtime calls the whole program makes
+ */
+
+
+#pragma once
+
+#include <cupti.h>
+
+
+/**
+ * \class apiCounter
+ * \brief Counts cudaMalloc calls and device to host copies with a CUPTI runtime callback
+ *
+ * The callback sees every call in the process, the ones thrust and cusp make inside their algorithms included,
+ * so nothing has to be counted by hand at the call sites.
+ * Only the callbacks that are counted are enabled, the other runtime calls don't pay for it.
+ */
+class apiCounter
+{
+	CUpti_SubscriberHandle	subscriber;
+	bool	active;			///< true once start() subscribed
+	int		numMallocs,		///< cudaMalloc calls since the counter was last reset
+			numCopies;		///< device to host cudaMemcpy(Async) calls since the counter was last reset
+
+	static void CUPTIAPI callback(void *userdata, CUpti_CallbackDomain domain, CUpti_CallbackId cbid, const CUpti_CallbackData *info);
+
+public:
+	apiCounter();
+	~apiCounter();
+
+	void start();
+
+	int mallocs();
+	int deviceToHost();
+	void reset();
+};
+
+apiCounter &cudaCalls();
@@ -8,6 +8,9 @@
 
 #include "bodies.h"
 #include <cusp/blas/blas.h>
+#include <cfloat>
+#include <algorithm>
+#include <vector>
 #include <iomanip>
 #include <fstream>
 
@@ -59,6 +62,22 @@ void bodies::initialise(parameterDB &db, domain &D)
 	ytop.resize(numBodies);
 	ybot.resize(numBodies);
 
+	hostMeta.startI.resize(numBodies);
+	hostMeta.startJ.resize(numBodies);
+	hostMeta.numCellsX.resize(numBodies);
+	hostMeta.numCellsY.resize(numBodies);
+	hostMeta.xmin.resize(numBodies);
+	hostMeta.xmax.resize(numBodies);
+	hostMeta.ymin.resize(numBodies);
+	hostMeta.ymax.resize(numBodies);
+	hostMeta.startI0.resize(numBodies);
+	hostMeta.startJ0.resize(numBodies);
+	hostMeta.numCellsX0.resize(numBodies);
+	hostMeta.numCellsY0.resize(numBodies);
+	metaPacked.resize(12*numBodies);
+	metaPacked_h.resize(12*numBodies);
+	analytic = false;
+
 
 	// calculate offsets, number of points in each body and the total number of points
 	totalPoints = 0;
@@ -68,6 +87,26 @@ void bodies::initialise(parameterDB &db, domain &D)
 		numPoints[k] = (*B)[k].numPoints;
 		totalPoints += numPoints[k];
 	}
+	cusp::array1d<int, cusp::host_memory> pointBody_h(totalPoints);
+	for(int k=0; k<numBodies; k++)
+		for(int i=0; i<(*B)[k].numPoints; i++)
+			pointBody_h[offsets[k]+i] = k;
+	pointBody = pointBody_h;
+	motion_h.resize(9*numBodies);
+	motion.resize(9*numBodies);
+	refCentre_h.resize(2*numBodies);
+	centre_h.resize(2*numBodies);
+	centre.resize(2*numBodies);
+	for(int k=0; k<numBodies; k++)
+	{
+		refCentre_h[2*k]	= 0;
+		refCentre_h[2*k+1]	= 0;
+		for(int i=0; i<(*B)[k].numPoints; i++)
+		{
+			refCentre_h[2*k]	+= (*B)[k].X[i]/(*B)[k].numPoints;
+			refCentre_h[2*k+1]	+= (*B)[k].Y[i]/(*B)[k].numPoints;
+		}
+	}
 
 	// fill up coordinates of body points
 	X.resize(totalPoints);
@@ -140,70 +179,272 @@ void bodies::initialise(parameterDB &db, domain &D)
 	update(db, D, 0.0);
 
 	if(numBodies)
-	{
-		calculateTightBoundingBoxes(db, D);
 		calculateBoundingBoxes(db, D);
-		numCellsXHost = numCellsX[0];
-		numCellsYHost = numCellsY[0];
-	}
 
 	midX=0;
 	midY=0;
 	midX0=0;
 	midY0=0;
+	cusp::array1d<double, cusp::host_memory>
+		xHost = x,
+		yHost = y;
 	for (int i=0;i<totalPoints;i++)
 	{
-		midX += x[i];
-		midY += y[i];
+		midX += xHost[i];
+		midY += yHost[i];
 	}
 	midX /= totalPoints;
 	midY /= totalPoints;
 	midX=midX0;
 	midY=midY0;
+
+	// only a single body can use its analytic shape, the tagging kernels handle one shape at a time
+	// analyticTags in bodies.yaml turns it on, otherwise the nodes are tagged against the boundary points
+	// a body given by its points gets a distance field reaching a few cells past the tags and image points
+	analytic = false;
+	if (numBodies == 1 && (*B)[0].analyticTags)
+	{
+		if ((*B)[0].Shape.type == shapeType::POLYGON)
+			buildDistanceField((*B)[0], D.mid_h/4, 5*D.mid_h);
+		else
+			Shape = (*B)[0].Shape;
+		Shape.cx -= midX;
+		Shape.cy -= midY;
+		analytic = true;
+	}
+	else if (numBodies > 1)
+	{
+		for (int k=0; k<numBodies; k++)
+			if ((*B)[k].analyticTags)
+				std::cout << "WARNING: analyticTags is ignored for body " << k << ", only a single body can be tagged with its shape" << std::endl;
+
+		// the tagging kernels need the surfaces of two bodies to be at least two cells apart, see kernels::tag_u_luo
+		std::vector<int> owner;
+		for (int k=0; k<numBodies; k++)
+			owner.insert(owner.end(), (*B)[k].numPoints, k);
+		double minGap = 2*D.mid_h;
+		std::vector<bool> close(numBodies*numBodies, false);
+		for (int i=0; i<totalPoints; i++)
+			for (int j=i+1; j<totalPoints; j++)
+				if (owner[i] != owner[j] && !close[owner[i]*numBodies + owner[j]]
+					&& (xHost[i]-xHost[j])*(xHost[i]-xHost[j]) + (yHost[i]-yHost[j])*(yHost[i]-yHost[j]) < minGap*minGap)
+				{
+					close[owner[i]*numBodies + owner[j]] = true;
+					std::cout << "WARNING: bodies " << owner[i] << " and " << owner[j] << " are less than two cells apart, "
+							  << "the nodes between them can be tagged for either body" << std::endl;
+				}
+	}
 	centerVelocityV = 0;
 	centerVelocityU = 0;
 	centerVelocityU0= 0;
 	centerVelocityV0= 0;
 }
 
-//flag this isn't setup to work with multiple bodies
-//flag this kernel is setup to be called recursivly to handle body sizes larger than than
-//flag this kernel isn't working for smaller body node spacing (0.005 works, 0.004 does not), disabling for now
-//the maximum number of points allowable in a block
+/**
+ * \brief Samples the signed distance and the nearest segment of the boundary of a body on a lattice in the body frame.
+ *
+ * The distance is only calculated within band of a segment, each segment visits the lattice nodes around it,
+ * the nodes further away keep -band or band so the sign is still right and have no segment (-1).
+ * The boundary points follow the lattice so geometry::closestPoint can project onto the segments.
+ * The sign comes from an even-odd count of the segments crossed along each row of the lattice.
+ * The frame of the body is its centre of rotation and angle, so rigid motion only moves the frame.
+ *
+ * \param Body the body, its reference points X, Y form a closed loop
+ * \param h lattice spacing
+ * \param band half width of the band
+ */
+void bodies::buildDistanceField(body &Body, double h, double band)
+{
+	int n = Body.numPoints;
+	double	xmin = DBL_MAX, xmax = -DBL_MAX,
+			ymin = DBL_MAX, ymax = -DBL_MAX;
+	std::vector<double> bx(n), by(n);
+	for (int k=0; k<n; k++)
+	{
+		bx[k] = Body.X[k] - Body.X0[0];
+		by[k] = Body.Y[k] - Body.X0[1];
+		xmin = std::min(xmin, bx[k]);
+		xmax = std::max(xmax, bx[k]);
+		ymin = std::min(ymin, by[k]);
+		ymax = std::max(ymax, by[k]);
+	}
+	int fnx = int((xmax-xmin+2*band)/h) + 2,
+		fny = int((ymax-ymin+2*band)/h) + 2;
+	double	x0 = xmin - band,
+			y0 = ymin - band;
+
+	cusp::array1d<double, cusp::host_memory> field(2*fnx*fny + 2*n);
+	for (int k=0; k<fnx*fny; k++)
+	{
+		field[2*k]   = band;
+		field[2*k+1] = -1;
+	}
+	for (int k=0; k<n; k++)
+	{
+		field[2*fnx*fny + 2*k]   = bx[k];
+		field[2*fnx*fny + 2*k+1] = by[k];
+	}
+
+	// unsigned distance and nearest segment, segment k joins point l = k-1 to point k
+	for (int k=0, l=n-1; k<n; l=k++)
+	{
+		double	dx = bx[k]-bx[l],
+				dy = by[k]-by[l],
+				len2 = dx*dx + dy*dy;
+		int	i0 = std::max(int((std::min(bx[k],bx[l]) - band - x0)/h), 0),
+			i1 = std::min(int((std::max(bx[k],bx[l]) + band - x0)/h) + 1, fnx-1),
+			j0 = std::max(int((std::min(by[k],by[l]) - band - y0)/h), 0),
+			j1 = std::min(int((std::max(by[k],by[l]) + band - y0)/h) + 1, fny-1);
+		for (int j=j0; j<=j1; j++)
+		{
+			for (int i=i0; i<=i1; i++)
+			{
+				double	px = x0 + i*h,
+						py = y0 + j*h,
+						s  = len2 > 0 ? ((px-bx[l])*dx + (py-by[l])*dy)/len2 : 0;
+				s = std::min(std::max(s, 0.0), 1.0);
+				double	cx = bx[l] + s*dx,
+						cy = by[l] + s*dy,
+						d  = sqrt((px-cx)*(px-cx) + (py-cy)*(py-cy));
+				int m = 2*(j*fnx + i);
+				if (d < field[m])
+				{
+					field[m]   = d;
+					field[m+1] = k;
+				}
+			}
+		}
+	}
+
+	// the nodes with an odd number of segments to their left are inside
+	std::vector<double> cross;
+	for (int j=0; j<fny; j++)
+	{
+		double py = y0 + j*h;
+		cross.clear();
+		for (int k=0, l=n-1; k<n; l=k++)
+			if ((by[k] > py) != (by[l] > py))
+				cross.push_back(bx[l] + (bx[k]-bx[l])*(py-by[l])/(by[k]-by[l]));
+		std::sort(cross.begin(), cross.end());
+		for (int i=0, c=0; i<fnx; i++)
+		{
+			double px = x0 + i*h;
+			while (c < (int)cross.size() && cross[c] < px)
+				c++;
+			if (c%2 == 1)
+				field[2*(j*fnx + i)] *= -1;
+		}
+	}
+
+	distanceField = field;
+	Shape.type		= shapeType::DISTANCE_FIELD;
+	Shape.cx		= Body.Xc[0];
+	Shape.cy		= Body.Xc[1];
+	Shape.a			= band;
+	Shape.b			= band;
+	Shape.angle		= Body.Theta;
+	Shape.field		= thrust::raw_pointer_cast( &(distanceField[0]) );
+	Shape.fieldNx	= fnx;
+	Shape.fieldNy	= fny;
+	Shape.fieldPoints	= n;
+	Shape.fieldX0	= x0;
+	Shape.fieldY0	= y0;
+	Shape.fieldH	= h;
+}
+
+/*
+ * The bodies are only translated by the solvers that use the analytic shape, so the shape follows (midX, midY)
+ */
+shape bodies::currentShape()
+{
+	shape S = Shape;
+	S.cx += midX;
+	S.cy += midY;
+	return S;
+}
+
+/*
+ * index of the first value in the sorted array a that is not less than v, n if there isn't one
+ */
+__device__
+int lowerBound(double *a, int n, double v)
+{
+	int lo = 0,
+		hi = n;
+	while (lo < hi)
+	{
+		int mid = (lo + hi)/2;
+		if (a[mid] < v)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * one block per body, the threads of a block reduce the extent of its points
+ * then the box is scaled about its centre and located on the grid with a binary search
+ * launch with 256 threads per block
+ * param bx x-coordinates of the body points
+ * param by y-coordinates of the body points
+ * param offsets index of the first point of each body
+ * param numPoints number of points in each body
+ * param x x-coordinates of the grid, size nx
+ * param y y-coordinates of the grid, size ny
+ * param scale the box is grown by this factor in each direction
+ */
 __global__
-void boundingBox(double *x, double *y,
-				 thrust::device_vector<double>::iterator xmax_in, thrust::device_vector<double>::iterator xmin_in, thrust::device_vector<double>::iterator ymax_in, thrust::device_vector<double>::iterator ymin_in,
-				 int *startI, int *startJ, int *numCellsX, int *numCellsY,
-				 double *xmax, double *xmin, double *ymax, double *ymin, double scale)
+void boundingBoxes(double *bx, double *by, int *offsets, int *numPoints, double *x, double *y, int nx, int ny,
+				   int *startI, int *startJ, int *numCellsX, int *numCellsY,
+				   double *xmin, double *xmax, double *ymin, double *ymax, double scale)
 {
+	__shared__ double cache[4*256];
+	int k = blockIdx.x;
+	double	xlo = DBL_MAX,
+			xhi = -DBL_MAX,
+			ylo = DBL_MAX,
+			yhi = -DBL_MAX;
+	for (int l = offsets[k] + threadIdx.x; l < offsets[k] + numPoints[k]; l += blockDim.x)
+	{
+		xlo = fmin(xlo, bx[l]);
+		xhi = fmax(xhi, bx[l]);
+		ylo = fmin(ylo, by[l]);
+		yhi = fmax(yhi, by[l]);
+	}
+	cache[threadIdx.x]		= xlo;
+	cache[256 + threadIdx.x]	= xhi;
+	cache[512 + threadIdx.x]	= ylo;
+	cache[768 + threadIdx.x]	= yhi;
+	__syncthreads();
+	for (int stride = blockDim.x/2; stride > 0; stride /= 2)
+	{
+		if (threadIdx.x < stride)
+		{
+			cache[threadIdx.x]		= fmin(cache[threadIdx.x],		cache[threadIdx.x + stride]);
+			cache[256 + threadIdx.x]	= fmax(cache[256 + threadIdx.x],	cache[256 + threadIdx.x + stride]);
+			cache[512 + threadIdx.x]	= fmin(cache[512 + threadIdx.x],	cache[512 + threadIdx.x + stride]);
+			cache[768 + threadIdx.x]	= fmax(cache[768 + threadIdx.x],	cache[768 + threadIdx.x + stride]);
+		}
+		__syncthreads();
+	}
 	if (threadIdx.x > 0)
 		return;
 
-	xmax[0] = *xmax_in;
-	xmin[0] = *xmin_in;
-	ymax[0] = *ymax_in;
-	ymin[0] = *ymin_in;
-	double	dx = xmax[0]-xmin[0],
-			dy = ymax[0]-ymin[0];
-	xmax[0] += 0.5*dx*(scale-1.0);
-	xmin[0] -= 0.5*dx*(scale-1.0);
-	ymax[0] += 0.5*dy*(scale-1.0);
-	ymin[0] -= 0.5*dy*(scale-1.0);
-	int i=0,
-		j=0;
-	while(x[i+1] < xmin[0])
-		i++;
-	while(y[j+1] < ymin[0])
-		j++;
-	startI[0] = i;
-	startJ[0] = j;
-
-	while(x[i] < xmax[0])
-		i++;
-	while(y[j] < ymax[0])
-		j++;
-	numCellsX[0] = i - startI[0];
-	numCellsY[0] = j - startJ[0];
+	double	dx = cache[256] - cache[0],
+			dy = cache[768] - cache[512];
+	xmin[k] = cache[0]   - 0.5*dx*(scale-1.0);
+	xmax[k] = cache[256] + 0.5*dx*(scale-1.0);
+	ymin[k] = cache[512] - 0.5*dy*(scale-1.0);
+	ymax[k] = cache[768] + 0.5*dy*(scale-1.0);
+
+	//the box starts in the last cell whose node is left of/below the minimum and ends at the first node past the maximum
+	int i = max(lowerBound(x, nx, xmin[k]) - 1, 0),
+		j = max(lowerBound(y, ny, ymin[k]) - 1, 0);
+	startI[k] = i;
+	startJ[k] = j;
+	numCellsX[k] = min(lowerBound(x, nx, xmax[k]), nx-1) - i;
+	numCellsY[k] = min(lowerBound(y, ny, ymax[k]), ny-1) - j;
 }
 
 /**
@@ -212,7 +453,8 @@ void boundingBox(double *x, double *y,
  * First the bounding box is scaled by a coefficient stored in the database.
  * Then, indices of the x-coordinate and y-coordinate of the bottom left cell
  * of the bounding box are stored. Finally, the number of cells in the x- and y-
- * directions are calculated.
+ * directions are calculated. All bodies are handled by one launch.
+ * The unscaled boxes are recalculated as well, then both are copied to the host.
  *
  * \param db database that contains all the simulation parameters
  * \param D information about the computational grid
@@ -222,68 +464,122 @@ void bodies::calculateBoundingBoxes(parameterDB &db, domain &D)
 	double scale = db["simulation"]["scaleCV"].get<double>();
 	double	*x_r = thrust::raw_pointer_cast( &(D.x[0]) ),
 			*y_r = thrust::raw_pointer_cast( &(D.y[0]) ),
+			*bx_r = thrust::raw_pointer_cast( &(x[0]) ),
+			*by_r = thrust::raw_pointer_cast( &(y[0]) ),
 			*xmin_r = thrust::raw_pointer_cast( &(xleft[0]) ),
 			*xmax_r = thrust::raw_pointer_cast( &(xright[0]) ),
 			*ymin_r = thrust::raw_pointer_cast( &(ybot[0]) ),
 			*ymax_r = thrust::raw_pointer_cast( &(ytop[0]) );
-	int *startI_r = thrust::raw_pointer_cast( &(startI[0]) ),
+	int *offsets_r = thrust::raw_pointer_cast( &(offsets[0]) ),
+		*numPoints_r = thrust::raw_pointer_cast( &(numPoints[0]) ),
+		*startI_r = thrust::raw_pointer_cast( &(startI[0]) ),
 		*startJ_r = thrust::raw_pointer_cast( &(startJ[0]) ),
 		*numCellsX_r = thrust::raw_pointer_cast( &(numCellsX[0]) ),
 		*numCellsY_r = thrust::raw_pointer_cast( &(numCellsY[0]) );
 
-	thrust::device_vector<double>::iterator iter_xmax,
-											iter_xmin,
-											iter_ymax,
-											iter_ymin;
-
-	iter_xmax = thrust::max_element(x.begin(),x.end());
-	iter_xmin = thrust::min_element(x.begin(),x.end());
-	iter_ymax = thrust::max_element(y.begin(),y.end());
-	iter_ymin = thrust::min_element(y.begin(),y.end());
-
+	dim3 grid(numBodies, 1);
+	dim3 block(256, 1);
+	boundingBoxes<<<grid,block>>>(bx_r, by_r, offsets_r, numPoints_r, x_r, y_r, D.nx, D.ny,
+								  startI_r, startJ_r, numCellsX_r, numCellsY_r,
+								  xmin_r, xmax_r, ymin_r, ymax_r, scale);
+	calculateTightBoundingBoxes(db, D);
+	updateMetadata();
+}
 
-	const int blocksize = 1;
-	dim3 grid(1, 1);
-	dim3 block(blocksize, 1);
-	boundingBox<<<grid,block>>>(x_r,y_r,
-								iter_xmax, iter_xmin, iter_ymax, iter_ymin,
-								startI_r, startJ_r, numCellsX_r, numCellsY_r,
-								xmax_r,xmin_r,ymax_r,ymin_r, scale);
+/*
+ * copies the bounding box of every body into one array, packed[12*k+field]
+ * the integers are stored as doubles, which is exact for any grid index
+ */
+__global__
+void packMetadata(double *packed, int *startI, int *startJ, int *numCellsX, int *numCellsY,
+				  double *xmin, double *xmax, double *ymin, double *ymax,
+				  int *startI0, int *startJ0, int *numCellsX0, int *numCellsY0, int numBodies)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numBodies)
+		return;
+	packed[12*k]	= startI[k];
+	packed[12*k+1]	= startJ[k];
+	packed[12*k+2]	= numCellsX[k];
+	packed[12*k+3]	= numCellsY[k];
+	packed[12*k+4]	= xmin[k];
+	packed[12*k+5]	= xmax[k];
+	packed[12*k+6]	= ymin[k];
+	packed[12*k+7]	= ymax[k];
+	packed[12*k+8]	= startI0[k];
+	packed[12*k+9]	= startJ0[k];
+	packed[12*k+10]	= numCellsX0[k];
+	packed[12*k+11]	= numCellsY0[k];
 }
 
-void bodies::calculateTightBoundingBoxes(parameterDB &db, domain &D) //flag this should be merged into the normal calculate bounding box function
+/**
+ * \brief Refreshes the host copy of the bounding boxes with one device to host copy.
+ */
+void bodies::updateMetadata()
 {
-	double scale = db["simulation"]["scaleCV"].get<double>();
-	int  i, j;
-	for(int k=0; k<numBodies; k++)
-	{
-		xmin0[k] = x[offsets[k]];
-		xmax0[k] = xmin[k];
-		ymin0[k] = y[offsets[k]];
-		ymax0[k] = ymin[k];
-		for(int l=offsets[k]+1; l<offsets[k]+numPoints[k]; l++)
-		{
-			if(x[l] < xmin0[k]) xmin0[k] = x[l];
-			if(x[l] > xmax0[k]) xmax0[k] = x[l];
-			if(y[l] < ymin0[k]) ymin0[k] = y[l];
-			if(y[l] > ymax0[k]) ymax0[k] = y[l];
-		}
+	double	*packed_r = thrust::raw_pointer_cast( &(metaPacked[0]) ),
+			*xmin_r = thrust::raw_pointer_cast( &(xleft[0]) ),
+			*xmax_r = thrust::raw_pointer_cast( &(xright[0]) ),
+			*ymin_r = thrust::raw_pointer_cast( &(ybot[0]) ),
+			*ymax_r = thrust::raw_pointer_cast( &(ytop[0]) );
+	int *startI_r = thrust::raw_pointer_cast( &(startI[0]) ),
+		*startJ_r = thrust::raw_pointer_cast( &(startJ[0]) ),
+		*numCellsX_r = thrust::raw_pointer_cast( &(numCellsX[0]) ),
+		*numCellsY_r = thrust::raw_pointer_cast( &(numCellsY[0]) ),
+		*startI0_r = thrust::raw_pointer_cast( &(startI0[0]) ),
+		*startJ0_r = thrust::raw_pointer_cast( &(startJ0[0]) ),
+		*numCellsX0_r = thrust::raw_pointer_cast( &(numCellsX0[0]) ),
+		*numCellsY0_r = thrust::raw_pointer_cast( &(numCellsY0[0]) );
+
+	const int blocksize = 256;
+	dim3 grid( int( (numBodies-0.5)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	packMetadata<<<grid,block>>>(packed_r, startI_r, startJ_r, numCellsX_r, numCellsY_r,
+								 xmin_r, xmax_r, ymin_r, ymax_r,
+								 startI0_r, startJ0_r, numCellsX0_r, numCellsY0_r, numBodies);
+	thrust::copy(metaPacked.begin(), metaPacked.begin()+12*numBodies, metaPacked_h.begin());
 
-		i=0; j=0;
-		while(D.x[i+1] < xmin0[k])
-			i++;
-		while(D.y[j+1] < ymin0[k])
-			j++;
-		startI0[k] = i;
-		startJ0[k] = j;
-
-		while(D.x[i] < xmax[k])
-			i++;
-		while(D.y[j] < ymax[k])
-			j++;
-		numCellsX0[k] = i - startI0[k];
-		numCellsY0[k] = j - startJ0[k];
+	for (int k=0; k<numBodies; k++)
+	{
+		hostMeta.startI[k]		= int(metaPacked_h[12*k]);
+		hostMeta.startJ[k]		= int(metaPacked_h[12*k+1]);
+		hostMeta.numCellsX[k]	= int(metaPacked_h[12*k+2]);
+		hostMeta.numCellsY[k]	= int(metaPacked_h[12*k+3]);
+		hostMeta.xmin[k]		= metaPacked_h[12*k+4];
+		hostMeta.xmax[k]		= metaPacked_h[12*k+5];
+		hostMeta.ymin[k]		= metaPacked_h[12*k+6];
+		hostMeta.ymax[k]		= metaPacked_h[12*k+7];
+		hostMeta.startI0[k]		= int(metaPacked_h[12*k+8]);
+		hostMeta.startJ0[k]		= int(metaPacked_h[12*k+9]);
+		hostMeta.numCellsX0[k]	= int(metaPacked_h[12*k+10]);
+		hostMeta.numCellsY0[k]	= int(metaPacked_h[12*k+11]);
 	}
+	numCellsXHost = hostMeta.numCellsX[0];
+	numCellsYHost = hostMeta.numCellsY[0];
+}
+
+void bodies::calculateTightBoundingBoxes(parameterDB &db, domain &D)
+{
+	double	*x_r = thrust::raw_pointer_cast( &(D.x[0]) ),
+			*y_r = thrust::raw_pointer_cast( &(D.y[0]) ),
+			*bx_r = thrust::raw_pointer_cast( &(x[0]) ),
+			*by_r = thrust::raw_pointer_cast( &(y[0]) ),
+			*xmin_r = thrust::raw_pointer_cast( &(xmin0[0]) ),
+			*xmax_r = thrust::raw_pointer_cast( &(xmax0[0]) ),
+			*ymin_r = thrust::raw_pointer_cast( &(ymin0[0]) ),
+			*ymax_r = thrust::raw_pointer_cast( &(ymax0[0]) );
+	int *offsets_r = thrust::raw_pointer_cast( &(offsets[0]) ),
+		*numPoints_r = thrust::raw_pointer_cast( &(numPoints[0]) ),
+		*startI_r = thrust::raw_pointer_cast( &(startI0[0]) ),
+		*startJ_r = thrust::raw_pointer_cast( &(startJ0[0]) ),
+		*numCellsX_r = thrust::raw_pointer_cast( &(numCellsX0[0]) ),
+		*numCellsY_r = thrust::raw_pointer_cast( &(numCellsY0[0]) );
+
+	dim3 grid(numBodies, 1);
+	dim3 block(256, 1);
+	boundingBoxes<<<grid,block>>>(bx_r, by_r, offsets_r, numPoints_r, x_r, y_r, D.nx, D.ny,
+								  startI_r, startJ_r, numCellsX_r, numCellsY_r,
+								  xmin_r, xmax_r, ymin_r, ymax_r, 1.0);
 }
 
 /**
@@ -303,13 +599,6 @@ void bodies::calculateTightBoundingBoxes(parameterDB &db, domain &D) //flag this
  */
 void bodies::update(parameterDB &db, domain &D, double Time)
 {
-	typedef typename cusp::array1d<double, cusp::device_memory> Array;
-	typedef typename Array::iterator                 Iterator;
-	typedef cusp::array1d_view<Iterator>             View;
-
-	// views of the vectors that store the coordinates and velocities of all the body points
-	View    XView, YView, xView, yView, onesView, uBView, vBView;
-
 	// body data
 	std::vector<body> *B = db["flow"]["bodies"].get<std::vector<body> *>();
 
@@ -318,43 +607,103 @@ void bodies::update(parameterDB &db, domain &D, double Time)
 		// update the location and velocity of the body
 		(*B)[l].update(Time);
 
-		// create the views for the current body
-		if(l < numBodies-1)
-		{
-			XView    = View(X.begin()+offsets[l], X.begin()+offsets[l+1]);
-			YView    = View(Y.begin()+offsets[l], Y.begin()+offsets[l+1]);
-			onesView = View(ones.begin()+offsets[l], ones.begin()+offsets[l+1]);
-			uBView   = View(uB.begin()+offsets[l], uB.begin()+offsets[l+1]);
-			vBView   = View(vB.begin()+offsets[l], vB.begin()+offsets[l+1]);
-			xView    = View(x.begin()+offsets[l], x.begin()+offsets[l+1]);
-			yView    = View(y.begin()+offsets[l], y.begin()+offsets[l+1]);
-		}
-		else
-		{
-			XView    = View(X.begin()+offsets[l], X.end());
-			YView    = View(Y.begin()+offsets[l], Y.end());
-			onesView = View(ones.begin()+offsets[l], ones.end());
-			xView    = View(x.begin()+offsets[l], x.end());
-			yView    = View(y.begin()+offsets[l], y.end());
-			uBView   = View(uB.begin()+offsets[l], uB.end());
-			vBView   = View(vB.begin()+offsets[l], vB.end());
+		double *m = &motion_h[9*l];
+		m[0] = (*B)[l].Xc[0];
+		m[1] = (*B)[l].Xc[1];
+		m[2] = cos((*B)[l].Theta);
+		m[3] = sin((*B)[l].Theta);
+		m[4] = (*B)[l].X0[0];
+		m[5] = (*B)[l].X0[1];
+		m[6] = (*B)[l].vel[0];
+		m[7] = (*B)[l].vel[1];
+		m[8] = (*B)[l].angVel;
+	}
+	applyMotion();
 
-		}
+	// the distance field is never resampled, only its frame follows the body
+	if (analytic && Shape.type == shapeType::DISTANCE_FIELD)
+	{
+		Shape.cx	= (*B)[0].Xc[0] - midX;
+		Shape.cy	= (*B)[0].Xc[1] - midY;
+		Shape.angle	= (*B)[0].Theta;
+	}
+}
 
-		// update postitions
-		// x-coordinates
-		cusp::blas::axpbypcz( onesView, XView, onesView, xView, (*B)[l].Xc[0],  cos((*B)[l].Theta), -(*B)[l].X0[0]*cos((*B)[l].Theta) );
-		cusp::blas::axpbypcz( xView,    YView, onesView, xView,           1.0, -sin((*B)[l].Theta),  (*B)[l].X0[1]*sin((*B)[l].Theta) );
-		// y-coordinates
-		cusp::blas::axpbypcz( onesView, XView, onesView, yView, (*B)[l].Xc[1],  sin((*B)[l].Theta), -(*B)[l].X0[0]*sin((*B)[l].Theta) );
-		cusp::blas::axpbypcz( yView,    YView, onesView, yView,           1.0,  cos((*B)[l].Theta), -(*B)[l].X0[1]*cos((*B)[l].Theta) );
-
-		// update velocities
-		// x-velocities
-		cusp::blas::axpbypcz(onesView, yView, onesView, uBView, (*B)[l].vel[0], -(*B)[l].angVel,  (*B)[l].angVel*(*B)[l].Xc[1]);
-		// y-velocities
-		cusp::blas::axpbypcz(onesView, xView, onesView, vBView, (*B)[l].vel[1],  (*B)[l].angVel, -(*B)[l].angVel*(*B)[l].Xc[0]);
+/**
+ * \brief Shifts every body and sets its translational velocity, the rotation is left as it is.
+ *
+ * \param dx shift in the x-direction
+ * \param dy shift in the y-direction
+ * \param u new x-velocity
+ * \param v new y-velocity
+ */
+void bodies::translate(double dx, double dy, double u, double v)
+{
+	for(int l=0; l<numBodies; l++)
+	{
+		motion_h[9*l]	+= dx;
+		motion_h[9*l+1]	+= dy;
+		motion_h[9*l+6]	= u;
+		motion_h[9*l+7]	= v;
 	}
+	applyMotion();
+}
+
+/**
+ * \brief Copies the motion table to the device and moves the boundary points of every body with one launch.
+ *
+ * The centre of each body is moved on the host, it is only two doubles per body.
+ */
+void bodies::applyMotion()
+{
+	if (totalPoints == 0)
+		return;
+	motion = motion_h;
+	for(int l=0; l<numBodies; l++)
+	{
+		double	*m = &motion_h[9*l],
+				dX = refCentre_h[2*l] - m[4],
+				dY = refCentre_h[2*l+1] - m[5];
+		centre_h[2*l]	= m[0] + m[2]*dX - m[3]*dY;
+		centre_h[2*l+1]	= m[1] + m[3]*dX + m[2]*dY;
+	}
+	centre = centre_h;
+
+	double	*x_r	= thrust::raw_pointer_cast( &(x[0]) ),
+			*y_r	= thrust::raw_pointer_cast( &(y[0]) ),
+			*uB_r	= thrust::raw_pointer_cast( &(uB[0]) ),
+			*vB_r	= thrust::raw_pointer_cast( &(vB[0]) ),
+			*X_r	= thrust::raw_pointer_cast( &(X[0]) ),
+			*Y_r	= thrust::raw_pointer_cast( &(Y[0]) ),
+			*motion_r = thrust::raw_pointer_cast( &(motion[0]) );
+	int		*pointBody_r = thrust::raw_pointer_cast( &(pointBody[0]) );
+
+	const int blocksize = 256;
+	dim3 grid( int( (totalPoints-0.5)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	rigidMotion<<<grid,block>>>(x_r, y_r, uB_r, vB_r, X_r, Y_r, pointBody_r, motion_r, totalPoints);
+}
+
+/**
+ * \brief Rotates the reference point about X0, moves it to Xc and sets the rigid body velocity of the point.
+ *
+ * One thread per boundary point, each point reads the row of its body in the motion table.
+ */
+__global__
+void rigidMotion(double *x, double *y, double *uB, double *vB, double *X, double *Y, int *pointBody, double *motion, int totalPoints)
+{
+	int i = threadIdx.x + blockDim.x * blockIdx.x;
+	if (i >= totalPoints)
+		return;
+	double *m = &motion[9*pointBody[i]];
+	double	dX = X[i] - m[4],
+			dY = Y[i] - m[5],
+			xi = m[0] + m[2]*dX - m[3]*dY,
+			yi = m[1] + m[3]*dX + m[2]*dY;
+	x[i]	= xi;
+	y[i]	= yi;
+	uB[i]	= m[6] - m[8]*(yi - m[1]);
+	vB[i]	= m[7] + m[8]*(xi - m[0]);
 }
 
 
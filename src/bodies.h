@@ -8,6 +8,35 @@
 #include "domain.h"
 #include "parameterDB.h"
 #include "body.h"
+#include <thrust/copy.h>
+
+/**
+ * \struct bodyMetadata
+ * \brief Host copy of the bounding box of each body.
+ *
+ * Refreshed with a single device to host copy each time the bounding boxes are recalculated,
+ * host code should read these instead of indexing the device arrays in \c bodies.
+ */
+struct bodyMetadata
+{
+	cusp::array1d<int, cusp::host_memory>
+		startI,       ///< starting cell index of the bounding box of a body
+		startJ,       ///< starting cell index of the bounding box of a body
+		numCellsX,    ///< number of cells in the x-direction in the bounding box of a body
+		numCellsY;    ///< number of cells in the y-direction in the bounding box of a body
+
+	cusp::array1d<double, cusp::host_memory>
+		xmin,  ///< lowest x-coordinate for the bounding box of a body
+		xmax,  ///< highest x-coordinate for the bounding box of a body
+		ymin,  ///< lowest y-coordinate for the bounding box of a body
+		ymax;  ///< highest y-coordinate for the bounding box of a body
+
+	cusp::array1d<int, cusp::host_memory>
+		startI0,		///< starting cell index of the unscaled bounding box of a body
+		startJ0,		///< starting cell index of the unscaled bounding box of a body
+		numCellsX0,		///< number of cells in the x-direction in the unscaled bounding box of a body
+		numCellsY0;		///< number of cells in the y-direction in the unscaled bounding box of a body
+};
 
 /**
  * \class bodies
@@ -18,11 +47,18 @@ class bodies
 public:
 	int  numBodies,   ///< number of bodies
 	     totalPoints, ///< total number of boundary points (all bodies)
-	     numCellsXHost,	///< number of cells in the x-direction in the bounding box of a body on the host
-	     numCellsYHost;
+	     numCellsXHost,	///< number of cells in the x-direction in the bounding box of body 0 on the host
+	     numCellsYHost;	///< number of cells in the y-direction in the bounding box of body 0 on the host
 
 	bool bodiesMove;  ///< tells whether the body is moving or not
 
+	bool analytic;    ///< tag the nodes with the analytic shape of the body instead of ray casting on the boundary points
+
+	shape Shape;      ///< analytic shape of body 0, its centre is stored relative to (midX, midY) so it moves with the body
+
+	cusp::array1d<double, cusp::device_memory>
+		distanceField;    ///< narrow band signed distance and nearest segments of body 0 in its own frame, then its boundary points, see shapeType::DISTANCE_FIELD
+
 	cusp::array1d<int, cusp::device_memory>
 		numPoints,    ///< number of points for each body
 		offsets;      ///< array index of the first point of each body
@@ -47,6 +83,30 @@ public:
 		ymin0,  ///< lowest y-coordinate for the bounding box of a body (original size)
 		ymax0;  ///< highest y-coordinate for the bounding box of a body (original size)
 
+	bodyMetadata hostMeta;	///< host copy of the bounding boxes
+
+	cusp::array1d<double, cusp::device_memory>
+		metaPacked;	///< bounding box data of every body packed into one array so it can be copied to the host at once
+
+	cusp::array1d<double, cusp::host_memory>
+		metaPacked_h;
+
+	cusp::array1d<int, cusp::device_memory>
+		pointBody;	///< index of the body each boundary point belongs to
+
+	cusp::array1d<double, cusp::host_memory>
+		motion_h;	///< rigid motion of every body, 9 doubles per body: Xc, cos and sin of Theta, X0, vel and angVel
+
+	cusp::array1d<double, cusp::device_memory>
+		motion;		///< device copy of motion_h
+
+	cusp::array1d<double, cusp::host_memory>
+		refCentre_h,	///< average of the reference points of each body
+		centre_h;		///< current centre of each body, x and y, moved with the body by applyMotion
+
+	cusp::array1d<double, cusp::device_memory>
+		centre;		///< device copy of centre_h, the tagging kernels use it to tell which side of a body a node is on
+
 	cusp::array1d<double, cusp::device_memory>
 		X,     ///< reference x-coordinates of the boundary points
 		Y,     ///< reference y-coordinates of the boundary points
@@ -120,9 +180,24 @@ public:
 	// store indices of the non scaled bounding box of each body
 	void calculateTightBoundingBoxes(parameterDB &db, domain &D);
 
+	// copy the bounding boxes to the host
+	void updateMetadata();
+
+	// analytic shape of body 0 at its current position
+	shape currentShape();
+
+	// sample the signed distance to the boundary points of a body on a lattice in the body frame
+	void buildDistanceField(body &Body, double h, double band);
+
 	// update position, velocity and neighbors of each body
 	void update(parameterDB &db, domain &D, double Time);
 
+	// shift every body and set its translational velocity
+	void translate(double dx, double dy, double u, double v);
+
+	// move all the boundary points to the positions in the motion table
+	void applyMotion();
+
 	// write body coordinates into a file
 	void writeToFile(std::string &caseFolder, int timeStep);
 
@@ -131,7 +206,14 @@ public:
 };
 
 __global__
-void boundingBox(double *x, double *y,
-				 thrust::device_vector<double>::iterator xmax_in, thrust::device_vector<double>::iterator xmin_in, thrust::device_vector<double>::iterator ymax_in, thrust::device_vector<double>::iterator ymin_in,
-				 int *startI, int *startJ, int *numCellsX, int *numCellsY,
-				 double *xmax, double *xmin, double *ymax, double *ymin, double scale);
+void boundingBoxes(double *bx, double *by, int *offsets, int *numPoints, double *x, double *y, int nx, int ny,
+				   int *startI, int *startJ, int *numCellsX, int *numCellsY,
+				   double *xmin, double *xmax, double *ymin, double *ymax, double scale);
+
+__global__
+void rigidMotion(double *x, double *y, double *uB, double *vB, double *X, double *Y, int *pointBody, double *motion, int totalPoints);
+
+__global__
+void packMetadata(double *packed, int *startI, int *startJ, int *numCellsX, int *numCellsY,
+				  double *xmin, double *xmax, double *ymin, double *ymax,
+				  int *startI0, int *startJ0, int *numCellsX0, int *numCellsY0, int numBodies);
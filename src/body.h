@@ -7,6 +7,7 @@
 
 #pragma once
 #include <cusp/array1d.h>
+#include "shape.h"
 
 /**
  * \class body
@@ -29,6 +30,10 @@ class body
     cusp::array1d<double, cusp::host_memory>
     	X,         ///< reference x-coordinate of boundary points
 		Y;         ///< reference y-coordinate of boundary points
+
+	shape Shape;	///< analytic description of the surface, POLYGON if the body only has its boundary points
+
+	bool analyticTags;	///< tag the nodes with Shape instead of the boundary points, only used when there is a single body
          
 	double X0[2];     ///< reference center of rotation
 	     
@@ -104,5 +109,13 @@ class body
 		xOscillation[0] = xOscillation[1] = xOscillation[2] = 0.0;
 		yOscillation[0] = yOscillation[1] = yOscillation[2] = 0.0;
 		pitchOscillation[0] = pitchOscillation[1] = pitchOscillation[2] = 0.0;
+		Shape.type = shapeType::POLYGON;
+		Shape.cx = Shape.cy = 0.0;
+		Shape.a = Shape.b = 0.0;
+		Shape.angle = 0.0;
+		Shape.field = 0;
+		Shape.fieldNx = Shape.fieldNy = Shape.fieldPoints = 0;
+		Shape.fieldX0 = Shape.fieldY0 = Shape.fieldH = 0.0;
+		analyticTags = false;
 	}
 };
@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ * \file cachedAllocator.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Implementation of the methods of the class \c cachedAllocator
+ */
+
+
+#include "cachedAllocator.h"
+#include <iostream>
+#include <cstdlib>
+
+cachedAllocator::cachedAllocator()
+{
+	numAllocations = 0;
+}
+
+cachedAllocator::~cachedAllocator()
+{
+	freeAll();
+}
+
+/*
+ * Returns the smallest cached block that fits, or a new block if none do
+ * param num_bytes size of the request
+ */
+char *cachedAllocator::allocate(std::ptrdiff_t num_bytes)
+{
+	char *result = 0;
+	freeBlocks::iterator block = free_blocks.lower_bound(num_bytes);
+	if (block != free_blocks.end())
+	{
+		result = block->second;
+		num_bytes = block->first;
+		free_blocks.erase(block);
+	}
+	else
+	{
+		if (cudaMalloc((void **) &result, num_bytes) != cudaSuccess)
+		{
+			std::cout << "ERROR: cachedAllocator failed to allocate " << num_bytes << " bytes" << std::endl;
+			std::exit(-1);
+		}
+		numAllocations++;
+	}
+	allocated_blocks.insert(std::make_pair(result, num_bytes));
+	return result;
+}
+
+/*
+ * Moves a block back into the cache, the memory is not freed
+ */
+void cachedAllocator::deallocate(char *ptr, size_t n)
+{
+	allocatedBlocks::iterator block = allocated_blocks.find(ptr);
+	if (block == allocated_blocks.end())
+		return;
+	free_blocks.insert(std::make_pair(block->second, ptr));
+	allocated_blocks.erase(block);
+}
+
+int cachedAllocator::allocations()
+{
+	return numAllocations;
+}
+
+void cachedAllocator::resetAllocations()
+{
+	numAllocations = 0;
+}
+
+/*
+ * Releases every block, the return value of cudaFree is ignored because this also runs at exit after the context may be gone
+ */
+void cachedAllocator::freeAll()
+{
+	for (freeBlocks::iterator i = free_blocks.begin(); i != free_blocks.end(); i++)
+		cudaFree(i->second);
+	for (allocatedBlocks::iterator i = allocated_blocks.begin(); i != allocated_blocks.end(); i++)
+		cudaFree(i->first);
+	free_blocks.clear();
+	allocated_blocks.clear();
+}
+
+/*
+ * The pool shared by the solvers and the bodies
+ */
+cachedAllocator &devicePool()
+{
+	static cachedAllocator pool;
+	return pool;
+}
@@ -0,0 +1,46 @@
+/***************************************************************************//**
+ * \file cachedAllocator.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the class \c cachedAllocator, a caching pool for the temporary device memory used by thrust
+ */
+
+
+#pragma once
+
+#include <map>
+#include <cstddef>
+#include <thrust/system/cuda/execution_policy.h>
+
+
+/**
+ * \class cachedAllocator
+ * \brief Keeps the device memory thrust asks for as scratch space and hands it back out on the next request
+ *
+ * Pass it to an algorithm with thrust::cuda::par(devicePool()).
+ * Blocks are only released when the program exits, so once every size a step needs has been seen
+ * the pool stops calling cudaMalloc.
+ */
+class cachedAllocator
+{
+	typedef std::multimap<std::ptrdiff_t, char *>	freeBlocks;
+	typedef std::map<char *, std::ptrdiff_t>		allocatedBlocks;
+
+	freeBlocks		free_blocks;		///< cached blocks, sorted by size
+	allocatedBlocks	allocated_blocks;	///< blocks currently handed out
+	int				numAllocations;		///< number of cudaMalloc calls since the counter was last reset
+
+public:
+	typedef char value_type;
+
+	cachedAllocator();
+	~cachedAllocator();
+
+	char *allocate(std::ptrdiff_t num_bytes);
+	void deallocate(char *ptr, size_t n);
+
+	int allocations();
+	void resetAllocations();
+	void freeAll();
+};
+
+cachedAllocator &devicePool();
@@ -22,23 +22,15 @@
 #include "solvers/NavierStokes/fadlunModified.h"
 #include "solvers/NavierStokes/luoIBM.h"
 #include "types.h"
+#include <sstream>
+#include <cmath>
 
-int main(int argc, char **argv)
+/*
+ * Creates the solver picked in simParams.yaml on a grid.
+ * I think this can be simplified/streamlined now that there is only one solver
+ */
+NavierStokesSolver *createSolver(parameterDB &paramDB, domain &dom_info)
 {
-	cudaDeviceReset();
-	// initialize the computational domain
-	domain dom_info;
-
-	// initialize the parameters of the simulation
-	parameterDB paramDB;
-
-	// read input .yaml files
-	io::readInputs(argc, argv, paramDB, dom_info);
-
-	//print simulation info
-	io::printSimulationInfo(paramDB, dom_info);
-
-	// create and initialize the flow solver, I think this can be simplified/streamlined now that there is only one solver
 	NavierStokesSolver *solver = 0;
 	solverType st = paramDB["simulation"]["SolverType"].get<solverType>();
 	switch(st)
@@ -59,12 +51,160 @@ int main(int argc, char **argv)
 		//solver = new FSI(&paramDB, &dom_info);
 		//break;
 	}
+	return solver;
+}
+
+/*
+ * Grid sequencing for the startup transient, does nothing unless gridLevels > 1.
+ * Level n uses the grid of domain.yaml with mid_h scaled by 2^n, starting from the coarsest one, gridLevels-1.
+ * Every level runs coarseSteps steps, or fewer if the convergence monitor stops it, with dt scaled the same way
+ * so the CFL number stays put, then its solution is prolonged onto the next finer level.
+ * The finer level takes over the time the coarser one reached, so a prescribed body motion carries on in phase.
+ * The levels write to caseFolder/levelN so the output of the production run is left alone.
+ * param fine the initialised solver on the grid of domain.yaml, level 1 is prolonged onto it
+ */
+void runCoarseLevels(parameterDB &paramDB, NavierStokesSolver *fine)
+{
+	int levels = paramDB["simulation"]["gridLevels"].get<int>();
+	std::string folder = paramDB["inputs"]["caseFolder"].get<std::string>(),
+				domainFile = folder + "/domain.yaml";
+
+	NavierStokesSolver *coarse = 0;
+	parameterDB *coarseDB = 0;
+	domain *coarseDomain = 0;
+	for (int level = levels-1; level > 0; level--)
+	{
+		double factor = pow(2.0, level);
+		std::stringstream out;
+		out << folder << "/level" << level;
+
+		parameterDB *db = new parameterDB(paramDB);
+		(*db)["inputs"]["caseFolder"].set<std::string>(out.str());
+		(*db)["simulation"]["dt"].set<double>(factor*paramDB["simulation"]["dt"].get<double>());
+		(*db)["simulation"]["dtMax"].set<double>(factor*paramDB["simulation"]["dtMax"].get<double>());
+		(*db)["simulation"]["nt"].set<int>(paramDB["simulation"]["startStep"].get<int>() + paramDB["simulation"]["coarseSteps"].get<int>());
+
+		domain *D = new domain;
+		io::parseDomainFile(domainFile, *D, factor);
+		std::cout << "\nStartup level " << level << ": " << D->nx << "x" << D->ny << " cells" << std::endl;
+
+		NavierStokesSolver *solver = createSolver(*db, *D);
+		solver->initialise();
+		if (coarse)
+		{
+			solver->prolong(*coarse);
+			delete coarse;
+			delete coarseDB;
+			delete coarseDomain;
+		}
+		else	// the coarsest level starts at the time of the fine run, not at startStep steps of its own dt
+			solver->setTime(paramDB["simulation"]["startStep"].get<int>()*paramDB["simulation"]["dt"].get<double>());
+		while (!solver->finished())
+		{
+			solver->stepTime();
+			solver->writeData();
+		}
+		solver->shutDown();
+
+		coarse = solver;
+		coarseDB = db;
+		coarseDomain = D;
+	}
+	if (coarse)
+	{
+		fine->prolong(*coarse);
+		delete coarse;
+		delete coarseDB;
+		delete coarseDomain;
+	}
+}
+
+/*
+ * Fork mode, runs when -variants is given.
+ * The solver of the case runs up to forkStep, then its state is kept on the device and the solver is freed.
+ * Every variant is a sub-folder of the case folder with its own flow.yaml and/or bodies.yaml.
+ * It gets a solver of its own, starts from a copy of the shared state and runs up to nt, writing to its folder.
+ * param solver the initialised solver of the case, deleted here
+ */
+void runVariants(parameterDB &paramDB, domain &dom_info, NavierStokesSolver *solver)
+{
+	int nt = paramDB["simulation"]["nt"].get<int>();
+	std::string folder = paramDB["inputs"]["caseFolder"].get<std::string>();
+	std::vector<std::string> variants = io::split(paramDB["inputs"]["variants"].get<std::string>(), ',');
+
+	// spin up once
+	paramDB["simulation"]["nt"].set<int>(paramDB["simulation"]["forkStep"].get<int>());
+	while (!solver->finished())
+	{
+		solver->stepTime();
+		solver->writeData();
+	}
+	solverState state;
+	solver->saveState(state);
+	solver->shutDown();
+	delete solver;
+	paramDB["simulation"]["nt"].set<int>(nt);
+
+	for (size_t k=0; k<variants.size(); k++)
+	{
+		parameterDB db(paramDB);
+		std::string variantFolder = folder + "/" + variants[k];
+		io::readVariant(db, variantFolder);
+		std::cout << "\nVariant " << variants[k] << " from time step " << state.timeStep << std::endl;
+
+		NavierStokesSolver *variant = createSolver(db, dom_info);
+		variant->initialise();
+		variant->loadState(state);
+		io::writeInfoFile(db, dom_info);
+
+		while (!variant->finished())
+		{
+			variant->stepTime();
+			variant->writeData();
+		}
+		variant->shutDown();
+		delete variant;
+		io::freeVariant(db, paramDB);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	cudaDeviceReset();
+	// initialize the computational domain
+	domain dom_info;
+
+	// initialize the parameters of the simulation
+	parameterDB paramDB;
+
+	// read input .yaml files
+	io::readInputs(argc, argv, paramDB, dom_info);
+
+	//print simulation info
+	io::printSimulationInfo(paramDB, dom_info);
+
+	// create and initialize the flow solver
+	NavierStokesSolver *solver = createSolver(paramDB, dom_info);
 	solver->initialise();
 
+	// start from the solution of another run, or run the startup transient on the coarse grids if there are any
+	std::string initFrom = paramDB["inputs"]["initFrom"].get<std::string>();
+	if (initFrom != "")
+		solver->initialiseFrom(initFrom);
+	else
+		runCoarseLevels(paramDB, solver);
+
 	//prints to output and files
 	io::printDeviceMemoryUsage();
 	io::writeInfoFile(paramDB, dom_info);
 
+	// branch the variants from one spun up state
+	if (paramDB["inputs"]["variants"].get<std::string>() != "")
+	{
+		runVariants(paramDB, dom_info, solver);
+		return 0;
+	}
+
 	// time-step loop
 	while (!solver->finished())
 	{
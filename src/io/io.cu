@@ -137,6 +137,60 @@ void readInputs(int argc, char **argv, parameterDB &DB, domain &D)
 	commandLineParse2(argc, argv, DB);
 }
 
+/**
+ * \brief Applies the files of a variant folder to a copy of the database of the case.
+ *
+ * The flow.yaml and bodies.yaml found in the folder replace those of the case, the missing ones are kept.
+ * The bodies and boundary conditions are stored behind pointers shared by the copies of the database,
+ * so the variant gets its own before they are overwritten.
+ *
+ * \param DB copy of the database of the case
+ * \param variantFolder folder of the variant, it becomes the case folder of the variant
+ */
+void readVariant(parameterDB &DB, std::string &variantFolder)
+{
+	boundaryCondition **caseBC = DB["flow"]["boundaryConditions"].get<boundaryCondition **>(),
+	                  **bc = new boundaryCondition*[4];
+	for (int i=0; i<4; i++)
+	{
+		bc[i] = new boundaryCondition[2];
+		bc[i][0] = caseBC[i][0];
+		bc[i][1] = caseBC[i][1];
+	}
+	DB["flow"]["boundaryConditions"].set<boundaryCondition **>(bc);
+
+	string fname = variantFolder + "/flow.yaml";
+	if (std::ifstream(fname.c_str()))
+		parseFlowFile(fname, DB);
+
+	fname = variantFolder + "/bodies.yaml";
+	if (std::ifstream(fname.c_str()))
+	{
+		DB["flow"]["bodies"].set<std::vector<body> *>(new std::vector<body>);
+		parseBodiesFile(fname, DB);
+	}
+
+	DB["inputs"]["caseFolder"].set<string>(variantFolder);
+}
+
+/**
+ * \brief Frees the boundary conditions and bodies \c readVariant gave a variant, call once its solver is deleted.
+ *
+ * \param DB database of the variant
+ * \param caseDB database of the case, its bodies are shared by a variant without a bodies.yaml and are kept
+ */
+void freeVariant(parameterDB &DB, parameterDB &caseDB)
+{
+	boundaryCondition **bc = DB["flow"]["boundaryConditions"].get<boundaryCondition **>();
+	for (int i=0; i<4; i++)
+		delete[] bc[i];
+	delete[] bc;
+
+	std::vector<body> *B = DB["flow"]["bodies"].get<std::vector<body> *>();
+	if (B != caseDB["flow"]["bodies"].get<std::vector<body> *>())
+		delete B;
+}
+
 /**
  * \brief Initializes the database with default values.
  *
@@ -154,6 +208,8 @@ void initialiseDefaultDB(parameterDB &DB)
 	string inputs = "inputs";
 	DB[inputs]["caseFolder"].set<string>("/scratch/cases/cuIBM/cases/cylinder/Re40");
 	DB[inputs]["deviceNumber"].set<int>(0);
+	DB[inputs]["initFrom"].set<string>("");
+	DB[inputs]["variants"].set<string>("");
 
 	// flow parameters
 	string flow = "flow";
@@ -180,20 +236,39 @@ void initialiseDefaultDB(parameterDB &DB)
 	//DB[sim]["solverType"].set<int>(0); //flag get rid of this?
 	DB[sim]["Ured"].set<double>(3);
 	DB[sim]["SolverType"].set<solverType>(NAVIERSTOKES);
+	DB[sim]["countTransfers"].set<bool>(false);
+	DB[sim]["bodyFixedFrame"].set<bool>(false);
+	DB[sim]["forceInterval"].set<int>(100);
+	DB[sim]["adaptiveTimeStep"].set<bool>(false);
+	DB[sim]["targetCFL"].set<double>(0.5);
+	DB[sim]["dtGrowth"].set<double>(1.1);
+	DB[sim]["dtMin"].set<double>(0);
+	DB[sim]["dtMax"].set<double>(0);
+	DB[sim]["steadyTolerance"].set<double>(0);
+	DB[sim]["periodicTolerance"].set<double>(0);
+	DB[sim]["periodicCycles"].set<int>(3);
+	DB[sim]["monitorInterval"].set<int>(10);
+	DB[sim]["gridLevels"].set<int>(1);
+	DB[sim]["coarseSteps"].set<int>(0);
+	DB[sim]["forkStep"].set<int>(0);
 
 	// velocity solver
 	string solver = "velocitySolve";
-	DB[solver]["solver"].set<string>("CG");
+	DB[solver]["solver"].set<string>("BICGSTAB");
 	DB[solver]["preconditioner"].set<preconditionerType>(DIAGONAL);
 	DB[solver]["tolerance"].set<double>(1e-5);
 	DB[solver]["maxIterations"].set<int>(10000);
+	DB[solver]["residualCheckInterval"].set<int>(1);
 
 	// Poisson solver
 	solver = "PoissonSolve";
-	DB[solver]["solver"].set<string>("CG");
+	DB[solver]["solver"].set<string>("BICGSTAB");
 	DB[solver]["preconditioner"].set<preconditionerType>(DIAGONAL);
 	DB[solver]["tolerance"].set<double>(1e-5);
 	DB[solver]["maxIterations"].set<int>(20000);
+	DB[solver]["residualCheckInterval"].set<int>(1);
+	DB[solver]["reducedSystem"].set<bool>(false);
+	DB[solver]["testReducedSystem"].set<bool>(false);
 }
 
 /**
@@ -295,6 +370,23 @@ void commandLineParse2(int argc, char **argv, parameterDB &DB)
 			i++;
 			DB["PoissonSolve"]["tolerance"].set<double>(toNumber<double>(string(argv[i])));
 		}
+		// print the number of device to host copies made each step
+		if ( strcmp(argv[i],"-countTransfers")==0 )
+		{
+			DB["simulation"]["countTransfers"].set<bool>(true);
+		}
+		// start from the solution saved by another run, given as caseFolder/timeStep
+		if ( strcmp(argv[i],"-initFrom")==0 )
+		{
+			i++;
+			DB["inputs"]["initFrom"].set<string>(string(argv[i]));
+		}
+		// comma separated sub-folders of the case folder, each one runs from the state at forkStep
+		if ( strcmp(argv[i],"-variants")==0 )
+		{
+			i++;
+			DB["inputs"]["variants"].set<string>(string(argv[i]));
+		}
 	}
 }
 
@@ -354,6 +446,28 @@ void printSimulationInfo(parameterDB &DB, domain &D)
 	std::cout << "dt = " << dt << '\n';
 	std::cout << "scaleCV = " << scaleCV << '\n';
 	std::cout << "startStep = " << startStep << '\n';
+	std::cout << "bodyFixedFrame = " << (DB["simulation"]["bodyFixedFrame"].get<bool>() ? "true" : "false") << '\n';
+	std::cout << "forceInterval = " << DB["simulation"]["forceInterval"].get<int>() << '\n';
+	if (DB["simulation"]["adaptiveTimeStep"].get<bool>())
+	{
+		std::cout << "adaptiveTimeStep = true" << '\n';
+		std::cout << "targetCFL = " << DB["simulation"]["targetCFL"].get<double>() << '\n';
+		std::cout << "dtGrowth = " << DB["simulation"]["dtGrowth"].get<double>() << '\n';
+		std::cout << "dtMin = " << DB["simulation"]["dtMin"].get<double>() << '\n';
+		std::cout << "dtMax = " << DB["simulation"]["dtMax"].get<double>() << '\n';
+	}
+	if (DB["simulation"]["steadyTolerance"].get<double>() > 0 || DB["simulation"]["periodicTolerance"].get<double>() > 0)
+	{
+		std::cout << "steadyTolerance = " << DB["simulation"]["steadyTolerance"].get<double>() << '\n';
+		std::cout << "periodicTolerance = " << DB["simulation"]["periodicTolerance"].get<double>() << '\n';
+		std::cout << "periodicCycles = " << DB["simulation"]["periodicCycles"].get<int>() << '\n';
+		std::cout << "monitorInterval = " << DB["simulation"]["monitorInterval"].get<int>() << '\n';
+	}
+	if (DB["simulation"]["gridLevels"].get<int>() > 1)
+	{
+		std::cout << "gridLevels = " << DB["simulation"]["gridLevels"].get<int>() << '\n';
+		std::cout << "coarseSteps = " << DB["simulation"]["coarseSteps"].get<int>() << '\n';
+	}
 	std::cout << "nt = "    << nt << '\n';
 	std::cout << "nsave = " << nsave << '\n';
 	
@@ -368,10 +482,20 @@ void printSimulationInfo(parameterDB &DB, domain &D)
 	std::cout << "Solver = " << DB["PoissonSolve"]["solver"].get<std::string>() << '\n';
 	//std::cout << "Preconditioner = " << stringFromPreconditionerType(DB["PoissonSolve"]["preconditioner"].get<preconditionerType>()) << '\n';
 	std::cout << "Tolerance = " << DB["PoissonSolve"]["tolerance"].get<double>() << '\n';
+	std::cout << "Reduced system = " << (DB["PoissonSolve"]["reducedSystem"].get<bool>() ? "true" : "false") << '\n';
+	if (DB["PoissonSolve"]["testReducedSystem"].get<bool>())
+		std::cout << "Reduced system checked against the full one every step" << '\n';
 	
 	std::cout << "\nOutput parameters" << '\n';
 	std::cout << "-----------------" << '\n';
 	std::cout << "Output folder = " << DB["inputs"]["caseFolder"].get<std::string>() << '\n';
+	if (DB["inputs"]["initFrom"].get<std::string>() != "")
+		std::cout << "Initial solution = " << DB["inputs"]["initFrom"].get<std::string>() << '\n';
+	if (DB["inputs"]["variants"].get<std::string>() != "")
+	{
+		std::cout << "Variants = " << DB["inputs"]["variants"].get<std::string>() << '\n';
+		std::cout << "forkStep = " << DB["simulation"]["forkStep"].get<int>() << '\n';
+	}
 	std::cout << "nsave = " << DB["simulation"]["nsave"].get<int>() << '\n';
 	
 	cudaDeviceProp deviceProp;
@@ -422,6 +546,9 @@ void writeInfoFile(parameterDB &DB, domain &D)
 /**
  * \brief Writes grid-points coordinates into the file \a grid.
  *
+ * For each direction the number of cells is followed by the nx (ny) cell centres, which is what
+ * scripts/python/readData.py reads, and the last cell edge. \c readGrid rebuilds the edges from them.
+ *
  * \param caseFolder the directory of the simulation
  * \param D information about the computational grid
  */
@@ -430,19 +557,111 @@ void writeGrid(std::string &caseFolder, domain &D)
 	std::stringstream out;
 	out << caseFolder << "/grid";
 	std::ofstream file(out.str().c_str(), ios::binary);
-	double x[D.nx], y[D.ny];
+	double x[D.nx+1], y[D.ny+1];
 	for (int i=0; i < D.nx; i++)
 		x[i] = D.x[i];
+	x[D.nx] = D.x[D.nx-1] + 0.5*D.dx[D.nx-1];
 	for (int i=0; i < D.ny; i++)
 		y[i] = D.y[i];
+	y[D.ny] = D.y[D.ny-1] + 0.5*D.dy[D.ny-1];
 
 	file.write((char*)(&D.nx), sizeof(int));
-	file.write((char*)(&x[0]), (D.nx+1)*sizeof(double));//flag, wrong size?
+	file.write((char*)(&x[0]), (D.nx+1)*sizeof(double));
 	file.write((char*)(&D.ny), sizeof(int));
 	file.write((char*)(&y[0]), (D.ny+1)*sizeof(double));
 	file.close();
 }
 
+/**
+ * \brief Turns the n cell centres and the last edge of a line read from \a grid into its n+1 cell edges, in place.
+ *
+ * Every centre is halfway between its edges, so the edges follow from the last one.
+ */
+void edgesFromCentres(cusp::array1d<double, cusp::host_memory> &a)
+{
+	int n = a.size()-1;
+	double edge = a[n];
+	for (int i=n-1; i >= 0; i--)
+	{
+		double centre = a[i];
+		a[i+1] = edge;
+		edge = 2*centre - edge;
+	}
+	a[0] = edge;
+}
+
+/**
+ * \brief Reads the cell edges from the file \a grid written by \c writeGrid.
+ *
+ * \param caseFolder the directory of the simulation
+ * \param xEdges the nx+1 edges of the cells in the x-direction
+ * \param yEdges the ny+1 edges of the cells in the y-direction
+ */
+void readGrid(std::string &caseFolder, cusp::array1d<double, cusp::host_memory> &xEdges, cusp::array1d<double, cusp::host_memory> &yEdges)
+{
+	std::string path = caseFolder + "/grid";
+	std::ifstream file(path.c_str(), ios::binary);
+	if (!file)
+	{
+		std::cout << "ERROR: could not open " << path << std::endl;
+		exit(-1);
+	}
+	int nx, ny;
+	file.read((char*)(&nx), sizeof(int));
+	xEdges.resize(nx+1);
+	file.read((char*)(&xEdges[0]), (nx+1)*sizeof(double));
+	file.read((char*)(&ny), sizeof(int));
+	yEdges.resize(ny+1);
+	file.read((char*)(&yEdges[0]), (ny+1)*sizeof(double));
+	if (!file)
+	{
+		std::cout << "ERROR: " << path << " is too short" << std::endl;
+		exit(-1);
+	}
+	file.close();
+	edgesFromCentres(xEdges);
+	edgesFromCentres(yEdges);
+}
+
+/**
+ * \brief Reads one array written by \c writeData, the size followed by the values.
+ */
+void readArray(std::string path, cusp::array1d<double, cusp::host_memory> &a)
+{
+	std::ifstream file(path.c_str(), ios::binary);
+	int N = 0;
+	file.read((char*)(&N), sizeof(int));
+	if (!file || N <= 0)
+	{
+		std::cout << "ERROR: could not read " << path << std::endl;
+		exit(-1);
+	}
+	a.resize(N);
+	file.read((char*)(&a[0]), N*sizeof(double));
+	if (!file)
+	{
+		std::cout << "ERROR: " << path << " is too short" << std::endl;
+		exit(-1);
+	}
+	file.close();
+}
+
+/**
+ * \brief Reads the velocity and pressure written by \c writeData at a given time-step.
+ *
+ * \param caseFolder directory of the simulation
+ * \param n the time-step number
+ * \param u the velocities, read from the file \a q
+ * \param p the pressure, read from the file \a lambda
+ */
+void readData(std::string &caseFolder, int n, cusp::array1d<double, cusp::host_memory> &u, cusp::array1d<double, cusp::host_memory> &p)
+{
+	std::stringstream out;
+	out << caseFolder << '/' << std::setfill('0') << std::setw(7) << n;
+	readArray(out.str() + "/q", u);
+	readArray(out.str() + "/lambda", p);
+}
+
 /**
  * \brief Writes numerical data at a given time-step (on the device).
  *
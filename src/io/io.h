@@ -32,8 +32,14 @@ namespace io
 	// read data inputs from the command-line and the simulation files
 	void readInputs(int argc, char **argv, parameterDB &DB, domain &D); 
 
+	// apply the input files of a variant folder to a copy of the database
+	void readVariant(parameterDB &DB, std::string &variantFolder);
+
+	// free what readVariant allocated for a variant
+	void freeVariant(parameterDB &DB, parameterDB &caseDB);
+
     // parse the \a domain file and generate the computational grid
-	void parseDomainFile(std::string &domFile, domain &D);
+	void parseDomainFile(std::string &domFile, domain &D, double coarsen = 1);
 	
 	// parse the \a flow file and store the parameters in the database
 	void parseFlowFile(std::string &flowFile, parameterDB &DB);
@@ -67,6 +73,12 @@ namespace io
 
 	template <typename Vector>
 	void writeData(std::string &caseFolder, int n, Vector &u, Vector &p, domain &D);
+
+	// read the cell edges from the file grid of a case
+	void readGrid(std::string &caseFolder, cusp::array1d<double, cusp::host_memory> &xEdges, cusp::array1d<double, cusp::host_memory> &yEdges);
+
+	// read the velocity and pressure saved at a given time-step
+	void readData(std::string &caseFolder, int n, cusp::array1d<double, cusp::host_memory> &u, cusp::array1d<double, cusp::host_memory> &p);
 	
 	// print device memory usage
 	void printDeviceMemoryUsage();
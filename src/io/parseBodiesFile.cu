@@ -85,6 +85,13 @@ void operator >> (const YAML::Node &node, body &Body)
 	{
 		std::cout<<"frequency not found\n\n";
 	}
+	try
+	{
+		node["analyticTags"] >> Body.analyticTags;
+	}
+	catch(...)
+	{
+	}
 	// get the type of body and read in appropriate details
 	string type;
 	node["type"] >> type;
@@ -149,6 +156,72 @@ void operator >> (const YAML::Node &node, body &Body)
 			Body.X[i] = cx + R*cos(i*2*M_PI/Body.numPoints);
 			Body.Y[i] = cy + R*sin(i*2*M_PI/Body.numPoints);
 		}
+		Body.Shape.type = shapeType::CIRCLE;
+		Body.Shape.cx = cx;
+		Body.Shape.cy = cy;
+		Body.Shape.a = R;
+	}
+	else if (type == "ellipse")
+	{
+		double cx, cy, a, b, angle;
+		int numPoints;
+		node["ellipseOptions"][0] >> cx;
+		node["ellipseOptions"][1] >> cy;
+		node["ellipseOptions"][2] >> a;
+		node["ellipseOptions"][3] >> b;
+		node["ellipseOptions"][4] >> angle;
+		node["ellipseOptions"][5] >> numPoints;
+		Body.Shape.type = shapeType::ELLIPSE;
+		Body.Shape.cx = cx;
+		Body.Shape.cy = cy;
+		Body.Shape.a = a;
+		Body.Shape.b = b;
+		Body.Shape.angle = angle*M_PI/180;
+
+		// the boundary points are still needed for the force and body output
+		Body.numPoints = numPoints;
+		Body.X.resize(numPoints);
+		Body.Y.resize(numPoints);
+		for(int i=0; i<Body.numPoints; i++)
+		{
+			geometry::toGlobal(Body.Shape, a*cos(i*2*M_PI/numPoints), b*sin(i*2*M_PI/numPoints), Body.X[i], Body.Y[i]);
+		}
+	}
+	else if (type == "naca")
+	{
+		// centre of the chord, chord length, thickness in percent of the chord, angle of attack in degrees
+		double cx, cy, c, t, aoa;
+		int numPoints;
+		node["nacaOptions"][0] >> cx;
+		node["nacaOptions"][1] >> cy;
+		node["nacaOptions"][2] >> c;
+		node["nacaOptions"][3] >> t;
+		node["nacaOptions"][4] >> aoa;
+		node["nacaOptions"][5] >> numPoints;
+		if (numPoints%2!=0)
+			numPoints++;
+		Body.Shape.type = shapeType::NACA00XX;
+		Body.Shape.cx = cx;
+		Body.Shape.cy = cy;
+		Body.Shape.a = c;
+		Body.Shape.b = t/100;
+		Body.Shape.angle = -aoa*M_PI/180;
+
+		// upper surface from the leading edge to the trailing edge then the lower surface back, spaced evenly in sqrt(x/c)
+		int half = numPoints/2;
+		Body.numPoints = numPoints;
+		Body.X.resize(numPoints);
+		Body.Y.resize(numPoints);
+		for(int i=0; i<=half; i++)
+		{
+			double s = double(i)/half;
+			geometry::toGlobal(Body.Shape, geometry::nacaX(Body.Shape, s), geometry::nacaY(Body.Shape, s), Body.X[i], Body.Y[i]);
+		}
+		for(int i=1; i<half; i++)
+		{
+			double s = double(half-i)/half;
+			geometry::toGlobal(Body.Shape, geometry::nacaX(Body.Shape, s), -geometry::nacaY(Body.Shape, s), Body.X[half+i], Body.Y[half+i]);
+		}
 	}
 	else
 		printf("[E]: unknown Body type\n");
@@ -20,12 +20,13 @@ namespace io
 using std::string;
 
 /**
- * \brief Overloads the operator >>. Gets information from the parsed domain file.
+ * \brief Gets the cells of one direction from the parsed domain file.
  *
  * \param node the parsed file
  * \param D instance of the class \c domain to be filled
+ * \param coarsen factor applied to mid_h, the cells of every subdomain grow by it and their number drops
  */
-void operator >> (const YAML::Node &node, domain &D)
+void parseDirection(const YAML::Node &node, domain &D, double coarsen)
 {
 	string dir;
 	double start;
@@ -34,6 +35,7 @@ void operator >> (const YAML::Node &node, domain &D)
 	node["direction"] >> dir;
 	node["start"] >> start;
 	node["mid_h"] >> mid_h;
+	mid_h *= coarsen;
 	D.mid_h = mid_h;
 
 	double end, stretchRatio, a, count = 0;
@@ -351,15 +353,16 @@ void operator >> (const YAML::Node &node, domain &D)
  *
  * \param domFile the file that contains information about the computational grid
  * \param D instance of the class \c domain that will be filled with information about the computational grid
+ * \param coarsen ratio of the cell size to the one in the file, used to derive the coarse grids of the startup
  */
-void parseDomainFile(std::string &domFile, domain &D)
+void parseDomainFile(std::string &domFile, domain &D, double coarsen)
 {
 	std::ifstream fin(domFile.c_str());			//setup to go through casefolder/domain.yaml
 	YAML::Parser  parser(fin);
 	YAML::Node    doc;
 	parser.GetNextDocument(doc);
 	for (unsigned int i=0; i<doc.size(); i++)	//go through each node in domain.yaml
-		doc[i] >> D;
+		parseDirection(doc[i], D, coarsen);
 
 	D.xu.resize(D.nx-1);	//xu on device
 	D.yu.resize(D.ny);		//yu on device
@@ -40,6 +40,16 @@ preconditionerType preconditionerTypeFromString(string &s)
     return SMOOTHED_AGGREGATION;
   else if (s == "AINV")
     return AINV;
+  else if (s == "ILU0")
+    return ILU0;
+  else if (s == "IC0")
+    return IC0;
+  else if (s == "CHEBYSHEV")
+    return CHEBYSHEV;
+  else if (s == "BLOCK_JACOBI")
+    return BLOCK_JACOBI;
+  else if (s == "AMG")
+    return AMG;
   else
     return NONE;
 }
@@ -76,9 +86,23 @@ void parseSimulation(const YAML::Node &node, parameterDB &DB)
 	       scaleCV = 2.0;
 	int    nt = 100,
 	       nsave = 100,
-	       startStep = 0;
+	       startStep = 0,
+	       forceInterval = 100;
 	string convSch = "ADAMS_BASHFORTH_2";
-	bool   restart = false;
+	bool   restart = false,
+	       bodyFixedFrame = false,
+	       adaptiveTimeStep = false;
+	double targetCFL = 0.5,
+	       dtGrowth = 1.1,
+	       dtMin = 0,
+	       dtMax = 0,
+	       steadyTolerance = 0,
+	       periodicTolerance = 0;
+	int    periodicCycles = 3,
+	       monitorInterval = 10,
+	       gridLevels = 1,
+	       coarseSteps = 0,
+	       forkStep = 0;
 
 	string SolverType = "NAVIER_STOKES_SOLVER";
 	// read simulation parameters
@@ -113,6 +137,104 @@ void parseSimulation(const YAML::Node &node, parameterDB &DB)
 	catch(...)
 	{
 	}
+	try
+	{
+		node["bodyFixedFrame"] >> bodyFixedFrame;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["adaptiveTimeStep"] >> adaptiveTimeStep;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["targetCFL"] >> targetCFL;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["dtGrowth"] >> dtGrowth;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["dtMin"] >> dtMin;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["dtMax"] >> dtMax;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["steadyTolerance"] >> steadyTolerance;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["periodicTolerance"] >> periodicTolerance;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["periodicCycles"] >> periodicCycles;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["monitorInterval"] >> monitorInterval;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["gridLevels"] >> gridLevels;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["coarseSteps"] >> coarseSteps;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["forkStep"] >> forkStep;
+	}
+	catch(...)
+	{
+	}
+	try
+	{
+		node["forceInterval"] >> forceInterval;
+	}
+	catch(...)
+	{
+	}
 
 	// write to DB
 	string dbKey = "simulation";
@@ -121,15 +243,30 @@ void parseSimulation(const YAML::Node &node, parameterDB &DB)
 	DB[dbKey]["nsave"].set<int>(nsave);
 	DB[dbKey]["nt"].set<int>(nt);
 	DB[dbKey]["restart"].set<bool>(restart);
+	DB[dbKey]["bodyFixedFrame"].set<bool>(bodyFixedFrame);
+	DB[dbKey]["forceInterval"].set<int>(forceInterval);
+	DB[dbKey]["adaptiveTimeStep"].set<bool>(adaptiveTimeStep);
+	DB[dbKey]["targetCFL"].set<double>(targetCFL);
+	DB[dbKey]["dtGrowth"].set<double>(dtGrowth);
+	DB[dbKey]["dtMin"].set<double>(dtMin);
+	DB[dbKey]["dtMax"].set<double>(dtMax);
+	DB[dbKey]["steadyTolerance"].set<double>(steadyTolerance);
+	DB[dbKey]["periodicTolerance"].set<double>(periodicTolerance);
+	DB[dbKey]["periodicCycles"].set<int>(periodicCycles);
+	DB[dbKey]["monitorInterval"].set<int>(monitorInterval);
+	DB[dbKey]["gridLevels"].set<int>(gridLevels);
+	DB[dbKey]["coarseSteps"].set<int>(coarseSteps);
+	DB[dbKey]["forkStep"].set<int>(forkStep);
 	DB[dbKey]["SolverType"].set<solverType>(solverTypeFromString(SolverType));
 
-	string system = "velocity", linearSolver = "CG", preconditioner = "DIAGONAL";
+	string system = "velocity", linearSolver = "BICGSTAB", preconditioner = "DIAGONAL";
 	double tol = 1e-5;
 	int maxIter = 10000;
 
 	const YAML::Node &solvers = node["linearSolvers"];
 	for (unsigned int i=0; i<solvers.size(); i++)
 	{
+		int checkInterval = 1;
 		// read linear solver options
 		solvers[i]["system"] >> system;
 		solvers[i]["solver"] >> linearSolver;
@@ -154,6 +291,29 @@ void parseSimulation(const YAML::Node &node, parameterDB &DB)
 		catch(...)
 		{
 		}
+		try
+		{
+			solvers[i]["residualCheckInterval"] >> checkInterval;
+		}
+		catch(...)
+		{
+		}
+		bool reducedSystem = false;
+		try
+		{
+			solvers[i]["reducedSystem"] >> reducedSystem;
+		}
+		catch(...)
+		{
+		}
+		bool testReducedSystem = false;
+		try
+		{
+			solvers[i]["testReducedSystem"] >> testReducedSystem;
+		}
+		catch(...)
+		{
+		}
 
 		// write to DB
 		string dbKey = system + "Solve";
@@ -161,6 +321,9 @@ void parseSimulation(const YAML::Node &node, parameterDB &DB)
 		DB[dbKey]["preconditioner"].set<preconditionerType>(preconditionerTypeFromString(preconditioner));
 		DB[dbKey]["tolerance"].set<double>(tol);
 		DB[dbKey]["maxIterations"].set<int>(maxIter);
+		DB[dbKey]["residualCheckInterval"].set<int>(checkInterval);
+		DB[dbKey]["reducedSystem"].set<bool>(reducedSystem);
+		DB[dbKey]["testReducedSystem"].set<bool>(testReducedSystem);
 	}
 }
 
@@ -13,6 +13,10 @@
 #include <cusp/precond/aggregation/smoothed_aggregation.h>
 #include <cusp/precond/ainv.h>
 #include <cusp/detail/format.h>
+#include <preconditioners/incompleteFactorisation.h>
+#include <preconditioners/chebyshev.h>
+#include <preconditioners/blockJacobi.h>
+#include <preconditioners/amg.h>
 
 /**
 / * \enum  preconditionerType
@@ -23,7 +27,12 @@ enum preconditionerType
 	NONE,                 ///< no preconditioner
 	DIAGONAL,             ///< diagonal preconditioner
 	SMOOTHED_AGGREGATION, ///< smoothed aggregation preconditioner
-	AINV                  ///< approximate inverse preconditioner
+	AINV,                 ///< approximate inverse preconditioner
+	ILU0,                 ///< incomplete LU factorisation with no fill
+	IC0,                  ///< incomplete Cholesky factorisation with no fill, for (nearly) symmetric systems
+	CHEBYSHEV,            ///< Jacobi scaled Chebyshev polynomial
+	BLOCK_JACOBI,         ///< block Jacobi with one tridiagonal block per grid row
+	AMG                   ///< smoothed aggregation AMG that keeps its hierarchy on update()
 };
 
 /**
@@ -39,6 +48,8 @@ class preconditioner
 	                      typename Matrix::memory_space,
 	                      typename Matrix::index_type>* LO;
 
+	void build(const Matrix &A);
+
 public:
 	typedef typename Matrix::index_type   index_type;
 	typedef typename Matrix::value_type   value_type;
@@ -81,18 +92,26 @@ preconditioner<Matrix>::preconditioner()
 *///
 template <class Matrix>
 preconditioner<Matrix>::preconditioner(const Matrix &A, preconditionerType _type)
+{
+	type = _type;
+	build(A);
+}
+
+/**
+/ * \brief Generates an instance of linear_operator with the derived class required by the type
+/ *
+/ * \param A matrix of the system (instance of the class \c Matrix)
+*///
+template <class Matrix>
+void preconditioner<Matrix>::build(const Matrix &A)
 {
 	typedef typename Matrix::value_type   ValueType;
 	typedef typename Matrix::index_type   IndexType;
 	typedef typename Matrix::memory_space MemorySpace;
 
-	type = _type;
-
-	// generate an instance of linear_operator with the required derived class
-	// depending on the second parameter
-	/*if (type == NONE)
-		LO = new cusp::identity_operator<ValueType, MemorySpace>(A.num_rows, A.num_cols);
-	else*/
+	if (type == NONE)
+		LO = new cusp::identity_operator<ValueType, MemorySpace, IndexType>(A.num_rows, A.num_cols);
+	else
 	if (type == DIAGONAL)
 		LO = new cusp::precond::diagonal<ValueType, MemorySpace>(A);
 	else
@@ -102,6 +121,21 @@ preconditioner<Matrix>::preconditioner(const Matrix &A, preconditionerType _type
 	if (type == AINV)
 		LO = new cusp::precond::nonsym_bridson_ainv<ValueType, MemorySpace>(A);
 	else
+	if (type == ILU0)
+		LO = new preconditioners::incompleteFactorisation<IndexType, ValueType, MemorySpace>(A, false);
+	else
+	if (type == IC0)
+		LO = new preconditioners::incompleteFactorisation<IndexType, ValueType, MemorySpace>(A, true);
+	else
+	if (type == CHEBYSHEV)
+		LO = new preconditioners::chebyshev<IndexType, ValueType, MemorySpace>(A);
+	else
+	if (type == BLOCK_JACOBI)
+		LO = new preconditioners::blockJacobi<IndexType, ValueType, MemorySpace>(A);
+	else
+	if (type == AMG)
+		LO = new preconditioners::aggregationAMG<IndexType, ValueType, MemorySpace>(A);
+	else
 	{
 		std::cout << "ERROR: Choose a valid preconditioner!\n" << std::endl;
 		exit(0);
@@ -119,31 +153,27 @@ preconditioner<Matrix>::~preconditioner()
 
 /**
 / * \brief Updates the preconditioner of the system.
+/ *        AMG keeps its hierarchy and only recomputes the coarse operators,
+/ *        the other types are rebuilt from scratch.
 / *
 / * \param A matrix of the system (instance of the class \c Matrix)
 *///
 template <class Matrix>
 void preconditioner<Matrix>::update(const Matrix &A)
 {
-	typedef typename Matrix::value_type   ValueType;
-	typedef typename Matrix::index_type   IndexType;
-	typedef typename Matrix::memory_space MemorySpace;
-
-	/*if (type == NONE)
-		LO = cusp::identity_operator<ValueType, MemorySpace>(A.num_rows, A.num_cols);
-	else*/
-	if (type == DIAGONAL)
-		*LO = cusp::precond::diagonal<ValueType, MemorySpace>(A);
-	else
-	if (type == SMOOTHED_AGGREGATION)
-		*LO = cusp::precond::aggregation::smoothed_aggregation<IndexType, ValueType, MemorySpace>(A);
+	if (type == NONE)
+		return;
 	else
-	if (type == AINV)
-		*LO = cusp::precond::nonsym_bridson_ainv<ValueType, MemorySpace>(A);
+	if (type == AMG)
+	{
+		preconditioners::aggregationAMG<index_type, value_type, memory_space> *MG =
+			static_cast<preconditioners::aggregationAMG<index_type, value_type, memory_space> *>(LO);
+		MG->updateValues(A);
+	}
 	else
 	{
-		std::cout << "ERROR: Choose a valid preconditioner!\n" << std::endl;
-		exit(0);
+		delete LO;
+		build(A);
 	}
 }
 
@@ -155,15 +185,13 @@ template <typename Matrix>
 template <typename VectorType1, typename VectorType2>
 void preconditioner<Matrix>::operator()(const VectorType1 &x, VectorType2 &y) const
 {
-	/*if (type == NONE)
+	if (type == NONE)
 	{
-		cusp::identity_operator<value_type, memory_space> *identity =
-			static_cast<cusp::identity_operator<value_type, memory_space> *>(LO);
-		printf("dispatching identity->operator()\n");
-		identity->operator()(x,b);
+		cusp::identity_operator<value_type, memory_space, index_type> *identity =
+			static_cast<cusp::identity_operator<value_type, memory_space, index_type> *>(LO);
+		identity->operator()(x,y);
 	}
-	else*/
-	if (type == DIAGONAL)
+	else if (type == DIAGONAL)
 	{
 		cusp::precond::diagonal<value_type, memory_space> *diag =
 			static_cast<cusp::precond::diagonal<value_type, memory_space> *>(LO);
@@ -181,6 +209,30 @@ void preconditioner<Matrix>::operator()(const VectorType1 &x, VectorType2 &y) co
 			static_cast<cusp::precond::nonsym_bridson_ainv<value_type, memory_space> *>(LO);
 		AI->operator()(x,y);
 	}
+	else if (type == ILU0 || type == IC0)
+	{
+		preconditioners::incompleteFactorisation<index_type, value_type, memory_space> *IF =
+			static_cast<preconditioners::incompleteFactorisation<index_type, value_type, memory_space> *>(LO);
+		IF->operator()(x,y);
+	}
+	else if (type == CHEBYSHEV)
+	{
+		preconditioners::chebyshev<index_type, value_type, memory_space> *CH =
+			static_cast<preconditioners::chebyshev<index_type, value_type, memory_space> *>(LO);
+		CH->operator()(x,y);
+	}
+	else if (type == BLOCK_JACOBI)
+	{
+		preconditioners::blockJacobi<index_type, value_type, memory_space> *BJ =
+			static_cast<preconditioners::blockJacobi<index_type, value_type, memory_space> *>(LO);
+		BJ->operator()(x,y);
+	}
+	else if (type == AMG)
+	{
+		preconditioners::aggregationAMG<index_type, value_type, memory_space> *MG =
+			static_cast<preconditioners::aggregationAMG<index_type, value_type, memory_space> *>(LO);
+		MG->operator()(x,y);
+	}
 	else
 	{
 		printf("ERROR: Choose a valid preconditioner!\n");
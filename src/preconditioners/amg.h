@@ -0,0 +1,372 @@
+/***************************************************************************//**
+ * \file amg.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief smoothed aggregation AMG that can refresh its Galerkin products without redoing the aggregation
+ */
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <cusp/linear_operator.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/transpose.h>
+#include <cusp/multiply.h>
+#include <cusp/blas/blas.h>
+#include <thrust/copy.h>
+#include <thrust/iterator/counting_iterator.h>
+#include "sparseUtilities.h"
+
+namespace preconditioners
+{
+
+/**
+ * \brief writes 1/a_ii for one row of a CSR matrix
+ */
+template <typename IndexType, typename ValueType>
+struct inverseDiagonalRow
+{
+	const IndexType *rowOffsets, *cols;
+	const ValueType *vals;
+	ValueType *invDiag;
+
+	inverseDiagonalRow(const IndexType *_rowOffsets, const IndexType *_cols, const ValueType *_vals, ValueType *_invDiag)
+		: rowOffsets(_rowOffsets), cols(_cols), vals(_vals), invDiag(_invDiag) {}
+
+	__host__ __device__
+	void operator()(IndexType i) const
+	{
+		ValueType d = 0;
+		for (IndexType p=rowOffsets[i]; p<rowOffsets[i+1]; p++)
+			if (cols[p] == i)
+				d += vals[p];
+		invDiag[i] = d == 0 ? 1 : 1/d;
+	}
+};
+
+/**
+ * \class aggregationAMG
+ * \brief Smoothed aggregation AMG, V(1,1) cycle with weighted Jacobi smoothing and a dense LU on the coarsest level
+ *
+ * The setup (strength of connection, aggregation, prolongator smoothing) is done on the host.
+ * updateValues() keeps the aggregates and the P/R operators of every level and only recomputes the
+ * coarse operators R*A*P and the smoother diagonals, so a matrix whose values (or a few rows) change
+ * every time step doesn't pay for a full setup each step.
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+class aggregationAMG : public cusp::linear_operator<ValueType, MemorySpace, IndexType>
+{
+	typedef cusp::linear_operator<ValueType, MemorySpace, IndexType> Parent;
+	typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace> Matrix;
+	typedef cusp::array1d<ValueType, MemorySpace> Array;
+
+	struct level
+	{
+		Matrix A, P, R;
+		Array invDiag;
+		ValueType omega;			///< Jacobi weight, 4/(3 rho(D^-1 A))
+		mutable Array x, b, r;
+	};
+
+	std::vector<level> levels;
+
+	int coarseN;
+	std::vector<ValueType> coarseLU;	///< dense LU of the coarsest operator, row major
+	std::vector<int> coarsePivot;
+	mutable cusp::array1d<ValueType, cusp::host_memory> coarse_h;
+
+	void setInverseDiagonal(level &L);
+	void factoriseCoarsest(const cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> &A_h);
+	void cycle(int l) const;
+
+public:
+	template <typename MatrixType>
+	aggregationAMG(const MatrixType &A);
+
+	template <typename MatrixType>
+	void updateValues(const MatrixType &A);
+
+	int numLevels() const
+	{
+		return levels.size();
+	}
+
+	template <typename VectorType1, typename VectorType2>
+	void operator()(const VectorType1 &x, VectorType2 &y) const
+	{
+		cusp::copy(x, levels[0].b);
+		cycle(0);
+		cusp::copy(levels[0].x, y);
+	}
+};
+
+/*
+ * Full setup of the hierarchy
+ * param A the fine matrix
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename MatrixType>
+aggregationAMG<IndexType, ValueType, MemorySpace>::aggregationAMG(const MatrixType &A)
+	: Parent(A.num_rows, A.num_cols)
+{
+	const ValueType theta = 0.08;	//strength of connection threshold
+	const int maxLevels = 10,
+	          coarseSize = 256;
+
+	hostCSR<IndexType, ValueType> A_h(A);
+	while (true)
+	{
+		int n = A_h.n;
+		cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> csr_h(n, n, A_h.cols.size());
+		thrust::copy(A_h.rowOffsets.begin(), A_h.rowOffsets.end(), csr_h.row_offsets.begin());
+		thrust::copy(A_h.cols.begin(), A_h.cols.end(), csr_h.column_indices.begin());
+		thrust::copy(A_h.vals.begin(), A_h.vals.end(), csr_h.values.begin());
+
+		levels.push_back(level());
+		level &L = levels.back();
+		L.A = csr_h;
+		L.x.resize(n);
+		L.b.resize(n);
+		L.r.resize(n);
+		setInverseDiagonal(L);
+
+		//Jacobi weight from the Gershgorin bound on the spectral radius of D^-1 A
+		std::vector<ValueType> d(n, 0);
+		ValueType rho = 0;
+		for (int i=0; i<n; i++)
+			if (A_h.diag[i] != -1)
+				d[i] = A_h.vals[A_h.diag[i]];
+		for (int i=0; i<n; i++)
+		{
+			ValueType sum = 0;
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+				sum += std::fabs(A_h.vals[p]);
+			rho = std::max(rho, d[i] == 0 ? 1 : sum/std::fabs(d[i]));
+		}
+		L.omega = 4.0/(3.0*rho);
+
+		if (n <= coarseSize || (int)levels.size() == maxLevels)
+		{
+			factoriseCoarsest(csr_h);
+			break;
+		}
+
+		//aggregation, first pass: nodes whose strong neighbours are all free start a new aggregate
+		std::vector<int> agg(n, -1);
+		std::vector<bool> strong(A_h.cols.size(), false);
+		for (int i=0; i<n; i++)
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+			{
+				int j = A_h.cols[p];
+				strong[p] = j != i && std::fabs(A_h.vals[p]) >= theta*std::sqrt(std::fabs(d[i]*d[j]));
+			}
+		int numAgg = 0;
+		for (int i=0; i<n; i++)
+		{
+			if (agg[i] != -1)
+				continue;
+			bool free = true;
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1] && free; p++)
+				if (strong[p] && agg[A_h.cols[p]] != -1)
+					free = false;
+			if (!free)
+				continue;
+			agg[i] = numAgg;
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+				if (strong[p])
+					agg[A_h.cols[p]] = numAgg;
+			numAgg++;
+		}
+		//second pass: join a neighbouring aggregate from the first pass
+		std::vector<int> firstPass(agg);
+		for (int i=0; i<n; i++)
+		{
+			if (agg[i] != -1)
+				continue;
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+				if (strong[p] && firstPass[A_h.cols[p]] != -1)
+				{
+					agg[i] = firstPass[A_h.cols[p]];
+					break;
+				}
+		}
+		//third pass: whatever is left becomes an aggregate with its free neighbours
+		for (int i=0; i<n; i++)
+		{
+			if (agg[i] != -1)
+				continue;
+			agg[i] = numAgg;
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+				if (strong[p] && agg[A_h.cols[p]] == -1)
+					agg[A_h.cols[p]] = numAgg;
+			numAgg++;
+		}
+		if (numAgg > 0.9*n)
+		{
+			//not coarsening any more
+			factoriseCoarsest(csr_h);
+			break;
+		}
+
+		//smoothed prolongator P = (I - omega D^-1 A) T, T(i,agg(i)) = 1
+		std::vector<IndexType> pOffsets(n+1, 0), pCols;
+		std::vector<ValueType> pVals;
+		std::vector< std::pair<IndexType, ValueType> > row;
+		for (int i=0; i<n; i++)
+		{
+			row.clear();
+			row.push_back(std::make_pair((IndexType)agg[i], (ValueType)1));
+			ValueType scale = d[i] == 0 ? 0 : L.omega/d[i];
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+			{
+				IndexType c = agg[A_h.cols[p]];
+				size_t q = 0;
+				while (q < row.size() && row[q].first != c)
+					q++;
+				if (q == row.size())
+					row.push_back(std::make_pair(c, (ValueType)0));
+				row[q].second -= scale*A_h.vals[p];
+			}
+			std::sort(row.begin(), row.end());
+			for (size_t q=0; q<row.size(); q++)
+			{
+				pCols.push_back(row[q].first);
+				pVals.push_back(row[q].second);
+			}
+			pOffsets[i+1] = pCols.size();
+		}
+		cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> P_h(n, numAgg, pCols.size()), R_h;
+		thrust::copy(pOffsets.begin(), pOffsets.end(), P_h.row_offsets.begin());
+		thrust::copy(pCols.begin(), pCols.end(), P_h.column_indices.begin());
+		thrust::copy(pVals.begin(), pVals.end(), P_h.values.begin());
+		cusp::transpose(P_h, R_h);
+		L.P = P_h;
+		L.R = R_h;
+
+		//Galerkin product for the next level
+		Matrix AP, Ac;
+		cusp::multiply(L.A, L.P, AP);
+		cusp::multiply(L.R, AP, Ac);
+		A_h = hostCSR<IndexType, ValueType>(Ac);
+	}
+}
+
+/*
+ * Recomputes the coarse operators and smoothers for new matrix values, the aggregates, P and R are kept
+ * The matrix must be the same size as the one used in the setup and sorted by row
+ * param A the fine matrix
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename MatrixType>
+void aggregationAMG<IndexType, ValueType, MemorySpace>::updateValues(const MatrixType &A)
+{
+	levels[0].A = A;
+	for (size_t l=0; l<levels.size(); l++)
+	{
+		setInverseDiagonal(levels[l]);
+		if (l+1 == levels.size())
+		{
+			cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> A_h(levels[l].A);
+			factoriseCoarsest(A_h);
+			break;
+		}
+		Matrix AP;
+		cusp::multiply(levels[l].A, levels[l].P, AP);
+		cusp::multiply(levels[l].R, AP, levels[l+1].A);
+	}
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void aggregationAMG<IndexType, ValueType, MemorySpace>::setInverseDiagonal(level &L)
+{
+	L.invDiag.resize(L.A.num_rows);
+	inverseDiagonalRow<IndexType, ValueType> row(thrust::raw_pointer_cast( &(L.A.row_offsets[0]) ),
+	                                             thrust::raw_pointer_cast( &(L.A.column_indices[0]) ),
+	                                             thrust::raw_pointer_cast( &(L.A.values[0]) ),
+	                                             thrust::raw_pointer_cast( &(L.invDiag[0]) ));
+	thrust::for_each(thrust::counting_iterator<IndexType, MemorySpace>(0),
+	                 thrust::counting_iterator<IndexType, MemorySpace>(L.A.num_rows), row);
+}
+
+/*
+ * dense LU with partial pivoting of the coarsest operator
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void aggregationAMG<IndexType, ValueType, MemorySpace>::factoriseCoarsest(const cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> &A_h)
+{
+	int n = coarseN = A_h.num_rows;
+	coarseLU.assign(n*n, 0);
+	coarsePivot.resize(n);
+	coarse_h.resize(n);
+	for (int i=0; i<n; i++)
+		for (IndexType p=A_h.row_offsets[i]; p<A_h.row_offsets[i+1]; p++)
+			coarseLU[i*n+A_h.column_indices[p]] += A_h.values[p];
+	for (int k=0; k<n; k++)
+	{
+		int piv = k;
+		for (int i=k+1; i<n; i++)
+			if (std::fabs(coarseLU[i*n+k]) > std::fabs(coarseLU[piv*n+k]))
+				piv = i;
+		coarsePivot[k] = piv;
+		if (piv != k)
+			for (int j=0; j<n; j++)
+				std::swap(coarseLU[k*n+j], coarseLU[piv*n+j]);
+		if (coarseLU[k*n+k] == 0)
+			coarseLU[k*n+k] = 1;	//singular coarse operator (pure neumann), pin the null space
+		for (int i=k+1; i<n; i++)
+		{
+			ValueType f = coarseLU[i*n+k] /= coarseLU[k*n+k];
+			for (int j=k+1; j<n; j++)
+				coarseLU[i*n+j] -= f*coarseLU[k*n+j];
+		}
+	}
+}
+
+/*
+ * V(1,1) cycle on level l, reads levels[l].b and writes levels[l].x
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void aggregationAMG<IndexType, ValueType, MemorySpace>::cycle(int l) const
+{
+	const level &L = levels[l];
+	if (l+1 == (int)levels.size())
+	{
+		int n = coarseN;
+		coarse_h = L.b;
+		for (int k=0; k<n; k++)
+			std::swap(coarse_h[k], coarse_h[coarsePivot[k]]);
+		for (int i=0; i<n; i++)
+			for (int j=0; j<i; j++)
+				coarse_h[i] -= coarseLU[i*n+j]*coarse_h[j];
+		for (int i=n-1; i>=0; i--)
+		{
+			for (int j=i+1; j<n; j++)
+				coarse_h[i] -= coarseLU[i*n+j]*coarse_h[j];
+			coarse_h[i] /= coarseLU[i*n+i];
+		}
+		L.x = coarse_h;
+		return;
+	}
+	const level &C = levels[l+1];
+
+	//pre smooth from a zero guess
+	cusp::blas::xmy(L.invDiag, L.b, L.x);
+	cusp::blas::scal(L.x, L.omega);
+
+	//coarse grid correction
+	cusp::multiply(L.A, L.x, L.r);
+	cusp::blas::axpby(L.b, L.r, L.r, ValueType(1), ValueType(-1));
+	cusp::multiply(L.R, L.r, C.b);
+	cycle(l+1);
+	cusp::multiply(L.P, C.x, L.r);
+	cusp::blas::axpy(L.r, L.x, ValueType(1));
+
+	//post smooth
+	cusp::multiply(L.A, L.x, L.r);
+	cusp::blas::axpby(L.b, L.r, L.r, ValueType(1), ValueType(-1));
+	cusp::blas::xmy(L.invDiag, L.r, L.r);
+	cusp::blas::axpy(L.r, L.x, L.omega);
+}
+
+} // end namespace preconditioners
@@ -0,0 +1,123 @@
+/***************************************************************************//**
+ * \file blockJacobi.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief block Jacobi preconditioner with one tridiagonal block per grid row
+ */
+
+#pragma once
+
+#include <cusp/linear_operator.h>
+#include <thrust/iterator/zip_iterator.h>
+#include "sparseUtilities.h"
+
+namespace preconditioners
+{
+
+/**
+ * \brief solves one tridiagonal block with the Thomas algorithm, using the factorisation stored by blockJacobi
+ */
+template <typename IndexType, typename ValueType>
+struct thomasBlock
+{
+	const ValueType *sub, *super, *invDenom, *x;
+	ValueType *y;
+
+	thomasBlock(const ValueType *_sub, const ValueType *_super, const ValueType *_invDenom, const ValueType *_x, ValueType *_y)
+		: sub(_sub), super(_super), invDenom(_invDenom), x(_x), y(_y) {}
+
+	template <typename Tuple>
+	__host__ __device__
+	void operator()(Tuple block) const
+	{
+		IndexType start = thrust::get<0>(block),
+		          end   = thrust::get<1>(block);
+		y[start] = x[start]*invDenom[start];
+		for (IndexType i=start+1; i<end; i++)
+			y[i] = (x[i] - sub[i]*y[i-1])*invDenom[i];
+		for (IndexType i=end-2; i>=start; i--)
+			y[i] -= super[i]*y[i+1];
+	}
+};
+
+/**
+ * \class blockJacobi
+ * \brief Inverts the east/west coupling of each grid row exactly and ignores the north/south coupling
+ *
+ * A block starts wherever a row has no entry just left of its diagonal, which for the staggered velocity
+ * and pressure numbering is the first node of every grid row. One thread solves one block.
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+class blockJacobi : public cusp::linear_operator<ValueType, MemorySpace, IndexType>
+{
+	typedef cusp::linear_operator<ValueType, MemorySpace, IndexType> Parent;
+
+	cusp::array1d<IndexType, MemorySpace> blockStart;
+	cusp::array1d<ValueType, MemorySpace>
+		sub,		///< entry left of the diagonal
+		super,		///< modified entry right of the diagonal, c_i/(b_i - a_i c_i-1)
+		invDenom;	///< 1/(b_i - a_i c_i-1)
+
+public:
+	template <typename MatrixType>
+	blockJacobi(const MatrixType &A)
+		: Parent(A.num_rows, A.num_cols)
+	{
+		hostCSR<IndexType, ValueType> A_h(A);
+		int n = A_h.n;
+		std::vector<ValueType> a(n, 0), b(n, 0), c(n, 0);
+		std::vector<IndexType> starts;
+		for (int i=0; i<n; i++)
+		{
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+			{
+				if (A_h.cols[p] == i-1)
+					a[i] = A_h.vals[p];
+				else if (A_h.cols[p] == i)
+					b[i] = A_h.vals[p];
+				else if (A_h.cols[p] == i+1)
+					c[i] = A_h.vals[p];
+			}
+			if (i == 0 || a[i] == 0)
+			{
+				starts.push_back(i);
+				a[i] = 0;
+				if (i > 0)
+					c[i-1] = 0;
+			}
+		}
+		starts.push_back(n);
+
+		std::vector<ValueType> cp(n), inv(n);
+		for (int i=0; i<n; i++)
+		{
+			ValueType denom = b[i] - (a[i] == 0 ? 0 : a[i]*cp[i-1]);
+			if (denom == 0)
+			{
+				std::cout << "ERROR: singular block in the block Jacobi preconditioner at row " << i << std::endl;
+				exit(0);
+			}
+			inv[i] = 1/denom;
+			cp[i] = c[i]*inv[i];
+		}
+
+		blockStart = cusp::array1d<IndexType, cusp::host_memory>(starts.begin(), starts.end());
+		sub        = cusp::array1d<ValueType, cusp::host_memory>(a.begin(), a.end());
+		super      = cusp::array1d<ValueType, cusp::host_memory>(cp.begin(), cp.end());
+		invDenom   = cusp::array1d<ValueType, cusp::host_memory>(inv.begin(), inv.end());
+	}
+
+	template <typename VectorType1, typename VectorType2>
+	void operator()(const VectorType1 &x, VectorType2 &y) const
+	{
+		const ValueType *a_r = thrust::raw_pointer_cast( &(sub[0]) ),
+		                *c_r = thrust::raw_pointer_cast( &(super[0]) ),
+		                *d_r = thrust::raw_pointer_cast( &(invDenom[0]) ),
+		                *x_r = thrust::raw_pointer_cast( &(x[0]) );
+		ValueType       *y_r = thrust::raw_pointer_cast( &(y[0]) );
+		thrust::for_each(thrust::make_zip_iterator(thrust::make_tuple(blockStart.begin(), blockStart.begin()+1)),
+		                 thrust::make_zip_iterator(thrust::make_tuple(blockStart.end()-1, blockStart.end())),
+		                 thomasBlock<IndexType, ValueType>(a_r, c_r, d_r, x_r, y_r));
+	}
+};
+
+} // end namespace preconditioners
@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * \file chebyshev.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Jacobi scaled Chebyshev polynomial preconditioner with automatic eigenvalue bounds
+ */
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <cusp/linear_operator.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <thrust/copy.h>
+#include <cusp/blas/blas.h>
+#include "sparseUtilities.h"
+
+namespace preconditioners
+{
+
+/**
+ * \class chebyshev
+ * \brief Applies a fixed number of Chebyshev iterations on D^-1 A, starting from zero
+ *
+ * The spectrum of D^-1 A is bracketed automatically:
+ * the upper bound comes from a few power iterations, the lower bound from the Gershgorin discs.
+ * For the strongly diagonally dominant velocity LHS the discs give a lower bound well above zero and a low degree is enough.
+ * For the poisson LHS the discs touch zero so the lower bound is set to a fraction of the upper one
+ * and a higher degree is used.
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+class chebyshev : public cusp::linear_operator<ValueType, MemorySpace, IndexType>
+{
+	typedef cusp::linear_operator<ValueType, MemorySpace, IndexType> Parent;
+
+	cusp::csr_matrix<IndexType, ValueType, MemorySpace> A;
+	cusp::array1d<ValueType, MemorySpace> invDiag;
+	mutable cusp::array1d<ValueType, MemorySpace> r, d, t;
+
+	ValueType lambdaMin, lambdaMax;
+	int degree;
+
+public:
+	/*
+	 * param A_ the matrix
+	 * param _degree degree of the polynomial, chosen from the estimated condition number if <= 0
+	 */
+	template <typename MatrixType>
+	chebyshev(const MatrixType &A_, int _degree = 0)
+		: Parent(A_.num_rows, A_.num_cols)
+	{
+		hostCSR<IndexType, ValueType> A_h(A_);
+		int n = A_h.n;
+
+		cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> csr_h(n, n, A_h.cols.size());
+		thrust::copy(A_h.rowOffsets.begin(), A_h.rowOffsets.end(), csr_h.row_offsets.begin());
+		thrust::copy(A_h.cols.begin(), A_h.cols.end(), csr_h.column_indices.begin());
+		thrust::copy(A_h.vals.begin(), A_h.vals.end(), csr_h.values.begin());
+		A = csr_h;
+
+		//Gershgorin discs of D^-1 A are centred on 1
+		ValueType radius = 0;
+		cusp::array1d<ValueType, cusp::host_memory> invDiag_h(n);
+		for (int i=0; i<n; i++)
+		{
+			ValueType a_ii = A_h.diag[i] == -1 ? 0 : A_h.vals[A_h.diag[i]],
+			          sum = 0;
+			for (IndexType p=A_h.rowOffsets[i]; p<A_h.rowOffsets[i+1]; p++)
+				if (A_h.cols[p] != i)
+					sum += std::fabs(A_h.vals[p]);
+			invDiag_h[i] = a_ii == 0 ? 1 : 1/a_ii;
+			radius = std::max(radius, a_ii == 0 ? sum : sum/std::fabs(a_ii));
+		}
+		invDiag = invDiag_h;
+
+		r.resize(n);
+		d.resize(n);
+		t.resize(n);
+
+		//power iterations for the largest eigenvalue of D^-1 A
+		cusp::array1d<ValueType, cusp::host_memory> start(n);
+		for (int i=0; i<n; i++)
+			start[i] = 1 + 0.1*((i*7919)%13);
+		d = start;
+		cusp::blas::scal(d, 1/cusp::blas::nrm2(d));
+		ValueType estimate = 1;
+		for (int k=0; k<15; k++)
+		{
+			cusp::multiply(A, d, t);
+			cusp::blas::xmy(invDiag, t, t);
+			estimate = cusp::blas::nrm2(t);
+			if (estimate == 0)
+				break;
+			cusp::blas::axpby(t, t, d, 1/estimate, ValueType(0));
+		}
+
+		lambdaMax = std::min(ValueType(1.1)*estimate, 1+radius);
+		lambdaMin = std::max(1-radius, lambdaMax/30);
+		if (_degree > 0)
+			degree = _degree;
+		else
+			degree = (lambdaMax/lambdaMin < 10) ? 2 : 4;
+	}
+
+	template <typename VectorType1, typename VectorType2>
+	void operator()(const VectorType1 &x, VectorType2 &y) const
+	{
+		ValueType theta = (lambdaMax+lambdaMin)/2,
+		          delta = (lambdaMax-lambdaMin)/2,
+		          sigma = theta/delta,
+		          rho   = 1/sigma;
+
+		cusp::blas::xmy(invDiag, x, r);
+		cusp::blas::axpby(r, r, d, 1/theta, ValueType(0));
+		cusp::copy(d, y);
+		for (int k=1; k<degree; k++)
+		{
+			cusp::multiply(A, d, t);
+			cusp::blas::xmy(invDiag, t, t);
+			cusp::blas::axpy(t, r, ValueType(-1));
+			ValueType rhoNew = 1/(2*sigma-rho);
+			cusp::blas::axpby(d, r, d, rhoNew*rho, 2*rhoNew/delta);
+			cusp::blas::axpy(d, y, ValueType(1));
+			rho = rhoNew;
+		}
+	}
+};
+
+} // end namespace preconditioners
@@ -0,0 +1,187 @@
+/***************************************************************************//**
+ * \file incompleteFactorisation.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief ILU(0) and IC(0) preconditioners, applied with level scheduled triangular solves
+ */
+
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <cusp/linear_operator.h>
+#include <cusp/copy.h>
+#include "sparseUtilities.h"
+
+namespace preconditioners
+{
+
+/**
+ * \class incompleteFactorisation
+ * \brief M = L*U with the sparsity pattern of A (ILU(0)), or M = L*L^T with the pattern of the lower half of A (IC(0))
+ *
+ * The factors are computed once on the host, the triangular solves run in MemorySpace.
+ * IC(0) only looks at the lower half of the matrix so it should only be used for (nearly) symmetric systems.
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+class incompleteFactorisation : public cusp::linear_operator<ValueType, MemorySpace, IndexType>
+{
+	typedef cusp::linear_operator<ValueType, MemorySpace, IndexType> Parent;
+
+	triangularFactor<IndexType, ValueType, MemorySpace> L, U;
+
+	void factoriseILU(hostCSR<IndexType, ValueType> &A);
+	void factoriseIC(hostCSR<IndexType, ValueType> &A);
+	void split(const hostCSR<IndexType, ValueType> &A, const std::vector<ValueType> &diagL, const std::vector<ValueType> &diagU);
+
+public:
+	template <typename MatrixType>
+	incompleteFactorisation(const MatrixType &A, bool symmetric)
+		: Parent(A.num_rows, A.num_cols)
+	{
+		hostCSR<IndexType, ValueType> A_h(A);
+		for (int i=0; i<A_h.n; i++)
+			if (A_h.diag[i] == -1)
+			{
+				std::cout << "ERROR: incomplete factorisation needs a diagonal entry in every row, missing in row " << i << std::endl;
+				exit(0);
+			}
+		if (symmetric)
+			factoriseIC(A_h);
+		else
+			factoriseILU(A_h);
+	}
+
+	template <typename VectorType1, typename VectorType2>
+	void operator()(const VectorType1 &x, VectorType2 &y) const
+	{
+		cusp::copy(x, y);
+		L.sweep(y);
+		U.sweep(y);
+	}
+};
+
+/*
+ * ILU(0), ikj variant in place on the values of A
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void incompleteFactorisation<IndexType, ValueType, MemorySpace>::factoriseILU(hostCSR<IndexType, ValueType> &A)
+{
+	int n = A.n;
+	std::vector<IndexType> pos(n, -1);
+	for (int i=0; i<n; i++)
+	{
+		for (IndexType p=A.rowOffsets[i]; p<A.rowOffsets[i+1]; p++)
+			pos[A.cols[p]] = p;
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+		{
+			int k = A.cols[p];
+			A.vals[p] /= A.vals[A.diag[k]];
+			for (IndexType q=A.diag[k]+1; q<A.rowOffsets[k+1]; q++)
+				if (pos[A.cols[q]] != -1)
+					A.vals[pos[A.cols[q]]] -= A.vals[p]*A.vals[q];
+		}
+		for (IndexType p=A.rowOffsets[i]; p<A.rowOffsets[i+1]; p++)
+			pos[A.cols[p]] = -1;
+	}
+
+	std::vector<ValueType> diagL(n, 1), diagU(n);
+	for (int i=0; i<n; i++)
+		diagU[i] = A.vals[A.diag[i]];
+	split(A, diagL, diagU);
+}
+
+/*
+ * IC(0), row by row on the lower half of A, the upper half is replaced by the transpose of the factor
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void incompleteFactorisation<IndexType, ValueType, MemorySpace>::factoriseIC(hostCSR<IndexType, ValueType> &A)
+{
+	int n = A.n;
+	std::vector<IndexType> pos(n, -1);
+	std::vector<ValueType> diag(n);
+	for (int i=0; i<n; i++)
+	{
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+			pos[A.cols[p]] = p;
+		ValueType d = A.vals[A.diag[i]];
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+		{
+			int k = A.cols[p];
+			ValueType s = A.vals[p];
+			for (IndexType q=A.rowOffsets[k]; q<A.diag[k]; q++)
+				if (pos[A.cols[q]] != -1)
+					s -= A.vals[pos[A.cols[q]]]*A.vals[q];
+			A.vals[p] = s/diag[k];
+			d -= A.vals[p]*A.vals[p];
+		}
+		//the incomplete factor can break down even for an SPD matrix, fall back to the unmodified diagonal
+		diag[i] = d > 0 ? std::sqrt(d) : std::sqrt(std::fabs(A.vals[A.diag[i]]));
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+			pos[A.cols[p]] = -1;
+	}
+
+	//mirror the lower factor onto the upper half so split() sees L and L^T
+	std::vector<IndexType> count(n+1, 0);
+	for (int i=0; i<n; i++)
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+			count[A.cols[p]+1]++;
+	for (int i=0; i<n; i++)
+		count[i+1] += count[i];
+	std::vector<IndexType> tOffsets(count), tCols(count[n]);
+	std::vector<ValueType> tVals(count[n]);
+	for (int i=0; i<n; i++)
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+		{
+			IndexType q = count[A.cols[p]]++;
+			tCols[q] = i;
+			tVals[q] = A.vals[p];
+		}
+
+	std::vector<IndexType> lOffsets(n+1, 0), lCols;
+	std::vector<ValueType> lVals;
+	for (int i=0; i<n; i++)
+	{
+		for (IndexType p=A.rowOffsets[i]; p<A.diag[i]; p++)
+		{
+			lCols.push_back(A.cols[p]);
+			lVals.push_back(A.vals[p]);
+		}
+		lOffsets[i+1] = lCols.size();
+	}
+	L.build(n, lOffsets, lCols, lVals, diag, true);
+	U.build(n, tOffsets, tCols, tVals, diag, false);
+}
+
+/*
+ * Splits a factorised CSR matrix into its strictly lower and strictly upper parts and builds the level schedules
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void incompleteFactorisation<IndexType, ValueType, MemorySpace>::split(const hostCSR<IndexType, ValueType> &A,
+                                                                      const std::vector<ValueType> &diagL, const std::vector<ValueType> &diagU)
+{
+	int n = A.n;
+	std::vector<IndexType> lOffsets(n+1, 0), uOffsets(n+1, 0), lCols, uCols;
+	std::vector<ValueType> lVals, uVals;
+	for (int i=0; i<n; i++)
+	{
+		for (IndexType p=A.rowOffsets[i]; p<A.rowOffsets[i+1]; p++)
+		{
+			if (A.cols[p] < i)
+			{
+				lCols.push_back(A.cols[p]);
+				lVals.push_back(A.vals[p]);
+			}
+			else if (A.cols[p] > i)
+			{
+				uCols.push_back(A.cols[p]);
+				uVals.push_back(A.vals[p]);
+			}
+		}
+		lOffsets[i+1] = lCols.size();
+		uOffsets[i+1] = uCols.size();
+	}
+	L.build(n, lOffsets, lCols, lVals, diagL, true);
+	U.build(n, uOffsets, uCols, uVals, diagU, false);
+}
+
+} // end namespace preconditioners
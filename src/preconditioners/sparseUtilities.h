@@ -0,0 +1,165 @@
+/***************************************************************************//**
+ * \file sparseUtilities.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief host helpers shared by the preconditioners: a row sorted CSR copy of a matrix
+ *        and the level schedule used to run sparse triangular solves in parallel
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cusp/coo_matrix.h>
+#include <cusp/array1d.h>
+#include <thrust/for_each.h>
+
+namespace preconditioners
+{
+
+/**
+ * \brief CSR matrix on the host with the columns of each row sorted and duplicates summed
+ */
+template <typename IndexType, typename ValueType>
+struct hostCSR
+{
+	int n;
+	std::vector<IndexType> rowOffsets,
+	                       cols,
+	                       diag;		///< position of the diagonal entry in each row, -1 if there is none
+	std::vector<ValueType> vals;
+
+	template <typename MatrixType>
+	hostCSR(const MatrixType &A)
+	{
+		cusp::coo_matrix<IndexType, ValueType, cusp::host_memory> A_h(A);
+		n = A_h.num_rows;
+
+		std::vector< std::pair<IndexType, ValueType> > entries;
+		std::vector<IndexType> count(n+1, 0), order(A_h.num_entries);
+		for (size_t p=0; p<A_h.num_entries; p++)
+			count[A_h.row_indices[p]+1]++;
+		for (int i=0; i<n; i++)
+			count[i+1] += count[i];
+		std::vector<IndexType> next(count.begin(), count.end()-1);
+		for (size_t p=0; p<A_h.num_entries; p++)
+			order[next[A_h.row_indices[p]]++] = p;
+
+		rowOffsets.assign(n+1, 0);
+		diag.assign(n, -1);
+		for (int i=0; i<n; i++)
+		{
+			entries.clear();
+			for (IndexType q=count[i]; q<count[i+1]; q++)
+				entries.push_back(std::make_pair((IndexType)A_h.column_indices[order[q]], (ValueType)A_h.values[order[q]]));
+			std::sort(entries.begin(), entries.end());
+			for (size_t q=0; q<entries.size(); q++)
+			{
+				if (q > 0 && entries[q].first == cols.back())
+				{
+					vals.back() += entries[q].second;
+					continue;
+				}
+				if (entries[q].first == i)
+					diag[i] = cols.size();
+				cols.push_back(entries[q].first);
+				vals.push_back(entries[q].second);
+			}
+			rowOffsets[i+1] = cols.size();
+		}
+	}
+};
+
+/**
+ * \brief one row of a level scheduled triangular solve: y_i = (y_i - sum_j T_ij y_j)/d_i
+ */
+template <typename IndexType, typename ValueType>
+struct triangularSweepRow
+{
+	const IndexType *rowOffsets, *cols;
+	const ValueType *vals, *diag;
+	ValueType *y;
+
+	triangularSweepRow(const IndexType *_rowOffsets, const IndexType *_cols, const ValueType *_vals, const ValueType *_diag, ValueType *_y)
+		: rowOffsets(_rowOffsets), cols(_cols), vals(_vals), diag(_diag), y(_y) {}
+
+	__host__ __device__
+	void operator()(IndexType i) const
+	{
+		ValueType s = y[i];
+		for (IndexType p=rowOffsets[i]; p<rowOffsets[i+1]; p++)
+			s -= vals[p]*y[cols[p]];
+		y[i] = s/diag[i];
+	}
+};
+
+/**
+ * \brief a strictly triangular CSR matrix plus diagonal, with the rows grouped into levels
+ *
+ * Rows in the same level only depend on rows of earlier levels so each level is solved in one parallel pass.
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+class triangularFactor
+{
+	cusp::array1d<IndexType, MemorySpace> rowOffsets, cols, levelRows;
+	cusp::array1d<ValueType, MemorySpace> vals, diag;
+	std::vector<IndexType> levelPtr;
+
+public:
+	/*
+	 * Copies the factor to MemorySpace and computes its level schedule
+	 * param n number of rows
+	 * param T_rowOffsets, T_cols, T_vals strictly lower or strictly upper triangular part in CSR
+	 * param T_diag diagonal of the factor
+	 * param lower true if the factor is lower triangular
+	 */
+	void build(int n, const std::vector<IndexType> &T_rowOffsets, const std::vector<IndexType> &T_cols,
+	           const std::vector<ValueType> &T_vals, const std::vector<ValueType> &T_diag, bool lower)
+	{
+		std::vector<IndexType> level(n, 0);
+		int numLevels = 0;
+		for (int k=0; k<n; k++)
+		{
+			int i = lower ? k : n-1-k;
+			for (IndexType p=T_rowOffsets[i]; p<T_rowOffsets[i+1]; p++)
+				level[i] = std::max(level[i], level[T_cols[p]]+1);
+			numLevels = std::max(numLevels, (int)level[i]+1);
+		}
+		levelPtr.assign(numLevels+1, 0);
+		for (int i=0; i<n; i++)
+			levelPtr[level[i]+1]++;
+		for (int l=0; l<numLevels; l++)
+			levelPtr[l+1] += levelPtr[l];
+		std::vector<IndexType> next(levelPtr.begin(), levelPtr.end()-1), rows(n);
+		for (int i=0; i<n; i++)
+			rows[next[level[i]]++] = i;
+
+		rowOffsets = cusp::array1d<IndexType, cusp::host_memory>(T_rowOffsets.begin(), T_rowOffsets.end());
+		cols       = cusp::array1d<IndexType, cusp::host_memory>(T_cols.begin(), T_cols.end());
+		vals       = cusp::array1d<ValueType, cusp::host_memory>(T_vals.begin(), T_vals.end());
+		diag       = cusp::array1d<ValueType, cusp::host_memory>(T_diag.begin(), T_diag.end());
+		levelRows  = cusp::array1d<IndexType, cusp::host_memory>(rows.begin(), rows.end());
+	}
+
+	/*
+	 * Solves T y = y in place, one parallel pass per level
+	 */
+	template <typename VectorType>
+	void sweep(VectorType &y) const
+	{
+		const IndexType *ro_r = thrust::raw_pointer_cast( &(rowOffsets[0]) ),
+		                *c_r  = cols.size() ? thrust::raw_pointer_cast( &(cols[0]) ) : 0;
+		const ValueType *v_r  = vals.size() ? thrust::raw_pointer_cast( &(vals[0]) ) : 0,
+		                *d_r  = thrust::raw_pointer_cast( &(diag[0]) );
+		ValueType       *y_r  = thrust::raw_pointer_cast( &(y[0]) );
+		triangularSweepRow<IndexType, ValueType> row(ro_r, c_r, v_r, d_r, y_r);
+		for (size_t l=0; l+1<levelPtr.size(); l++)
+			thrust::for_each(levelRows.begin()+levelPtr[l], levelRows.begin()+levelPtr[l+1], row);
+	}
+
+	int numLevels() const
+	{
+		return levelPtr.size()-1;
+	}
+};
+
+} // end namespace preconditioners
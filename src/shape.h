@@ -0,0 +1,438 @@
+/***************************************************************************//**
+ * \file shape.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief analytic description of a body surface, answers inside, closest point, normal and ray crossing queries without the boundary points
+ *
+ * Circles and ellipses are solved in closed form.
+ * The NACA 00xx section uses the thickness distribution of scripts/python/naca00xx.py written in terms of s = sqrt(x/c),
+ * which removes the square root singularity at the leading edge, and a fixed number of bisection or golden section
+ * iterations where no closed form exists, so every query still costs the same for every node.
+ * A single body read from a points file is described by a DISTANCE_FIELD, a narrow band signed distance and nearest segment
+ * lattice built once in the body frame, the body is moved by moving the frame so the lattice is never rebuilt.
+ * Its closest points are projections onto the boundary segments, so they lie on the polygon.
+ * Bodies that are neither fall back to ray casting on the boundary points.
+ */
+
+#pragma once
+
+#include <cmath>
+
+namespace shapeType
+{
+enum
+{
+	POLYGON	= 0,	///< no analytic description, use the boundary points
+	CIRCLE	= 1,	///< a = radius
+	ELLIPSE	= 2,	///< a, b = semi-axes along the rotated x and y directions
+	NACA00XX= 3,	///< a = chord, b = maximum thickness as a fraction of the chord, centred on mid chord
+	DISTANCE_FIELD = 4	///< sampled signed distance, a = half width of the band, the centre and angle are the body frame
+};
+}
+
+/**
+ * \struct shape
+ * \brief Plain data so it can be passed to a kernel by value.
+ */
+struct shape
+{
+	int		type;	///< one of shapeType
+	double	cx,		///< x-coordinate of the centre
+			cy,		///< y-coordinate of the centre
+			a,		///< radius, first semi-axis or chord
+			b,		///< second semi-axis or thickness
+			angle;	///< counterclockwise rotation of the shape in radians
+
+	const double *field;	///< DISTANCE_FIELD only: distance and nearest segment at each lattice node, row major, then the boundary points
+	int		fieldNx,		///< lattice nodes in the body x direction
+			fieldNy,		///< lattice nodes in the body y direction
+			fieldPoints;	///< boundary points stored as x, y pairs in the body frame after the lattice, segment k joins point k-1 to k
+	double	fieldX0,		///< body frame coordinates of lattice node (0,0)
+			fieldY0,
+			fieldH;			///< lattice spacing
+};
+
+namespace geometry
+{
+/*
+ * global to body coordinates, the body x axis is rotated by S.angle
+ */
+__host__ __device__ inline
+void toLocal(const shape &S, double x, double y, double &xl, double &yl)
+{
+	double	c = cos(S.angle),
+			s = sin(S.angle),
+			dx = x - S.cx,
+			dy = y - S.cy;
+	xl =  c*dx + s*dy;
+	yl = -s*dx + c*dy;
+}
+
+__host__ __device__ inline
+void toGlobal(const shape &S, double xl, double yl, double &x, double &y)
+{
+	double	c = cos(S.angle),
+			s = sin(S.angle);
+	x = S.cx + c*xl - s*yl;
+	y = S.cy + s*xl + c*yl;
+}
+
+/*
+ * NACA 00xx surface point as a function of s = sqrt(x/c), the section is centred so x runs from -c/2 to c/2
+ */
+__host__ __device__ inline
+double nacaX(const shape &S, double s)
+{
+	return S.a*(s*s - 0.5);
+}
+
+__host__ __device__ inline
+double nacaY(const shape &S, double s)
+{
+	double s2 = s*s;
+	return 5*S.b*S.a*(0.2969*s - 0.1260*s2 - 0.3516*s2*s2 + 0.2843*s2*s2*s2 - 0.1036*s2*s2*s2*s2);
+}
+
+/*
+ * d(nacaX)/ds and d(nacaY)/ds, finite at the leading edge
+ */
+__host__ __device__ inline
+void nacaTangent(const shape &S, double s, double &tx, double &ty)
+{
+	double s2 = s*s;
+	tx = 2*S.a*s;
+	ty = 5*S.b*S.a*(0.2969 - 0.2520*s - 1.4064*s2*s + 1.7058*s2*s2*s - 0.8288*s2*s2*s2*s);
+}
+
+/*
+ * bilinear interpolation of the signed distance stored in the distance field at the body frame point (xl,yl)
+ * points off the lattice are outside the band and far from the body
+ */
+__host__ __device__ inline
+double fieldValue(const shape &S, double xl, double yl)
+{
+	double	fi = (xl - S.fieldX0)/S.fieldH,
+			fj = (yl - S.fieldY0)/S.fieldH;
+	if (fi < 0 || fj < 0 || fi >= S.fieldNx-1 || fj >= S.fieldNy-1)
+		return S.a;
+	int		i = int(fi),
+			j = int(fj),
+			k = 2*(j*S.fieldNx + i),
+			row = 2*S.fieldNx;
+	double	wx = fi - i,
+			wy = fj - j;
+	return (1-wy)*((1-wx)*S.field[k] + wx*S.field[k+2]) + wy*((1-wx)*S.field[k+row] + wx*S.field[k+row+2]);
+}
+
+/*
+ * closest point (bxl,byl) to the body frame point (xl,yl) on the nearest segments of the four lattice nodes around it
+ * interpolating the closest points of the nodes would cut the corners of the polygon, projecting keeps the point on a segment
+ * the lattice nodes outside the band have no segment, a point with none around it is left where it is
+ */
+__host__ __device__ inline
+void fieldClosestPoint(const shape &S, double xl, double yl, double &bxl, double &byl)
+{
+	const double *P = S.field + 2*S.fieldNx*S.fieldNy;
+	int	i = int(fmin(fmax((xl - S.fieldX0)/S.fieldH, 0.0), S.fieldNx-2.0)),
+		j = int(fmin(fmax((yl - S.fieldY0)/S.fieldH, 0.0), S.fieldNy-2.0));
+	double bestD = 1e300;
+	bxl = xl;
+	byl = yl;
+	for (int n = 0; n < 4; n++)
+	{
+		int k = int(S.field[2*((j + n/2)*S.fieldNx + i + n%2) + 1]);
+		if (k < 0)
+			continue;
+		int l = (k + S.fieldPoints - 1) % S.fieldPoints;
+		double	dx = P[2*k] - P[2*l],
+				dy = P[2*k+1] - P[2*l+1],
+				len2 = dx*dx + dy*dy,
+				s = len2 > 0 ? ((xl-P[2*l])*dx + (yl-P[2*l+1])*dy)/len2 : 0;
+		s = fmin(fmax(s, 0.0), 1.0);
+		double	cx = P[2*l] + s*dx,
+				cy = P[2*l+1] + s*dy,
+				d = (xl-cx)*(xl-cx) + (yl-cy)*(yl-cy);
+		if (d < bestD)
+		{
+			bestD = d;
+			bxl = cx;
+			byl = cy;
+		}
+	}
+}
+
+/*
+ * signed distance of the point (x,y) to the surface, negative inside, only valid for DISTANCE_FIELD shapes
+ */
+__host__ __device__ inline
+double signedDistance(const shape &S, double x, double y)
+{
+	double xl, yl;
+	toLocal(S, x, y, xl, yl);
+	return fieldValue(S, xl, yl);
+}
+
+/*
+ * true if the point (x,y) is strictly inside the shape
+ */
+__host__ __device__ inline
+bool isInside(const shape &S, double x, double y)
+{
+	double xl, yl;
+	toLocal(S, x, y, xl, yl);
+	if (S.type == shapeType::CIRCLE)
+		return xl*xl + yl*yl < S.a*S.a;
+	if (S.type == shapeType::ELLIPSE)
+		return xl*xl/(S.a*S.a) + yl*yl/(S.b*S.b) < 1;
+	if (S.type == shapeType::NACA00XX)
+	{
+		double xc = xl/S.a + 0.5;
+		if (xc <= 0 || xc >= 1)
+			return false;
+		return fabs(yl) < nacaY(S, sqrt(xc));
+	}
+	if (S.type == shapeType::DISTANCE_FIELD)
+		return fieldValue(S, xl, yl) < 0;
+	return false;
+}
+
+/*
+ * outward unit normal of the surface at the surface point (bx,by)
+ */
+__host__ __device__ inline
+void normal(const shape &S, double bx, double by, double &nx, double &ny)
+{
+	double xl, yl, nxl, nyl;
+	toLocal(S, bx, by, xl, yl);
+	if (S.type == shapeType::NACA00XX)
+	{
+		double s = sqrt(fmin(fmax(xl/S.a + 0.5, 0.0), 1.0)),
+			   tx, ty;
+		nacaTangent(S, s, tx, ty);
+		nxl = -ty;
+		nyl = yl >= 0 ? tx : -tx;
+	}
+	else if (S.type == shapeType::DISTANCE_FIELD)
+	{
+		double d = 0.5*S.fieldH;
+		nxl = fieldValue(S, xl+d, yl) - fieldValue(S, xl-d, yl);
+		nyl = fieldValue(S, xl, yl+d) - fieldValue(S, xl, yl-d);
+	}
+	else
+	{
+		double b = S.type == shapeType::ELLIPSE ? S.b : S.a;
+		nxl = xl/(S.a*S.a);
+		nyl = yl/(b*b);
+	}
+	double len = sqrt(nxl*nxl + nyl*nyl);
+	double c = cos(S.angle),
+		   s = sin(S.angle);
+	nx = (c*nxl - s*nyl)/len;
+	ny = (s*nxl + c*nyl)/len;
+}
+
+/*
+ * closest point (bx,by) on the surface to (x,y)
+ * the ellipse uses a fixed number of newton iterations on the polar angle, the NACA section a coarse sweep
+ * followed by golden section refinement on the surface of the same side as the point,
+ * the distance field projects onto the nearest segments of the lattice nodes around the point
+ */
+__host__ __device__ inline
+void closestPoint(const shape &S, double x, double y, double &bx, double &by)
+{
+	double xl, yl, bxl, byl;
+	toLocal(S, x, y, xl, yl);
+	if (S.type == shapeType::CIRCLE)
+	{
+		double r = sqrt(xl*xl + yl*yl);
+		if (r == 0)
+		{
+			bxl = S.a;
+			byl = 0;
+		}
+		else
+		{
+			bxl = S.a*xl/r;
+			byl = S.a*yl/r;
+		}
+	}
+	else if (S.type == shapeType::ELLIPSE)
+	{
+		//minimise the distance to (a cos t, b sin t)
+		double t = atan2(S.a*yl, S.b*xl);
+		for (int it = 0; it < 8; it++)
+		{
+			double	ct = cos(t),
+					st = sin(t),
+					f  = (S.a*S.a - S.b*S.b)*st*ct - xl*S.a*st + yl*S.b*ct,
+					df = (S.a*S.a - S.b*S.b)*(ct*ct - st*st) - xl*S.a*ct - yl*S.b*st;
+			if (df == 0)
+				break;
+			t -= f/df;
+		}
+		bxl = S.a*cos(t);
+		byl = S.b*sin(t);
+	}
+	else if (S.type == shapeType::DISTANCE_FIELD)
+	{
+		fieldClosestPoint(S, xl, yl, bxl, byl);
+	}
+	else
+	{
+		double	side = yl >= 0 ? 1 : -1,
+				best = 0,
+				bestD = 1e300;
+		const int samples = 32;
+		for (int k = 0; k <= samples; k++)
+		{
+			double	s  = double(k)/samples,
+					dx = nacaX(S, s) - xl,
+					dy = side*nacaY(S, s) - yl,
+					d  = dx*dx + dy*dy;
+			if (d < bestD)
+			{
+				bestD = d;
+				best = s;
+			}
+		}
+		double	lo = fmax(best - 1.0/samples, 0.0),
+				hi = fmin(best + 1.0/samples, 1.0),
+				g  = 0.5*(sqrt(5.0) - 1);
+		for (int it = 0; it < 40; it++)
+		{
+			double	s1 = hi - g*(hi-lo),
+					s2 = lo + g*(hi-lo),
+					d1 = (nacaX(S,s1)-xl)*(nacaX(S,s1)-xl) + (side*nacaY(S,s1)-yl)*(side*nacaY(S,s1)-yl),
+					d2 = (nacaX(S,s2)-xl)*(nacaX(S,s2)-xl) + (side*nacaY(S,s2)-yl)*(side*nacaY(S,s2)-yl);
+			if (d1 < d2)
+				hi = s2;
+			else
+				lo = s1;
+		}
+		double s = 0.5*(lo+hi);
+		bxl = nacaX(S, s);
+		byl = side*nacaY(S, s);
+	}
+	toGlobal(S, bxl, byl, bx, by);
+}
+
+/*
+ * crossings of the line (x0,y0) + t*(ux,uy) with the surface, the shapes are convex so there are at most two
+ * returns false if the line misses the shape, otherwise t0 < t1 are the parameters where it enters and leaves
+ * param range the NACA section is searched for t in [-range, range], should cover the shape
+ */
+__host__ __device__ inline
+bool crossings(const shape &S, double x0, double y0, double ux, double uy, double range, double &t0, double &t1)
+{
+	double px, py, dx, dy;
+	toLocal(S, x0, y0, px, py);
+	double	c = cos(S.angle),
+			s = sin(S.angle);
+	dx =  c*ux + s*uy;
+	dy = -s*ux + c*uy;
+	if (S.type == shapeType::CIRCLE || S.type == shapeType::ELLIPSE)
+	{
+		double	ia = 1/(S.a*S.a),
+				ib = S.type == shapeType::ELLIPSE ? 1/(S.b*S.b) : ia,
+				A = dx*dx*ia + dy*dy*ib,
+				B = 2*(px*dx*ia + py*dy*ib),
+				C = px*px*ia + py*py*ib - 1,
+				disc = B*B - 4*A*C;
+		if (disc <= 0)
+			return false;
+		disc = sqrt(disc);
+		t0 = (-B - disc)/(2*A);
+		t1 = (-B + disc)/(2*A);
+		return true;
+	}
+	if (S.type == shapeType::NACA00XX)
+	{
+		//find a point of the line inside the section, then bisect towards both ends
+		//every point of the chord is inside so try where the line crosses it before sampling the line
+		const int samples = 64;
+		double tIn = 0;
+		bool found = false;
+		if (fabs(dy) > 1e-12)
+		{
+			tIn = -py/dy;
+			found = fabs(px + tIn*dx) < 0.5*S.a && fabs(tIn) < range;
+		}
+		for (int k = 0; k <= samples && !found; k++)
+		{
+			double t = -range + 2*range*k/samples;
+			if (isInside(S, x0 + t*ux, y0 + t*uy))
+			{
+				tIn = t;
+				found = true;
+			}
+		}
+		if (!found)
+			return false;
+		double lo = -range, hi = tIn;
+		for (int it = 0; it < 50; it++)
+		{
+			double mid = 0.5*(lo+hi);
+			if (isInside(S, x0 + mid*ux, y0 + mid*uy))
+				hi = mid;
+			else
+				lo = mid;
+		}
+		t0 = 0.5*(lo+hi);
+		lo = tIn; hi = range;
+		for (int it = 0; it < 50; it++)
+		{
+			double mid = 0.5*(lo+hi);
+			if (isInside(S, x0 + mid*ux, y0 + mid*uy))
+				lo = mid;
+			else
+				hi = mid;
+		}
+		t1 = 0.5*(lo+hi);
+		return true;
+	}
+	return false;
+}
+
+/*
+ * first crossing of the surface by the ray (x0,y0) + t*(ux,uy) with 0 <= t < tmax, (ux,uy) is a unit vector
+ * the analytic shapes use crossings, the distance field bisects between the ends of the ray if their signs differ,
+ * tmax should be short compared to the body, one grid cell, so the ray can only cross the surface once
+ * returns false if the surface is not crossed
+ */
+__host__ __device__ inline
+bool firstCrossing(const shape &S, double x0, double y0, double ux, double uy, double tmax, double range, double &t)
+{
+	if (S.type == shapeType::DISTANCE_FIELD)
+	{
+		double	f0 = signedDistance(S, x0, y0),
+				f1 = signedDistance(S, x0 + tmax*ux, y0 + tmax*uy);
+		if (f0 == 0)
+		{
+			t = 0;
+			return true;
+		}
+		if ((f0 < 0) == (f1 < 0))
+			return false;
+		double lo = 0, hi = tmax;
+		for (int it = 0; it < 30; it++)
+		{
+			double mid = 0.5*(lo+hi);
+			if ((signedDistance(S, x0 + mid*ux, y0 + mid*uy) < 0) == (f0 < 0))
+				lo = mid;
+			else
+				hi = mid;
+		}
+		t = 0.5*(lo+hi);
+		return true;
+	}
+	double t0, t1;
+	if (!crossings(S, x0, y0, ux, uy, range, t0, t1))
+		return false;
+	if (t0 >= 0 && t0 < tmax)
+		t = t0;
+	else if (t1 >= 0 && t1 < tmax)
+		t = t1;
+	else
+		return false;
+	return true;
+}
+}
@@ -27,9 +27,8 @@ void fadlunModified::generateRHS2()
 			*distance_from_u_to_body_r = thrust::raw_pointer_cast( &(distance_from_u_to_body[0]) ),
 			*distance_from_v_to_body_r = thrust::raw_pointer_cast( &(distance_from_v_to_body[0]) );
 
-	int		*tagsP_r= thrust::raw_pointer_cast( &(tagsP[0]) ),
-			*tagsIn_r=thrust::raw_pointer_cast( &(tagsIn[0]) ),
-			*tagsPO_r=thrust::raw_pointer_cast( &(tagsPOut[0]) );
+	unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast( &(cellTypeP[0]) ),
+					*cellTypeUV_r	= thrust::raw_pointer_cast( &(cellTypeUV[0]) );
 	const int blocksize = 256;
 	
 	parameterDB  &db = *NavierStokesSolver::paramDB;
@@ -37,7 +36,7 @@ void fadlunModified::generateRHS2()
 
 	dim3 grid( int( (nx*ny-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
-	kernels::intermediatePressure<<<grid,block>>>(rhs2_r, uhat_r, tagsP_r, tagsPO_r, tagsIn_r, distance_from_u_to_body_r, distance_from_v_to_body_r, ym_r, yp_r, xm_r, xp_r, dx_r, dy_r, nx, ny);
+	kernels::intermediatePressure<<<grid,block>>>(rhs2_r, uhat_r, cellTypeP_r, cellTypeUV_r, distance_from_u_to_body_r, distance_from_v_to_body_r, ym_r, yp_r, xm_r, xp_r, dx_r, dy_r, nx, ny);
 	NavierStokesSolver::pressure_old = NavierStokesSolver::pressure;
 	NavierStokesSolver::logger.stopTimer("RHS2");
 }
@@ -57,15 +56,15 @@ void fadlunModified::generateLHS2()
 			*dyv_r	= thrust::raw_pointer_cast( &(distance_from_v_to_body[0]) );
 
 	int		*row_r	= thrust::raw_pointer_cast( &(NavierStokesSolver::LHS2.row_indices[0]) ),
-			*col_r	= thrust::raw_pointer_cast( &(NavierStokesSolver::LHS2.column_indices[0]) ),
-			*tagsP_r= thrust::raw_pointer_cast( &(tagsP[0]) ),
-			*tagsPo_r= thrust::raw_pointer_cast( &(tagsPOut[0]) );
+			*col_r	= thrust::raw_pointer_cast( &(NavierStokesSolver::LHS2.column_indices[0]) );
+	unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast( &(cellTypeP[0]) );
 
 	const int blocksize = 256;
 	dim3 grid( int( (nx*ny-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
 	cusp::blas::fill(LHS2.values,0);
-	kernels::LHS2_mid<<<grid,block>>>(row_r, col_r, val_r, dxu_r, dyv_r, tagsP_r, tagsPo_r, dx_r, dy_r, nx, ny, dt);
+	kernels::LHS2_mid<<<grid,block>>>(row_r, col_r, val_r, dxu_r, dyv_r, cellTypeP_r, dx_r, dy_r, nx, ny, dt);
 	kernels::LHS2_BC<<<grid,block>>>(row_r, col_r, val_r, dx_r, dy_r, nx,ny,dt);
+	NavierStokesSolver::DS.invalidate();
 	logger.stopTimer("LHS2");
 }
@@ -27,8 +27,8 @@ void fadlunModified::generateRHS1()
 			*distance_between_nodes_at_IB_r	= thrust::raw_pointer_cast( &(distance_between_nodes_at_IB[0]) ),
 			*uv_r	= thrust::raw_pointer_cast( &(uv[0]) );
 	
-	int	*tags_r	= thrust::raw_pointer_cast( &(tags[0]) ),
-		*tagsIn_r=thrust::raw_pointer_cast( &(tagsIn[0]) );
+	int	*tags_r	= thrust::raw_pointer_cast( &(tags[0]) );
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast( &(cellTypeUV[0]) );
 	
 	parameterDB  &db = *NavierStokesSolver::paramDB;
 	double	nu = db["flow"]["nu"].get<double>();
@@ -55,10 +55,10 @@ void fadlunModified::generateRHS1()
 
 	NavierStokesSolver::generateBC1();
 
-	kernels::generateRHS<<<dimGridUV,dimBlockUV>>>(rhs_r, L_r, Nold_r, N_r, u_r, bc1_r, dt, nx, ny);
+	kernels::generateRHS<<<dimGridUV,dimBlockUV>>>(rhs_r, L_r, Nold_r, N_r, u_r, bc1_r, dt, dtRatio, nx, ny);
 
-	kernels::updateRHS1forIBX<<<dimGridU,dimBlockU>>>(tags_r, tagsIn_r, rhs_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, uv_r, nx, ny);
-	kernels::updateRHS1forIBY<<<dimGridV,dimBlockV>>>(tags_r, tagsIn_r, rhs_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, uv_r, nx, ny);
+	kernels::updateRHS1forIBX<<<dimGridU,dimBlockU>>>(tags_r, cellTypeUV_r, rhs_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, uv_r, nx, ny);
+	kernels::updateRHS1forIBY<<<dimGridV,dimBlockV>>>(tags_r, cellTypeUV_r, rhs_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, uv_r, nx, ny);
 }
 
 void fadlunModified::updateRobinBoundary()
@@ -96,8 +96,8 @@ void fadlunModified::generateLHS1()
 	int 	*row_r	= thrust::raw_pointer_cast( &(LHS1.row_indices[0])),
 			*col_r	= thrust::raw_pointer_cast( &(LHS1.column_indices[0])),
 			*tags_r	= thrust::raw_pointer_cast( &(tags[0]) ),
-			*tags2_r= thrust::raw_pointer_cast( &(tags2[0]) ),
-			*tagsIn_r= thrust::raw_pointer_cast( &(tagsIn[0]) );
+			*tags2_r= thrust::raw_pointer_cast( &(tags2[0]) );
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast( &(cellTypeUV[0]) );
 
 	double	nu = (*paramDB)["flow"]["nu"].get<double>();
 	double	dt = (*paramDB)["simulation"]["dt"].get<double>();
@@ -110,8 +110,8 @@ void fadlunModified::generateLHS1()
 	dim3 gridV( int( (nx*(ny-1)-0.5)/blocksize ) +1, 1);
 	dim3 blockV(blocksize, 1);
 
-	kernels::LHS_mid_X<<<gridU,blockU>>>(row_r, col_r, val_r, tags_r, tags2_r, tagsIn_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, dx_r, dy_r, dt, nu, nx, ny);
-	kernels::LHS_mid_Y<<<gridV,blockV>>>(row_r, col_r, val_r, tags_r, tags2_r, tagsIn_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, dx_r, dy_r, dt, nu, nx, ny);
+	kernels::LHS_mid_X<<<gridU,blockU>>>(row_r, col_r, val_r, tags_r, tags2_r, cellTypeUV_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, dx_r, dy_r, dt, nu, nx, ny);
+	kernels::LHS_mid_Y<<<gridV,blockV>>>(row_r, col_r, val_r, tags_r, tags2_r, cellTypeUV_r, distance_from_intersection_to_node_r, distance_between_nodes_at_IB_r, dx_r, dy_r, dt, nu, nx, ny);
 
 	kernels::LHS_BC_X<<<gridU,blockU>>>(row_r, col_r, val_r, dx_r, dy_r, dt, nu, nx, ny);
 	kernels::LHS_BC_Y<<<gridV,blockV>>>(row_r, col_r, val_r, dx_r, dy_r, dt, nu, nx, ny);
@@ -5,11 +5,12 @@
  */
 
 #include "LHS1.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 
 namespace kernels
 {
 __global__
-void LHS_mid_X(int *row, int *col, double *val, int *tags, int *tags2, int *tagsIn, double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *dx, double *dy, double dt, double nu, int nx, int ny)
+void LHS_mid_X(int *row, int *col, double *val, int *tags, int *tags2, unsigned char *cellTypeUV, double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *dx, double *dy, double dt, double nu, int nx, int ny)
 {
 	if (threadIdx.x + blockDim.x * blockIdx.x >= (nx-1)*ny)
 		return;
@@ -24,7 +25,7 @@ void LHS_mid_X(int *row, int *col, double *val, int *tags, int *tags2, int *tags
 	int numE = (nx-1)*4 - 2      + (J-1)*(5*(nx-1)  - 2) + I*5 - 1;
 
 	double temp = 1;
-	if( (tags[i] == -1  && tagsIn[i] == -1) || tagsIn[i] == 0)// if point isn't tagged
+	if( (tags[i] == -1 && cellType::isFluid(cellTypeUV[i])) || cellType::isSolid(cellTypeUV[i]))// if point isn't tagged
 	{
 		//EAST
 		row[numE] = i;
@@ -154,7 +155,7 @@ void LHS_mid_X(int *row, int *col, double *val, int *tags, int *tags2, int *tags
 		numE++;
 	}
 	//end tagged
-	else if (tagsIn[i] > 0) //inner point is tagged Note:: dx and dy must be uniform in a section with a body...
+	else if (cellType::isGhost(cellTypeUV[i])) //inner point is tagged Note:: dx and dy must be uniform in a section with a body...
 	{
 		//ADJACENT POINT
 		if (tags[i+1] != -1)// go right to body
@@ -249,7 +250,7 @@ void LHS_mid_X(int *row, int *col, double *val, int *tags, int *tags2, int *tags
 }
 
 __global__
-void LHS_mid_Y(int *row, int *col, double *val, int *tags, int *tags2, int *tagsIn, double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *dx, double *dy, double dt, double nu, int nx, int ny)
+void LHS_mid_Y(int *row, int *col, double *val, int *tags, int *tags2, unsigned char *cellTypeUV, double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *dx, double *dy, double dt, double nu, int nx, int ny)
 {
 	if (threadIdx.x + blockDim.x * blockIdx.x >= nx*(ny-1))
 		return;
@@ -263,7 +264,7 @@ void LHS_mid_Y(int *row, int *col, double *val, int *tags, int *tags2, int *tags
 	int numE = (nx-1)*ny*5 - 2*ny-2*(nx-1)  +  nx*4-2  + (J-1)*(nx*5 - 2) + I*5 - 1;
 	double temp = 1;
 
-	if((tags[i] == -1 && tagsIn[i] == -1)||tagsIn[i] == 0)	//if not tagged
+	if((tags[i] == -1 && cellType::isFluid(cellTypeUV[i])) || cellType::isSolid(cellTypeUV[i]))	//if not tagged
 	{
 		//EAST
 		row[numE] = i;
@@ -388,7 +389,7 @@ void LHS_mid_Y(int *row, int *col, double *val, int *tags, int *tags2, int *tags
 		numE++;
 	}//end tagged
 
-	else if (tagsIn[i] != -1) //inner point is tagged Note:: dx and dy must be uniform in a section with a body...
+	else if (cellType::isGhost(cellTypeUV[i])) //inner point is tagged Note:: dx and dy must be uniform in a section with a body...
 	{
 		//setup adjacent point
 		if (tags[i+1] != -1)// go right to body
@@ -5,11 +5,12 @@
  */
 
 #include "LHS2.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 
 namespace kernels
 {
 __global__
-void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body, double *distance_from_v_to_body, int  *tagsP, int *tagsPOut, double *dx, double *dy, int nx, int ny, double dt)
+void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body, double *distance_from_v_to_body, unsigned char *cellTypeP, double *dx, double *dy, int nx, int ny, double dt)
 {
 	int ip 	= threadIdx.x + blockDim.x * blockIdx.x;
 	if (ip >= nx*ny)
@@ -23,11 +24,11 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 	int numE = nx*4-2 + (J-1)*(nx*5-2) + I*5-1;
 	double temp = 0;
 	//just outside immersed body
-	if (tagsPOut[ip] != -1)
+	if (cellType::isHybrid(cellTypeP[ip]))
 	{
 		//EAST
 		//check if east is outside body
-		if (tagsP[ip+1] == -1)
+		if (cellType::isFluid(cellTypeP[ip+1]))
 		{
 			row[numE] = ip;
 			col[numE] = ip + 1;
@@ -53,7 +54,7 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 
 		//WEST
 		//check if west pressure node is outside the body
-		if(tagsP[ip-1] == -1)
+		if(cellType::isFluid(cellTypeP[ip-1]))
 		{
 			row[numE] = ip;
 			col[numE] = ip - 1;
@@ -80,7 +81,7 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 
 		//NORTH
 		//check if north pressure node is outside body
-		if (tagsP[ip+nx] == -1)
+		if (cellType::isFluid(cellTypeP[ip+nx]))
 		{
 			row[numE] = ip;
 			col[numE] = ip + nx;
@@ -106,7 +107,7 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 
 		//SOUTH
 		//check if south pressure node is outside body
-		if (tagsP[ip-nx] == -1)
+		if (cellType::isFluid(cellTypeP[ip-nx]))
 		{
 			row[numE] = ip;
 			col[numE] = ip - nx;
@@ -133,10 +134,10 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 	}
 	//end just outside immersed body
 	//if just inside body
-	else if (tagsP[ip] > 0)
+	else if (cellType::isGhost(cellTypeP[ip]))
 	{
 		//EAST
-		if (tagsP[ip+1] == 0)
+		if (cellType::isSolid(cellTypeP[ip+1]))
 		{
 			row[numE] = ip;
 			col[numE] = ip + 1;
@@ -153,7 +154,7 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 		}
 
 		//WEST
-		if (tagsP[ip-1] == 0)
+		if (cellType::isSolid(cellTypeP[ip-1]))
 		{
 			row[numE] = ip;
 			col[numE]= ip - 1;
@@ -170,7 +171,7 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 		}
 
 		//NORTH
-		if (tagsP[ip+nx] == 0)
+		if (cellType::isSolid(cellTypeP[ip+nx]))
 		{
 			row[numE] = ip;
 			col[numE] = ip + nx;
@@ -187,7 +188,7 @@ void LHS2_mid(int *row, int *col, double *val, double *distance_from_u_to_body,
 		}
 
 		//SOUTH
-		if (tagsP[ip-nx] == 0)
+		if (cellType::isSolid(cellTypeP[ip-nx]))
 		{
 			row[numE] = ip;
 			col[numE] = ip - nx;
@@ -14,5 +14,5 @@
 namespace kernels
 {
 __global__
-void intermediatePressure(double *rhs2, double *uhat, int *tagsP, int *tagsPOut, int *tagsIn, double *distance_from_u_to_body, double *distance_from_v_to_body, double *ym, double *yp, double *xm, double *xp, double *dx, double *dy, int nx, int ny);
+void intermediatePressure(double *rhs2, double *uhat, unsigned char *cellTypeP, unsigned char *cellTypeUV, double *distance_from_u_to_body, double *distance_from_v_to_body, double *ym, double *yp, double *xm, double *xp, double *dx, double *dy, int nx, int ny);
 }//end namespace kernels
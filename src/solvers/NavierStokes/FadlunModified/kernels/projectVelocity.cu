@@ -7,11 +7,12 @@
 
 
 #include "projectVelocity.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 
 namespace kernels 
 {
 __global__
-void project_velocity_X(double *u, double *uhat, double *uold, double *pressure, int *tagsP, int *tagsIn, double *dx, double dt, int nx, int ny)
+void project_velocity_X(double *u, double *uhat, double *uold, double *pressure, unsigned char *cellTypeP, unsigned char *cellTypeUV, double *dx, double dt, int nx, int ny)
 {
 	int i	= threadIdx.x + (blockDim.x * blockIdx.x),
 		I	= i % (nx-1),
@@ -24,11 +25,11 @@ void project_velocity_X(double *u, double *uhat, double *uold, double *pressure,
 
 	uold[i] = u[i];
 
-	u[i] = uhat[i] - (tagsP[ip+1] ==-1 && tagsP[ip] == -1) * dt*(pressure[ip+1]-pressure[ip]) / (0.5*dx[I+1]+0.5*dx[I]);
+	u[i] = uhat[i] - (cellType::isFluid(cellTypeP[ip+1]) && cellType::isFluid(cellTypeP[ip])) * dt*(pressure[ip+1]-pressure[ip]) / (0.5*dx[I+1]+0.5*dx[I]);
 }
 
 __global__
-void project_velocity_Y(double *u, double *uhat, double *uold, double *pressure, int *tagsP, int *tagsIn, double *dy, double dt, int nx, int ny)
+void project_velocity_Y(double *u, double *uhat, double *uold, double *pressure, unsigned char *cellTypeP, unsigned char *cellTypeUV, double *dy, double dt, int nx, int ny)
 {
 	int numU= (nx-1)*ny,
 		i	= threadIdx.x + (blockDim.x * blockIdx.x),
@@ -44,7 +45,7 @@ void project_velocity_Y(double *u, double *uhat, double *uold, double *pressure,
 
 	uold[i] = u[i];
 	
-	u[i] = uhat[i] - (tagsP[ip+nx] == -1 && tagsP[ip] == -1) * dt*(pressure[ip+nx]-pressure[ip]) / (0.5*dy[J+1]+0.5*dy[J]);
+	u[i] = uhat[i] - (cellType::isFluid(cellTypeP[ip+nx]) && cellType::isFluid(cellTypeP[ip])) * dt*(pressure[ip+nx]-pressure[ip]) / (0.5*dy[J+1]+0.5*dy[J]);
 }
 
 }//end namespace kernels
@@ -7,11 +7,12 @@
  */
 
 #include "tagPoints.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 
 namespace kernels
 {
 __global__
-void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
+void tag_u(int *tags, unsigned char *cellTypeUV, int *tags2, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
 			   double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
 			   int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY)
 {
@@ -99,7 +100,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 				{
 					outsideX  = true;
 					bdryFlagX = iu;
-					tagsIn[iu] = iu;
+					cellTypeUV[iu] = cellType::GHOST;
 					Xa        = 0.0;
 					Xb        = 1.0;
 					flag      = true; // flag is true when the point of intersection coincides with the grid point
@@ -115,7 +116,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlagX  = iu;
 					bdryFlag2X = iu+1;
 					if (tags[iu-1]==-1)
-						tagsIn[iu-1]	= iu-1;
+						cellTypeUV[iu-1] = cellType::GHOST;
 					Xa = xu[I]-x;
 					Xb = xu[I+1]-xu[I];
 					if (x > midX)
@@ -128,7 +129,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlagX  = iu;
 					bdryFlag2X = iu-1;
 					if(tags[iu+1] == -1)
-						tagsIn[iu+1]	= iu+1;
+						cellTypeUV[iu+1] = cellType::GHOST;
 					Xa = x-xu[I];
 					Xb = xu[I]-xu[I-1];
 					if (x < midX)
@@ -156,7 +157,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					outsideY  = true; // then the point is considered to be outside the grid
 					bdryFlagY = iu;    // the point is considered to be a forcing point, with index iu
 					bdryFlag2Y= iu;
-					tagsIn[iu]=iu;
+					cellTypeUV[iu] = cellType::GHOST;
 					Ya        = 0.0;  // the coefficient for the linear interpolation during forcing
 					Yb        = 1.0;
 					flag      = true; // flag is true when the point of intersection coincides with the grid point
@@ -173,7 +174,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlag2Y= iu+(nx-1);
 					//if (outsideY)
 					if(tags[iu-nx+1]==-1)
-						tagsIn[iu-(nx-1)]=iu-(nx-1);
+						cellTypeUV[iu-(nx-1)] = cellType::GHOST;
 					Ya = yu[J]-y;
 					Yb = yu[J+1]-yu[J];
 				}
@@ -184,7 +185,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlag2Y= iu-(nx-1);
 					//if (outsideY)
 					if (tags[iu+nx-1]==-1)
-						tagsIn[iu+(nx-1)]=iu+(nx-1);
+						cellTypeUV[iu+(nx-1)] = cellType::GHOST;
 					Ya = y-yu[J];
 					Yb = yu[J]-yu[J-1];
 				}
@@ -196,7 +197,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 
 	if (outsideX && bdryFlagX>=0)
 	{
-		tagsIn[iu]	= -1;
+		cellTypeUV[iu] = cellType::HYBRID;
 		tags[iu]	= bdryFlagX;
 		tags2[iu]	= bdryFlag2X;
 		distance_from_intersection_to_node[iu]		= Xa;
@@ -205,7 +206,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 	}
 	else if (outsideY && bdryFlagY>=0)
 	{
-		tagsIn[iu]	= -1;
+		cellTypeUV[iu] = cellType::HYBRID;
 		tags[iu]	= bdryFlagY;
 		tags2[iu]	= bdryFlag2Y;
 		distance_from_intersection_to_node[iu]		= Ya;
@@ -215,7 +216,7 @@ void tag_u(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 }
 
 __global__
-void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
+void tag_v(int *tags, unsigned char *cellTypeUV, int *tags2, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
 		   double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
 		   int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY)
 {
@@ -298,7 +299,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					outsideX   = true;
 					bdryFlagX = iv;
 					bdryFlag2X= iv;
-					tagsIn[iv] = iv;
+					cellTypeUV[iv] = cellType::GHOST;
 					Xa        = 0.0;
 					Xb        = 1.0;
 					flag      = true;
@@ -313,7 +314,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlagX  = iv;
 					bdryFlag2X = iv+1;
 					if (tags[iv-1]==-1)
-						tagsIn[iv-1] = iv-1;
+						cellTypeUV[iv-1] = cellType::GHOST;
 					Xa = xv[I]-x;
 					Xb = xv[I+1]-xv[I];
 				}
@@ -323,7 +324,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlagX  = iv;
 					bdryFlag2X = iv-1;
 					if (tags[iv+1] == -1)
-						tagsIn[iv+1] = iv+1;
+						cellTypeUV[iv+1] = cellType::GHOST;
 					Xa = x-xv[I];
 					Xb = xv[I]-xv[I-1];
 				}
@@ -346,7 +347,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					outsideY   = true;
 					bdryFlagY = iv;
 					bdryFlag2Y= iv;
-					tagsIn[iv] = iv;
+					cellTypeUV[iv] = cellType::GHOST;
 					Ya        = 0.0;
 					Yb        = 1.0;
 					flag      = true;
@@ -360,7 +361,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlagY  = iv;
 					bdryFlag2Y = iv+nx;
 					if (tags[iv-nx] == -1)
-						tagsIn[iv-nx] = iv-nx;
+						cellTypeUV[iv-nx] = cellType::GHOST;
 					Ya = yv[J]-y;
 					Yb = yv[J+1]-yv[J];
 					//case 3
@@ -372,7 +373,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 					bdryFlagY  = iv;
 					bdryFlag2Y = iv-nx;
 					if(tags[iv+nx] == -1)
-						tagsIn[iv+nx] = iv+nx;
+						cellTypeUV[iv+nx] = cellType::GHOST;
 					Ya = y-yv[J];
 					Yb = yv[J]-yv[J-1];
 					//case 4
@@ -386,7 +387,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 	}
 	if (outsideY && bdryFlagY>=0)
 	{
-		tagsIn[iv] = -1;
+		cellTypeUV[iv] = cellType::HYBRID;
 		tags[iv]    = bdryFlagY;
 		tags2[iv]   = bdryFlag2Y;
 		distance_from_intersection_to_node[iv]  = Ya;
@@ -395,7 +396,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 	}
 	else if (outsideX && bdryFlagX>=0)
 	{
-		tagsIn[iv] = -1;
+		cellTypeUV[iv] = cellType::HYBRID;
 		tags[iv]    = bdryFlagX;
 		tags2[iv]   = bdryFlag2X;
 		distance_from_intersection_to_node[iv]  = Xa;
@@ -405,7 +406,7 @@ void tag_v(int *tags, int *tagsIn, int *tags2, double *bx, double *by, double *u
 }
 
 __global__
-void tag_p(int *tagsP, int *tagsPOut, double *bx, double *by, double *yu, double *xv,
+void tag_p(unsigned char *cellTypeP, double *bx, double *by, double *yu, double *xv,
 		   int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY)
 {
 	// calculate indicies indices
@@ -434,7 +435,6 @@ void tag_p(int *tagsP, int *tagsPOut, double *bx, double *by, double *yu, double
 			x,
 			y;
 
-	//tagsP[ip] = 1000;
 	while(l<totalPoints)
 	{
 		if (by[k] > by[l])
@@ -475,23 +475,23 @@ void tag_p(int *tagsP, int *tagsPOut, double *bx, double *by, double *yu, double
 				// just inside, right of mid
 				if (x > midX + eps && x > xv[I] + eps && x < xv[I+1] + eps)
 				{
-					tagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 				}
 				// just inside, left of mid
 				else if (x < midX + eps && x < xv[I] +eps && x > xv[I-1])
 				{
-					tagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 				}
 
 				// just inside, right of mid
 				if (x > midX + eps && x < xv[I] + eps && x > xv[I-1] + eps)
 				{
-					tagsPOut[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 				}
 				// just inside, left of mid
 				else if (x < midX + eps && x > xv[I] +eps && x < xv[I+1] + eps)
 				{
-					tagsPOut[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 				}
 			}
 		}
@@ -512,23 +512,23 @@ void tag_p(int *tagsP, int *tagsPOut, double *bx, double *by, double *yu, double
 				// just inside, north of mid
 				if (y > midY + eps && y > yu[J] +eps && y < yu[J+1])
 				{
-					tagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 				}
 				//just inside, south of mid
 				else if (y < midY + eps && y < yu[J] +eps && y > yu[J-1] +eps)
 				{
-					tagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 				}
 
 				// just inside, north of mid
 				if (y > midY + eps && y < yu[J] +eps && y > yu[J-1])
 				{
-					tagsPOut[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 				}
 				//just inside, south of mid
 				else if (y < midY + eps && y > yu[J] +eps && y < yu[J+1] +eps)
 				{
-					tagsPOut[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 				}
 			}
 		}
@@ -538,7 +538,7 @@ void tag_p(int *tagsP, int *tagsPOut, double *bx, double *by, double *yu, double
 }
 
 __global__
-void zero_pressure(int *tagsP,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
+void zero_pressure(unsigned char *cellTypeP,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
 {
 	// calculate indicies indices
 	int j	= threadIdx.x + blockDim.x * blockIdx.x,
@@ -554,30 +554,30 @@ void zero_pressure(int *tagsP,  int i_start, int j_start, int i_end, int j_end,
 	for (int i=i_start; i<i_end; i++)
 	{
 		I = J*nx+i;
-		if (tagsP[I-1] >= 0)
+		if (cellType::isInside(cellTypeP[I-1]))
 		{
-			if (tagsP[I]!=-1 && tagsP[I-1]==0)
+			if (cellType::isInside(cellTypeP[I]) && cellType::isSolid(cellTypeP[I-1]))
 			{
 				rowIsntDone = false;
 			}
-			if(tagsP[I]==-1 && rowIsntDone)
+			if(!cellType::isInside(cellTypeP[I]) && rowIsntDone)
 			{
-				tagsP[I]=0;
+				cellTypeP[I] |= cellType::SOLID;
 			}
-			if(tagsP[I]==0 && tagsP[I-1] !=0)
+			if(cellType::isSolid(cellTypeP[I]) && !cellType::isSolid(cellTypeP[I-1]))
 			{
 				int k = i;
 				while (k < nx)
 				{
 					k++;
-					if (tagsP[J*nx+k] != -1 )
+					if (cellType::isInside(cellTypeP[J*nx+k]))
 					{
 						flag = true;
 					}
 				}
 				if (!flag)
 				{
-					tagsP[I]=-1;
+					cellTypeP[I] &= ~cellType::SOLID;
 					rowIsntDone = false;
 				}
 			}
@@ -586,7 +586,7 @@ void zero_pressure(int *tagsP,  int i_start, int j_start, int i_end, int j_end,
 }
 
 __global__
-void zero_x(int *tagsIn,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
+void zero_x(unsigned char *cellTypeUV,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
 {
 	// calculate indicies indices
 	int j	= threadIdx.x + blockDim.x * blockIdx.x,
@@ -602,30 +602,30 @@ void zero_x(int *tagsIn,  int i_start, int j_start, int i_end, int j_end, int nx
 	{
 		I = J*(nx-1)+i;
 
-		if (tagsIn[I-1] >= 0)
+		if (cellType::isInside(cellTypeUV[I-1]))
 		{
-			if (tagsIn[I]!=-1 && tagsIn[I-1]==0)
+			if (cellType::isInside(cellTypeUV[I]) && cellType::isSolid(cellTypeUV[I-1]))
 			{
 				rowIsntDone = false;
 			}
-			if(tagsIn[I]==-1 && rowIsntDone)
+			if(!cellType::isInside(cellTypeUV[I]) && rowIsntDone)
 			{
-				tagsIn[I]=0;
+				cellTypeUV[I] |= cellType::SOLID;
 			}
-			if(tagsIn[I]==0 && tagsIn[I-1] !=0)
+			if(cellType::isSolid(cellTypeUV[I]) && !cellType::isSolid(cellTypeUV[I-1]))
 			{
 				int k = i;
 				while (k < nx-1)
 				{
 					k++;
-					if (tagsIn[J*(nx-1)+k] != -1 )
+					if (cellType::isInside(cellTypeUV[J*(nx-1)+k]))
 					{
 						flag = true;
 					}
 				}
 				if (!flag)
 				{
-					tagsIn[I]=-1;
+					cellTypeUV[I] &= ~cellType::SOLID;
 					rowIsntDone = false;
 				}
 			}
@@ -634,7 +634,7 @@ void zero_x(int *tagsIn,  int i_start, int j_start, int i_end, int j_end, int nx
 }
 
 __global__
-void zero_y(int *tagsIn,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
+void zero_y(unsigned char *cellTypeUV,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
 {
 	// calculate indicies indices
 	int j	= threadIdx.x + blockDim.x * blockIdx.x,
@@ -650,30 +650,30 @@ void zero_y(int *tagsIn,  int i_start, int j_start, int i_end, int j_end, int nx
 	for (int i=i_start; i<i_end; i++)
 	{
 		I = J*(nx)+i + (nx-1)*ny;
-		if (tagsIn[I-1] >= 0)
+		if (cellType::isInside(cellTypeUV[I-1]))
 		{
-			if (tagsIn[I]!=-1 && tagsIn[I-1]==0)
+			if (cellType::isInside(cellTypeUV[I]) && cellType::isSolid(cellTypeUV[I-1]))
 			{
 				rowIsntDone = false;
 			}
-			if(tagsIn[I]==-1 && rowIsntDone)
+			if(!cellType::isInside(cellTypeUV[I]) && rowIsntDone)
 			{
-				tagsIn[I]=0;
+				cellTypeUV[I] |= cellType::SOLID;
 			}
-			if(tagsIn[I]==0 && tagsIn[I-1] !=0)
+			if(cellType::isSolid(cellTypeUV[I]) && !cellType::isSolid(cellTypeUV[I-1]))
 			{
 				int k = i;
 				while (k < nx-1)
 				{
 					k++;
-					if (tagsIn[J*(nx)+k + (nx-1)*ny] != -1 )
+					if (cellType::isInside(cellTypeUV[J*(nx)+k + (nx-1)*ny]))
 					{
 						flag = true;
 					}
 				}
 				if (!flag)
 				{
-					tagsIn[I]=-1;
+					cellTypeUV[I] &= ~cellType::SOLID;
 					rowIsntDone = false;
 				}
 			}
@@ -16,8 +16,8 @@ void fadlunModified::velocityProjection()
 			*dx_r	= thrust::raw_pointer_cast( &(NavierStokesSolver::domInfo-> dx[0]) ),
 			*dy_r	= thrust::raw_pointer_cast( &(NavierStokesSolver::domInfo-> dy[0]) );
 	
-	int *tagsP_r = thrust::raw_pointer_cast( &(tagsP[0]) ),
-		*tagsin_r = thrust::raw_pointer_cast( &(tagsIn[0]) );
+	unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast( &(cellTypeP[0]) ),
+					*cellTypeUV_r	= thrust::raw_pointer_cast( &(cellTypeUV[0]) );
 	parameterDB  &db = *NavierStokesSolver::paramDB;
 	double	dt = db["simulation"]["dt"].get<double>();
 
@@ -30,8 +30,8 @@ void fadlunModified::velocityProjection()
 	dim3 dimGridV( int( (nx*(ny-1)-0.5)/blocksize ) +1, 1);
 	dim3 dimBlockV(blocksize, 1);
 
-	kernels::project_velocity_X<<<dimGridU,dimBlockU>>>(u_r, uhat_r, u_old, pressure_r, tagsP_r, tagsin_r, dx_r, dt, nx, ny);
-	kernels::project_velocity_Y<<<dimGridV,dimBlockV>>>(u_r, uhat_r, u_old, pressure_r, tagsP_r, tagsin_r, dy_r, dt, nx, ny);
+	kernels::project_velocity_X<<<dimGridU,dimBlockU>>>(u_r, uhat_r, u_old, pressure_r, cellTypeP_r, cellTypeUV_r, dx_r, dt, nx, ny);
+	kernels::project_velocity_Y<<<dimGridV,dimBlockV>>>(u_r, uhat_r, u_old, pressure_r, cellTypeP_r, cellTypeUV_r, dy_r, dt, nx, ny);
 
 	logger.stopTimer("Velocity Projection");
 }
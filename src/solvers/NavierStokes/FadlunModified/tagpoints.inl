@@ -10,7 +10,9 @@
  *        which the velocity interpolation is performed.
  */
 #include <solvers/NavierStokes/FadlunModified/kernels/tagPoints.h>
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 #include <cusp/print.h>
+#include <thrust/equal.h>
 
 void fadlunModified::tagPoints()
 {
@@ -18,10 +20,10 @@ void fadlunModified::tagPoints()
 	int  nx = NavierStokesSolver::domInfo->nx,
 		 ny = NavierStokesSolver::domInfo->ny,
 		 totalPoints = B.totalPoints,
-		 i_start = B.startI[0],
-		 j_start = B.startJ[0],
-		 width_i = B.numCellsX[0],
-		 height_j = B.numCellsY[0],
+		 i_start = B.hostMeta.startI[0],
+		 j_start = B.hostMeta.startJ[0],
+		 width_i = B.hostMeta.numCellsX[0],
+		 height_j = B.hostMeta.numCellsY[0],
 		 i_end = i_start + width_i,
 		 j_end = j_start + height_j;
 	
@@ -41,20 +43,17 @@ void fadlunModified::tagPoints()
 			*uv_r		= thrust::raw_pointer_cast ( &(uv[0]) );
 	
 	int 	*tags_r		= thrust::raw_pointer_cast ( &(tags[0]) ),
-			*tags2_r	= thrust::raw_pointer_cast ( &(tags2[0]) ),
-			*tagsIn_r	= thrust::raw_pointer_cast ( &(tagsIn[0]) ),
-			*tagsP_r	= thrust::raw_pointer_cast ( &(tagsP[0]) ),
-			*tagsPOut_r	= thrust::raw_pointer_cast ( &(tagsPOut[0]) ),
-			*tagsPOld_r = thrust::raw_pointer_cast ( &(tagsPOld[0]) );
+			*tags2_r	= thrust::raw_pointer_cast ( &(tags2[0]) );
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast ( &(cellTypeUV[0]) ),
+					*cellTypeP_r	= thrust::raw_pointer_cast ( &(cellTypeP[0]) );
 	
 	//testing
-	tagsOld = tags;
-	tagsPOld = tagsPOut;
+	cellTypeUVOld = cellTypeUV;
+	cellTypePOld = cellTypeP;
 	cusp::blas::fill(tags, -1);
 	cusp::blas::fill(tags2, -1);
-	cusp::blas::fill(tagsIn, -1);
-	cusp::blas::fill(tagsP, -1);
-	cusp::blas::fill(tagsPOut, -1);
+	cusp::blas::fill(cellTypeUV, cellType::FLUID);
+	cusp::blas::fill(cellTypeP, cellType::FLUID);
 	cusp::blas::fill(distance_from_intersection_to_node, 1);
 	cusp::blas::fill(distance_between_nodes_at_IB, 1);
 		
@@ -64,51 +63,48 @@ void fadlunModified::tagPoints()
 	dim3 dimGrid0(int( (i_end-i_start-0.5)/blocksize ) +1, 1);
 	
 	//tag u direction nodes for tags, tagsout and tags2
-	kernels::tag_u<<<dimGrid,dimBlock>>>(tags_r, tagsIn_r, tags2_r,
+	kernels::tag_u<<<dimGrid,dimBlock>>>(tags_r, cellTypeUV_r, tags2_r,
 										   bx_r, by_r, uB_r, vB_r, yu_r, xu_r, a_r, b_r, dub_r, dvb_r, uv_r, 
 										   i_start, j_start, i_end, j_end, nx, ny, totalPoints, B.midX, B.midY);
 	//tag v direction nodes for tags, tagsout and tag2
-	kernels::tag_v<<<dimGrid,dimBlock>>>(tags_r, tagsIn_r, tags2_r,
+	kernels::tag_v<<<dimGrid,dimBlock>>>(tags_r, cellTypeUV_r, tags2_r,
 										   bx_r, by_r, uB_r, vB_r, yv_r, xv_r, a_r, b_r, dub_r, dvb_r, uv_r, 
 										   i_start, j_start, i_end, j_end, nx, ny, totalPoints, B.midX, B.midY);
 	//tag pressure nodes for tagsp and tagspout
-	kernels::tag_p<<<dimGrid,dimBlock>>>(tagsP_r, tagsPOut_r,
+	kernels::tag_p<<<dimGrid,dimBlock>>>(cellTypeP_r,
 											bx_r, by_r, yu_r, xv_r, 
 											i_start, j_start, i_end, j_end, nx, ny, totalPoints, B.midX, B.midY);
 	//zero the inside of tagsp
-	kernels::zero_pressure<<<dimGrid0, dimBlock>>>(tagsP_r, i_start, j_start, i_end, j_end, nx, ny);
+	kernels::zero_pressure<<<dimGrid0, dimBlock>>>(cellTypeP_r, i_start, j_start, i_end, j_end, nx, ny);
 	//zero the inside of tagsinx
-	kernels::zero_x<<<dimGrid0,dimBlock>>>(tagsIn_r, i_start, j_start, i_end, j_end, nx, ny);
+	kernels::zero_x<<<dimGrid0,dimBlock>>>(cellTypeUV_r, i_start, j_start, i_end, j_end, nx, ny);
 	//zero the inside of tagsiny
-	kernels::zero_y<<<dimGrid0,dimBlock>>>(tagsIn_r, i_start, j_start, i_end, j_end, nx, ny);
+	kernels::zero_y<<<dimGrid0,dimBlock>>>(cellTypeUV_r, i_start, j_start, i_end, j_end, nx, ny);
 	
 	//testing //flag
-	double a = thrust::reduce(tagsOld.begin(),tagsOld.end()-nx*(ny-1)),
-		   b = thrust::reduce(tags.begin(), tags.end()-nx*(ny-1)),
-		   c = thrust::reduce(tagsOld.end()-nx*(ny-1), tagsOld.end()),
-		   d = thrust::reduce(tags.end()-nx*(ny-1), tags.end()),
-		   f = thrust::reduce(tagsPOld.begin(), tagsPOld.end()),
-		   g = thrust::reduce(tagsPOut.begin(), tagsPOut.end());
+	bool sameX = thrust::equal(thrust::cuda::par(devicePool()), cellTypeUV.begin(), cellTypeUV.end()-nx*(ny-1), cellTypeUVOld.begin()),
+		 sameY = thrust::equal(thrust::cuda::par(devicePool()), cellTypeUV.end()-nx*(ny-1), cellTypeUV.end(), cellTypeUVOld.end()-nx*(ny-1)),
+		 sameP = thrust::equal(thrust::cuda::par(devicePool()), cellTypeP.begin(), cellTypeP.end(), cellTypePOld.begin());
 
 	if (timeStep>0)
 	{
-	if (a!=b)
+	if (!sameX)
 	{
 		std::cout<<"tags x changed at " << timeStep<<"\n";
-		//arrayprint(tags,"tagsx","x");
-		//arrayprint(tagsOld,"tagsOldx","x");
+		//arrayprint(cellTypeUV,"cellTypeUVx","x");
+		//arrayprint(cellTypeUVOld,"cellTypeUVOldx","x");
 	}
-	if (c!=d)
+	if (!sameY)
 	{
 		std::cout<<"tags y changed at " << timeStep<<"\n";
-		//arrayprint(tags,"tagsy","y");
-		//arrayprint(tagsOld,"tagsOldy","y");
+		//arrayprint(cellTypeUV,"cellTypeUVy","y");
+		//arrayprint(cellTypeUVOld,"cellTypeUVOldy","y");
 	}
-	if (f!=g)
+	if (!sameP)
 	{
 		std::cout<<"tags p changed at " << timeStep<<"\n";
-		//arrayprint(tagsPOut,"tagsp","p");
-		//arrayprint(tagsPOld,"tagsPOldx","p");
+		//arrayprint(cellTypeP,"cellTypep","p");
+		//arrayprint(cellTypePOld,"cellTypePOld","p");
 	}
 	}
 	logger.stopTimer("tagPoints");
@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * \file convergence.inl
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief functions that stop the run early once the flow is steady or periodic
+ */
+
+#include <thrust/inner_product.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/functional.h>
+
+struct absDifference
+{
+	__host__ __device__
+	double operator()(double a, double b) const
+	{
+		return (a > b) ? a-b : b-a;
+	}
+};
+
+struct absValue
+{
+	__host__ __device__
+	double operator()(double a) const
+	{
+		return (a > 0) ? a : -a;
+	}
+};
+
+/*
+ * max|u-uold|/(dt*uRef), the relative change of the velocity per unit time, the same measure as the force drift
+ * uRef is the freestream speed from uInitial and vInitial, or the largest velocity in the domain if the fluid starts at rest
+ * u holds the face velocities, so the residual doesn't depend on the cell size
+ */
+double NavierStokesSolver::velocityResidual()
+{
+	double change = thrust::inner_product(thrust::cuda::par(devicePool()), u.begin(), u.end(), uold.begin(), 0.0,
+										  thrust::maximum<double>(), absDifference()),
+		   uRef = sqrt(pow((*paramDB)["flow"]["uInitial"].get<double>(), 2) + pow((*paramDB)["flow"]["vInitial"].get<double>(), 2));
+	if (uRef == 0)
+		uRef = thrust::transform_reduce(thrust::cuda::par(devicePool()), u.begin(), u.end(), absValue(), 0.0, thrust::maximum<double>());
+	return change / ((*paramDB)["simulation"]["dt"].get<double>() * std::max(uRef, 1e-12));
+}
+
+/*
+ * Runs the steady and periodic tests of monitor once every monitorInterval steps
+ * The force samples are fed to the monitor when they are read back, so with bodies the force tests lag by up to forceInterval steps.
+ * return true the first time a test passes, stopState remembers which one
+ */
+bool NavierStokesSolver::converged()
+{
+	int monitorInterval = (*paramDB)["simulation"]["monitorInterval"].get<int>();
+	if (!monitor.active() || stopState != convergenceMonitor::RUNNING || timeStep%monitorInterval != 0)
+		return stopState != convergenceMonitor::RUNNING;
+
+	logger.startTimer("monitor");
+	monitor.addResidual(velocityResidual());
+	stopState = monitor.check(forceHistory.size() > 0);
+	logger.stopTimer("monitor");
+
+	if (stopState == convergenceMonitor::STEADY)
+		std::cout << "\nSteady state reached at time step " << timeStep << ", residual " << monitor.lastResidual() << std::endl;
+	else if (stopState == convergenceMonitor::PERIODIC)
+		std::cout << "\nPeriodic state reached at time step " << timeStep << ", lift period " << monitor.lastPeriod()
+				  << ", frequency " << 1.0/monitor.lastPeriod() << std::endl;
+	return stopState != convergenceMonitor::RUNNING;
+}
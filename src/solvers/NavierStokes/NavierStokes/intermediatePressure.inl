@@ -55,5 +55,6 @@ void NavierStokesSolver::generateLHS2()
 	cusp::blas::fill(LHS2.values,0);
 	kernels::LHS2_mid_nobody<<<grid,block>>>(row_r, col_r, val_r, dx_r, dy_r, nx, ny, dt);
 	kernels::LHS2_BC<<<grid,block>>>(row_r, col_r, val_r, dx_r, dy_r, nx,ny,dt);
+	DS.invalidate();
 	logger.stopTimer("LHS2");
 }
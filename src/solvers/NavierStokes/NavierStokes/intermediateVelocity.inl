@@ -46,7 +46,7 @@ void NavierStokesSolver::generateRHS1()
 
 	generateBC1();
 
-	kernels::generateRHS<<<dimGridUV,dimBlockUV>>>(rhs_r, L_r, Nold_r, N_r, u_r, bc1_r, dt, nx, ny);
+	kernels::generateRHS<<<dimGridUV,dimBlockUV>>>(rhs_r, L_r, Nold_r, N_r, u_r, bc1_r, dt, dtRatio, nx, ny);
 }
 
 /**
@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * \file CFL.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief kernel to find the largest CFL number without storing it for every cell
+ */
+
+#include "CFL.h"
+
+namespace kernels
+{
+/*
+ * Each thread computes |u|/dx + |v|/dy of one pressure cell, using the largest of the two faces in each direction,
+ * then the block reduces them in shared memory and thread 0 writes the block maximum and the cell it belongs to.
+ * Multiply by dt to get the CFL number. Must be launched with cflBlockSize threads per block.
+ * param blockMax largest rate of each block
+ * param blockArg pressure index of the cell with the largest rate of each block
+ */
+__global__
+void maxCFLRate(double *blockMax, int *blockArg, double *u, double *dx, double *dy, int nx, int ny)
+{
+	__shared__ double rate[cflBlockSize];
+	__shared__ int arg[cflBlockSize];
+
+	int t	= threadIdx.x,
+		ip	= threadIdx.x + blockDim.x * blockIdx.x;
+
+	rate[t] = 0;
+	arg[t] = 0;
+	if (ip < nx*ny)
+	{
+		int	I	= ip % nx,
+			J	= ip / nx,
+			iu	= J*(nx-1) + I,
+			iv	= (nx-1)*ny + J*nx + I;
+		double	uc = 0,
+				vc = 0;
+		if (I > 0)
+			uc = fabs(u[iu-1]);
+		if (I < nx-1 && fabs(u[iu]) > uc)
+			uc = fabs(u[iu]);
+		if (J > 0)
+			vc = fabs(u[iv-nx]);
+		if (J < ny-1 && fabs(u[iv]) > vc)
+			vc = fabs(u[iv]);
+		rate[t] = uc/dx[I] + vc/dy[J];
+		arg[t] = ip;
+	}
+	__syncthreads();
+
+	for (int stride = cflBlockSize/2; stride > 0; stride /= 2)
+	{
+		if (t < stride && rate[t+stride] > rate[t])
+		{
+			rate[t] = rate[t+stride];
+			arg[t] = arg[t+stride];
+		}
+		__syncthreads();
+	}
+
+	if (t == 0)
+	{
+		blockMax[blockIdx.x] = rate[0];
+		blockArg[blockIdx.x] = arg[0];
+	}
+}
+}
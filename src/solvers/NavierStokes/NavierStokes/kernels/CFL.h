@@ -0,0 +1,34 @@
+/***************************************************************************//**
+ * \file CFL.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the kernel that reduces the CFL number of every cell to one maximum per block
+ */
+
+#pragma once
+
+#include <thrust/tuple.h>
+
+namespace kernels
+{
+/*
+ * threads per block of maxCFLRate
+ */
+const int cflBlockSize = 256;
+
+__global__
+void maxCFLRate(double *blockMax, int *blockArg, double *u, double *dx, double *dy, int nx, int ny);
+
+/*
+ * picks the larger of two (CFL rate, cell) pairs, the lower cell on a tie so the result doesn't depend on the reduction order
+ */
+struct maxCFLEntry
+{
+	__host__ __device__
+	thrust::tuple<double, int> operator()(const thrust::tuple<double, int> &a, const thrust::tuple<double, int> &b) const
+	{
+		if (thrust::get<0>(b) > thrust::get<0>(a) || (thrust::get<0>(b) == thrust::get<0>(a) && thrust::get<1>(b) < thrust::get<1>(a)))
+			return b;
+		return a;
+	}
+};
+}
@@ -0,0 +1,233 @@
+/***************************************************************************//**
+ * \file controlVolumeForce.cu
+ * \author Anush Krishnan (anush@bu.edu),
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief control volume force on every body, one block per body reduces all six components at once
+ *
+ * Uses the control volume approach explained by Lai and Peskin (2000).
+ * I, J are the indices of the bottom left cell of the control surface and ncx, ncy its size in cells.
+ */
+
+#include "controlVolumeForce.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
+
+namespace kernels
+{
+/*
+ * drag on the left and right faces, idx < ncy
+ */
+__device__ inline
+double dragLeftRight(double *u, double *p, double nu, double *dx, double *dy, int nx, int I, int J, int ncx, int idx)
+{
+	int  Ip = (J+idx)*nx + I,
+	     Iu = (J+idx)*(nx-1) + I;
+
+	return -(
+	          // multiply the pressure with the surface area to get p dy
+	          (
+	           p[Ip+ncx] - p[Ip]
+	          )*dy[J+idx]
+	          +
+	          // ur^2 - ul^2 * dy
+	          (
+	              (u[Iu+ncx]+u[Iu+ncx-1])*(u[Iu+ncx]+u[Iu+ncx-1])/4
+	            - (u[Iu-1]+u[Iu])*(u[Iu-1]+u[Iu])/4
+	          )*dy[J+idx]
+	          -
+	          // du/dx * dy
+	          // approximate using dudx of the inside cell of the cv instead of the lr average
+	          nu*
+	          (
+	              (u[Iu+ncx] - u[Iu+ncx-1])/dx[I+ncx]
+	            - (u[Iu] - u[Iu-1])/dx[I]
+	          )*dy[J+idx]
+	        );
+}
+
+/*
+ * drag on the bottom and top faces, idx <= ncx
+ */
+__device__ inline
+double dragBottomTop(double *u, double nu, double *dx, double *dy, int nx, int ny, int I, int J, int ncy, int idx)
+{
+	int  Iu = J*(nx-1) + (I-1+idx),
+	     Iv = (nx-1)*ny + (J-1)*nx + I+idx;
+
+	return -(
+	          // multiply by dS
+	          (
+	            0.25 * ( u[Iu+ncy*(nx-1)] + u[Iu+(ncy-1)*(nx-1)] )
+	                 * ( u[Iv+ncy*nx] + u[Iv+ncy*nx-1] )
+	            -
+	            0.25 * ( u[Iu] + u[Iu-(nx-1)] )
+	                 * ( u[Iv] + u[Iv-1] )
+	          )
+	          -
+	          // multiply by dS (cannot use the leftRight trick in this case)
+	          nu*
+	          (
+	            (
+	              (u[Iu+ncy*(nx-1)] - u[Iu+(ncy-1)*(nx-1)])/2.0/(dy[J+ncy]+dy[J+ncy-1]) +
+	              (u[Iv+ncy*nx] - u[Iv+ncy*nx-1])          /2.0/(dx[I+idx]+dx[I+idx-1])
+	            )
+	            -
+	            (
+	              (u[Iu] - u[Iu-(nx-1)])/2.0/(dy[J]+dy[J-1]) +
+	              (u[Iv] - u[Iv-1])     /2.0/(dx[I+idx]+dx[I+idx-1])
+	            )
+	          )
+	        )*0.5*(dx[I+idx]+dx[I+idx-1]);
+}
+
+/*
+ * unsteady drag of the fluid nodes inside the control volume, idx < (ncx+1)*ncy
+ */
+__device__ inline
+double dragUnsteady(double *u, double *uold, unsigned char *cellTypeUV, double *dx, double *dy, double dt, int nx, int I, int J, int ncx, int idx)
+{
+	int i = idx%(ncx+1),
+	    j = idx/(ncx+1);
+
+	int Iu = (J+j)*(nx-1) + (I-1+i);
+
+	return - cellType::isFluid(cellTypeUV[Iu]) * ((u[Iu]*dy[J+j] - uold[Iu]*dy[J+j])/dt * 0.5*(dx[I+i]+dx[I-1+i]));
+}
+
+/*
+ * lift on the left and right faces, idx <= ncy
+ */
+__device__ inline
+double liftLeftRight(double *u, double nu, double *dx, double *dy, int nx, int ny, int I, int J, int ncx, int idx)
+{
+	int  Iu = (J+idx)*(nx-1) + (I-1),
+	     Iv = (nx-1)*ny + (J-1+idx)*nx + I;
+
+	return -(
+	          // multiply by dS
+	          (
+	            0.25 * ( u[Iu+ncx] + u[Iu+ncx-(nx-1)] )
+	                 * ( u[Iv+ncx] + u[Iv+ncx-1] )
+	            -
+	            0.25 * ( u[Iu] + u[Iu-(nx-1)] )
+	                 * ( u[Iv] + u[Iv-1] )
+	          )
+	          -
+	          // multiply by dS (cannot use the leftRight trick in this case)
+	          nu*
+	          (
+	            (
+	              (u[Iu+ncx] - u[Iu+ncx-(nx-1)])/2.0/(dy[J+idx]+dy[J-1+idx]) +
+	              (u[Iv+ncx] - u[Iv+ncx-1])/2.0/(dx[I+ncx]+dx[I+ncx-1])
+	            )
+	            -
+	            (
+	              (u[Iu] - u[Iu-(nx-1)])/2.0/(dy[J+idx]+dy[J-1+idx]) +
+	              (u[Iv] - u[Iv-1])/2.0/(dx[I]+dx[I-1])
+	            )
+	          )
+	        )*0.5*(dy[J+idx]+dy[J-1+idx]);
+}
+
+/*
+ * lift on the bottom and top faces, idx < ncx
+ */
+__device__ inline
+double liftBottomTop(double *u, double *p, double nu, double *dx, double *dy, int nx, int ny, int I, int J, int ncy, int idx)
+{
+	int  Ip = J*nx + I+idx,
+	     Iv = (nx-1)*ny + (J-1)*nx + I+idx;
+
+	return -(
+	          // multiply the pressure with the surface area to get p dx
+	          (p[Ip+ncy*nx]-p[Ip-nx])*dx[I+idx]
+	          +
+	          // divide q^2 by dx, so that just v^2 dx is obtained
+	          (
+	              0.25*(u[Iv+(ncy+1)*nx] + u[Iv+ncy*nx])*(u[Iv+(ncy+1)*nx] + u[Iv+ncy*nx])
+	            - 0.25*(u[Iv] + u[Iv-nx])*(u[Iv] + u[Iv-nx])
+	          )*dx[I+idx]
+	          -
+	          // no multiplication or division since dv/dy dx = dq/dy
+	          nu*
+	          (
+	              (u[Iv+(ncy+1)*nx] - u[Iv+ncy*nx])*dx[I+idx]/dy[J+ncy]
+	            - (u[Iv] - u[Iv-nx])*dx[I]/dy[J-1]
+	          )
+	        );
+}
+
+/*
+ * unsteady lift of the fluid nodes inside the control volume, idx < ncx*(ncy+1)
+ */
+__device__ inline
+double liftUnsteady(double *u, double *uold, unsigned char *cellTypeUV, double *dx, double *dy, double dt, int nx, int ny, int I, int J, int ncx, int idx)
+{
+	int i = idx%ncx,
+	    j = idx/ncx;
+
+	int Iv = (J-1+j)*nx + (I+i) + (nx-1)*ny;
+
+	return -cellType::isFluid(cellTypeUV[Iv]) * ((u[Iv]*dx[I+i] - uold[Iv]*dx[I+i])/dt * 0.5*(dy[J+j]+dy[J-1+j]));
+}
+
+/*
+ * Each thread sums its share of every face and the unsteady terms of body blockIdx.x,
+ * then the block reduces the six partial sums in shared memory and thread 0 writes them to force[body*6+c].
+ * Must be launched with forceBlockSize threads per block and one block per body.
+ * param force forceComponents doubles per body
+ * param frameForceX fictitious force on the fluid in the control volume of body 0, removed from its unsteady drag
+ */
+__global__
+void controlVolumeForce(double *force, double *u, double *uold, double *p, unsigned char *cellTypeUV, double *dx, double *dy, double nu, double dt, double frameForceX,
+						int *startI, int *startJ, int *numCellsX, int *numCellsY, int nx, int ny)
+{
+	__shared__ double partial[forceComponents*forceBlockSize];
+
+	int body = blockIdx.x,
+		t = threadIdx.x,
+		I = startI[body],
+		J = startJ[body],
+		ncx = numCellsX[body],
+		ncy = numCellsY[body];
+
+	double	FxX = 0, FxY = 0, FxU = 0,
+			FyX = 0, FyY = 0, FyU = 0;
+
+	for (int idx = t; idx < ncy; idx += blockDim.x)
+		FxX += dragLeftRight(u, p, nu, dx, dy, nx, I, J, ncx, idx);
+	for (int idx = t; idx < ncx+1; idx += blockDim.x)
+		FxY += dragBottomTop(u, nu, dx, dy, nx, ny, I, J, ncy, idx);
+	for (int idx = t; idx < (ncx+1)*ncy; idx += blockDim.x)
+		FxU += dragUnsteady(u, uold, cellTypeUV, dx, dy, dt, nx, I, J, ncx, idx);
+	for (int idx = t; idx < ncy+1; idx += blockDim.x)
+		FyX += liftLeftRight(u, nu, dx, dy, nx, ny, I, J, ncx, idx);
+	for (int idx = t; idx < ncx; idx += blockDim.x)
+		FyY += liftBottomTop(u, p, nu, dx, dy, nx, ny, I, J, ncy, idx);
+	for (int idx = t; idx < ncx*(ncy+1); idx += blockDim.x)
+		FyU += liftUnsteady(u, uold, cellTypeUV, dx, dy, dt, nx, ny, I, J, ncx, idx);
+
+	partial[0*forceBlockSize + t] = FxX;
+	partial[1*forceBlockSize + t] = FxY;
+	partial[2*forceBlockSize + t] = FxU;
+	partial[3*forceBlockSize + t] = FyX;
+	partial[4*forceBlockSize + t] = FyY;
+	partial[5*forceBlockSize + t] = FyU;
+	__syncthreads();
+
+	for (int stride = forceBlockSize/2; stride > 0; stride /= 2)
+	{
+		if (t < stride)
+			for (int c = 0; c < forceComponents; c++)
+				partial[c*forceBlockSize + t] += partial[c*forceBlockSize + t + stride];
+		__syncthreads();
+	}
+
+	if (t == 0)
+	{
+		for (int c = 0; c < forceComponents; c++)
+			force[body*forceComponents + c] = partial[c*forceBlockSize];
+		if (body == 0)
+			force[2] -= frameForceX;
+	}
+}
+}
@@ -0,0 +1,30 @@
+/***************************************************************************//**
+ * \file controlVolumeForce.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief control volume force on every body with one kernel launch
+ *
+ * The force of each body is stored as six doubles, FxX FxY FxU FyX FyY FyU,
+ * the drag and lift from the left/right faces, the bottom/top faces and the unsteady term.
+ */
+
+#pragma once
+
+namespace kernels
+{
+/*
+ * number of doubles stored per body per step
+ */
+const int forceComponents = 6;
+
+/*
+ * threads per block, the kernels are launched with one block per body
+ */
+const int forceBlockSize = 256;
+
+/*
+ * the unsteady terms only count the velocity nodes that are cellType::isFluid
+ */
+__global__
+void controlVolumeForce(double *force, double *u, double *uold, double *p, unsigned char *cellTypeUV, double *dx, double *dy, double nu, double dt, double frameForceX,
+						int *startI, int *startJ, int *numCellsX, int *numCellsY, int nx, int ny);
+}
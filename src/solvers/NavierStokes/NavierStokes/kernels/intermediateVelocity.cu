@@ -22,16 +22,17 @@ namespace kernels
  * param u u velocities
  * param bc1 boundary condition terms
  * param dt change in time
+ * param dtRatio dt of this step over dt of the last step, the Adams-Bashforth weights are 1+r/2 and r/2 (1.5 and 0.5 for a constant dt)
  * param nx number of cells in x direction
  * param ny number of cells in y direction
  */
 __global__
-void generateRHS(double *rhs, double *L, double *Nold, double *N, double *u, double *bc1, double dt, int nx, int ny)
+void generateRHS(double *rhs, double *L, double *Nold, double *N, double *u, double *bc1, double dt, double dtRatio, int nx, int ny)
 {
 	if (threadIdx.x + (blockDim.x * blockIdx.x) >= (ny-1)*nx + (nx-1)*ny)
 			return;
 	int i 	= threadIdx.x + (blockDim.x * blockIdx.x);
-	rhs[i]  = u[i] + dt*(0.5*Nold[i] - 1.5*N[i] + 0.5*L[i]) + bc1[i];
+	rhs[i]  = u[i] + dt*(0.5*dtRatio*Nold[i] - (1+0.5*dtRatio)*N[i] + 0.5*L[i]) + bc1[i];
 }
 
 /*
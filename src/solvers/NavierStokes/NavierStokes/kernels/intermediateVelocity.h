@@ -15,7 +15,7 @@
 namespace kernels
 {
 __global__
-void generateRHS(double *rhs, double *L, double *Nold, double *N, double *u, double *bc1, double dt, int nx, int ny);
+void generateRHS(double *rhs, double *L, double *Nold, double *N, double *u, double *bc1, double dt, double dtRatio, int nx, int ny);
 
 __global__
 void bc1X(double *u, double *bc1, double *ym, double *yp, double *xm, double *xp, double *dx, double *dy, double nu, double dt, int nx, int ny);
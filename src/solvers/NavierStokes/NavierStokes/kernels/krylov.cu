@@ -0,0 +1,204 @@
+/***************************************************************************//**
+ * \file krylov.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief fused vector kernels for the krylov solvers, every kernel makes one pass over its vectors
+ *        and writes the per block partial sums of the dot products it needs
+ *        must be launched with 256 threads per block
+ */
+
+#include "krylov.h"
+
+namespace kernels
+{
+/*
+ * sums numValues arrays of 256 values in shared memory and writes one partial sum per block for each
+ * param cache shared memory, cache[v*256 + threadIdx.x]
+ * param partial partial sums, partial[v*gridDim.x + blockIdx.x]
+ * param numValues number of dot products being reduced
+ */
+__device__
+void blockReduce(double *cache, double *partial, int numValues)
+{
+	__syncthreads();
+	for (int stride = blockDim.x/2; stride > 0; stride /= 2)
+	{
+		if (threadIdx.x < stride)
+			for (int v=0; v<numValues; v++)
+				cache[v*256 + threadIdx.x] += cache[v*256 + threadIdx.x + stride];
+		__syncthreads();
+	}
+	if (threadIdx.x == 0)
+		for (int v=0; v<numValues; v++)
+			partial[v*gridDim.x + blockIdx.x] = cache[v*256];
+}
+
+/*
+ * r = b - Ax, the initial search directions and the norms of r and b
+ * param r residual
+ * param rstar shadow residual (bicgstab), can be r
+ * param p search direction, can be r
+ * param b right hand side
+ * param Ax A times the initial guess
+ * param partial partial sums of (r,r) and (b,b)
+ * param n size of the vectors
+ */
+__global__
+void residual(double *r, double *rstar, double *p, double *b, double *Ax, double *partial, int n)
+{
+	__shared__ double cache[2*256];
+	double rr = 0, bb = 0;
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+	{
+		double ri = b[i] - Ax[i];
+		r[i] = ri;
+		rstar[i] = ri;
+		p[i] = ri;
+		rr += ri*ri;
+		bb += b[i]*b[i];
+	}
+	cache[threadIdx.x] = rr;
+	cache[256 + threadIdx.x] = bb;
+	blockReduce(cache, partial, 2);
+}
+
+/*
+ * partial sums of (a,b)
+ */
+__global__
+void dot(double *a, double *b, double *partial, int n)
+{
+	__shared__ double cache[256];
+	double ab = 0;
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+		ab += a[i]*b[i];
+	cache[threadIdx.x] = ab;
+	blockReduce(cache, partial, 1);
+}
+
+/*
+ * adds up the partial sums of each block, launch with one block of 256 threads
+ * param partial partial sums, partial[v*numPartials + block]
+ * param result the dot products
+ * param numPartials number of blocks used by the kernel that wrote the partial sums
+ * param numValues number of dot products
+ */
+__global__
+void sumPartials(double *partial, double *result, int numPartials, int numValues)
+{
+	__shared__ double cache[3*256];
+	for (int v=0; v<numValues; v++)
+	{
+		double sum = 0;
+		for (int i = threadIdx.x; i < numPartials; i += blockDim.x)
+			sum += partial[v*numPartials + i];
+		cache[v*256 + threadIdx.x] = sum;
+	}
+	__syncthreads();
+	for (int stride = blockDim.x/2; stride > 0; stride /= 2)
+	{
+		if (threadIdx.x < stride)
+			for (int v=0; v<numValues; v++)
+				cache[v*256 + threadIdx.x] += cache[v*256 + threadIdx.x + stride];
+		__syncthreads();
+	}
+	if (threadIdx.x == 0)
+		for (int v=0; v<numValues; v++)
+			result[v] = cache[v*256];
+}
+
+/*
+ * s = r - alpha v and (s,s)
+ */
+__global__
+void bicgstabS(double *s, double *r, double *v, double alpha, double *partial, int n)
+{
+	__shared__ double cache[256];
+	double ss = 0;
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+	{
+		double si = r[i] - alpha*v[i];
+		s[i] = si;
+		ss += si*si;
+	}
+	cache[threadIdx.x] = ss;
+	blockReduce(cache, partial, 1);
+}
+
+/*
+ * (t,s) and (t,t) in one pass
+ */
+__global__
+void bicgstabOmega(double *t, double *s, double *partial, int n)
+{
+	__shared__ double cache[2*256];
+	double ts = 0, tt = 0;
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+	{
+		ts += t[i]*s[i];
+		tt += t[i]*t[i];
+	}
+	cache[threadIdx.x] = ts;
+	cache[256 + threadIdx.x] = tt;
+	blockReduce(cache, partial, 2);
+}
+
+/*
+ * x += alpha ph + omega sh, r = s - omega t, then (rstar,r) and (r,r)
+ */
+__global__
+void bicgstabUpdate(double *x, double *r, double *rstar, double *ph, double *sh, double *s, double *t, double alpha, double omega, double *partial, int n)
+{
+	__shared__ double cache[2*256];
+	double rho = 0, rr = 0;
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+	{
+		x[i] += alpha*ph[i] + omega*sh[i];
+		double ri = s[i] - omega*t[i];
+		r[i] = ri;
+		rho += rstar[i]*ri;
+		rr += ri*ri;
+	}
+	cache[threadIdx.x] = rho;
+	cache[256 + threadIdx.x] = rr;
+	blockReduce(cache, partial, 2);
+}
+
+/*
+ * p = r + beta (p - omega v)
+ */
+__global__
+void bicgstabDirection(double *p, double *r, double *v, double beta, double omega, int n)
+{
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+		p[i] = r[i] + beta*(p[i] - omega*v[i]);
+}
+
+/*
+ * x += alpha p, r -= alpha q and (r,r)
+ */
+__global__
+void cgUpdate(double *x, double *r, double *p, double *q, double alpha, double *partial, int n)
+{
+	__shared__ double cache[256];
+	double rr = 0;
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+	{
+		x[i] += alpha*p[i];
+		double ri = r[i] - alpha*q[i];
+		r[i] = ri;
+		rr += ri*ri;
+	}
+	cache[threadIdx.x] = rr;
+	blockReduce(cache, partial, 1);
+}
+
+/*
+ * p = z + beta p
+ */
+__global__
+void cgDirection(double *p, double *z, double beta, int n)
+{
+	for (int i = threadIdx.x + blockDim.x * blockIdx.x; i < n; i += blockDim.x * gridDim.x)
+		p[i] = z[i] + beta*p[i];
+}
+}
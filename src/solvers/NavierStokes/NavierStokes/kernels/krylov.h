@@ -0,0 +1,42 @@
+/***************************************************************************//**
+ * \file krylov.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the fused vector update and reduction kernels used by the krylov solvers
+ */
+
+#pragma once
+
+/**
+ * \namespace kernels
+ * \brief Contains all the custom-written CUDA kernels.
+ */
+
+namespace kernels
+{
+__global__
+void residual(double *r, double *rstar, double *p, double *b, double *Ax, double *partial, int n);
+
+__global__
+void dot(double *a, double *b, double *partial, int n);
+
+__global__
+void sumPartials(double *partial, double *result, int numPartials, int numValues);
+
+__global__
+void bicgstabS(double *s, double *r, double *v, double alpha, double *partial, int n);
+
+__global__
+void bicgstabOmega(double *t, double *s, double *partial, int n);
+
+__global__
+void bicgstabUpdate(double *x, double *r, double *rstar, double *ph, double *sh, double *s, double *t, double alpha, double omega, double *partial, int n);
+
+__global__
+void bicgstabDirection(double *p, double *r, double *v, double beta, double omega, int n);
+
+__global__
+void cgUpdate(double *x, double *r, double *p, double *q, double alpha, double *partial, int n);
+
+__global__
+void cgDirection(double *p, double *z, double beta, int n);
+}
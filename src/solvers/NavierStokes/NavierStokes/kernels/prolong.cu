@@ -0,0 +1,138 @@
+/***************************************************************************//**
+ * \file prolong.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief kernels to interpolate a solution from one grid onto another
+ */
+
+#include "prolong.h"
+
+namespace kernels
+{
+/*
+ * index lo of the interval x[lo] <= v < x[lo+1] of a sorted list of n >= 2 coordinates, clamped to the first and last interval
+ */
+__device__ inline
+int bracket(double *x, int n, double v)
+{
+	int lo = 0,
+		hi = n-1;
+	while (hi - lo > 1)
+	{
+		int mid = (lo+hi)/2;
+		if (x[mid] <= v)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * linear weight of x[lo+1], clamped so points outside the coarse nodes take the value of the nearest one
+ */
+__device__ inline
+double weight(double *x, int n, int lo, double v)
+{
+	if (n < 2)
+		return 0;
+	double w = (v - x[lo]) / (x[lo+1] - x[lo]);
+	return (w < 0) ? 0 : (w > 1) ? 1 : w;
+}
+
+/*
+ * Bilinear interpolation between two tensor product sets of nodes, one thread per fine node
+ * fine[j*nxf+i] is at (xf[i], yf[j]) and coarse[j*nxc+i] at (xc[i], yc[j])
+ * Used for the pressure at the cell centres, each component of N at its own faces and the stream function at the cell corners.
+ */
+__global__
+void interpolateNodes(double *fine, double *coarse, double *xf, double *yf, int nxf, int nyf, double *xc, double *yc, int nxc, int nyc)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x;
+	if (idx >= nxf*nyf)
+		return;
+	int i = idx % nxf,
+		j = idx / nxf;
+
+	int I = (nxc < 2) ? 0 : bracket(xc, nxc, xf[i]),
+		J = (nyc < 2) ? 0 : bracket(yc, nyc, yf[j]);
+	double wx = weight(xc, nxc, I, xf[i]),
+		   wy = weight(yc, nyc, J, yf[j]);
+	int I1 = (nxc < 2) ? I : I+1,
+		J1 = (nyc < 2) ? J : J+1;
+
+	fine[idx] = (1-wy)*((1-wx)*coarse[J*nxc+I]  + wx*coarse[J*nxc+I1])
+			  +    wy *((1-wx)*coarse[J1*nxc+I] + wx*coarse[J1*nxc+I1]);
+}
+
+/*
+ * Velocities from a stream function stored at the (nx+1)*(ny+1) cell corners, u = dpsi/dy and v = -dpsi/dx
+ * The fluxes of every cell telescope, so the result has no discrete divergence whatever psi is.
+ */
+__global__
+void velocityFromStreamFunction(double *u, double *psi, double *dx, double *dy, int nx, int ny)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		numU = (nx-1)*ny;
+	if (idx >= numU + nx*(ny-1))
+		return;
+	if (idx < numU)
+	{
+		int I = idx % (nx-1),
+			J = idx / (nx-1);
+		u[idx] = (psi[(J+1)*(nx+1) + I+1] - psi[J*(nx+1) + I+1]) / dy[J];
+	}
+	else
+	{
+		int I = (idx-numU) % nx,
+			J = (idx-numU) / nx;
+		u[idx] = -(psi[(J+1)*(nx+1) + I+1] - psi[(J+1)*(nx+1) + I]) / dx[I];
+	}
+}
+
+/*
+ * Flux conserving remap of one velocity component, one thread per target face
+ * Along the normal direction the source faces are interpolated linearly, along the face the source is taken as constant
+ * in each source cell and averaged over the overlap with the target face, so the flux through any source face line is kept.
+ * The face with normal index n and tangential index t is value[n*strideNormal + t*strideTangent],
+ * for u the normal is x and for v it is y.
+ * param normalT positions of the target faces along the normal, numNormalT of them
+ * param edgesT cell edges of the target along the face, numTangentT+1 of them
+ */
+__global__
+void remapFaces(double *target, double *source,
+				double *normalT, double *edgesT, int numNormalT, int numTangentT, int strideNormalT, int strideTangentT,
+				double *normalS, double *edgesS, int numNormalS, int numTangentS, int strideNormalS, int strideTangentS)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x;
+	if (idx >= numNormalT*numTangentT)
+		return;
+	int n = idx % numNormalT,
+		t = idx / numNormalT;
+
+	int N0 = (numNormalS < 2) ? 0 : bracket(normalS, numNormalS, normalT[n]),
+		N1 = (numNormalS < 2) ? N0 : N0+1;
+	double w = weight(normalS, numNormalS, N0, normalT[n]),
+		   lo = edgesT[t],
+		   hi = edgesT[t+1],
+		   sum = 0,
+		   covered = 0;
+
+	int first = bracket(edgesS, numTangentS+1, lo);
+	for (int k = first; k < numTangentS && edgesS[k] < hi; k++)
+	{
+		double overlap = ((edgesS[k+1] < hi) ? edgesS[k+1] : hi) - ((edgesS[k] > lo) ? edgesS[k] : lo);
+		if (overlap > 0)
+		{
+			sum += overlap * ((1-w)*source[N0*strideNormalS + k*strideTangentS] + w*source[N1*strideNormalS + k*strideTangentS]);
+			covered += overlap;
+		}
+	}
+	// a face outside the source domain takes the value of the nearest source cell
+	if (covered == 0)
+	{
+		sum = (1-w)*source[N0*strideNormalS + first*strideTangentS] + w*source[N1*strideNormalS + first*strideTangentS];
+		covered = 1;
+	}
+	target[n*strideNormalT + t*strideTangentT] = sum / covered;
+}
+}
@@ -0,0 +1,21 @@
+/***************************************************************************//**
+ * \file prolong.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the kernels that move a solution from one grid to another
+ */
+
+#pragma once
+
+namespace kernels
+{
+__global__
+void interpolateNodes(double *fine, double *coarse, double *xf, double *yf, int nxf, int nyf, double *xc, double *yc, int nxc, int nyc);
+
+__global__
+void velocityFromStreamFunction(double *u, double *psi, double *dx, double *dy, int nx, int ny);
+
+__global__
+void remapFaces(double *target, double *source,
+				double *normalT, double *edgesT, int numNormalT, int numTangentT, int strideNormalT, int strideTangentT,
+				double *normalS, double *edgesS, int numNormalS, int numTangentS, int strideNormalS, int strideTangentS);
+}
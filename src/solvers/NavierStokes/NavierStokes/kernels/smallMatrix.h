@@ -0,0 +1,149 @@
+/***************************************************************************//**
+ * \file smallMatrix.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief small dense inverse and solve routines for the immersed boundary interpolation systems
+ *
+ * Every matrix is N*N doubles stored row major, A[r*N+c]. The routines work on one matrix in the calling thread,
+ * a kernel that keeps a matrix per node (Ainv of the hybrid pressure nodes) passes the one of its node.
+ * The routines are __host__ __device__ inline so every interpolation kernel shares the same code.
+ */
+
+#pragma once
+
+#include <cmath>
+
+namespace kernels
+{
+/*
+ * inverts A with gauss-jordan elimination and partial pivoting
+ * param A the matrix, left unchanged
+ * param Ainv the inverse, zero if A is singular
+ * returns false if A is singular
+ */
+template <int N>
+__host__ __device__ inline
+bool invert(const double *A, double *Ainv)
+{
+	double M[N*N];
+	for (int k=0; k<N*N; k++)
+	{
+		M[k] = A[k];
+		Ainv[k] = 0;
+	}
+	for (int k=0; k<N; k++)
+		Ainv[k*N+k] = 1;
+
+	for (int c=0; c<N; c++)
+	{
+		//pivot on the largest entry left in column c
+		int p = c;
+		for (int r=c+1; r<N; r++)
+			if (fabs(M[r*N+c]) > fabs(M[p*N+c]))
+				p = r;
+		if (M[p*N+c] == 0)
+		{
+			for (int k=0; k<N*N; k++)
+				Ainv[k] = 0;
+			return false;
+		}
+		if (p != c)
+			for (int k=0; k<N; k++)
+			{
+				double t = M[c*N+k];		M[c*N+k] = M[p*N+k];		M[p*N+k] = t;
+				t = Ainv[c*N+k];			Ainv[c*N+k] = Ainv[p*N+k];	Ainv[p*N+k] = t;
+			}
+
+		double d = 1/M[c*N+c];
+		for (int k=0; k<N; k++)
+		{
+			M[c*N+k] *= d;
+			Ainv[c*N+k] *= d;
+		}
+		for (int r=0; r<N; r++)
+		{
+			if (r == c)
+				continue;
+			double f = M[r*N+c];
+			if (f == 0)
+				continue;
+			for (int k=0; k<N; k++)
+			{
+				M[r*N+k] -= f*M[c*N+k];
+				Ainv[r*N+k] -= f*Ainv[c*N+k];
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * out = A v
+ */
+template <int N>
+__host__ __device__ inline
+void matVec(const double *A, const double *v, double *out)
+{
+	for (int r=0; r<N; r++)
+	{
+		double sum = 0;
+		for (int c=0; c<N; c++)
+			sum += A[r*N+c]*v[c];
+		out[r] = sum;
+	}
+}
+
+/*
+ * out = A' v, used to turn an inverse into interpolation weights:
+ * if a = Ainv q and f = phi . a then f = (Ainv' phi) . q
+ */
+template <int N>
+__host__ __device__ inline
+void applyTranspose(const double *A, const double *v, double *out)
+{
+	for (int c=0; c<N; c++)
+	{
+		double sum = 0;
+		for (int r=0; r<N; r++)
+			sum += A[r*N+c]*v[r];
+		out[c] = sum;
+	}
+}
+
+/*
+ * solves A x = b, returns false and zeroes x if A is singular
+ */
+template <int N>
+__host__ __device__ inline
+bool solve(const double *A, const double *b, double *x)
+{
+	double Ainv[N*N];
+	bool ok = invert<N>(A, Ainv);
+	matVec<N>(Ainv, b, x);
+	return ok;
+}
+
+/*
+ * solves A' x = b, returns false and zeroes x if A is singular
+ */
+template <int N>
+__host__ __device__ inline
+bool solveTranspose(const double *A, const double *b, double *x)
+{
+	double Ainv[N*N];
+	bool ok = invert<N>(A, Ainv);
+	applyTranspose<N>(Ainv, b, x);
+	return ok;
+}
+
+/*
+ * one row of the bilinear system f = a0 + a1 x + a2 y + a3 x y
+ */
+__host__ __device__ inline
+void bilinearRow(double x, double y, double *row)
+{
+	row[0] = 1;
+	row[1] = x;
+	row[2] = y;
+	row[3] = x*y;
+}
+}
@@ -0,0 +1,307 @@
+/***************************************************************************//**
+ * \file prolong.inl
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief functions to start a solver from the solution of another solver or run
+ */
+
+#include <solvers/NavierStokes/NavierStokes/kernels/prolong.h>
+
+/*
+ * positions of the n+1 cell edges of a line of n cells with centres x and widths dx
+ */
+void cellEdges(cusp::array1d<double, cusp::host_memory> &edges, cusp::array1d<double, cusp::device_memory> &x, cusp::array1d<double, cusp::device_memory> &dx)
+{
+	cusp::array1d<double, cusp::host_memory>	xH = x,
+												dxH = dx;
+	int n = xH.size();
+	edges.resize(n+1);
+	edges[0] = xH[0] - 0.5*dxH[0];
+	for (int i=0; i<n; i++)
+		edges[i+1] = xH[i] + 0.5*dxH[i];
+}
+
+/*
+ * centres of the cells between a list of n+1 edges
+ */
+void cellCentres(cusp::array1d<double, cusp::host_memory> &centres, cusp::array1d<double, cusp::host_memory> &edges)
+{
+	int n = edges.size()-1;
+	centres.resize(n);
+	for (int i=0; i<n; i++)
+		centres[i] = 0.5*(edges[i] + edges[i+1]);
+}
+
+/*
+ * Stream function at the cell corners of a grid given by its cell edges, psi[j*(nx+1)+i] is at x edge i and y edge j
+ * psi is integrated along the first row of interior v faces, then up every column of u faces.
+ * The two outer columns have no u faces, they come from the interior v faces and their corners on the boundary are extrapolated.
+ * The velocity field has to be divergence free for the result not to depend on the path.
+ */
+void streamFunction(cusp::array1d<double, cusp::host_memory> &psi, cusp::array1d<double, cusp::host_memory> &uH,
+					cusp::array1d<double, cusp::host_memory> &ex, cusp::array1d<double, cusp::host_memory> &ey)
+{
+	int nx = ex.size()-1,
+		ny = ey.size()-1,
+		numU = (nx-1)*ny;
+	psi.resize((nx+1)*(ny+1));
+	int w = nx+1;	// corners per row
+
+	psi[w] = 0;
+	for (int I=0; I<nx; I++)
+		psi[w + I+1] = psi[w + I] - uH[numU + I]*(ex[I+1]-ex[I]);
+
+	for (int i=1; i<nx; i++)
+	{
+		psi[i] = psi[w + i] - uH[i-1]*(ey[1]-ey[0]);
+		for (int j=1; j<ny; j++)
+			psi[(j+1)*w + i] = psi[j*w + i] + uH[j*(nx-1) + i-1]*(ey[j+1]-ey[j]);
+	}
+
+	for (int j=2; j<ny; j++)
+	{
+		psi[j*w]      = psi[j*w + 1]    + uH[numU + (j-1)*nx]*(ex[1]-ex[0]);
+		psi[j*w + nx] = psi[j*w + nx-1] - uH[numU + (j-1)*nx + nx-1]*(ex[nx]-ex[nx-1]);
+	}
+	psi[0] = psi[w] - (psi[w+1] - psi[1]);
+	psi[nx] = psi[w+nx] - (psi[w+nx-1] - psi[nx-1]);
+	psi[ny*w] = psi[(ny-1)*w] + (psi[ny*w+1] - psi[(ny-1)*w+1]);
+	psi[ny*w+nx] = psi[(ny-1)*w+nx] + (psi[ny*w+nx-1] - psi[(ny-1)*w+nx-1]);
+}
+
+/*
+ * Replaces the velocity, pressure and convection term with those of a solver on a coarser grid of the same domain
+ * The velocity goes through the stream function of the coarse field, interpolated to the fine cell corners,
+ * so the fine field is divergence free on the staggered grid. The pressure and N are interpolated bilinearly.
+ * The coarse field is projected first, the velocity the immersed boundary methods set inside the bodies isn't
+ * divergence free and would make the stream function depend on the path. The coarse solver is left projected.
+ * The run continues from the time the coarse solver reached, see setTime.
+ * Call after initialise.
+ */
+void NavierStokesSolver::prolong(NavierStokesSolver &coarse)
+{
+	logger.startTimer("prolong");
+	domain &C = *coarse.domInfo,
+		   &F = *domInfo;
+	int nxc = C.nx, nyc = C.ny,
+		nx = F.nx, ny = F.ny,
+		numUc = (nxc-1)*nyc,
+		numU = (nx-1)*ny;
+
+	coarse.removeDivergence();
+	cusp::array1d<double, cusp::host_memory> psiH, exH, eyH,
+											 uH = coarse.u;
+	cellEdges(exH, C.x, C.dx);
+	cellEdges(eyH, C.y, C.dy);
+	streamFunction(psiH, uH, exH, eyH);
+	cusp::array1d<double, cusp::device_memory> psiC = psiH,
+											   psiF((nx+1)*(ny+1)),
+											   exC = exH,
+											   eyC = eyH;
+	cellEdges(exH, F.x, F.dx);
+	cellEdges(eyH, F.y, F.dy);
+	cusp::array1d<double, cusp::device_memory> exF = exH, eyF = eyH;
+
+	double	*psiC_r = thrust::raw_pointer_cast( &(psiC[0]) ),
+			*psiF_r = thrust::raw_pointer_cast( &(psiF[0]) ),
+			*exC_r = thrust::raw_pointer_cast( &(exC[0]) ),
+			*eyC_r = thrust::raw_pointer_cast( &(eyC[0]) ),
+			*exF_r = thrust::raw_pointer_cast( &(exF[0]) ),
+			*eyF_r = thrust::raw_pointer_cast( &(eyF[0]) ),
+			*u_r = thrust::raw_pointer_cast( &(u[0]) ),
+			*N_r = thrust::raw_pointer_cast( &(N[0]) ),
+			*p_r = thrust::raw_pointer_cast( &(pressure[0]) ),
+			*Nc_r = thrust::raw_pointer_cast( &(coarse.N[0]) ),
+			*pc_r = thrust::raw_pointer_cast( &(coarse.pressure[0]) ),
+			*dx_r = thrust::raw_pointer_cast( &(F.dx[0]) ),
+			*dy_r = thrust::raw_pointer_cast( &(F.dy[0]) ),
+			*x_r = thrust::raw_pointer_cast( &(F.x[0]) ),
+			*y_r = thrust::raw_pointer_cast( &(F.y[0]) ),
+			*xu_r = thrust::raw_pointer_cast( &(F.xu[0]) ),
+			*yu_r = thrust::raw_pointer_cast( &(F.yu[0]) ),
+			*xv_r = thrust::raw_pointer_cast( &(F.xv[0]) ),
+			*yv_r = thrust::raw_pointer_cast( &(F.yv[0]) ),
+			*xc_r = thrust::raw_pointer_cast( &(C.x[0]) ),
+			*yc_r = thrust::raw_pointer_cast( &(C.y[0]) ),
+			*xuc_r = thrust::raw_pointer_cast( &(C.xu[0]) ),
+			*yuc_r = thrust::raw_pointer_cast( &(C.yu[0]) ),
+			*xvc_r = thrust::raw_pointer_cast( &(C.xv[0]) ),
+			*yvc_r = thrust::raw_pointer_cast( &(C.yv[0]) );
+
+	const int blocksize = 256;
+	dim3 block(blocksize, 1);
+	dim3 gridPsi( int( ((nx+1)*(ny+1)-0.5)/blocksize ) +1, 1),
+		 gridUV( int( (numU + nx*(ny-1)-0.5)/blocksize ) +1, 1),
+		 gridU( int( (numU-0.5)/blocksize ) +1, 1),
+		 gridV( int( (nx*(ny-1)-0.5)/blocksize ) +1, 1),
+		 gridP( int( (nx*ny-0.5)/blocksize ) +1, 1);
+
+	kernels::interpolateNodes<<<gridPsi,block>>>(psiF_r, psiC_r, exF_r, eyF_r, nx+1, ny+1, exC_r, eyC_r, nxc+1, nyc+1);
+	kernels::velocityFromStreamFunction<<<gridUV,block>>>(u_r, psiF_r, dx_r, dy_r, nx, ny);
+	kernels::interpolateNodes<<<gridU,block>>>(N_r, Nc_r, xu_r, yu_r, nx-1, ny, xuc_r, yuc_r, nxc-1, nyc);
+	kernels::interpolateNodes<<<gridV,block>>>(N_r+numU, Nc_r+numUc, xv_r, yv_r, nx, ny-1, xvc_r, yvc_r, nxc, nyc-1);
+	kernels::interpolateNodes<<<gridP,block>>>(p_r, pc_r, x_r, y_r, nx, ny, xc_r, yc_r, nxc, nyc);
+
+	setTime(coarse.simulationTime);
+	uold = u;
+	pressure_old = pressure;
+	logger.stopTimer("prolong");
+	std::cout << "Prolonged the solution from the " << nxc << "x" << nyc << " grid" << std::endl;
+}
+
+/*
+ * Starts from the velocity and pressure saved by another run, on any grid of the same domain
+ * param path caseFolder/timeStep of the saved solution, the grid is read from caseFolder/grid
+ * Each velocity component is remapped so the flux through the source faces is kept, the pressure is interpolated bilinearly.
+ * The saved velocity is the intermediate one and the remap is not exactly conservative across grids, so a projection follows.
+ * N is left to the first step. Call after initialise.
+ */
+void NavierStokesSolver::initialiseFrom(std::string path)
+{
+	logger.startTimer("initialiseFrom");
+	size_t slash = path.find_last_of('/');
+	std::string folder = (slash == std::string::npos) ? "." : path.substr(0, slash);
+	int step = atoi(path.substr(slash == std::string::npos ? 0 : slash+1).c_str());
+
+	cusp::array1d<double, cusp::host_memory> exH, eyH, xH, yH, uH, pH;
+	io::readGrid(folder, exH, eyH);
+	io::readData(folder, step, uH, pH);
+	int nxs = exH.size()-1,
+		nys = eyH.size()-1,
+		numUs = (nxs-1)*nys;
+	if (uH.size() != numUs + nxs*(nys-1) || pH.size() != nxs*nys)
+	{
+		std::cout << "ERROR: the solution in " << path << " does not match the " << nxs << "x" << nys << " grid of " << folder << std::endl;
+		exit(-1);
+	}
+	cellCentres(xH, exH);
+	cellCentres(yH, eyH);
+	cusp::array1d<double, cusp::device_memory> exS = exH, eyS = eyH, xS = xH, yS = yH, uS = uH, pS = pH;
+
+	domain &F = *domInfo;
+	int nx = F.nx,
+		ny = F.ny,
+		numU = (nx-1)*ny;
+	cellEdges(exH, F.x, F.dx);
+	cellEdges(eyH, F.y, F.dy);
+	cusp::array1d<double, cusp::device_memory> exT = exH, eyT = eyH;
+
+	double	*exS_r = thrust::raw_pointer_cast( &(exS[0]) ),
+			*eyS_r = thrust::raw_pointer_cast( &(eyS[0]) ),
+			*xS_r = thrust::raw_pointer_cast( &(xS[0]) ),
+			*yS_r = thrust::raw_pointer_cast( &(yS[0]) ),
+			*uS_r = thrust::raw_pointer_cast( &(uS[0]) ),
+			*pS_r = thrust::raw_pointer_cast( &(pS[0]) ),
+			*exT_r = thrust::raw_pointer_cast( &(exT[0]) ),
+			*eyT_r = thrust::raw_pointer_cast( &(eyT[0]) ),
+			*u_r = thrust::raw_pointer_cast( &(u[0]) ),
+			*p_r = thrust::raw_pointer_cast( &(pressure[0]) ),
+			*x_r = thrust::raw_pointer_cast( &(F.x[0]) ),
+			*y_r = thrust::raw_pointer_cast( &(F.y[0]) ),
+			*xu_r = thrust::raw_pointer_cast( &(F.xu[0]) ),
+			*yv_r = thrust::raw_pointer_cast( &(F.yv[0]) );
+
+	const int blocksize = 256;
+	dim3 block(blocksize, 1);
+	dim3 gridU( int( (numU-0.5)/blocksize ) +1, 1),
+		 gridV( int( (nx*(ny-1)-0.5)/blocksize ) +1, 1),
+		 gridP( int( (nx*ny-0.5)/blocksize ) +1, 1);
+
+	// the interior edges of the source are its u (v) faces along x (y)
+	kernels::remapFaces<<<gridU,block>>>(u_r, uS_r, xu_r, eyT_r, nx-1, ny, 1, nx-1,
+										 exS_r+1, eyS_r, nxs-1, nys, 1, nxs-1);
+	kernels::remapFaces<<<gridV,block>>>(u_r+numU, uS_r+numUs, yv_r, exT_r, ny-1, nx, nx, 1,
+										 eyS_r+1, exS_r, nys-1, nxs, nxs, 1);
+	kernels::interpolateNodes<<<gridP,block>>>(p_r, pS_r, x_r, y_r, nx, ny, xS_r, yS_r, nxs, nys);
+
+	removeDivergence();
+	zeroVelocity();
+	uold = u;
+	pressure_old = pressure;
+	logger.stopTimer("initialiseFrom");
+	std::cout << "Initialised the solution from " << path << " on the " << nxs << "x" << nys << " grid" << std::endl;
+}
+
+/*
+ * Projects u onto the divergence free fields of the grid, ignoring the bodies
+ * Uses the poisson matrix of the solver without bodies with the PoissonSolve solver and preconditioner (BICGSTAB if it is
+ * DIRECT, the factorisation belongs to the matrix with bodies), the matrix of the solver and the pressure are kept.
+ * A solve that doesn't converge is reported and u is projected with the last iterate, the run goes on from there.
+ */
+void NavierStokesSolver::removeDivergence()
+{
+	int nx = domInfo->nx,
+		ny = domInfo->ny;
+	cusp::coo_matrix<int, double, cusp::device_memory> saved;
+	cusp::array1d<double, cusp::device_memory> mapped = pressure;
+	LHS2.swap(saved);
+	LHS2.resize(nx*ny, nx*ny, 5*nx*ny - 2*ny-2*nx);
+	NavierStokesSolver::generateLHS2();
+
+	uhat = u;
+	NavierStokesSolver::generateRHS2();
+	cusp::blas::fill(pressure, 0);
+	std::string method = (*paramDB)["PoissonSolve"]["solver"].get<std::string>();
+	if (method == "DIRECT")
+		method = "BICGSTAB";
+	preconditioner< cusp::coo_matrix<int, double, cusp::device_memory> > M(LHS2, (*paramDB)["PoissonSolve"]["preconditioner"].get<preconditionerType>());
+	krylovSolver KS;
+	KS.checkInterval = (*paramDB)["PoissonSolve"]["residualCheckInterval"].get<int>();
+	KS.solve(LHS2, pressure, rhs2, M, method, (*paramDB)["PoissonSolve"]["maxIterations"].get<int>(), (*paramDB)["PoissonSolve"]["tolerance"].get<double>());
+	if (!KS.converged())
+	{
+		std::cout << "WARNING: projection of the initial velocity did not converge, it is left partly divergent" << std::endl;
+		std::cout << "Iterations   : " << KS.iteration_count() << std::endl;
+		std::cout << "Residual norm: " << KS.residual_norm() << std::endl;
+	}
+	NavierStokesSolver::velocityProjection();
+
+	pressure = mapped;
+	LHS2.swap(saved);
+}
+
+/*
+ * Jumps to time t, for a run that continues from a state reached by another solver
+ * The velocity inside the bodies is reset, solvers with a prescribed body motion move the bodies to where they are at t first.
+ */
+void NavierStokesSolver::setTime(double t)
+{
+	simulationTime = t;
+	zeroVelocity();
+}
+
+/*
+ * Copies the fields and the time of this solver, the copies stay on the device
+ */
+void NavierStokesSolver::saveState(solverState &state)
+{
+	state.u = u;
+	state.uold = uold;
+	state.pressure = pressure;
+	state.N = N;
+	state.timeStep = timeStep;
+	state.simulationTime = simulationTime;
+	state.dt = (*paramDB)["simulation"]["dt"].get<double>();
+}
+
+/*
+ * Continues from a state saved by a solver on the same grid
+ * initialise placed the bodies at the start time, setTime moves them to the time of the state, then the bodies may
+ * differ from those of the saved solver so the velocity inside them is reset.
+ * Call after initialise.
+ */
+void NavierStokesSolver::loadState(solverState &state)
+{
+	if (state.u.size() != u.size() || state.pressure.size() != pressure.size())
+	{
+		std::cout << "ERROR: the saved state is on a different grid" << std::endl;
+		exit(-1);
+	}
+	u = state.u;
+	uold = state.uold;
+	pressure = state.pressure;
+	pressure_old = state.pressure;
+	N = state.N;
+	timeStep = state.timeStep;
+	(*paramDB)["simulation"]["dt"].set<double>(state.dt);
+	setTime(state.simulationTime);
+}
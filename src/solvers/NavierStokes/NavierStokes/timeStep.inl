@@ -0,0 +1,90 @@
+/***************************************************************************//**
+ * \file timeStep.inl
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief functions to find the largest CFL number and adapt the time step to it
+ */
+
+#include <solvers/NavierStokes/NavierStokes/kernels/CFL.h>
+#include <thrust/reduce.h>
+#include <thrust/iterator/zip_iterator.h>
+
+/*
+ * Largest CFL number of the current velocity field with the current dt
+ * Each block reduces its cells on the device, the block maxima are reduced together with their cells so both come back in one copy
+ * param position pressure index of the cell with the largest CFL number
+ */
+double NavierStokesSolver::maxCFL(int &position)
+{
+	double	*u_r	= thrust::raw_pointer_cast( &(u[0]) ),
+			*dx_r	= thrust::raw_pointer_cast( &(domInfo->dx[0]) ),
+			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]) );
+
+	int nx = domInfo->nx,
+		ny = domInfo->ny;
+
+	dim3 grid( int( (nx*ny-0.5)/kernels::cflBlockSize ) +1, 1);
+	dim3 block(kernels::cflBlockSize, 1);
+	cflBlockMax.resize(grid.x);
+	cflBlockArg.resize(grid.x);
+
+	double	*blockMax_r	= thrust::raw_pointer_cast( &(cflBlockMax[0]) );
+	int		*blockArg_r	= thrust::raw_pointer_cast( &(cflBlockArg[0]) );
+
+	kernels::maxCFLRate<<<grid,block>>>(blockMax_r, blockArg_r, u_r, dx_r, dy_r, nx, ny);
+
+	//the rates are never negative, so any block beats the initial value
+	thrust::tuple<double, int> largest = thrust::reduce(thrust::cuda::par(devicePool()),
+											thrust::make_zip_iterator(thrust::make_tuple(cflBlockMax.begin(), cflBlockArg.begin())),
+											thrust::make_zip_iterator(thrust::make_tuple(cflBlockMax.end(), cflBlockArg.end())),
+											thrust::make_tuple(-1.0, -1), kernels::maxCFLEntry());
+	position = thrust::get<1>(largest);
+	return (*paramDB)["simulation"]["dt"].get<double>() * thrust::get<0>(largest);
+}
+
+/*
+ * Picks the dt of the next step from the largest CFL number, call before anything of the step uses dt
+ * The step is kept while the CFL number is between targetCFL/dtGrowth and targetCFL, above that it shrinks
+ * towards the middle of that band and below it grows by dtGrowth. Keeping dt inside the band means
+ * the dt dependent matrices are only rebuilt every few steps.
+ * A step shrinks by at most dtGrowth too, so a sudden jump in the CFL number takes a few steps to absorb
+ * instead of one large change of dt (and of the Adams-Bashforth weights).
+ * dtRatio is set to the ratio of the new step to the last one for the Adams-Bashforth weights.
+ */
+void NavierStokesSolver::adaptTimeStep()
+{
+	parameterDB &db = *paramDB;
+	dtRatio = 1;
+	if (!db["simulation"]["adaptiveTimeStep"].get<bool>())
+		return;
+
+	logger.startTimer("adaptTimeStep");
+	double	dt		= db["simulation"]["dt"].get<double>(),
+			target	= db["simulation"]["targetCFL"].get<double>(),
+			growth	= db["simulation"]["dtGrowth"].get<double>(),
+			dtMin	= db["simulation"]["dtMin"].get<double>(),
+			dtMax	= db["simulation"]["dtMax"].get<double>(),
+			dtNew	= dt;
+	int position;
+	double cfl = maxCFL(position);
+
+	if (cfl > target)
+	{
+		dtNew = dt*target/(cfl*sqrt(growth));
+		if (dtNew < dt/growth)
+			dtNew = dt/growth;
+	}
+	else if (cfl*growth <= target)
+		dtNew = dt*growth;
+
+	if (dtMax > 0 && dtNew > dtMax)
+		dtNew = dtMax;
+	if (dtNew < dtMin)
+		dtNew = dtMin;
+
+	if (dtNew != dt)
+	{
+		db["simulation"]["dt"].set<double>(dtNew);
+		dtRatio = dtNew/dt;
+	}
+	logger.stopTimer("adaptTimeStep");
+}
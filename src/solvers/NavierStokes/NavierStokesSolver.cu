@@ -6,11 +6,12 @@
 
 #include "NavierStokesSolver.h"
 #include "NavierStokes/kernels/initialise.h"
+#include "NavierStokes/kernels/controlVolumeForce.h"
 #include <sys/stat.h>
 #include <io/io.h>
+#include <apiCounter.h>
 #include <cusp/precond/aggregation/smoothed_aggregation.h>//flag
 #include <cusp/krylov/cg.h>//flag
-#include <cusp/krylov/bicgstab.h>
 #include <cusp/krylov/gmres.h>//flag
 #include <cusp/krylov/bicg.h>//flag
 #include <cusp/print.h>//flag
@@ -55,6 +56,14 @@ void NavierStokesSolver::initialiseNoBody()
 	//////////////////////////////////////////////////////////////////////////////////////////////////
 	// initial values of timeStep
 	timeStep = (*paramDB)["simulation"]["startStep"].get<int>();
+	simulationTime = timeStep*(*paramDB)["simulation"]["dt"].get<double>();
+	dtRatio = 1;
+	versions.watch(dependency::DT, (*paramDB)["simulation"]["dt"].get<double>());
+	versions.watch(dependency::NU, (*paramDB)["flow"]["nu"].get<double>());
+	monitor.setup((*paramDB)["simulation"]["steadyTolerance"].get<double>(),
+				  (*paramDB)["simulation"]["periodicTolerance"].get<double>(),
+				  (*paramDB)["simulation"]["periodicCycles"].get<int>());
+	stopState = convergenceMonitor::RUNNING;
 
 	// creates directory
 	std::string folder = (*paramDB)["inputs"]["caseFolder"].get<std::string>();
@@ -163,6 +172,75 @@ void NavierStokesSolver::initialiseNoBody()
 	std::stringstream outiter;
 	outiter << folder << "/iterations";
 	iterationsFile.open(outiter.str().c_str());
+	// deviceMallocs counts every cudaMalloc of the step, scratchPoolMallocs the ones made by the thrust scratch pool
+	// the rest come from allocations that aren't pooled: cusp temporaries, preconditioner setups and matrix resizes
+	cudaCalls().start();
+	cudaCalls().reset();
+	iterationsFile << "#timeStep\tvelocityIterations\tPoissonIterations\tdeviceMallocs\tscratchPoolMallocs" << std::endl;
+}
+
+/*
+ * Sizes the force history for forceInterval steps of every body
+ * the body solvers call this after the bodies are initialised
+ */
+void NavierStokesSolver::initialiseForceHistory(int numBodies)
+{
+	forceInterval = (*paramDB)["simulation"]["forceInterval"].get<int>();
+	if (forceInterval < 1)
+		forceInterval = 1;
+	forceHistory.resize(forceInterval*numBodies*kernels::forceComponents);
+	forceHistoryHost.resize(forceInterval*numBodies*kernels::forceComponents);
+	forceTime.resize(forceInterval);
+	forceSlot = 0;
+	forceBodies = numBodies;
+}
+
+/*
+ * Copies the filled slots of forceHistory to the host with one transfer
+ * forceX, forceY, fxx, fxy and fxu are set from the first body in the last slot
+ */
+void NavierStokesSolver::readForces()
+{
+	if (forceSlot == 0)
+		return;
+	int n = forceSlot*forceBodies*kernels::forceComponents,
+		last = (forceSlot-1)*forceBodies*kernels::forceComponents;
+	thrust::copy(forceHistory.begin(), forceHistory.begin()+n, forceHistoryHost.begin());
+
+	fxx = forceHistoryHost[last];
+	fxy = forceHistoryHost[last+1];
+	fxu = forceHistoryHost[last+2];
+	forceX = fxx + fxy + fxu;
+	forceY = forceHistoryHost[last+3] + forceHistoryHost[last+4] + forceHistoryHost[last+5];
+}
+
+/*
+ * Reads back the force history and writes one line per slot to the force file, then empties the history
+ * each line is the time followed by Fx, FxX, FxY, FxU and Fy of every body
+ * the force on the first body is also passed to the convergence monitor
+ */
+void NavierStokesSolver::writeForces()
+{
+	if (forceSlot == 0)
+		return;
+	readForces();
+
+	logger.startTimer("output");
+	for (int s = 0; s < forceSlot; s++)
+	{
+		forceFile << forceTime[s];
+		for (int b = 0; b < forceBodies; b++)
+		{
+			double *f = &forceHistoryHost[(s*forceBodies + b)*kernels::forceComponents];
+			forceFile << '\t' << f[0]+f[1]+f[2] << '\t' << f[0] << '\t' << f[1] << '\t' << f[2] << '\t' << f[3]+f[4]+f[5];
+		}
+		forceFile << '\n';
+		double *f = &forceHistoryHost[s*forceBodies*kernels::forceComponents];
+		monitor.addForce(forceTime[s], f[0]+f[1]+f[2], f[3]+f[4]+f[5]);
+	}
+	forceFile.flush();
+	logger.stopTimer("output");
+	forceSlot = 0;
 }
 
 /*
@@ -178,11 +256,42 @@ void NavierStokesSolver::initialiseLHS()
 	LHS2.resize(nx*ny, nx*ny, 5*nx*ny - 2*ny-2*nx);
 	generateLHS1();
 	generateLHS2();
+	if ((*paramDB)["PoissonSolve"]["solver"].get<std::string>() == "DIRECT")
+		DS.factorise(LHS2, nx, ny);
 
 	PC.generate(LHS1,LHS2, (*paramDB)["velocitySolve"]["preconditioner"].get<preconditionerType>(), (*paramDB)["PoissonSolve"]["preconditioner"].get<preconditionerType>());
+	versions.built(dependency::LHS1_MATRIX);
+	versions.built(dependency::LHS2_MATRIX);
+	versions.built(dependency::PRECONDITIONER);
 	std::cout << "Assembled LHS matrices!" << std::endl;
 }
 
+/*
+ * Rebuilds the left hand sides and the preconditioners if dt or nu changed since they were built
+ * Used by the solvers whose matrices don't depend on a moving body
+ */
+void NavierStokesSolver::refreshLHS()
+{
+	versions.watch(dependency::DT, (*paramDB)["simulation"]["dt"].get<double>());
+	versions.watch(dependency::NU, (*paramDB)["flow"]["nu"].get<double>());
+	if (versions.stale(dependency::LHS1_MATRIX))
+	{
+		generateLHS1();
+		versions.built(dependency::LHS1_MATRIX);
+	}
+	if (versions.stale(dependency::LHS2_MATRIX))
+	{
+		generateLHS2();
+		versions.built(dependency::LHS2_MATRIX);
+	}
+	//the sparsity of the matrices doesn't change, so the preconditioners set up in initialiseLHS only need their values updated
+	if (versions.stale(dependency::PRECONDITIONER))
+	{
+		PC.update(LHS1, LHS2);
+		versions.built(dependency::PRECONDITIONER);
+	}
+}
+
 //##############################################################################
 //                            TIME STEPPING
 //##############################################################################
@@ -192,6 +301,10 @@ void NavierStokesSolver::initialiseLHS()
  */
 void NavierStokesSolver::stepTime()
 {
+	//0: Pick dt and rebuild the matrices if their inputs changed
+	adaptTimeStep();
+	refreshLHS();
+
 	//1: Solve for intermediate velocity
 	generateRHS1();
 	//arrayprint(rhs1,"rhs1","x");
@@ -212,6 +325,7 @@ void NavierStokesSolver::stepTime()
 
 	//4: update time
 	timeStep++;
+	simulationTime += (*paramDB)["simulation"]["dt"].get<double>();
 	if (timeStep%(*paramDB)["simulation"]["nsave"].get<int>() == 0)
 	{
 	}
@@ -221,12 +335,15 @@ void NavierStokesSolver::stepTime()
 /**
  * \brief Evaluates the condition required to stop the simulation.
  *
+ * The simulation stops after nt time steps, or earlier if steadyTolerance or periodicTolerance is set
+ * and the flow has become steady or periodic.
+ *
  * \return a Boolean to continue or stop the simulation
  */
 bool NavierStokesSolver::finished()
 {
 	int nt = (*paramDB)["simulation"]["nt"].get<int>();
-	return (timeStep < nt) ? false : true;
+	return (timeStep < nt) ? converged() : true;
 }
 
 /**
@@ -255,18 +372,17 @@ void NavierStokesSolver::solveIntermediateVelocity()
 	int  maxIters = (*paramDB)["velocitySolve"]["maxIterations"].get<int>();
 	double relTol = (*paramDB)["velocitySolve"]["tolerance"].get<double>();
 
-	cusp::monitor<double> sys1Mon(rhs1,maxIters,relTol);//flag currently this takes much more time than it should.
-	//cusp::krylov::bicgstab(LHS1, uhat, rhs1, sys1Mon, *PC.PC1);
-	cusp::krylov::bicgstab(LHS1, uhat, rhs1, sys1Mon);
+	KS1.checkInterval = (*paramDB)["velocitySolve"]["residualCheckInterval"].get<int>();
+	KS1.solve(LHS1, uhat, rhs1, *PC.PC1, (*paramDB)["velocitySolve"]["solver"].get<std::string>(), maxIters, relTol);
 
-	iterationCount1 = sys1Mon.iteration_count();
+	iterationCount1 = KS1.iteration_count();
 
-	if (!sys1Mon.converged())
+	if (!KS1.converged())
 	{
 		std::cout << "ERROR: Solve for uhat failed at time step " << timeStep << std::endl;
 		std::cout << "Iterations   : " << iterationCount1 << std::endl;
-		std::cout << "Residual norm: " << sys1Mon.residual_norm() << std::endl;
-		std::cout << "Tolerance    : " << sys1Mon.tolerance() << std::endl;
+		std::cout << "Residual norm: " << KS1.residual_norm() << std::endl;
+		std::cout << "Tolerance    : " << KS1.tolerance() << std::endl;
 		std::exit(-1);
 	}
 
@@ -280,24 +396,46 @@ void NavierStokesSolver::solveIntermediateVelocity()
 void NavierStokesSolver::solvePoisson()
 {
 	logger.startTimer("solvePoisson");
+	solvePoissonSystem(LHS2, pressure, rhs2);
+	logger.stopTimer("solvePoisson");
+}
+
+/*
+ * Solves A x = b with the poisson solver and preconditioner from the input file
+ * param A LHS2, or the reduced poisson system
+ * param x the solution, also the initial guess for the iterative solvers
+ * param b the right hand side
+ * param nodes pressure node of each unknown if A is the reduced system, NULL if A covers every pressure node
+ */
+void NavierStokesSolver::solvePoissonSystem(cusp::coo_matrix<int, double, cusp::device_memory> &A, cusp::array1d<double, cusp::device_memory> &x,
+											cusp::array1d<double, cusp::device_memory> &b, const std::vector<int> *nodes)
+{
+	//A only changes when generateLHS2 is called, so the factorisation is reused until then
+	if ((*paramDB)["PoissonSolve"]["solver"].get<std::string>() == "DIRECT")
+	{
+		if (!DS.isFactorised())
+			DS.factorise(A, domInfo->nx, domInfo->ny, nodes);
+		DS.solve(b, x);
+		iterationCount2 = 0;
+		return;
+	}
 
 	int  maxIters = (*paramDB)["PoissonSolve"]["maxIterations"].get<int>();
 	double relTol   = (*paramDB)["PoissonSolve"]["tolerance"].get<double>();
 
-	cusp::monitor<double> sys2Mon(rhs2, maxIters, relTol);
-	cusp::krylov::bicgstab(LHS2, pressure, rhs2, sys2Mon, *PC.PC2);
+	KS2.checkInterval = (*paramDB)["PoissonSolve"]["residualCheckInterval"].get<int>();
+	KS2.solve(A, x, b, *PC.PC2, (*paramDB)["PoissonSolve"]["solver"].get<std::string>(), maxIters, relTol);
 
-	iterationCount2 = sys2Mon.iteration_count();
-	if (!sys2Mon.converged())
+	iterationCount2 = KS2.iteration_count();
+	PC.solved(iterationCount2);
+	if (!KS2.converged())
 	{
 		std::cout << "ERROR: Solve for pressure failed at time step " << timeStep << std::endl;
 		std::cout << "Iterations   : " << iterationCount2 << std::endl;
-		std::cout << "Residual norm: " << sys2Mon.residual_norm() << std::endl;
-		std::cout << "Tolerance    : " << sys2Mon.tolerance() << std::endl;
+		std::cout << "Residual norm: " << KS2.residual_norm() << std::endl;
+		std::cout << "Tolerance    : " << KS2.tolerance() << std::endl;
 		std::exit(-1);
 	}
-
-	logger.stopTimer("solvePoisson");
 }
 
 //##############################################################################
@@ -360,6 +498,18 @@ void NavierStokesSolver::arrayprint(cusp::array1d<double, cusp::device_memory> v
 	logger.stopTimer("output");
 }
 
+/**
+ * prints a cell type array, the bits are written as numbers instead of characters
+ */
+void NavierStokesSolver::arrayprint(cusp::array1d<unsigned char, cusp::device_memory> value, std::string name, std::string type, int time)
+{
+	if (timeStep != time && time > 0)
+		return;
+	cusp::array1d<double, cusp::device_memory> numbers(value.size());
+	thrust::copy(value.begin(), value.end(), numbers.begin());
+	arrayprint(numbers, name, type, time);
+}
+
 void NavierStokesSolver::printLHS()
 {
 	logger.startTimer("output");
@@ -412,8 +562,13 @@ void NavierStokesSolver::writeCommon()
 	if (timeStep % nsave == 0)
 		io::writeData(folder, timeStep, uhat, pressure, *domInfo);//, *paramDB);
 
-	// write the number of iterations for each solve
-	iterationsFile << timeStep << '\t' << iterationCount1 << '\t' << iterationCount2 << std::endl;
+	// write the number of iterations for each solve and the number of cudaMalloc calls since the last step, all of them and the scratch pool's
+	iterationsFile << timeStep << '\t' << iterationCount1 << '\t' << iterationCount2 << '\t' << cudaCalls().mallocs() << '\t' << devicePool().allocations() << std::endl;
+	// debug output, every device to host copy the step made, the ones inside thrust and cusp included
+	if ((*paramDB)["simulation"]["countTransfers"].get<bool>())
+		std::cout << "device to host copies at step " << timeStep << ": " << cudaCalls().deviceToHost() << std::endl;
+	cudaCalls().reset();
+	devicePool().resetAllocations();
 }
 
 /**
@@ -433,7 +588,12 @@ void NavierStokesSolver::writeData()
  */
 void NavierStokesSolver::shutDown()
 {
+	// a run stopped by the monitor keeps its last fields even if the step isn't a multiple of nsave
+	int nsave = (*paramDB)["simulation"]["nsave"].get<int>();
+	if (stopState != convergenceMonitor::RUNNING && timeStep % nsave != 0)
+		io::writeData((*paramDB)["inputs"]["caseFolder"].get<std::string>(), timeStep, uhat, pressure, *domInfo);
 	io::printTimingInfo(logger);
+	versions.printRebuilds();
 	iterationsFile.close();
 }
 
@@ -441,3 +601,6 @@ void NavierStokesSolver::shutDown()
 #include "NavierStokes/intermediateVelocity.inl"
 #include "NavierStokes/intermediatePressure.inl"
 #include "NavierStokes/projectVelocity.inl"
+#include "NavierStokes/timeStep.inl"
+#include "NavierStokes/convergence.inl"
+#include "NavierStokes/prolong.inl"
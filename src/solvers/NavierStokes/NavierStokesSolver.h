@@ -4,6 +4,11 @@
 #include <bodies.h>
 #include <io/io.h>
 #include "newPrecon.h"
+#include "directSolver.h"
+#include "krylovSolver.h"
+#include "dependencyGraph.h"
+#include "convergenceMonitor.h"
+#include <cachedAllocator.h>
 #include <parameterDB.h>
 #include <preconditioner.h>
 #include <cusp/precond/aggregation/smoothed_aggregation.h>
@@ -11,6 +16,25 @@
 #include <ctime>
 #include <cusp/print.h>
 
+/**
+ * \struct solverState
+ * \brief The fields of a solver at one time step, copied from one solver to another on the same grid.
+ */
+struct solverState
+{
+	cusp::array1d<double, cusp::device_memory>
+		u,
+		uold,
+		pressure,
+		N;
+
+	size_t timeStep;
+
+	double
+		simulationTime,
+		dt;
+};
+
 /**
  * \class NavierStokesSolver
  * \brief Solves the Navier-Stokes equations in a rectangular domain.
@@ -38,13 +62,31 @@ protected:
 		bc1, 		///< when you take L(uhat) you get boundary terms that need to go on the right side of the equation, those are here
 		rhs1,		///< -G*p -1.5N(u) + 0.5 N(uold) + 0.5 L(u)
 		rhs2,		///< rhs for the intermediate pressure
-		bc[4];		///< array that contains the boundary conditions of the rectangular
+		bc[4],		///< array that contains the boundary conditions of the rectangular
+		forceHistory;	///< control volume force components of every body, one slot per call to calculateForce since the last read back
+
+	cusp::array1d<double, cusp::host_memory>
+		forceHistoryHost,	///< host copy of forceHistory
+		forceTime;			///< time of each slot of forceHistory
 
 	size_t
 		timeStep,			///< time iteration number
 		iterationCount1,	///< number of iteration to solve the intermediate velocities
 		iterationCount2;	///< number of iteration to solve the Poisson equation
 
+	double
+		simulationTime,		///< time at the end of the last step, the sum of the time steps taken
+		dtRatio;			///< dt of this step over dt of the last step, 1 unless adaptTimeStep changed dt
+
+	cusp::array1d<double, cusp::device_memory>
+		cflBlockMax;		///< largest CFL rate of each block of maxCFLRate
+	cusp::array1d<int, cusp::device_memory>
+		cflBlockArg;		///< cell of each entry of cflBlockMax
+
+	int	forceSlot,		///< next free slot of forceHistory
+		forceInterval,	///< number of slots in forceHistory, the forces are copied to the host once every forceInterval calls
+		forceBodies;	///< number of bodies in each slot of forceHistory
+
 	double
 		forceX,		///< force acting on the body in the x direction //flag
 		forceY,		///< force acting on the body in the y direction //flag
@@ -58,17 +100,43 @@ protected:
 
 	newPrecon PC;
 
+	directSolver DS;	///< cached factorisation of LHS2, used when the poisson solver is DIRECT
+
+	krylovSolver
+		KS1,		///< iterative solver for the intermediate velocity
+		KS2;		///< iterative solver for the pressure
+
 	Logger logger;	///< instance of the class \c Logger to track time of different tasks
+
+	dependencyGraph versions;	///< versions of dt, nu, the grid and the body pose, decides which matrices have to be rebuilt
+
+	convergenceMonitor monitor;				///< steady and periodic state tests
+	convergenceMonitor::state stopState;	///< RUNNING until one of the tests of monitor passes
 	
-	std::ofstream iterationsFile;	///< file that contains the number of iterations
+	std::ofstream forceFile;	///< forces on the bodies, written by writeForces
+
+	std::ofstream iterationsFile;	///< file that contains the number of iterations and the number of cudaMalloc calls made by the thrust scratch pool each step
 	
 	//////////////////////////
 	//NavierStokesSolver.cu
 	//////////////////////////
 	void initialiseNoBody();
+	void initialiseForceHistory(int numBodies);
+	void readForces();
+	void writeForces();
 	void solveIntermediateVelocity();
-	void solvePoisson();
+	void refreshLHS();
+	double maxCFL(int &position);
+	void adaptTimeStep();
+	double velocityResidual();
+	bool converged();
+	void removeDivergence();
+	virtual void zeroVelocity() {}	// sets the velocity inside the bodies to that of the bodies, nothing to do without bodies
+	virtual void solvePoisson();
+	void solvePoissonSystem(cusp::coo_matrix<int, double, cusp::device_memory> &A, cusp::array1d<double, cusp::device_memory> &x,
+							cusp::array1d<double, cusp::device_memory> &b, const std::vector<int> *nodes = NULL);
 	void arrayprint(cusp::array1d<double, cusp::device_memory> value, std::string name, std::string type, int time);
+	void arrayprint(cusp::array1d<unsigned char, cusp::device_memory> value, std::string name, std::string type, int time);
 	void printLHS();
 
 	//////////////////////////
@@ -81,6 +149,7 @@ protected:
 public:
 	// constructor -- copy the database and information about the computational grid
 	NavierStokesSolver(parameterDB *pDB=NULL, domain *dInfo=NULL);
+	virtual ~NavierStokesSolver() {}
 
 	//////////////////////////
 	//NavierStokesSolver.cu
@@ -92,6 +161,11 @@ public:
 	virtual void writeData();
 	bool finished();
 	virtual void shutDown();
+	virtual void prolong(NavierStokesSolver &coarse);
+	virtual void setTime(double t);
+	void initialiseFrom(std::string path);
+	void saveState(solverState &state);
+	void loadState(solverState &state);
 
 	//////////////////////////
 	//intermediatepressure.inl
@@ -0,0 +1,219 @@
+/***************************************************************************//**
+ * \file convergenceMonitor.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Definition of the class \c convergenceMonitor, decides when a run has reached a steady or periodic state
+ */
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * \class convergenceMonitor
+ * \brief Watches the velocity residual and the force on the first body while the solver runs.
+ *
+ * The flow is steady when the relative change of the velocity per unit time (NavierStokesSolver::velocityResidual) and the
+ * relative drift of the force per unit time are both below steadyTolerance.
+ * The flow is periodic when the last periodicCycles periods of the lift, measured between upward crossings of its mean
+ * (the same signal scripts/matlab/oscFFT.m looks at after the run), and the amplitudes of those cycles agree within periodicTolerance.
+ * A tolerance of 0 turns the test off.
+ */
+class convergenceMonitor
+{
+	double	steadyTolerance,
+			periodicTolerance,
+			residual,					///< last value passed to addResidual
+			period;						///< mean period of the last cycles, set when the periodic test passes
+
+	int		periodicCycles,
+			driftSamples;				///< the drift is measured between the newest sample and the one driftSamples before it
+
+	size_t	capacity;					///< the oldest half of the samples is dropped when there are more than this
+
+	bool	haveResidual;
+
+	std::vector<double>
+		time,							///< time of each force sample, oldest first
+		drag,
+		lift;
+
+	/*
+	 * times of the upward crossings of lift = mean between sample first and the end, linearly interpolated
+	 */
+	void crossings(size_t first, double mean, std::vector<double> &tc) const
+	{
+		tc.clear();
+		for (size_t k = std::max(first, (size_t)1); k < lift.size(); k++)
+		{
+			double a = lift[k-1] - mean,
+				   b = lift[k] - mean;
+			if (a < 0 && b >= 0)
+				tc.push_back(time[k-1] + (time[k]-time[k-1]) * (-a)/(b-a));
+		}
+	}
+
+	double meanLift(size_t first) const
+	{
+		double sum = 0;
+		for (size_t k = first; k < lift.size(); k++)
+			sum += lift[k];
+		return sum/(lift.size()-first);
+	}
+
+	/*
+	 * index of the first sample at or after time t
+	 */
+	size_t sampleAt(double t) const
+	{
+		return std::lower_bound(time.begin(), time.end(), t) - time.begin();
+	}
+
+	/*
+	 * largest relative deviation from the mean of a list
+	 */
+	static double spread(const std::vector<double> &x)
+	{
+		double mean = 0, dev = 0;
+		for (size_t k = 0; k < x.size(); k++)
+			mean += x[k];
+		mean /= x.size();
+		for (size_t k = 0; k < x.size(); k++)
+			dev = std::max(dev, std::fabs(x[k]-mean));
+		return (mean != 0) ? dev/std::fabs(mean) : 1;
+	}
+
+public:
+	enum state {RUNNING, STEADY, PERIODIC};
+
+	convergenceMonitor()
+	: steadyTolerance(0), periodicTolerance(0), residual(0), period(0),
+	  periodicCycles(3), driftSamples(100), capacity(1<<16), haveResidual(false)
+	{
+	}
+
+	void setup(double steadyTol, double periodicTol, int cycles)
+	{
+		steadyTolerance = steadyTol;
+		periodicTolerance = periodicTol;
+		periodicCycles = std::max(cycles, 2);
+	}
+
+	bool active() const
+	{
+		return steadyTolerance > 0 || periodicTolerance > 0;
+	}
+
+	void addResidual(double r)
+	{
+		residual = r;
+		haveResidual = true;
+	}
+
+	/*
+	 * param t time of the sample
+	 * param fx drag on the first body
+	 * param fy lift on the first body
+	 */
+	void addForce(double t, double fx, double fy)
+	{
+		if (time.size() >= capacity)
+		{
+			time.erase(time.begin(), time.begin()+capacity/2);
+			drag.erase(drag.begin(), drag.begin()+capacity/2);
+			lift.erase(lift.begin(), lift.begin()+capacity/2);
+		}
+		time.push_back(t);
+		drag.push_back(fx);
+		lift.push_back(fy);
+	}
+
+	/*
+	 * change of the force per unit time between the newest sample and the one driftSamples before it,
+	 * relative to the magnitude of the newest force, -1 if there are not enough samples
+	 */
+	double forceDrift() const
+	{
+		if (time.size() < 2)
+			return -1;
+		size_t n = time.size()-1,
+			   o = (n > (size_t)driftSamples) ? n-driftSamples : 0;
+		double scale = std::max(std::max(std::fabs(drag[n]), std::fabs(lift[n])), 1e-12),
+			   dt = time[n]-time[o];
+		if (dt <= 0)
+			return -1;
+		return std::max(std::fabs(drag[n]-drag[o]), std::fabs(lift[n]-lift[o])) / (dt*scale);
+	}
+
+	/*
+	 * true if the last periodicCycles periods and amplitudes of the lift agree within periodicTolerance, sets period
+	 * the mean is taken over the whole history first, then again over the cycles that were found so the transient doesn't bias it
+	 */
+	bool periodicLift()
+	{
+		if (lift.size() < 3)
+			return false;
+		std::vector<double> tc;
+		double mean = meanLift(0);
+		crossings(0, mean, tc);
+		if (tc.size() < (size_t)periodicCycles+1)
+			return false;
+		size_t first = sampleAt(tc[tc.size()-periodicCycles-1]);
+		mean = meanLift(first);
+		crossings(first > 0 ? first-1 : 0, mean, tc);
+		if (tc.size() < (size_t)periodicCycles+1)
+			return false;
+
+		std::vector<double> periods, amplitudes;
+		for (size_t c = tc.size()-periodicCycles; c < tc.size(); c++)
+		{
+			periods.push_back(tc[c]-tc[c-1]);
+			double lo = lift[sampleAt(tc[c-1])], hi = lo;
+			for (size_t k = sampleAt(tc[c-1]); k < sampleAt(tc[c]); k++)
+			{
+				lo = std::min(lo, lift[k]);
+				hi = std::max(hi, lift[k]);
+			}
+			amplitudes.push_back(hi-lo);
+		}
+		// a lift that only jitters around its mean has no amplitude to speak of
+		if (amplitudes.back() <= periodicTolerance*std::max(std::fabs(mean), 1e-12))
+			return false;
+		if (spread(periods) > periodicTolerance || spread(amplitudes) > periodicTolerance)
+			return false;
+
+		period = 0;
+		for (size_t c = 0; c < periods.size(); c++)
+			period += periods[c];
+		period /= periods.size();
+		return true;
+	}
+
+	/*
+	 * runs the enabled tests
+	 * param hasForces false for a run without bodies, the steady test then only looks at the residual
+	 */
+	state check(bool hasForces)
+	{
+		if (steadyTolerance > 0 && haveResidual && residual < steadyTolerance)
+		{
+			double drift = forceDrift();
+			if (!hasForces || (drift >= 0 && drift < steadyTolerance))
+				return STEADY;
+		}
+		if (periodicTolerance > 0 && hasForces && periodicLift())
+			return PERIODIC;
+		return RUNNING;
+	}
+
+	double lastResidual() const
+	{
+		return residual;
+	}
+
+	double lastPeriod() const
+	{
+		return period;
+	}
+};
@@ -0,0 +1,168 @@
+/***************************************************************************//**
+ * \file dependencyGraph.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Definition of the class \c dependencyGraph, version counters that decide when the solver rebuilds its matrices
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+/**
+ * \brief The inputs and derived data tracked by \c dependencyGraph.
+ *
+ * DT, NU, GRID and BODY_POSE are inputs, they only change when they are touched.
+ * The others are derived, each one is stale when one of its inputs changed since it was last built.
+ */
+namespace dependency
+{
+enum node
+{
+	DT,					///< time step
+	NU,					///< viscosity
+	GRID,				///< the mesh
+	BODY_POSE,			///< position of the body points
+	BOUNDING_BOXES,		///< the control volumes of the force calculation and the tight boxes used to tag
+	TAGS_UV,			///< cellTypeUV, the body intercepts and image points of the velocity nodes
+	TAGS_P,				///< cellTypeP, the body intercepts and image points of the pressure nodes
+	LHS1_MATRIX,
+	LHS2_MATRIX,		///< LHS2, and LHS2r if the reduced poisson system is used
+	PRECONDITIONER,		///< both preconditioners
+	INTERPOLATION_UV,	///< ghost and hybrid velocity interpolation operators
+	INTERPOLATION_P,	///< lists of the ghost and hybrid pressure nodes
+	numNodes
+};
+
+inline
+const char *name(int n)
+{
+	static const char *names[numNodes] = {"dt", "nu", "grid", "body pose", "bounding boxes", "tags uv", "tags p",
+										   "LHS1", "LHS2", "preconditioner", "interpolation uv", "interpolation p"};
+	return names[n];
+}
+}
+
+/**
+ * \class dependencyGraph
+ * \brief Keeps a version counter for every node and the versions of its inputs when it was last built.
+ *
+ * A derived node is rebuilt with
+ *     if (versions.stale(n)) { rebuild; versions.built(n); }
+ * and building it bumps its own version, which makes the nodes that depend on it stale in turn.
+ * A body that doesn't move never touches BODY_POSE, so nothing is rebuilt after the first step.
+ */
+class dependencyGraph
+{
+	std::vector<int>
+		version,					///< bumped every time a node changes
+		rebuilds;					///< number of times each derived node was built
+
+	std::vector< std::vector<int> >
+		inputs,						///< the nodes each node depends on
+		seen;						///< versions of the inputs when the node was last built, empty if never built
+
+	std::vector<double> watched;	///< last value passed to watch()
+
+	void depends(int n, int input)
+	{
+		inputs[n].push_back(input);
+	}
+
+public:
+	dependencyGraph()
+	: version(dependency::numNodes, 0), rebuilds(dependency::numNodes, 0),
+	  inputs(dependency::numNodes), seen(dependency::numNodes), watched(dependency::numNodes, 0)
+	{
+		using namespace dependency;
+		depends(BOUNDING_BOXES, GRID);
+		depends(BOUNDING_BOXES, BODY_POSE);
+		depends(TAGS_UV, BODY_POSE);
+		depends(TAGS_UV, BOUNDING_BOXES);
+		depends(TAGS_P, BODY_POSE);
+		depends(TAGS_P, BOUNDING_BOXES);
+		depends(LHS1_MATRIX, DT);
+		depends(LHS1_MATRIX, NU);
+		depends(LHS1_MATRIX, GRID);
+		depends(LHS1_MATRIX, TAGS_UV);
+		depends(LHS2_MATRIX, DT);
+		depends(LHS2_MATRIX, GRID);
+		depends(LHS2_MATRIX, TAGS_P);
+		depends(LHS2_MATRIX, BODY_POSE);
+		depends(PRECONDITIONER, LHS1_MATRIX);
+		depends(PRECONDITIONER, LHS2_MATRIX);
+		depends(INTERPOLATION_UV, TAGS_UV);
+		depends(INTERPOLATION_P, TAGS_P);
+	}
+
+	/*
+	 * marks an input as changed
+	 */
+	void touch(int n)
+	{
+		version[n]++;
+	}
+
+	/*
+	 * touches an input if its value differs from the one passed last time, used for dt and nu
+	 */
+	void watch(int n, double value)
+	{
+		if (value != watched[n])
+			touch(n);
+		watched[n] = value;
+	}
+
+	/*
+	 * true if the node was never built or one of its inputs changed since
+	 */
+	bool stale(int n) const
+	{
+		if (seen[n].empty())
+			return true;
+		for (size_t k=0; k<inputs[n].size(); k++)
+			if (seen[n][k] != version[inputs[n][k]])
+				return true;
+		return false;
+	}
+
+	/*
+	 * records the versions of the inputs of a node that was just rebuilt
+	 * param changed false if the rebuild gave the same result, the nodes that depend on it stay up to date
+	 */
+	void built(int n, bool changed = true)
+	{
+		seen[n].resize(inputs[n].size());
+		for (size_t k=0; k<inputs[n].size(); k++)
+			seen[n][k] = version[inputs[n][k]];
+		rebuilds[n]++;
+		if (changed)
+			version[n]++;
+	}
+
+	// number of times input changed since n was last built, -1 if n was never built
+	int changesSince(int n, int input) const
+	{
+		if (seen[n].empty())
+			return -1;
+		for (size_t k=0; k<inputs[n].size(); k++)
+			if (inputs[n][k] == input)
+				return version[input] - seen[n][k];
+		return 0;
+	}
+
+	int current(int n) const
+	{
+		return version[n];
+	}
+
+	void printRebuilds() const
+	{
+		std::cout << "\nRebuilds" << '\n';
+		std::cout << "--------" << '\n';
+		for (int n=dependency::BOUNDING_BOXES; n<dependency::numNodes; n++)
+			std::cout << std::setw(18) << std::left << dependency::name(n) << std::right << rebuilds[n] << '\n';
+	}
+};
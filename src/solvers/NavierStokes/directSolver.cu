@@ -0,0 +1,304 @@
+/***************************************************************************//**
+ * \file directSolver.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Host sparse LDU factorisation used to solve the poisson equation when its LHS doesn't change between time steps
+ */
+
+#include "directSolver.h"
+#include <iostream>
+#include <cstdlib>
+
+/*
+ * Initialises the direct solver, nothing is factorised until factorise() is called
+ */
+directSolver::directSolver()
+{
+	n = 0;
+	factorised = false;
+}
+
+/*
+ * Recursively orders the cells of a box of the pressure grid, the two halves first then the line seperating them
+ * param i0 first I index of the box
+ * param i1 one past the last I index of the box
+ * param j0 first J index of the box
+ * param j1 one past the last J index of the box
+ * param nx number of cells in x direction
+ * param count number of unknowns ordered so far
+ */
+void directSolver::nestedDissection(int i0, int i1, int j0, int j1, int nx, int &count)
+{
+	if (i1 <= i0 || j1 <= j0)
+		return;
+
+	//small boxes are cheap to factorise in any order
+	if ((i1-i0)*(j1-j0) <= 16)
+	{
+		for (int J=j0; J<j1; J++)
+			for (int I=i0; I<i1; I++)
+				perm[count++] = J*nx+I;
+		return;
+	}
+
+	//cut the longer side in half
+	if (i1-i0 >= j1-j0)
+	{
+		int m = (i0+i1)/2;
+		nestedDissection(i0, m, j0, j1, nx, count);
+		nestedDissection(m+1, i1, j0, j1, nx, count);
+		for (int J=j0; J<j1; J++)
+			perm[count++] = J*nx+m;
+	}
+	else
+	{
+		int m = (j0+j1)/2;
+		nestedDissection(i0, i1, j0, m, nx, count);
+		nestedDissection(i0, i1, m+1, j1, nx, count);
+		for (int I=i0; I<i1; I++)
+			perm[count++] = m*nx+I;
+	}
+}
+
+/*
+ * Copies the matrix to the host, orders it and computes the LDU factors
+ * The matrix must have a symmetric sparsity pattern (the values don't have to be symmetric) and must not need pivoting,
+ * which is true for the poisson LHS
+ * param A the left hand side matrix for the poisson solve
+ * param nx number of cells in x direction
+ * param ny number of cells in y direction
+ * param nodes pressure node of each unknown if A only covers some of the nodes (the reduced poisson system), NULL if A covers all of them
+ */
+void directSolver::factorise(const cusp::coo_matrix<int, double, cusp::device_memory> &A, int nx, int ny, const std::vector<int> *nodes)
+{
+	cusp::coo_matrix<int, double, cusp::host_memory> A_h = A;
+	factorise(A_h, nx, ny, nodes);
+}
+
+/*
+ * Orders and factorises a matrix that is already on the host, see above
+ */
+void directSolver::factorise(const cusp::coo_matrix<int, double, cusp::host_memory> &A_h, int nx, int ny, const std::vector<int> *nodes)
+{
+	n = A_h.num_rows;
+	if (n != (nodes == NULL ? nx*ny : (int)nodes->size()))
+	{
+		std::cout << "ERROR: direct solver expects one unknown per pressure node\n";
+		std::exit(-1);
+	}
+
+	//ordering, the nested dissection of the whole grid restricted to the unknowns of A
+	perm.resize(nx*ny);
+	iperm.resize(nx*ny);
+	int count = 0;
+	nestedDissection(0, nx, 0, ny, nx, count);
+	if (nodes != NULL)
+	{
+		std::vector<int> unknown(nx*ny, -1);
+		for (int k=0; k<n; k++)
+			unknown[(*nodes)[k]] = k;
+		count = 0;
+		for (int k=0; k<nx*ny; k++)
+			if (unknown[perm[k]] >= 0)
+				perm[count++] = unknown[perm[k]];
+		perm.resize(n);
+		iperm.resize(n);
+	}
+	for (int k=0; k<n; k++)
+		iperm[perm[k]] = k;
+
+	//bucket the permuted matrix: for each k the entries of column k above the diagonal and of row k left of the diagonal
+	std::vector<int> Ap(n+1,0), Ai, Ak(n,0);
+	std::vector<double> Aup, Alo, Adiag(n,0.0);
+	for (size_t p=0; p<A_h.num_entries; p++)
+	{
+		int i = iperm[A_h.row_indices[p]],
+			j = iperm[A_h.column_indices[p]];
+		if (i != j)
+			Ap[(i>j ? i : j)+1]++;
+	}
+	for (int k=0; k<n; k++)
+		Ap[k+1] += Ap[k];
+	Ai.resize(Ap[n]);
+	Aup.assign(Ap[n], 0.0);
+	Alo.assign(Ap[n], 0.0);
+	for (size_t p=0; p<A_h.num_entries; p++)
+	{
+		int i = iperm[A_h.row_indices[p]],
+			j = iperm[A_h.column_indices[p]];
+		double v = A_h.values[p];
+		if (i == j)
+			Adiag[i] += v;
+		else if (i < j)
+		{
+			int q = Ap[j] + Ak[j]++;
+			Ai[q] = i;
+			Aup[q] = v;
+		}
+		else
+		{
+			int q = Ap[i] + Ak[i]++;
+			Ai[q] = j;
+			Alo[q] = v;
+		}
+	}
+
+	//elimination tree
+	std::vector<int> parent(n), flag(n), stack(n), colCount(n,0);
+	std::vector<int> &ancestor = flag;
+	for (int k=0; k<n; k++)
+	{
+		parent[k] = -1;
+		ancestor[k] = -1;
+		for (int p=Ap[k]; p<Ap[k+1]; p++)
+		{
+			int inext;
+			for (int i=Ai[p]; i != -1 && i < k; i = inext)
+			{
+				inext = ancestor[i];
+				ancestor[i] = k;
+				if (inext == -1)
+					parent[i] = k;
+			}
+		}
+	}
+
+	//symbolic factorisation, count the entries in each column of L
+	for (int k=0; k<n; k++)
+		flag[k] = -1;
+	for (int k=0; k<n; k++)
+	{
+		flag[k] = k;
+		for (int p=Ap[k]; p<Ap[k+1]; p++)
+			for (int i=Ai[p]; flag[i] != k; i = parent[i])
+			{
+				flag[i] = k;
+				colCount[i]++;
+			}
+	}
+	Lp.resize(n+1);
+	Lp[0] = 0;
+	for (int k=0; k<n; k++)
+		Lp[k+1] = Lp[k] + colCount[k];
+	Li.resize(Lp[n]);
+	Lx.resize(Lp[n]);
+	Ux.resize(Lp[n]);
+	D.resize(n);
+
+	//numeric factorisation, up-looking: row k of L and column k of U from sparse triangular solves with the factors found so far
+	std::vector<int> next(Lp.begin(), Lp.end()-1);
+	std::vector<double> x(n,0.0), z(n,0.0);
+	for (int k=0; k<n; k++)
+	{
+		//nonzero pattern of row k of L in topological order
+		int top = n;
+		flag[k] = -k-1;
+		for (int p=Ap[k]; p<Ap[k+1]; p++)
+		{
+			int len = 0;
+			for (int i=Ai[p]; flag[i] != -k-1; i = parent[i])
+			{
+				stack[len++] = i;
+				flag[i] = -k-1;
+			}
+			while (len > 0)
+				stack[--top] = stack[--len];
+			x[Ai[p]] += Aup[p];
+			z[Ai[p]] += Alo[p];
+		}
+
+		double dk = Adiag[k];
+		for (int t=top; t<n; t++)
+		{
+			int i = stack[t];
+			double ui = x[i],
+				   li = z[i];
+			x[i] = 0;
+			z[i] = 0;
+			for (int p=Lp[i]; p<next[i]; p++)
+			{
+				x[Li[p]] -= Lx[p]*ui;
+				z[Li[p]] -= Ux[p]*li;
+			}
+			double lki = li/D[i];
+			dk -= lki*ui;
+			int p = next[i]++;
+			Li[p] = k;
+			Lx[p] = lki;
+			Ux[p] = ui/D[i];
+		}
+		if (dk == 0)
+		{
+			std::cout << "ERROR: zero pivot in the direct solver at row " << perm[k] << std::endl;
+			std::exit(-1);
+		}
+		D[k] = dk;
+	}
+
+	work.resize(n);
+	b_h.resize(n);
+	x_h.resize(n);
+	factorised = true;
+}
+
+/*
+ * Solves Ax=b with the stored factors, a forward and back substitution
+ * param b the right hand side
+ * param x the solution
+ */
+void directSolver::solve(const cusp::array1d<double, cusp::device_memory> &b, cusp::array1d<double, cusp::device_memory> &x)
+{
+	b_h = b;
+	solve(&b_h[0], &x_h[0]);
+	x = x_h;
+}
+
+/*
+ * Solves Ax=b on the host, b and x may be the same array
+ */
+void directSolver::solve(const double *b, double *x)
+{
+	for (int k=0; k<n; k++)
+		work[k] = b[perm[k]];
+
+	//L D y = b
+	for (int i=0; i<n; i++)
+	{
+		double yi = work[i];
+		for (int p=Lp[i]; p<Lp[i+1]; p++)
+			work[Li[p]] -= Lx[p]*yi;
+		work[i] = yi/D[i];
+	}
+
+	//U x = y
+	for (int i=n-1; i>=0; i--)
+	{
+		double xi = work[i];
+		for (int p=Lp[i]; p<Lp[i+1]; p++)
+			xi -= Ux[p]*work[Li[p]];
+		work[i] = xi;
+	}
+
+	for (int k=0; k<n; k++)
+		x[perm[k]] = work[k];
+}
+
+/*
+ * Marks the factors as out of date, call this whenever the matrix changes
+ */
+void directSolver::invalidate()
+{
+	factorised = false;
+}
+
+bool directSolver::isFactorised()
+{
+	return factorised;
+}
+
+/*
+ * returns the number of entries stored in L and U (excluding the diagonal)
+ */
+int directSolver::factorNonzeros()
+{
+	return factorised ? 2*Lp[n] : 0;
+}
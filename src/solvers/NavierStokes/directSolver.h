@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * \file directSolver.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the class \c directSolver, a host sparse LDU factorisation of the poisson LHS
+ */
+
+#pragma once
+
+#include <vector>
+#include <cusp/coo_matrix.h>
+#include <cusp/array1d.h>
+
+/**
+ * \class directSolver
+ * \brief Factorises a structurally symmetric sparse matrix once on the host and reuses the factor.
+ *
+ * The unknowns are reordered with a geometric nested dissection of the nx by ny pressure grid
+ * before the factorisation, this keeps the fill of the factors close to O(n log n).
+ * A may also cover a subset of the grid (the reduced poisson system), the ordering is then restricted to those nodes.
+ * A = L*D*U with L unit lower and U unit upper triangular, L and U share one sparsity pattern.
+ */
+class directSolver
+{
+	int n;						///< number of unknowns
+
+	std::vector<int>
+		perm,					///< perm[k] is the original index of the k-th unknown in the new ordering
+		iperm,					///< inverse of perm
+		Lp,						///< column pointers of L (also the row pointers of U)
+		Li;						///< row indices of L (also the column indices of U)
+
+	std::vector<double>
+		Lx,						///< values of L below the diagonal
+		Ux,						///< values of U above the diagonal
+		D,						///< diagonal
+		work;					///< workspace for the substitutions
+
+	cusp::array1d<double, cusp::host_memory>
+		b_h,					///< host copy of the right hand side
+		x_h;					///< host copy of the solution
+
+	bool factorised;			///< true if the factors match the last matrix handed to factorise()
+
+	void nestedDissection(int i0, int i1, int j0, int j1, int nx, int &count);
+
+public:
+	directSolver();
+
+	void factorise(const cusp::coo_matrix<int, double, cusp::device_memory> &A, int nx, int ny, const std::vector<int> *nodes = NULL);
+	void factorise(const cusp::coo_matrix<int, double, cusp::host_memory> &A_h, int nx, int ny, const std::vector<int> *nodes = NULL);
+	void solve(const cusp::array1d<double, cusp::device_memory> &b, cusp::array1d<double, cusp::device_memory> &x);
+	void solve(const double *b, double *x);
+	void invalidate();
+	bool isFactorised();
+	int  factorNonzeros();
+};
@@ -6,6 +6,7 @@
  */
 
 #include "fadlunModified.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 #include <sys/stat.h>
 
 /**
@@ -38,28 +39,28 @@ void fadlunModified::initialise()
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	//tagpoints, size uv, device
 	tags.resize(numUV);//used in lhs1
-	tagsOld.resize(numUV);
-	tagsPOld.resize(numP);
 	tags2.resize(numUV);//used in lhs1
-	tagsIn.resize(numUV);//used in lhs1
+	cellTypeUV.resize(numUV);//used in lhs1
+	cellTypeUVOld.resize(numUV);
 	distance_from_intersection_to_node.resize(numUV);
 	distance_between_nodes_at_IB.resize(numUV);
 	uv.resize(numUV);
 
 	//tagpoints, size np, device
-	tagsP.resize(numP);//flag
-	tagsPOut.resize(numP);//flag
+	cellTypeP.resize(numP);
+	cellTypePOld.resize(numP);
 	distance_from_u_to_body.resize(numP);
 	distance_from_v_to_body.resize(numP);
 	test.resize(numP); //flag
 
-	cusp::blas::fill(tagsOld,-1);
-	cusp::blas::fill(tagsPOld,-1);
+	cusp::blas::fill(cellTypeUVOld, cellType::FLUID);
+	cusp::blas::fill(cellTypePOld, cellType::FLUID);
 
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	//Initialize Bodies
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	B.initialise((*paramDB), *domInfo);
+	initialiseForceHistory(B.numBodies);
 	std::cout << "Initialised bodies!" << std::endl;
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -98,8 +99,13 @@ void fadlunModified::initialiseLHS()
 	LHS2.resize(nx*ny, nx*ny, 5*nx*ny - 2*ny-2*nx); //flag this should have some zero terms in it because no nodes are being removing to account for the different stencil at the body
 	generateLHS1();
 	generateLHS2();
+	if (db["PoissonSolve"]["solver"].get<std::string>() == "DIRECT")
+		NavierStokesSolver::DS.factorise(NavierStokesSolver::LHS2, nx, ny);
 
 	NavierStokesSolver::PC.generate(NavierStokesSolver::LHS1,NavierStokesSolver::LHS2, db["velocitySolve"]["preconditioner"].get<preconditionerType>(), db["PoissonSolve"]["preconditioner"].get<preconditionerType>());
+	versions.built(dependency::LHS1_MATRIX);
+	versions.built(dependency::LHS2_MATRIX);
+	versions.built(dependency::PRECONDITIONER);
 	std::cout << "Assembled FADLUN LHS matrices!" << std::endl;
 }
 
@@ -109,10 +115,6 @@ void fadlunModified::initialiseLHS()
  */
 void fadlunModified::writeData()
 {
-
-	parameterDB  &db = *NavierStokesSolver::paramDB;
-	double dt  = db["simulation"]["dt"].get<double>();
-
 	logger.startTimer("output");
 	writeCommon();
 	logger.stopTimer("output");
@@ -122,8 +124,9 @@ void fadlunModified::writeData()
 	logger.startTimer("output");
 	if (NavierStokesSolver::timeStep == 0)
 		forceFile<<"timestep\tFx\tFxX\tFxY\tFxU\tFy\n";
-	forceFile << timeStep*dt << '\t' << B.forceX << '\t'<<fxx<<"\t"<<fxy<<"\t"<<fxu<<"\t" << B.forceY << std::endl;
 	logger.stopTimer("output");
+	if (forceSlot == forceInterval)
+		writeForces();
 }
 
 /**
@@ -146,6 +149,8 @@ void fadlunModified::writeCommon()
 
 void fadlunModified::stepTime()
 {
+	adaptTimeStep();
+	refreshLHS();
 	generateRHS1();
 	solveIntermediateVelocity();
 
@@ -156,6 +161,7 @@ void fadlunModified::stepTime()
 
 	//std::cout<<timeStep<<std::endl;
 	timeStep++;
+	simulationTime += (*paramDB)["simulation"]["dt"].get<double>();
 }
 
 /**
@@ -164,6 +170,7 @@ void fadlunModified::stepTime()
 void fadlunModified::shutDown()
 {
 	NavierStokesSolver::shutDown();
+	writeForces();
 	forceFile.close();
 }
 
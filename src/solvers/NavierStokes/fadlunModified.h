@@ -15,12 +15,13 @@ class fadlunModified : public NavierStokesSolver
 protected:
 	cusp::array1d<int, cusp::device_memory>
 		tags,		///< indices of velocity nodes near the IB on the device
-		tagsOld,
-		tagsPOld,
-		tags2,		///< indices of 2nd closest velocity node on the device
-		tagsIn,	///< indices of velocity nodes inside the IB
-		tagsP, 	///< indices of pressure nodes inside the IB
-		tagsPOut;	///< indices of pressure nodes outside the IB
+		tags2;		///< indices of 2nd closest velocity node on the device
+
+	cusp::array1d<unsigned char, cusp::device_memory> //one byte of cellType bits per node, as in luoIBM
+		cellTypeUV,		///< ghost (inside the IB), hybrid (tags) and solid velocity nodes
+		cellTypeP,		///< ghost (inside the IB), hybrid (outside the IB) and solid pressure nodes
+		cellTypeUVOld,	///< cell types before the last retag
+		cellTypePOld;
 
 	cusp::array1d<double, cusp::device_memory>
 		distance_from_intersection_to_node,			///< distance between IB and tagged node on the device
@@ -32,8 +33,6 @@ protected:
 
 	bodies 	B;		///< bodies in the flow
 
-	std::ofstream forceFile;
-
 	//////////////////////////
 	//calculateForce.inl
 	//////////////////////////
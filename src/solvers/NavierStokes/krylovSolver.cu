@@ -0,0 +1,256 @@
+/***************************************************************************//**
+ * \file krylovSolver.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief preconditioned CG and BiCGSTAB with fused vector kernels and persistent work vectors
+ */
+
+#include "krylovSolver.h"
+#include "NavierStokes/kernels/krylov.h"
+#include <cusp/multiply.h>
+#include <cusp/blas/blas.h>
+#include <cmath>
+#include <iostream>
+
+/*
+ * Initialises the solver, the work vectors are allocated on the first solve
+ */
+krylovSolver::krylovSolver()
+{
+	iterations = 0;
+	numBlocks = 0;
+	resNorm = 0;
+	tol = 0;
+	hasConverged = false;
+	checkInterval = 1;
+	partial.resize(3*256);
+	result.resize(3);
+	result_h.resize(3);
+}
+
+/*
+ * Resizes the work vectors if the size of the system has changed
+ * param n size of the system
+ */
+void krylovSolver::resize(int n)
+{
+	numBlocks = std::min(256, int((n-0.5)/256)+1);
+	if (r.size() == n)
+		return;
+	r.resize(n);
+	rstar.resize(n);
+	p.resize(n);
+	v.resize(n);
+	s.resize(n);
+	t.resize(n);
+	ph.resize(n);
+	sh.resize(n);
+}
+
+/*
+ * Finishes the dot products whose per block partial sums are in partial and copies them to result_h
+ * param numValues number of dot products
+ */
+void krylovSolver::reduce(int numValues)
+{
+	double	*partial_r	= thrust::raw_pointer_cast( &(partial[0]) ),
+			*result_r	= thrust::raw_pointer_cast( &(result[0]) );
+	kernels::sumPartials<<<1,256>>>(partial_r, result_r, numBlocks, numValues);
+	result_h = result;
+}
+
+/*
+ * Solves Ax=b
+ * param A the matrix
+ * param x the initial guess and the solution
+ * param b the right hand side
+ * param M the preconditioner
+ * param method "CG" or "BICGSTAB"
+ * param maxIters maximum number of iterations
+ * param relTol the solve converges when |r| <= relTol*|b|
+ */
+void krylovSolver::solve(const Matrix &A, Array &x, const Array &b, preconditioner<Matrix> &M, std::string method, int maxIters, double relTol)
+{
+	if (method == "BICGSTAB")
+		bicgstab(A, x, b, M, maxIters, relTol);
+	else if (method == "CG")
+		cg(A, x, b, M, maxIters, relTol);
+	else
+	{
+		std::cout << "ERROR: unrecognised linear solver " << method << ", choose CG or BICGSTAB" << std::endl;
+		exit(-1);
+	}
+}
+
+void krylovSolver::bicgstab(const Matrix &A, Array &x, const Array &b, preconditioner<Matrix> &M, int maxIters, double relTol)
+{
+	int n = b.size();
+	resize(n);
+
+	double	*x_r	= thrust::raw_pointer_cast( &(x[0]) ),
+			*b_r	= const_cast<double *>(thrust::raw_pointer_cast( &(b[0]) )),
+			*r_r	= thrust::raw_pointer_cast( &(r[0]) ),
+			*rstar_r= thrust::raw_pointer_cast( &(rstar[0]) ),
+			*p_r	= thrust::raw_pointer_cast( &(p[0]) ),
+			*v_r	= thrust::raw_pointer_cast( &(v[0]) ),
+			*s_r	= thrust::raw_pointer_cast( &(s[0]) ),
+			*t_r	= thrust::raw_pointer_cast( &(t[0]) ),
+			*ph_r	= thrust::raw_pointer_cast( &(ph[0]) ),
+			*sh_r	= thrust::raw_pointer_cast( &(sh[0]) ),
+			*partial_r = thrust::raw_pointer_cast( &(partial[0]) );
+
+	dim3 grid(numBlocks, 1);
+	dim3 block(256, 1);
+
+	//r = b - Ax, rstar = p = r
+	cusp::multiply(A, x, v);
+	kernels::residual<<<grid,block>>>(r_r, rstar_r, p_r, b_r, v_r, partial_r, n);
+	reduce(2);
+	double rho = result_h[0];
+	resNorm = sqrt(result_h[0]);
+	tol = relTol*sqrt(result_h[1]);
+	iterations = 0;
+	hasConverged = resNorm <= tol;
+
+	while (!hasConverged && iterations < maxIters)
+	{
+		//alpha = rho/(rstar, A M p)
+		M(p, ph);
+		cusp::multiply(A, ph, v);
+		kernels::dot<<<grid,block>>>(rstar_r, v_r, partial_r, n);
+		reduce(1);
+		if (result_h[0] == 0)
+			break;
+		double alpha = rho/result_h[0];
+
+		//s = r - alpha v, on check iterations read back |s| and stop early if it is already small enough
+		kernels::bicgstabS<<<grid,block>>>(s_r, r_r, v_r, alpha, partial_r, n);
+		if ((iterations+1) % checkInterval == 0)
+		{
+			reduce(1);
+			if (sqrt(result_h[0]) <= tol)
+			{
+				cusp::blas::axpy(ph, x, alpha);
+				resNorm = sqrt(result_h[0]);
+				hasConverged = true;
+				iterations++;
+				break;
+			}
+		}
+
+		//omega = (t,s)/(t,t)
+		M(s, sh);
+		cusp::multiply(A, sh, t);
+		kernels::bicgstabOmega<<<grid,block>>>(t_r, s_r, partial_r, n);
+		reduce(2);
+		double omega = result_h[1] == 0 ? 0 : result_h[0]/result_h[1];
+
+		//x += alpha ph + omega sh, r = s - omega t
+		kernels::bicgstabUpdate<<<grid,block>>>(x_r, r_r, rstar_r, ph_r, sh_r, s_r, t_r, alpha, omega, partial_r, n);
+		reduce(2);
+		iterations++;
+		resNorm = sqrt(result_h[1]);
+		// |r| comes back with (rstar,r) which the next direction needs anyway, so it is checked every iteration
+		if (resNorm <= tol)
+		{
+			hasConverged = true;
+			break;
+		}
+		if (omega == 0 || rho == 0)
+			break;
+
+		//p = r + beta (p - omega v)
+		double beta = (result_h[0]/rho)*(alpha/omega);
+		rho = result_h[0];
+		kernels::bicgstabDirection<<<grid,block>>>(p_r, r_r, v_r, beta, omega, n);
+	}
+	hasConverged = hasConverged || resNorm <= tol;
+}
+
+void krylovSolver::cg(const Matrix &A, Array &x, const Array &b, preconditioner<Matrix> &M, int maxIters, double relTol)
+{
+	int n = b.size();
+	resize(n);
+
+	double	*x_r	= thrust::raw_pointer_cast( &(x[0]) ),
+			*b_r	= const_cast<double *>(thrust::raw_pointer_cast( &(b[0]) )),
+			*r_r	= thrust::raw_pointer_cast( &(r[0]) ),
+			*p_r	= thrust::raw_pointer_cast( &(p[0]) ),
+			*q_r	= thrust::raw_pointer_cast( &(v[0]) ),
+			*z_r	= thrust::raw_pointer_cast( &(ph[0]) ),
+			*partial_r = thrust::raw_pointer_cast( &(partial[0]) );
+
+	dim3 grid(numBlocks, 1);
+	dim3 block(256, 1);
+
+	//r = b - Ax, p = z = M r
+	cusp::multiply(A, x, v);
+	kernels::residual<<<grid,block>>>(r_r, r_r, r_r, b_r, q_r, partial_r, n);
+	reduce(2);
+	resNorm = sqrt(result_h[0]);
+	tol = relTol*sqrt(result_h[1]);
+	iterations = 0;
+	hasConverged = resNorm <= tol;
+	if (hasConverged)
+		return;
+
+	M(r, ph);
+	p = ph;
+	kernels::dot<<<grid,block>>>(r_r, z_r, partial_r, n);
+	reduce(1);
+	double rz = result_h[0];
+
+	while (iterations < maxIters)
+	{
+		//alpha = (r,z)/(p,Ap)
+		cusp::multiply(A, p, v);
+		kernels::dot<<<grid,block>>>(p_r, q_r, partial_r, n);
+		reduce(1);
+		if (result_h[0] == 0)
+			break;
+		double alpha = rz/result_h[0];
+
+		//x += alpha p, r -= alpha q
+		kernels::cgUpdate<<<grid,block>>>(x_r, r_r, p_r, q_r, alpha, partial_r, n);
+		iterations++;
+		if (iterations % checkInterval == 0)
+		{
+			reduce(1);
+			resNorm = sqrt(result_h[0]);
+			if (resNorm <= tol)
+			{
+				hasConverged = true;
+				break;
+			}
+		}
+
+		//p = z + beta p
+		M(r, ph);
+		kernels::dot<<<grid,block>>>(r_r, z_r, partial_r, n);
+		reduce(1);
+		if (rz == 0)
+			break;
+		double beta = result_h[0]/rz;
+		rz = result_h[0];
+		kernels::cgDirection<<<grid,block>>>(p_r, z_r, beta, n);
+	}
+}
+
+bool krylovSolver::converged()
+{
+	return hasConverged;
+}
+
+int krylovSolver::iteration_count()
+{
+	return iterations;
+}
+
+double krylovSolver::residual_norm()
+{
+	return resNorm;
+}
+
+double krylovSolver::tolerance()
+{
+	return tol;
+}
@@ -0,0 +1,64 @@
+/***************************************************************************//**
+ * \file krylovSolver.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief Declaration of the class \c krylovSolver, preconditioned CG and BiCGSTAB built from fused vector kernels
+ */
+
+#pragma once
+
+#include <string>
+#include <cusp/coo_matrix.h>
+#include <cusp/array1d.h>
+#include <preconditioner.h>
+
+/**
+ * \class krylovSolver
+ * \brief Preconditioned CG/BiCGSTAB with persistent work vectors
+ *
+ * Every vector update is fused with the dot products that follow it, so an iteration only reads each vector
+ * the minimum number of times. The work vectors are kept between calls and only reallocated if the system size changes.
+ * CG reads back and checks |r| every checkInterval iterations. BiCGSTAB gets |r| for free with the next rho and checks it
+ * every iteration, checkInterval only sets how often the extra |s| readback for the half step early exit is made.
+ */
+class krylovSolver
+{
+	typedef cusp::coo_matrix<int, double, cusp::device_memory> Matrix;
+	typedef cusp::array1d<double, cusp::device_memory> Array;
+
+	Array
+		r,			///< residual
+		rstar,		///< shadow residual
+		p,			///< search direction
+		v,			///< A*ph
+		s,			///< intermediate residual
+		t,			///< A*sh
+		ph,			///< preconditioned search direction
+		sh,			///< preconditioned intermediate residual
+		partial,	///< per block partial sums of the dot products
+		result;		///< finished dot products
+
+	cusp::array1d<double, cusp::host_memory> result_h;
+
+	int		iterations,
+			numBlocks;
+	double	resNorm,
+			tol;
+	bool	hasConverged;
+
+	void resize(int n);
+	void reduce(int numValues);
+	void bicgstab(const Matrix &A, Array &x, const Array &b, preconditioner<Matrix> &M, int maxIters, double relTol);
+	void cg(const Matrix &A, Array &x, const Array &b, preconditioner<Matrix> &M, int maxIters, double relTol);
+
+public:
+	int checkInterval;	///< number of iterations between convergence checks
+
+	krylovSolver();
+
+	void solve(const Matrix &A, Array &x, const Array &b, preconditioner<Matrix> &M, std::string method, int maxIters, double relTol);
+
+	bool converged();
+	int iteration_count();
+	double residual_norm();
+	double tolerance();
+};
@@ -37,9 +37,7 @@ void luoIBM::initialise()
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	pressureStar.resize(numP);
 	ustar.resize(numUV);
-	ghostTagsUV.resize(numUV);
-	hybridTagsUV.resize(numUV);
-	hybridTagsUV2.resize(numUV);
+	cellTypeUV.resize(numUV);
 	body_intercept_x.resize(numUV);
 	body_intercept_y.resize(numUV);
 	image_point_x.resize(numUV);
@@ -99,24 +97,8 @@ void luoIBM::initialise()
 	vdvdy.resize(numP);
 
 	//interp
-	detA.resize(numP);
+	Ainv.resize(16*numP);
 	alpha.resize(numP);
-	b11.resize(numP);
-	b12.resize(numP);
-	b13.resize(numP);
-	b14.resize(numP);
-	b21.resize(numP);
-	b22.resize(numP);
-	b23.resize(numP);
-	b24.resize(numP);
-	b31.resize(numP);
-	b32.resize(numP);
-	b33.resize(numP);
-	b34.resize(numP);
-	b41.resize(numP);
-	b42.resize(numP);
-	b43.resize(numP);
-	b44.resize(numP);
 	stencilCoef.resize(numP);
 	interpCoef.resize(numP);
 	countD.resize(numP);
@@ -131,15 +113,41 @@ void luoIBM::initialise()
 	index4.resize(numP);
 
 	//tagpoints, size nump
-	ghostTagsP.resize(numP);
-	hybridTagsP.resize(numP);
+	cellTypeP.resize(numP);
 	distance_from_u_to_body.resize(numP);
 	distance_from_v_to_body.resize(numP);
+	cellTypeUVOld.resize(numUV);
+	cellTypePOld.resize(numP);
+	changedRows.resize(2);
+	changedRows_h.resize(2);
+	changedRowsUV.resize(numUV);
+	changedRowsP.resize(numP);
+	LHS2RowStart.resize(numP+1);
+	LHS2Mismatch.resize(1);
+	image_point_x_old.resize(numUV);
+	image_point_y_old.resize(numUV);
+	image_point_p_x_old.resize(numP);
+	image_point_p_y_old.resize(numP);
+	tagRegionValid = false;
+	numChangedRowsUV = 0;
+	numChangedRowsP = 0;
+	listedRowsUV = 0;
+	listedRowsP = 0;
+	listedVersionUV = -1;
+	listedVersionP = -1;
+
+	//reduced poisson system
+	reducedPoisson = (*paramDB)["PoissonSolve"]["reducedSystem"].get<bool>();
+	numUnknownsPC = -1;
+	if (reducedPoisson)
+		compactIndexP.resize(numP);
 
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	//Initialize Bodies
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	B.initialise((*paramDB), *domInfo);
+	versions.built(dependency::BOUNDING_BOXES);
+	initialiseForceHistory(B.numBodies);
 	std::cout << "Initialised bodies!" << std::endl;
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -184,20 +192,36 @@ void luoIBM::initialiseLHS()
 	LHS1.resize(numUV, numUV, (nx-1)*ny*5 - 2*ny-2*(nx-1)       +        (ny-1)*nx*5 - 2*(ny-1) - 2*nx);
 	//LHS2.resize(nx*ny, nx*ny, 5*nx*ny - 2*ny-2*nx + nx*ny*3); //flag
 	generateLHS1();
+	versions.built(dependency::LHS1_MATRIX);
 	//generateLHS2();
 
 	//NavierStokesSolver::PC.generate(NavierStokesSolver::LHS1,NavierStokesSolver::LHS2, db["velocitySolve"]["preconditioner"].get<preconditionerType>(), db["PoissonSolve"]["preconditioner"].get<preconditionerType>());
 	std::cout << "Assembled LUO LHS matrices!" << std::endl;
 }
 
+/*
+ * Rebuilds LHS1 if dt, nu or the velocity tags changed since it was built
+ * If only the tags did, just the rows listed by the last retag are reassembled
+ */
+void luoIBM::refreshLHS1()
+{
+	versions.watch(dependency::DT, (*paramDB)["simulation"]["dt"].get<double>());
+	versions.watch(dependency::NU, (*paramDB)["flow"]["nu"].get<double>());
+	if (versions.stale(dependency::LHS1_MATRIX))
+	{
+		if (rowsListed(dependency::LHS1_MATRIX, dependency::TAGS_UV, listedVersionUV))
+			updateLHS1Rows();
+		else
+			generateLHS1();
+		versions.built(dependency::LHS1_MATRIX);
+	}
+}
+
 /**
  * \brief Writes data into files.
  */
 void luoIBM::writeData()
 {
-	parameterDB  &db = *NavierStokesSolver::paramDB;
-	double dt  = db["simulation"]["dt"].get<double>();
-
 	logger.startTimer("output");
 	writeCommon();
 	logger.stopTimer("output");
@@ -210,8 +234,9 @@ void luoIBM::writeData()
 	logger.startTimer("output");
 	if (NavierStokesSolver::timeStep == 1)
 		forceFile<<"timestep\told\tPressure\tdudn\tnew\n";
-	forceFile << timeStep*dt << '\t' << B.forceX << '\t'<<fxx<<"\t"<<fxy<<"\t"<<fxu<<"\t" << B.forceY << std::endl;
 	logger.stopTimer("output");
+	if (forceSlot == forceInterval)
+		writeForces();
 }
 
 /**
@@ -237,34 +262,45 @@ void luoIBM::writeCommon()
  */
 void luoIBM::stepTime()
 {
+	adaptTimeStep();
+	refreshLHS1();
 	generateRHS1();
 	solveIntermediateVelocity();
 	weightUhat();
 
 	preRHS2();
-	sizeLHS2();
-	generateLHS2();
+	//LHS2 only depends on dt and the body, it is kept while neither changes
+	bool newLHS2 = versions.stale(dependency::LHS2_MATRIX);
+	if (newLHS2)
+		assembleLHS2();
 	generateRHS2();
-	LHS2.sort_by_row_and_column();
-	//print(LHS2);
-	//printLHS();
-	PC.generate(LHS1,LHS2, (*paramDB)["velocitySolve"]["preconditioner"].get<preconditionerType>(), (*paramDB)["PoissonSolve"]["preconditioner"].get<preconditionerType>());
+	if (newLHS2)
+	{
+		//print(LHS2);
+		//printLHS();
+		reducePoisson();
+		versions.built(dependency::LHS2_MATRIX);
+	}
+	if (versions.stale(dependency::PRECONDITIONER))
+		updatePreconditioners();
 
 	solvePoisson();
+	if ((*paramDB)["PoissonSolve"]["testReducedSystem"].get<bool>())
+		testReducedPoisson();
 
 	interpPGN();
 	velocityProjection();
 
 	std::cout<<timeStep<<std::endl;
 	timeStep++;
+	simulationTime += (*paramDB)["simulation"]["dt"].get<double>();
 	if (timeStep == 1000)
 	{
 		arrayprint(uhat,"uhat","x",-1);
 		arrayprint(pressure,"p","p",-1);
 		arrayprint(u,"u","x",-1);
-		arrayprint(ghostTagsP,"ghostp","p",-1);
-		arrayprint(ghostTagsUV,"ghostu","x",-1);
-		arrayprint(hybridTagsP,"hybridp","p",-1);
+		arrayprint(cellTypeP,"cellTypep","p",-1);
+		arrayprint(cellTypeUV,"cellTypeu","x",-1);
 	}
 }
 
@@ -274,6 +310,7 @@ void luoIBM::stepTime()
 void luoIBM::shutDown()
 {
 	NavierStokesSolver::shutDown();
+	writeForces();
 	forceFile.close();
 }
 
@@ -281,5 +318,6 @@ void luoIBM::shutDown()
 #include "luoIBM/intermediatePressure.inl"
 #include "luoIBM/projectVelocity.inl"
 #include "luoIBM/tagpoints.inl"
+#include "luoIBM/interpolationOperator.inl"
 #include "luoIBM/calculateForce.inl"
 #include "luoIBM/testing.inl"
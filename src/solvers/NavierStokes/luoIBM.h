@@ -8,17 +8,15 @@
 #pragma once
 
 #include "NavierStokesSolver.h"
+#include <cusp/csr_matrix.h>
 
 
 class luoIBM : public NavierStokesSolver
 {
 protected:
-	cusp::array1d<int, cusp::device_memory> //names are changed to keep consistency with the luo paper, tags the same points as modifiedFadlun
-		ghostTagsUV,		///< velocity nodes just inside the boundary  (tagsIn)
-		ghostTagsP,			///< pressure nodes just inside the boundary  (tagsP)
-		hybridTagsUV,		///< velocity nodes just outside the boundary (tags)
-		hybridTagsUV2,		///< velocity nodes 2 outside the boundary    (tags2)
-		hybridTagsP;		///< pressure nodes just outside the boundary (tagsPout)
+	cusp::array1d<unsigned char, cusp::device_memory> //tags the same points as modifiedFadlun, one byte of cellType bits per node
+		cellTypeUV,			///< ghost (tagsIn), hybrid (tags), hybrid2 (tags2) and solid velocity nodes
+		cellTypeP;			///< ghost (tagsP), hybrid (tagsPOut) and solid pressure nodes
 
 	cusp::array1d<double, cusp::device_memory>
 		pressureStar,
@@ -36,7 +34,7 @@ protected:
 		distance_between_nodes_at_IB,			///< distance between tags and tags2 on the device
 		distance_from_u_to_body,
 		distance_from_v_to_body,
-		uv;									///< velocity at the IB on the device
+		uv;									///< body velocity at the intercept of each ghost and hybrid node, and in the solid nodes
 
 	//testing variables
 	cusp::array1d<double, cusp::device_memory>
@@ -86,24 +84,8 @@ protected:
 
 	//interp variables
 	cusp::array1d<double, cusp::device_memory>
-		detA,
+		Ainv,				///< inverse of the bilinear system at each hybrid pressure node, 16 per node
 		alpha,
-		b11,
-		b12,
-		b13,
-		b14,
-		b21,
-		b22,
-		b23,
-		b24,
-		b31,
-		b32,
-		b33,
-		b34,
-		b41,
-		b42,
-		b43,
-		b44,
 		stencilCoef,
 		interpCoef;
 
@@ -125,15 +107,105 @@ protected:
 		index3,
 		index4;
 
+	//incremental tagging
+	cusp::array1d<unsigned char, cusp::device_memory>
+		cellTypeUVOld,		///< cell types before the last retag, used to find the nodes that changed
+		cellTypePOld;
 
-	bodies 	B;		///< bodies in the flow
+	cusp::array1d<int, cusp::device_memory>
+		changedRows,		///< number of rows of LHS1 and of LHS2 that changed in the last retag
+		changedRowsUV,		///< rows of LHS1 that changed in the last retag that changed any, in no particular order
+		changedRowsP,		///< the same for LHS2
+		LHS2RowStart,		///< position of the first entry of each row in the sorted LHS2
+		LHS2Mismatch;		///< set when a row of LHS2 can't be rewritten in place, see updateLHS2Rows
+	cusp::array1d<int, cusp::host_memory>
+		changedRows_h;
+
+	cusp::array1d<double, cusp::device_memory>
+		image_point_x_old,
+		image_point_y_old,
+		image_point_p_x_old,
+		image_point_p_y_old;
+
+	cusp::array1d<int, cusp::device_memory>
+		tagBoxes;			///< work list of the tagging kernels, the boxes to reset and the box of each body, see tagPoints
+
+	std::vector<int> tagBoxes0;	///< boxes tagged last time, i0 j0 i1 j1
+
+	int	numChangedRowsUV,	///< rows of LHS1 whose tags or image points changed in the last retag, the versions of TAGS_UV only move if this isn't 0
+		numChangedRowsP,	///< the same for LHS2 and TAGS_P
+		listedRowsUV,		///< length of changedRowsUV
+		listedRowsP,		///< length of changedRowsP
+		listedVersionUV,	///< version of TAGS_UV whose changes are in changedRowsUV, -1 if the list is incomplete
+		listedVersionP;		///< the same for TAGS_P and changedRowsP
+	bool tagRegionValid;	///< false until the first full tag
+
+	//precomputed velocity interpolation, rebuilt after the tags change
+	cusp::csr_matrix<int, double, cusp::device_memory>
+		ghostInterp,		///< weights of the fluid nodes used to set each ghost node
+		hybridInterp;		///< weights of the fluid nodes used to set each hybrid node
+
+	cusp::array1d<int, cusp::device_memory>
+		ghostNodesUV,		///< velocity index of each row of ghostInterp
+		hybridNodesUV;		///< velocity index of each row of hybridInterp
+
+	cusp::array1d<double, cusp::device_memory>
+		ghostBodyCoef,		///< coefficient of the body velocity for each ghost node
+		hybridBodyCoef,		///< coefficient of the body velocity for each hybrid node
+		interpTemp;
+
+	//compact lists of the tagged pressure nodes, the immersed boundary kernels run one thread per entry
+	cusp::array1d<int, cusp::device_memory>
+		ghostNodesP,		///< pressure index of each ghost node
+		hybridNodesP,		///< pressure index of each hybrid node
+		hybridCountP;		///< extra LHS2 entries of each hybrid node, scanned into countD by sizeLHS2
+
+	//reduced poisson system, only the fluid, hybrid and ghost pressure nodes are unknowns
+	cusp::coo_matrix<int, double, cusp::device_memory>
+		LHS2r;				///< rows and columns of LHS2 that belong to active pressure nodes, renumbered
 
-	std::ofstream forceFile;
+	cusp::array1d<int, cusp::device_memory>
+		activeP,			///< pressure index of each unknown of LHS2r
+		compactIndexP,		///< unknown of each pressure node in LHS2r, -1 for solid nodes
+		reduceKeep,			///< 1 for the entries of LHS2 copied to LHS2r
+		reduceOffset;		///< position of each kept entry in LHS2r
+
+	cusp::array1d<double, cusp::device_memory>
+		rhs2r,
+		pressureR;
+
+	std::vector<int> activeP_h;	///< host copy of activeP, only kept for the direct solver ordering
+
+	//exact elimination of the solid nodes from the reduced system, see eliminateSolidNodes
+	directSolver solidSolver;	///< factorisation of the solid block A_ss of LHS2
+
+	std::vector<int>
+		solidP_h,			///< pressure index of each row of A_ss
+		schurRows_h,		///< unknown of LHS2r of each row of A_as, the active rows coupled to a solid node
+		schurRowStart_h,	///< first entry of each row of A_as
+		schurSolid_h;		///< row of A_ss of each entry of A_as
+
+	std::vector<double>
+		schurValue_h,		///< value of each entry of A_as
+		schurWork_h;		///< one column of inv(A_ss) A_sa
+
+	cusp::array1d<int, cusp::device_memory>
+		solidP,				///< device copy of solidP_h
+		schurRows;			///< device copy of schurRows_h
+
+	cusp::array1d<double, cusp::device_memory>
+		rhs2Solid,			///< rhs2 at the solid nodes
+		schurCorrection;	///< A_as inv(A_ss) rhs2Solid, subtracted from rhs2r
+
+	bool reducedPoisson;	///< solve LHS2r instead of LHS2
+	int numUnknownsPC;		///< size of the poisson system the preconditioner was set up for
+
+	bodies 	B;		///< bodies in the flow
 
 	//////////////////////////
 	//calculateForce.inl
 	//////////////////////////
-	void calculateForce();
+	void calculateForce(double frameForceX = 0);
 	void luoForce();
 
 	//////////////////////////
@@ -141,7 +213,7 @@ protected:
 	//////////////////////////
 	void updateRobinBoundary();
 	void weightUhat();
-	void zeroVelocity();
+	virtual void zeroVelocity();
 
 	//////////////////////////
 	//intermediatePressure.inl
@@ -149,11 +221,31 @@ protected:
 	void preRHS2();
 	void interpPGN();
 	void sizeLHS2();
+	void assembleLHS2();
+	bool updateLHS2Rows();
+	void reducePoisson();
+	void eliminateSolidNodes();
+	void correctReducedRHS2();
+	void updatePreconditioners();
 
 	//////////////////////////
 	//tagpoints.inl
 	//////////////////////////
 	void tagPoints();
+	bool rowsListed(int n, int tags, int listedVersion);
+
+	//////////////////////////
+	//interpolationOperator.inl
+	//////////////////////////
+	void compactTags(cusp::array1d<unsigned char, cusp::device_memory> &types, unsigned char mask, cusp::array1d<int, cusp::device_memory> &nodes);
+	void buildInterpolationOperators();
+	void buildInterpolationOperator(cusp::csr_matrix<int, double, cusp::device_memory> &W, cusp::array1d<int, cusp::device_memory> &nodes,
+									cusp::array1d<double, cusp::device_memory> &bodyCoef, unsigned char mask, bool hybrid);
+	void applyInterpolationOperator(cusp::csr_matrix<int, double, cusp::device_memory> &W, cusp::array1d<int, cusp::device_memory> &nodes,
+									cusp::array1d<double, cusp::device_memory> &bodyCoef,
+									cusp::array1d<double, cusp::device_memory> &vel, cusp::array1d<double, cusp::device_memory> &out);
+	void interpolateToGhostNodes(cusp::array1d<double, cusp::device_memory> &vel);
+	void interpolateToHybridNodes();
 
 	//////////////////////////
 	//cast.inl
@@ -171,6 +263,7 @@ protected:
 	void testOutputY(); //for tagpoints
 	void testForce_p();
 	void testForce_dudn();
+	void testReducedPoisson(); //reduced against full poisson solve
 
 
 public:
@@ -185,7 +278,9 @@ public:
 	virtual void writeData();
 	virtual void writeCommon();
 	void outputPressure();
+	void refreshLHS1();
 	virtual void stepTime();
+	virtual void solvePoisson();
 	virtual void shutDown();
 
 	//////////////////////////
@@ -200,6 +295,7 @@ public:
 	virtual void generateRHS1();
 	virtual void preRHS1Interpolation();
 	virtual void generateLHS1();
+	void updateLHS1Rows();
 
 	//////////////////////////
 	//projectVelocity.inl
@@ -59,25 +59,9 @@ void castluo()
 	double udvdx_r = thrust::raw_pointer_cast ( &(udvdx[0]) );
 	double vdvdy_r = thrust::raw_pointer_cast ( &(vdvdy[0]) );
 
-	double detA_r = thrust::raw_pointer_cast ( &(detA[0]) );
+	double Ainv_r = thrust::raw_pointer_cast ( &(Ainv[0]) );
 	double alpha_r = thrust::raw_pointer_cast ( &(alpha[0]) );
 	
-	double b11_r = thrust::raw_pointer_cast ( &(b11[0]) );
-	double b12_r = thrust::raw_pointer_cast ( &(b12[0]) );
-	double b13_r = thrust::raw_pointer_cast ( &(b13[0]) );
-	double b14_r = thrust::raw_pointer_cast ( &(b14[0]) );
-	double b21_r = thrust::raw_pointer_cast ( &(b21[0]) );
-	double b22_r = thrust::raw_pointer_cast ( &(b22[0]) );
-	double b23_r = thrust::raw_pointer_cast ( &(b23[0]) );
-	double b24_r = thrust::raw_pointer_cast ( &(b24[0]) );
-	double b31_r = thrust::raw_pointer_cast ( &(b31[0]) );
-	double b32_r = thrust::raw_pointer_cast ( &(b32[0]) );
-	double b33_r = thrust::raw_pointer_cast ( &(b33[0]) );
-	double b34_r = thrust::raw_pointer_cast ( &(b34[0]) );
-	double b41_r = thrust::raw_pointer_cast ( &(b41[0]) );
-	double b42_r = thrust::raw_pointer_cast ( &(b42[0]) );
-	double b43_r = thrust::raw_pointer_cast ( &(b43[0]) );
-	double b44_r = thrust::raw_pointer_cast ( &(b44[0]) );
 	
 
 	int index1_r = thrust::raw_pointer_cast ( &(index1[0]) );
@@ -85,11 +69,8 @@ void castluo()
 	int index3_r = thrust::raw_pointer_cast ( &(index3[0]) );
 	int index4_r = thrust::raw_pointer_cast ( &(index4[0]) );
 	
-	int ghostTagsUV_r = thrust::raw_pointer_cast ( &(ghostTagsUV[0]) );
-	int ghostTagsP_r = thrust::raw_pointer_cast ( &(ghostTagsP[0]) );
-	int hybridTagsUV_r = thrust::raw_pointer_cast ( &(hybridTagsUV[0]) );
-	int hybridTagsUV2_r = thrust::raw_pointer_cast ( &(hybridTagsUV2[0]) );
-	int hybridTagsP_r = thrust::raw_pointer_cast ( &(hybridTagsP[0]) );
+	unsigned char cellTypeUV_r = thrust::raw_pointer_cast ( &(cellTypeUV[0]) );
+	unsigned char cellTypeP_r = thrust::raw_pointer_cast ( &(cellTypeP[0]) );
 	int Tags_r = thrust::raw_pointer_cast ( &(Tags[0]) );
 	
 	bool q1flag_r = thrust::raw_pointer_cast ( &(q1flag[0]) );
@@ -4,10 +4,18 @@
  * \brief functions to invoke the kernals that setup the prerequisites to solve the poission equation
  */
 
-#include <solvers/NavierStokes/luoIBM/kernels/intermediatePressure.h>
+#include <solvers/NavierStokes/luoIBM/kernels/boundaryNodes.h>
 #include <solvers/NavierStokes/luoIBM/kernels/LHS2.h>
 #include <solvers/NavierStokes/NavierStokes/kernels/LHS2.h>
-#include <solvers/NavierStokes/luoIBM/kernels/weight.h>//weighting function
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/gather.h>
+#include <thrust/binary_search.h>
+#include <thrust/transform.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <algorithm>
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 #include <solvers/NavierStokes/luoIBM/kernels/intermediateVelocity.h>
 #include <solvers/NavierStokes/NavierStokes/kernels/intermediatePressure.h>
 
@@ -16,130 +24,49 @@ void luoIBM::generateRHS2()
 	NavierStokesSolver::logger.startTimer("RHS2");
 
 	int nx = NavierStokesSolver::domInfo ->nx,
-		ny = NavierStokesSolver::domInfo ->ny;
-	
-	//variables related to the grid
-	double	*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
-			*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),	
-			*uB0_r		= thrust::raw_pointer_cast ( &(B.uBk[0]) ),
-			*vB0_r		= thrust::raw_pointer_cast ( &(B.vBk[0]) ),
-			*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),
-			*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) ),
-			*dx_r	= thrust::raw_pointer_cast( &(domInfo->dx[0]) ),
+		ny = NavierStokesSolver::domInfo ->ny,
+		numNodes = hybridNodesP.size();
+
+	double	*dx_r	= thrust::raw_pointer_cast( &(domInfo->dx[0]) ),
 			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]) ),
-			*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
-			*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
-			*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
-			*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
 			*ym_r	= thrust::raw_pointer_cast( &(bc[YMINUS][0]) ),
 			*yp_r	= thrust::raw_pointer_cast( &(bc[YPLUS][0]) ),
 			*xm_r	= thrust::raw_pointer_cast( &(bc[XMINUS][0]) ),
-			*xp_r	= thrust::raw_pointer_cast( &(bc[XPLUS][0]) );
-
-	//other variables
-	double	*alpha_r= thrust::raw_pointer_cast( &(alpha[0]) ),
-			*detA_r = thrust::raw_pointer_cast( &(detA[0]) ),
+			*xp_r	= thrust::raw_pointer_cast( &(bc[XPLUS][0]) ),
 			*rhs2_r	= thrust::raw_pointer_cast( &(rhs2[0]) ),
-			*uhat_r	= thrust::raw_pointer_cast( &(uhat[0]) ),
-			*u_r 		= thrust::raw_pointer_cast ( &(u[0]) );
-	
-	//variables used for interpolation
-	double 	*body_intercept_p_x_r = thrust::raw_pointer_cast( &(body_intercept_p_x[0]) ),
-			*body_intercept_p_y_r = thrust::raw_pointer_cast( &(body_intercept_p_y[0]) ),
-			*image_point_p_x_r = thrust::raw_pointer_cast( &(image_point_p_x[0]) ),
-			*image_point_p_y_r = thrust::raw_pointer_cast( &(image_point_p_y[0]) ),
-			*body_intercept_x_r = thrust::raw_pointer_cast( &(body_intercept_x[0]) ),
-			*body_intercept_y_r = thrust::raw_pointer_cast( &(body_intercept_y[0]) ),
-			*image_point_x_r = thrust::raw_pointer_cast( &(image_point_x[0]) ),
-			*image_point_y_r = thrust::raw_pointer_cast( &(image_point_y[0]) ),
-			*x1_p_r = thrust::raw_pointer_cast ( &(x1_p[0]) ),
-			*x2_p_r = thrust::raw_pointer_cast ( &(x2_p[0]) ),
-			*x3_p_r = thrust::raw_pointer_cast ( &(x3_p[0]) ),
-			*x4_p_r = thrust::raw_pointer_cast ( &(x4_p[0]) ),
-			*y1_p_r = thrust::raw_pointer_cast ( &(y1_p[0]) ),
-			*y2_p_r = thrust::raw_pointer_cast ( &(y2_p[0]) ),
-			*y3_p_r = thrust::raw_pointer_cast ( &(y3_p[0]) ),
-			*y4_p_r = thrust::raw_pointer_cast ( &(y4_p[0]) ),
-			*q1_p_r = thrust::raw_pointer_cast ( &(q1_p[0]) ),
-			*q2_p_r = thrust::raw_pointer_cast ( &(q2_p[0]) ),
-			*q3_p_r = thrust::raw_pointer_cast ( &(q3_p[0]) ),
-			*q4_p_r = thrust::raw_pointer_cast ( &(q4_p[0]) ),
-			*b11_r	= thrust::raw_pointer_cast( &(b11[0]) ),
-			*b12_r	= thrust::raw_pointer_cast( &(b12[0]) ),
-			*b13_r	= thrust::raw_pointer_cast( &(b13[0]) ),
-			*b14_r	= thrust::raw_pointer_cast( &(b14[0]) ),
-			*b21_r	= thrust::raw_pointer_cast( &(b21[0]) ),
-			*b22_r	= thrust::raw_pointer_cast( &(b22[0]) ),
-			*b23_r	= thrust::raw_pointer_cast( &(b23[0]) ),
-			*b24_r	= thrust::raw_pointer_cast( &(b24[0]) ),
-			*b31_r	= thrust::raw_pointer_cast( &(b31[0]) ),
-			*b32_r	= thrust::raw_pointer_cast( &(b32[0]) ),
-			*b33_r	= thrust::raw_pointer_cast( &(b33[0]) ),
-			*b34_r	= thrust::raw_pointer_cast( &(b34[0]) ),
-			*b41_r	= thrust::raw_pointer_cast( &(b41[0]) ),
-			*b42_r	= thrust::raw_pointer_cast( &(b42[0]) ),
-			*b43_r	= thrust::raw_pointer_cast( &(b43[0]) ),
-			*b44_r	= thrust::raw_pointer_cast( &(b44[0]) ),
-			*interpCoef_r	= thrust::raw_pointer_cast( &(interpCoef[0]) ),
-			*stencilCoef_r	= thrust::raw_pointer_cast( &(stencilCoef[0]) );
-			
-	//variables related to the uhat interpolation
-	double	*dudt_r	= thrust::raw_pointer_cast ( &(dudt[0]) ),
-			*dvdt_r	= thrust::raw_pointer_cast ( &(dvdt[0]) ),
-			*ududx_r	= thrust::raw_pointer_cast ( &(ududx[0]) ),
-			*vdudy_r	= thrust::raw_pointer_cast ( &(vdudy[0]) ),
-			*udvdx_r	= thrust::raw_pointer_cast ( &(udvdx[0]) ),
-			*vdvdy_r	= thrust::raw_pointer_cast ( &(vdvdy[0]) ),
-			*x1_r = thrust::raw_pointer_cast ( &(x1[0]) ),
-			*x2_r = thrust::raw_pointer_cast ( &(x2[0]) ),
-			*x3_r = thrust::raw_pointer_cast ( &(x3[0]) ),
-			*x4_r = thrust::raw_pointer_cast ( &(x4[0]) ),
-			*y1_r = thrust::raw_pointer_cast ( &(y1[0]) ),
-			*y2_r = thrust::raw_pointer_cast ( &(y2[0]) ),
-			*y3_r = thrust::raw_pointer_cast ( &(y3[0]) ),
-			*y4_r = thrust::raw_pointer_cast ( &(y4[0]) ),
-			*q1_r = thrust::raw_pointer_cast ( &(q1[0]) ),
-			*q2_r = thrust::raw_pointer_cast ( &(q2[0]) ),
-			*q3_r = thrust::raw_pointer_cast ( &(q3[0]) ),
-			*q4_r = thrust::raw_pointer_cast ( &(q4[0]) ),
-			*image_point_u_r = thrust::raw_pointer_cast( &(image_point_u[0]) );
-
-	int 	*ghostTagsP_r		= thrust::raw_pointer_cast ( &(ghostTagsP[0]) ),
-			*hybridTagsP_r		= thrust::raw_pointer_cast ( &(hybridTagsP[0]) ),
-			*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) ),
-			*hybridTagsUV_r		= thrust::raw_pointer_cast ( &(hybridTagsUV[0]) ),
-			*index1_r = thrust::raw_pointer_cast ( &(index1[0]) ),
-			*index2_r = thrust::raw_pointer_cast ( &(index2[0]) ),
-			*index3_r = thrust::raw_pointer_cast ( &(index3[0]) ),
-			*index4_r = thrust::raw_pointer_cast ( &(index4[0]) );
-			
-	bool	*q1flag_r = thrust::raw_pointer_cast ( &(q1flag[0]) ),
-			*q2flag_r = thrust::raw_pointer_cast ( &(q2flag[0]) ),
-			*q3flag_r = thrust::raw_pointer_cast ( &(q3flag[0]) ),
-			*q4flag_r = thrust::raw_pointer_cast ( &(q4flag[0]) );
-	
-	double	dt = (*paramDB)["simulation"]["dt"].get<double>();
+			*uhat_r	= thrust::raw_pointer_cast( &(uhat[0]) );
 
-	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
-		*j_start_r = thrust::raw_pointer_cast ( &(B.startJ[0]) ),
-		width = B.numCellsXHost, //flag this value is only moved to the host once (in B.initialise) if the body is moving too much this could break 
-		height=B.numCellsYHost;
-	
 	const int blocksize = 256;
-	dim3 gridsmall( int( (width*height-0.5)/blocksize ) +1, 1);
 	dim3 gridbig( int( (nx*ny-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
 
 	//rhsnormal
 	kernels::intermediatePressureNoBody<<<gridbig,block>>>(rhs2_r, uhat_r, ym_r, yp_r, xm_r, xp_r, dx_r, dy_r, nx, ny);
+
 	//rhsinterp
-	kernels::intermediatePressure_luo<<<gridbig,block>>>(rhs2_r, detA_r, hybridTagsP_r, alpha_r, stencilCoef_r,
-															xv_r, yu_r,
-															b11_r, b12_r, b13_r, b14_r, b21_r, b22_r, b23_r, b24_r,
-															b31_r, b32_r, b33_r, b34_r, b41_r, b42_r, b43_r, b44_r,
-															q1_p_r, q2_p_r, q3_p_r, q4_p_r,
-															q1flag_r, q2flag_r, q3flag_r, q4flag_r,
-															nx, ny);
+	if (numNodes > 0)
+	{
+		double	*alpha_r= thrust::raw_pointer_cast( &(alpha[0]) ),
+				*Ainv_r = thrust::raw_pointer_cast( &(Ainv[0]) ),
+				*xv_r	= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
+				*yu_r	= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
+				*stencilCoef_r	= thrust::raw_pointer_cast( &(stencilCoef[0]) ),
+				*q1_p_r = thrust::raw_pointer_cast ( &(q1_p[0]) ),
+				*q2_p_r = thrust::raw_pointer_cast ( &(q2_p[0]) ),
+				*q3_p_r = thrust::raw_pointer_cast ( &(q3_p[0]) ),
+				*q4_p_r = thrust::raw_pointer_cast ( &(q4_p[0]) );
+		int		*nodes_r = thrust::raw_pointer_cast ( &(hybridNodesP[0]) );
+		bool	*q1flag_r = thrust::raw_pointer_cast ( &(q1flag[0]) ),
+				*q2flag_r = thrust::raw_pointer_cast ( &(q2flag[0]) ),
+				*q3flag_r = thrust::raw_pointer_cast ( &(q3flag[0]) ),
+				*q4flag_r = thrust::raw_pointer_cast ( &(q4flag[0]) );
+
+		dim3 grid( int( (numNodes-0.5)/blocksize ) +1, 1);
+		kernels::hybridPressureRHS<<<grid,block>>>(rhs2_r, Ainv_r, alpha_r, stencilCoef_r, nodes_r, xv_r, yu_r,
+													q1_p_r, q2_p_r, q3_p_r, q4_p_r,
+													q1flag_r, q2flag_r, q3flag_r, q4flag_r,
+													numNodes, nx);
+	}
 	NavierStokesSolver::logger.stopTimer("RHS2");
 }
 
@@ -155,37 +82,21 @@ void luoIBM::generateLHS2()
 			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]) ),
 			*val_r	= thrust::raw_pointer_cast( &(LHS2.values[0]) ),
 			*alpha_r= thrust::raw_pointer_cast( &(alpha[0]) ),
-			*detA_r = thrust::raw_pointer_cast( &(detA[0]) ),
+			*Ainv_r = thrust::raw_pointer_cast( &(Ainv[0]) ),
 			*xv_r	= thrust::raw_pointer_cast( &(domInfo->xv[0]) ),
 			*yu_r	= thrust::raw_pointer_cast( &(domInfo->yu[0]) ),
-			*b11_r	= thrust::raw_pointer_cast( &(b11[0]) ),
-			*b12_r	= thrust::raw_pointer_cast( &(b12[0]) ),
-			*b13_r	= thrust::raw_pointer_cast( &(b13[0]) ),
-			*b14_r	= thrust::raw_pointer_cast( &(b14[0]) ),
-			*b21_r	= thrust::raw_pointer_cast( &(b21[0]) ),
-			*b22_r	= thrust::raw_pointer_cast( &(b22[0]) ),
-			*b23_r	= thrust::raw_pointer_cast( &(b23[0]) ),
-			*b24_r	= thrust::raw_pointer_cast( &(b24[0]) ),
-			*b31_r	= thrust::raw_pointer_cast( &(b31[0]) ),
-			*b32_r	= thrust::raw_pointer_cast( &(b32[0]) ),
-			*b33_r	= thrust::raw_pointer_cast( &(b33[0]) ),
-			*b34_r	= thrust::raw_pointer_cast( &(b34[0]) ),
-			*b41_r	= thrust::raw_pointer_cast( &(b41[0]) ),
-			*b42_r	= thrust::raw_pointer_cast( &(b42[0]) ),
-			*b43_r	= thrust::raw_pointer_cast( &(b43[0]) ),
-			*b44_r	= thrust::raw_pointer_cast( &(b44[0]) ),
 			*interpCoef_r	= thrust::raw_pointer_cast( &(interpCoef[0]) ),
 			*stencilCoef_r	= thrust::raw_pointer_cast( &(stencilCoef[0]) );
 
 	int		*row_r	= thrust::raw_pointer_cast( &(LHS2.row_indices[0]) ),
 			*col_r	= thrust::raw_pointer_cast( &(LHS2.column_indices[0]) ),
-			*ghostTagsP_r		= thrust::raw_pointer_cast ( &(ghostTagsP[0]) ),
-			*hybridTagsP_r		= thrust::raw_pointer_cast ( &(hybridTagsP[0]) ),
 			*index1_r = thrust::raw_pointer_cast ( &(index1[0]) ),
 			*index2_r = thrust::raw_pointer_cast ( &(index2[0]) ),
 			*index3_r = thrust::raw_pointer_cast ( &(index3[0]) ),
 			*index4_r = thrust::raw_pointer_cast ( &(index4[0]) ),
 			*countD_r	= thrust::raw_pointer_cast( &(countD[0]) );
+
+	unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast ( &(cellTypeP[0]) );
 	
 	bool	*q1flag_r = thrust::raw_pointer_cast ( &(q1flag[0]) ),
 			*q2flag_r = thrust::raw_pointer_cast ( &(q2flag[0]) ),
@@ -201,274 +112,484 @@ void luoIBM::generateLHS2()
 	cusp::blas::fill(LHS2.column_indices,0);
 	cusp::blas::fill(LHS2.values,0);
 	kernels::LHS2_mid_luo<<<grid,block>>>(row_r, col_r, val_r, dx_r, dy_r, nx, ny, dt, countD_r, stencilCoef_r, interpCoef_r,
-											detA_r, hybridTagsP_r, ghostTagsP_r, alpha_r,
+											Ainv_r, cellTypeP_r, alpha_r,
 											xv_r, yu_r,
-											b11_r, b12_r, b13_r, b14_r, b21_r, b22_r, b23_r, b24_r,
-											b31_r, b32_r, b33_r, b34_r, b41_r, b42_r, b43_r, b44_r,
 											q1flag_r, q2flag_r, q3flag_r, q4flag_r,
 											index1_r,index2_r,index3_r,index4_r);
 	kernels::LHS2_BC<<<grid,block>>>(row_r, col_r, val_r, dx_r, dy_r, nx,ny,dt);
+	DS.invalidate();
 	logger.stopTimer("LHS2");
-	
-	logger.startTimer("Preconditioner");
-	//if (timeStep == 0 || iterationCount2 > 100)
-	{
-		//seems like we need to call this every turn due to the pressure interpolation?
-		PC.generate(LHS1,LHS2, (*paramDB)["velocitySolve"]["preconditioner"].get<preconditionerType>(), (*paramDB)["PoissonSolve"]["preconditioner"].get<preconditionerType>());
-	}
-	/*else if (iterationCount2 > 100)
-	{
-		//PC.update(LHS1, LHS2);
-	}*/
-	logger.stopTimer("Preconditioner");
 }
 
-void luoIBM::sizeLHS2()
+/*
+ * Brings the sorted LHS2 up to date, call after preRHS2 and only if LHS2 is stale
+ * If only the body moved and the tags changed at most once, the rows listed by the retag and the hybrid rows (their
+ * interpolation weights move with the body) are rewritten in place, otherwise LHS2 is assembled and sorted again
+ */
+void luoIBM::assembleLHS2()
+{
+	if (rowsListed(dependency::LHS2_MATRIX, dependency::TAGS_P, listedVersionP) && updateLHS2Rows())
+		return;
+	sizeLHS2();
+	generateLHS2();
+	logger.startTimer("sort LHS2");
+	LHS2.sort_by_row_and_column();
+	thrust::lower_bound(thrust::cuda::par(devicePool()), LHS2.row_indices.begin(), LHS2.row_indices.end(),
+						thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(LHS2RowStart.size()), LHS2RowStart.begin());
+	logger.stopTimer("sort LHS2");
+}
+
+/*
+ * Rewrites the changed rows of the sorted LHS2 in place, see assembleLHS2
+ * Returns false if a row has a different number of entries than before, LHS2 has to be assembled again then
+ */
+bool luoIBM::updateLHS2Rows()
 {
 	NavierStokesSolver::logger.startTimer("LHS2");
 	int nx = domInfo ->nx,
 		ny = domInfo ->ny;
 
-	int		*hybridTagsP_r		= thrust::raw_pointer_cast ( &(hybridTagsP[0]) ),
+	double	dt 		= (*paramDB)["simulation"]["dt"].get<double>(),
+			*dx_r	= thrust::raw_pointer_cast( &(domInfo->dx[0]) ),
+			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]) ),
+			*val_r	= thrust::raw_pointer_cast( &(LHS2.values[0]) ),
+			*alpha_r= thrust::raw_pointer_cast( &(alpha[0]) ),
+			*Ainv_r = thrust::raw_pointer_cast( &(Ainv[0]) ),
+			*xv_r	= thrust::raw_pointer_cast( &(domInfo->xv[0]) ),
+			*yu_r	= thrust::raw_pointer_cast( &(domInfo->yu[0]) ),
+			*stencilCoef_r	= thrust::raw_pointer_cast( &(stencilCoef[0]) );
+
+	int		*col_r	= thrust::raw_pointer_cast( &(LHS2.column_indices[0]) ),
+			*rowStart_r	= thrust::raw_pointer_cast( &(LHS2RowStart[0]) ),
+			*mismatch_r	= thrust::raw_pointer_cast( &(LHS2Mismatch[0]) ),
 			*index1_r = thrust::raw_pointer_cast ( &(index1[0]) ),
 			*index2_r = thrust::raw_pointer_cast ( &(index2[0]) ),
 			*index3_r = thrust::raw_pointer_cast ( &(index3[0]) ),
-			*index4_r = thrust::raw_pointer_cast ( &(index4[0]) ),
-			*countD_r	= thrust::raw_pointer_cast( &(countD[0]) );
-	
-	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
-		*j_start_r = thrust::raw_pointer_cast ( &(B.startJ[0]) ),
-		width = B.numCellsXHost, 
-		height=B.numCellsYHost;
+			*index4_r = thrust::raw_pointer_cast ( &(index4[0]) );
 
-	//calculate indices for extra nodes
-	cusp::blas::fill(countD,0);
-	const int blocksize = 256;
-	dim3 grid(1,1);
-	dim3 block(blocksize, 1);
+	unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast ( &(cellTypeP[0]) );
 
-	kernels::hybridPressureNodeCount<<<grid,block>>>(countD_r, index1_r, index2_r, index3_r, index4_r, hybridTagsP_r,
-								i_start_r, j_start_r, width, height, nx, ny);
-	//find max value
-	thrust::device_vector<int>::iterator iter = thrust::max_element(countD.begin(),countD.end());
-	unsigned int position = iter - countD.begin();
-	int max_val = *iter;
+	//the rows whose tags changed, then every hybrid row, a row in both lists is written twice with the same values
+	int numLists = 0,
+		length[2];
+	int *lists[2];
+	if (versions.changesSince(dependency::LHS2_MATRIX, dependency::TAGS_P) > 0)
+	{
+		lists[numLists] = thrust::raw_pointer_cast( &(changedRowsP[0]) );
+		length[numLists++] = listedRowsP;
+	}
+	if (hybridNodesP.size() > 0)
+	{
+		lists[numLists] = thrust::raw_pointer_cast( &(hybridNodesP[0]) );
+		length[numLists++] = hybridNodesP.size();
+	}
 
-	LHS2.resize(nx*ny, nx*ny, nx*ny*5-nx*2-ny*2+max_val);
+	const int blocksize = 256;
+	dim3 block(blocksize, 1);
+	cusp::blas::fill(LHS2Mismatch, 0);
+	for (int l=0; l<numLists; l++)
+	{
+		dim3 grid( int( (length[l]-0.5)/blocksize ) +1, 1);
+		kernels::LHS2_rows_luo<<<grid,block>>>(col_r, val_r, rowStart_r, lists[l], length[l], mismatch_r,
+												dx_r, dy_r, nx, ny, dt, stencilCoef_r,
+												Ainv_r, cellTypeP_r, alpha_r, xv_r, yu_r,
+												index1_r, index2_r, index3_r, index4_r);
+	}
+	DS.invalidate();
 	logger.stopTimer("LHS2");
+	return LHS2Mismatch[0] == 0;
 }
 
-void luoIBM::interpPGN()
+/*
+ * Brings the preconditioners up to date with LHS1 and LHS2, call after LHS2 has been sorted and only if one of them was rebuilt
+ * A moving body changes LHS2 every step, but only by a few rows. A full setup is only
+ * done when the poisson solve slows down, otherwise the preconditioners are updated (for AMG this
+ * keeps the aggregates, P and R and only recomputes the coarse operators)
+ */
+void luoIBM::updatePreconditioners()
 {
-	logger.startTimer("P interp");
-	double	*u_r 		= thrust::raw_pointer_cast ( &(u[0]) ),
-			*pressure_r 	= thrust::raw_pointer_cast ( &(pressure[0]) ),
-			*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
-			*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
-			*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
-			*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
-			*body_intercept_p_x_r = thrust::raw_pointer_cast( &(body_intercept_p_x[0]) ),
-			*body_intercept_p_y_r = thrust::raw_pointer_cast( &(body_intercept_p_y[0]) ),
-			*body_intercept_p_r = thrust::raw_pointer_cast( &(body_intercept_p[0]) ),
-			*image_point_p_x_r = thrust::raw_pointer_cast( &(image_point_p_x[0]) ),
-			*image_point_p_y_r = thrust::raw_pointer_cast( &(image_point_p_y[0]) ),
-			*uB0_r		= thrust::raw_pointer_cast ( &(B.uBk[0]) ),
-			*vB0_r		= thrust::raw_pointer_cast ( &(B.vBk[0]) ),
-			*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
-			*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),
-			*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),
-			*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) );
-
-	double 	*x1_p_r = thrust::raw_pointer_cast ( &(x1_p[0]) ),
-			*x2_p_r = thrust::raw_pointer_cast ( &(x2_p[0]) ),
-			*x3_p_r = thrust::raw_pointer_cast ( &(x3_p[0]) ),
-			*x4_p_r = thrust::raw_pointer_cast ( &(x4_p[0]) ),
-			*y1_p_r = thrust::raw_pointer_cast ( &(y1_p[0]) ),
-			*y2_p_r = thrust::raw_pointer_cast ( &(y2_p[0]) ),
-			*y3_p_r = thrust::raw_pointer_cast ( &(y3_p[0]) ),
-			*y4_p_r = thrust::raw_pointer_cast ( &(y4_p[0]) ),
-			*q1_p_r = thrust::raw_pointer_cast ( &(q1_p[0]) ),
-			*q2_p_r = thrust::raw_pointer_cast ( &(q2_p[0]) ),
-			*q3_p_r = thrust::raw_pointer_cast ( &(q3_p[0]) ),
-			*q4_p_r = thrust::raw_pointer_cast ( &(q4_p[0]) ),
-			*a0_r	= thrust::raw_pointer_cast ( &(a0[0]) ),
-			*a1_r	= thrust::raw_pointer_cast ( &(a1[0]) ),
-			*a2_r	= thrust::raw_pointer_cast ( &(a2[0]) ),
-			*a3_r	= thrust::raw_pointer_cast ( &(a3[0]) ),
-			*dudt_r	= thrust::raw_pointer_cast ( &(dudt[0]) ),
-			*dvdt_r	= thrust::raw_pointer_cast ( &(dvdt[0]) ),
-			*ududx_r	= thrust::raw_pointer_cast ( &(ududx[0]) ),
-			*vdudy_r	= thrust::raw_pointer_cast ( &(vdudy[0]) ),
-			*udvdx_r	= thrust::raw_pointer_cast ( &(udvdx[0]) ),
-			*vdvdy_r	= thrust::raw_pointer_cast ( &(vdvdy[0]) );
-
-	int 	*ghostTagsP_r		= thrust::raw_pointer_cast ( &(ghostTagsP[0]) );
+	logger.startTimer("Preconditioner");
+	cusp::coo_matrix<int, double, cusp::device_memory> &A = reducedPoisson ? LHS2r : LHS2;
+	//the AMG hierarchy can only be updated if the number of unknowns didn't change
+	if (PC.degraded(iterationCount2) || (int)A.num_rows != numUnknownsPC)
+	{
+		PC.generate(LHS1, A, (*paramDB)["velocitySolve"]["preconditioner"].get<preconditionerType>(), (*paramDB)["PoissonSolve"]["preconditioner"].get<preconditionerType>());
+		numUnknownsPC = A.num_rows;
+	}
+	else
+		PC.update(LHS1, A);
+	versions.built(dependency::PRECONDITIONER);
+	logger.stopTimer("Preconditioner");
+}
 
-	int nx = domInfo ->nx,
-		ny = domInfo ->ny,
-		width_i = B.numCellsXHost, //flag this value is only moved to the host once (in B.initialise) if the body is moving too much this could break 
-		height_j=B.numCellsYHost;  //this is done because we need the value on the host to calculate the grid size, but copying it to the host every TS is expensive
-	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
-		*j_start_r = thrust::raw_pointer_cast ( &(B.startJ[0]) );
-	double dt = (*paramDB)["simulation"]["dt"].get<double>();
+/*
+ * Builds the reduced poisson system LHS2r from the sorted LHS2, call after LHS2 has been sorted
+ * The solid pressure nodes are not used after the solve, so their rows and columns are dropped. They are eliminated
+ * exactly, see eliminateSolidNodes, so the reduced system gives the same active pressures as the full one.
+ * Does nothing unless PoissonSolve: reducedSystem is set.
+ */
+void luoIBM::reducePoisson()
+{
+	if (!reducedPoisson)
+		return;
+	logger.startTimer("LHS2");
+	int numP = domInfo->nx * domInfo->ny,
+		numEntries = LHS2.num_entries;
+
+	//number the active nodes in order
+	int numActive = thrust::count_if(thrust::cuda::par(devicePool()), cellTypeP.begin(), cellTypeP.end(), kernels::lacksCellType(cellType::SOLID));
+	activeP.resize(numActive);
+	thrust::copy_if(thrust::cuda::par(devicePool()), thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(numP),
+					cellTypeP.begin(), activeP.begin(), kernels::lacksCellType(cellType::SOLID));
+	cusp::blas::fill(compactIndexP, -1);
+	thrust::scatter(thrust::cuda::par(devicePool()), thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(numActive),
+					activeP.begin(), compactIndexP.begin());
+	if ((*paramDB)["PoissonSolve"]["solver"].get<std::string>() == "DIRECT")
+	{
+		activeP_h.resize(numActive);
+		thrust::copy(activeP.begin(), activeP.begin()+numActive, activeP_h.begin());
+	}
+
+	//copy the entries between two active nodes
+	reduceKeep.resize(numEntries);
+	reduceOffset.resize(numEntries);
+	int *keep_r		= thrust::raw_pointer_cast( &(reduceKeep[0]) ),
+		*offset_r	= thrust::raw_pointer_cast( &(reduceOffset[0]) ),
+		*row_r		= thrust::raw_pointer_cast( &(LHS2.row_indices[0]) ),
+		*col_r		= thrust::raw_pointer_cast( &(LHS2.column_indices[0]) ),
+		*compact_r	= thrust::raw_pointer_cast( &(compactIndexP[0]) );
+	double	*val_r	= thrust::raw_pointer_cast( &(LHS2.values[0]) );
 
 	const int blocksize = 256;
-	dim3 grid( int( (width_i*height_j-0.5)/blocksize ) +1, 1);
+	dim3 grid( int( (numEntries-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
 
-	kernels::interpolatePressureToGhostNode<<<grid,block>>>(pressure_r, u_r, ghostTagsP_r, bx_r, by_r,
-									uB_r, uB0_r, vB_r, vB0_r, yu_r, yv_r, xu_r, xv_r,
-									body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r,  body_intercept_p_r,
-									i_start_r, j_start_r, width_i, nx, ny, dt, B.totalPoints,
-									dudt_r,ududx_r,dvdt_r,vdudy_r,udvdx_r,vdvdy_r,
-									a0_r, a1_r, a2_r, a3_r,
-									x1_p_r, x2_p_r, x3_p_r, x4_p_r, y1_p_r, y2_p_r, y3_p_r, y4_p_r, q1_p_r, q2_p_r, q3_p_r, q4_p_r);
-	logger.stopTimer("P interp");
+	kernels::reduce_LHS2_count<<<grid,block>>>(keep_r, row_r, col_r, compact_r, numEntries);
+	int lastKeep = reduceKeep[numEntries-1];
+	thrust::exclusive_scan(thrust::cuda::par(devicePool()), reduceKeep.begin(), reduceKeep.end(), reduceOffset.begin());
+	int numKept = reduceOffset[numEntries-1] + lastKeep;
+
+	LHS2r.resize(numActive, numActive, numKept);
+	int *rowR_r	= thrust::raw_pointer_cast( &(LHS2r.row_indices[0]) ),
+		*colR_r	= thrust::raw_pointer_cast( &(LHS2r.column_indices[0]) );
+	double	*valR_r	= thrust::raw_pointer_cast( &(LHS2r.values[0]) );
+	kernels::reduce_LHS2<<<grid,block>>>(rowR_r, colR_r, valR_r, row_r, col_r, val_r, keep_r, offset_r, compact_r, numEntries);
+
+	rhs2r.resize(numActive);
+	pressureR.resize(numActive);
+	eliminateSolidNodes();
+	logger.stopTimer("LHS2");
 }
 
-void luoIBM::preRHS2()
+/*
+ * Takes the Schur complement of the solid block of LHS2: LHS2r = A_aa - A_as inv(A_ss) A_sa, where a are the active and
+ * s the solid pressure nodes. Only the active nodes next to a body couple to its solid nodes, so the correction is a
+ * dense block over those nodes. A_ss is factorised on the host with the direct solver and inv(A_ss) A_sa is found one
+ * column at a time. The right hand side gets the matching correction every step, see correctReducedRHS2.
+ */
+void luoIBM::eliminateSolidNodes()
 {
-	NavierStokesSolver::logger.startTimer("RHS2");
+	int nx = domInfo->nx,
+		ny = domInfo->ny,
+		numP = nx*ny;
+
+	cusp::coo_matrix<int, double, cusp::host_memory> A_h = LHS2;
+	cusp::array1d<int, cusp::host_memory> compact_h = compactIndexP;
+
+	//number the solid nodes in order
+	std::vector<int> solidIndex(numP, -1);
+	solidP_h.clear();
+	for (int ip=0; ip<numP; ip++)
+		if (compact_h[ip] < 0)
+		{
+			solidIndex[ip] = solidP_h.size();
+			solidP_h.push_back(ip);
+		}
+	int numSolid = solidP_h.size();
+	schurRows_h.clear();
+	schurRowStart_h.assign(1, 0);
+	schurSolid_h.clear();
+	schurValue_h.clear();
+	if (numSolid == 0)
+		return;
+
+	//split the entries that touch a solid node into A_ss, A_as (LHS2 is sorted, so by row) and A_sa (gathered by column)
+	std::vector<int> ssRow, ssCol, columnOf(LHS2r.num_rows, -1), saColumn, saStart, saSolid;
+	std::vector<double> ssVal, saVal;
+	std::vector< std::vector<int> > saEntries;
+	for (size_t p=0; p<A_h.num_entries; p++)
+	{
+		int r	= A_h.row_indices[p],
+			c	= A_h.column_indices[p],
+			rs	= solidIndex[r],
+			cs	= solidIndex[c];
+		double v = A_h.values[p];
+		if (rs >= 0 && cs >= 0)
+		{
+			ssRow.push_back(rs);
+			ssCol.push_back(cs);
+			ssVal.push_back(v);
+		}
+		else if (cs >= 0)
+		{
+			if (schurRows_h.empty() || schurRows_h.back() != compact_h[r])
+			{
+				if (!schurRows_h.empty())
+					schurRowStart_h.push_back(schurSolid_h.size());
+				schurRows_h.push_back(compact_h[r]);
+			}
+			schurSolid_h.push_back(cs);
+			schurValue_h.push_back(v);
+		}
+		else if (rs >= 0)
+		{
+			int j = compact_h[c];
+			if (columnOf[j] < 0)
+			{
+				columnOf[j] = saColumn.size();
+				saColumn.push_back(j);
+				saEntries.push_back(std::vector<int>());
+			}
+			saEntries[columnOf[j]].push_back(saSolid.size());
+			saSolid.push_back(rs);
+			saVal.push_back(v);
+		}
+	}
+	schurRowStart_h.push_back(schurSolid_h.size());
 
-	int nx = NavierStokesSolver::domInfo ->nx,
-		ny = NavierStokesSolver::domInfo ->ny;
-
-	//variables related to the grid
-	double	*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
-			*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),	
-			*uB0_r		= thrust::raw_pointer_cast ( &(B.uBk[0]) ),
-			*vB0_r		= thrust::raw_pointer_cast ( &(B.vBk[0]) ),
-			*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),
-			*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) ),
-			*dx_r	= thrust::raw_pointer_cast( &(domInfo->dx[0]) ),
-			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]) ),
-			*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
-			*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
-			*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
-			*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
-			*ym_r	= thrust::raw_pointer_cast( &(bc[YMINUS][0]) ),
-			*yp_r	= thrust::raw_pointer_cast( &(bc[YPLUS][0]) ),
-			*xm_r	= thrust::raw_pointer_cast( &(bc[XMINUS][0]) ),
-			*xp_r	= thrust::raw_pointer_cast( &(bc[XPLUS][0]) );
+	cusp::coo_matrix<int, double, cusp::host_memory> Ass(numSolid, numSolid, ssVal.size());
+	for (size_t p=0; p<ssVal.size(); p++)
+	{
+		Ass.row_indices[p]		= ssRow[p];
+		Ass.column_indices[p]	= ssCol[p];
+		Ass.values[p]			= ssVal[p];
+	}
+	solidSolver.factorise(Ass, nx, ny, &solidP_h);
+
+	//the correction - A_as inv(A_ss) A_sa, one column of A_sa at a time, added to the entries of LHS2r keyed by row*n+column
+	cusp::coo_matrix<int, double, cusp::host_memory> R_h = LHS2r;
+	long long n = R_h.num_cols;
+	std::vector< std::pair<long long, double> > entries(R_h.num_entries);
+	for (size_t p=0; p<R_h.num_entries; p++)
+		entries[p] = std::make_pair(R_h.row_indices[p]*n + R_h.column_indices[p], R_h.values[p]);
+	schurWork_h.resize(numSolid);
+	int numRows = schurRows_h.size();
+	for (size_t j=0; j<saColumn.size(); j++)
+	{
+		std::fill(schurWork_h.begin(), schurWork_h.end(), 0.0);
+		for (size_t e=0; e<saEntries[j].size(); e++)
+			schurWork_h[saSolid[saEntries[j][e]]] = saVal[saEntries[j][e]];
+		solidSolver.solve(&schurWork_h[0], &schurWork_h[0]);
+		for (int k=0; k<numRows; k++)
+		{
+			double sum = 0;
+			for (int p=schurRowStart_h[k]; p<schurRowStart_h[k+1]; p++)
+				sum += schurValue_h[p]*schurWork_h[schurSolid_h[p]];
+			if (sum != 0)
+				entries.push_back(std::make_pair(schurRows_h[k]*n + saColumn[j], -sum));
+		}
+	}
 
-	//other variables
-	double	*alpha_r= thrust::raw_pointer_cast( &(alpha[0]) ),
-			*detA_r = thrust::raw_pointer_cast( &(detA[0]) ),
-			*rhs2_r	= thrust::raw_pointer_cast( &(rhs2[0]) ),
-			*uhat_r	= thrust::raw_pointer_cast( &(uhat[0]) ),
-			*u_r 		= thrust::raw_pointer_cast ( &(u[0]) );
-
-	//variables used for interpolation
-	double 	*body_intercept_p_x_r = thrust::raw_pointer_cast( &(body_intercept_p_x[0]) ),
-			*body_intercept_p_y_r = thrust::raw_pointer_cast( &(body_intercept_p_y[0]) ),
-			*image_point_p_x_r = thrust::raw_pointer_cast( &(image_point_p_x[0]) ),
-			*image_point_p_y_r = thrust::raw_pointer_cast( &(image_point_p_y[0]) ),
-			*body_intercept_x_r = thrust::raw_pointer_cast( &(body_intercept_x[0]) ),
-			*body_intercept_y_r = thrust::raw_pointer_cast( &(body_intercept_y[0]) ),
-			*image_point_x_r = thrust::raw_pointer_cast( &(image_point_x[0]) ),
-			*image_point_y_r = thrust::raw_pointer_cast( &(image_point_y[0]) ),
-			*x1_p_r = thrust::raw_pointer_cast ( &(x1_p[0]) ),
-			*x2_p_r = thrust::raw_pointer_cast ( &(x2_p[0]) ),
-			*x3_p_r = thrust::raw_pointer_cast ( &(x3_p[0]) ),
-			*x4_p_r = thrust::raw_pointer_cast ( &(x4_p[0]) ),
-			*y1_p_r = thrust::raw_pointer_cast ( &(y1_p[0]) ),
-			*y2_p_r = thrust::raw_pointer_cast ( &(y2_p[0]) ),
-			*y3_p_r = thrust::raw_pointer_cast ( &(y3_p[0]) ),
-			*y4_p_r = thrust::raw_pointer_cast ( &(y4_p[0]) ),
-			*q1_p_r = thrust::raw_pointer_cast ( &(q1_p[0]) ),
-			*q2_p_r = thrust::raw_pointer_cast ( &(q2_p[0]) ),
-			*q3_p_r = thrust::raw_pointer_cast ( &(q3_p[0]) ),
-			*q4_p_r = thrust::raw_pointer_cast ( &(q4_p[0]) ),
-			*b11_r	= thrust::raw_pointer_cast( &(b11[0]) ),
-			*b12_r	= thrust::raw_pointer_cast( &(b12[0]) ),
-			*b13_r	= thrust::raw_pointer_cast( &(b13[0]) ),
-			*b14_r	= thrust::raw_pointer_cast( &(b14[0]) ),
-			*b21_r	= thrust::raw_pointer_cast( &(b21[0]) ),
-			*b22_r	= thrust::raw_pointer_cast( &(b22[0]) ),
-			*b23_r	= thrust::raw_pointer_cast( &(b23[0]) ),
-			*b24_r	= thrust::raw_pointer_cast( &(b24[0]) ),
-			*b31_r	= thrust::raw_pointer_cast( &(b31[0]) ),
-			*b32_r	= thrust::raw_pointer_cast( &(b32[0]) ),
-			*b33_r	= thrust::raw_pointer_cast( &(b33[0]) ),
-			*b34_r	= thrust::raw_pointer_cast( &(b34[0]) ),
-			*b41_r	= thrust::raw_pointer_cast( &(b41[0]) ),
-			*b42_r	= thrust::raw_pointer_cast( &(b42[0]) ),
-			*b43_r	= thrust::raw_pointer_cast( &(b43[0]) ),
-			*b44_r	= thrust::raw_pointer_cast( &(b44[0]) );
-
-	//variables related to the uhat interpolation
-	double	*dudt_r	= thrust::raw_pointer_cast ( &(dudt[0]) ),
-			*dvdt_r	= thrust::raw_pointer_cast ( &(dvdt[0]) ),
-			*ududx_r	= thrust::raw_pointer_cast ( &(ududx[0]) ),
-			*vdudy_r	= thrust::raw_pointer_cast ( &(vdudy[0]) ),
-			*udvdx_r	= thrust::raw_pointer_cast ( &(udvdx[0]) ),
-			*vdvdy_r	= thrust::raw_pointer_cast ( &(vdvdy[0]) ),
-			*x1_r = thrust::raw_pointer_cast ( &(x1[0]) ),
-			*x2_r = thrust::raw_pointer_cast ( &(x2[0]) ),
-			*x3_r = thrust::raw_pointer_cast ( &(x3[0]) ),
-			*x4_r = thrust::raw_pointer_cast ( &(x4[0]) ),
-			*y1_r = thrust::raw_pointer_cast ( &(y1[0]) ),
-			*y2_r = thrust::raw_pointer_cast ( &(y2[0]) ),
-			*y3_r = thrust::raw_pointer_cast ( &(y3[0]) ),
-			*y4_r = thrust::raw_pointer_cast ( &(y4[0]) ),
-			*q1_r = thrust::raw_pointer_cast ( &(q1[0]) ),
-			*q2_r = thrust::raw_pointer_cast ( &(q2[0]) ),
-			*q3_r = thrust::raw_pointer_cast ( &(q3[0]) ),
-			*q4_r = thrust::raw_pointer_cast ( &(q4[0]) ),
-			*image_point_u_r = thrust::raw_pointer_cast( &(image_point_u[0]) );
-
-	int 	*ghostTagsP_r		= thrust::raw_pointer_cast ( &(ghostTagsP[0]) ),
-			*hybridTagsP_r		= thrust::raw_pointer_cast ( &(hybridTagsP[0]) ),
-			*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) ),
-			*hybridTagsUV_r		= thrust::raw_pointer_cast ( &(hybridTagsUV[0]) ),
-			*index1_r = thrust::raw_pointer_cast ( &(index1[0]) ),
-			*index2_r = thrust::raw_pointer_cast ( &(index2[0]) ),
-			*index3_r = thrust::raw_pointer_cast ( &(index3[0]) ),
-			*index4_r = thrust::raw_pointer_cast ( &(index4[0]) );
+	//sort the entries and add up the ones in the same place
+	std::sort(entries.begin(), entries.end());
+	int numMerged = 0;
+	for (size_t q=0; q<entries.size(); q++)
+		if (q == 0 || entries[q].first != entries[q-1].first)
+			numMerged++;
+	R_h.resize(LHS2r.num_rows, LHS2r.num_cols, numMerged);
+	int m = -1;
+	for (size_t q=0; q<entries.size(); q++)
+	{
+		if (q == 0 || entries[q].first != entries[q-1].first)
+		{
+			m++;
+			R_h.row_indices[m]		= entries[q].first / n;
+			R_h.column_indices[m]	= entries[q].first % n;
+			R_h.values[m]			= 0;
+		}
+		R_h.values[m] += entries[q].second;
+	}
+	LHS2r = R_h;
 
-	bool	*q1flag_r = thrust::raw_pointer_cast ( &(q1flag[0]) ),
-			*q2flag_r = thrust::raw_pointer_cast ( &(q2flag[0]) ),
-			*q3flag_r = thrust::raw_pointer_cast ( &(q3flag[0]) ),
-			*q4flag_r = thrust::raw_pointer_cast ( &(q4flag[0]) );
+	solidP = solidP_h;
+	schurRows = schurRows_h;
+	rhs2Solid.resize(numSolid);
+	schurCorrection.resize(numRows);
+}
+
+/*
+ * rhs2r -= A_as inv(A_ss) b_s, the part of the right hand side that the elimination of the solid nodes moves onto the ghost rows
+ */
+void luoIBM::correctReducedRHS2()
+{
+	int numSolid = solidP_h.size(),
+		numRows = schurRows_h.size();
+	if (numSolid == 0 || numRows == 0)
+		return;
+	thrust::gather(thrust::cuda::par(devicePool()), solidP.begin(), solidP.end(), rhs2.begin(), rhs2Solid.begin());
+	cusp::array1d<double, cusp::host_memory> b_s = rhs2Solid;
+	solidSolver.solve(&b_s[0], &b_s[0]);
+
+	cusp::array1d<double, cusp::host_memory> correction(numRows);
+	for (int k=0; k<numRows; k++)
+	{
+		double sum = 0;
+		for (int p=schurRowStart_h[k]; p<schurRowStart_h[k+1]; p++)
+			sum += schurValue_h[p]*b_s[schurSolid_h[p]];
+		correction[k] = sum;
+	}
+	schurCorrection = correction;
+	thrust::transform(thrust::cuda::par(devicePool()),
+					  thrust::make_permutation_iterator(rhs2r.begin(), schurRows.begin()),
+					  thrust::make_permutation_iterator(rhs2r.begin(), schurRows.end()),
+					  schurCorrection.begin(),
+					  thrust::make_permutation_iterator(rhs2r.begin(), schurRows.begin()),
+					  thrust::minus<double>());
+}
+
+/*
+ * Solves the reduced poisson system if PoissonSolve: reducedSystem is set, otherwise the full one
+ * The right hand side and the initial guess are gathered from rhs2 and pressure, the solution is scattered back
+ * and the solid pressure nodes, which are not part of the reduced system, are set to zero.
+ */
+void luoIBM::solvePoisson()
+{
+	if (!reducedPoisson)
+	{
+		NavierStokesSolver::solvePoisson();
+		return;
+	}
+	logger.startTimer("solvePoisson");
+	thrust::gather(thrust::cuda::par(devicePool()), activeP.begin(), activeP.end(), rhs2.begin(), rhs2r.begin());
+	thrust::gather(thrust::cuda::par(devicePool()), activeP.begin(), activeP.end(), pressure.begin(), pressureR.begin());
+	correctReducedRHS2();
 
-	double	dt = (*paramDB)["simulation"]["dt"].get<double>();
+	solvePoissonSystem(LHS2r, pressureR, rhs2r, &activeP_h);
 
-	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
-		*j_start_r = thrust::raw_pointer_cast ( &(B.startJ[0]) ),
-		width = B.numCellsXHost, //flag this value is only moved to the host once (in B.initialise) if the body is moving too much this could break 
-		height=B.numCellsYHost;
+	cusp::blas::fill(pressure, 0);
+	thrust::scatter(thrust::cuda::par(devicePool()), pressureR.begin(), pressureR.end(), activeP.begin(), pressure.begin());
+	logger.stopTimer("solvePoisson");
+}
 
-	const int blocksize = 256;
-	dim3 gridsmall( int( (width*height-0.5)/blocksize ) +1, 1);
-	dim3 gridbig( int( (nx*ny-0.5)/blocksize ) +1, 1);
-	dim3 block(blocksize, 1);
+/*
+ * Sizes LHS2 for the extra interpolation entries of the hybrid nodes
+ * The per node counts from preRHS2 are scanned into the offset of each node's extra entries, stored in countD
+ */
+void luoIBM::sizeLHS2()
+{
+	NavierStokesSolver::logger.startTimer("LHS2");
+	int nx = domInfo ->nx,
+		ny = domInfo ->ny,
+		numNodes = hybridNodesP.size(),
+		numExtra = 0;
+
+	if (numNodes > 0)
+	{
+		int last = hybridCountP[numNodes-1];
+		thrust::exclusive_scan(thrust::cuda::par(devicePool()), hybridCountP.begin(), hybridCountP.end(), hybridCountP.begin());
+		numExtra = hybridCountP[numNodes-1] + last;
+		thrust::scatter(thrust::cuda::par(devicePool()), hybridCountP.begin(), hybridCountP.end(), hybridNodesP.begin(), countD.begin());
+	}
+
+	LHS2.resize(nx*ny, nx*ny, nx*ny*5-nx*2-ny*2+numExtra);
+	logger.stopTimer("LHS2");
+}
+
+void luoIBM::interpPGN()
+{
+	logger.startTimer("P interp");
+	int numNodes = ghostNodesP.size();
+	if (numNodes > 0)
+	{
+		double	*pressure_r 	= thrust::raw_pointer_cast ( &(pressure[0]) ),
+				*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
+				*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
+				*body_intercept_p_x_r = thrust::raw_pointer_cast( &(body_intercept_p_x[0]) ),
+				*body_intercept_p_y_r = thrust::raw_pointer_cast( &(body_intercept_p_y[0]) ),
+				*body_intercept_p_r = thrust::raw_pointer_cast( &(body_intercept_p[0]) ),
+				*image_point_p_x_r = thrust::raw_pointer_cast( &(image_point_p_x[0]) ),
+				*image_point_p_y_r = thrust::raw_pointer_cast( &(image_point_p_y[0]) ),
+				*uB0_r		= thrust::raw_pointer_cast ( &(B.uBk[0]) ),
+				*vB0_r		= thrust::raw_pointer_cast ( &(B.vBk[0]) ),
+				*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
+				*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),
+				*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),
+				*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) );
+
+		int		*nodes_r		= thrust::raw_pointer_cast ( &(ghostNodesP[0]) );
+		unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast ( &(cellTypeP[0]) );
+
+		double dt = (*paramDB)["simulation"]["dt"].get<double>();
+
+		const int blocksize = 256;
+		dim3 grid( int( (numNodes-0.5)/blocksize ) +1, 1);
+		dim3 block(blocksize, 1);
+
+		kernels::ghostPressure<<<grid,block>>>(pressure_r, body_intercept_p_r, nodes_r, cellTypeP_r,
+												bx_r, by_r, uB_r, uB0_r, vB_r, vB0_r, xv_r, yu_r,
+												body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r,
+												numNodes, domInfo->nx, domInfo->ny, dt, B.totalPoints);
+	}
+	logger.stopTimer("P interp");
+}
+
+void luoIBM::preRHS2()
+{
+	NavierStokesSolver::logger.startTimer("RHS2");
 
 	//interpolate uhat to the inside of the body
-	kernels::interpolateVelocityToGhostNodeX<<<gridsmall,block>>>(uhat_r, ghostTagsUV_r, bx_r, by_r, uB_r, yu_r, xu_r,
-																body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-																i_start_r, j_start_r, width, nx, ny,
-																x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r,image_point_u_r);
-	kernels::interpolateVelocityToGhostNodeY<<<gridsmall,block>>>(uhat_r, ghostTagsUV_r, bx_r, by_r, vB_r, yv_r, xv_r,
-																body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-																i_start_r, j_start_r, width, nx, ny,
-																x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r,image_point_u_r);
-	//get alpha
-	kernels::alpha_<<<gridsmall,block>>>(alpha_r, ghostTagsP_r, hybridTagsP_r, yu_r, xv_r, 
-											body_intercept_p_x_r, body_intercept_p_y_r, 
-											i_start_r, j_start_r, width, nx, ny);
-	//get prereqs for interpolation (detA, index, )
-	kernels::interpolate_P_HN_setup<<<gridsmall,block>>>(detA_r, hybridTagsP_r, bx_r, by_r,
-															uB_r, uB0_r, vB_r, vB0_r,
-															yu_r, xv_r,
-															body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r,
-															i_start_r, j_start_r, width, nx, ny, dt, B.totalPoints,
-															b11_r, b12_r, b13_r, b14_r, b21_r, b22_r, b23_r, b24_r,
-															b31_r, b32_r, b33_r, b34_r, b41_r, b42_r, b43_r, b44_r,
-															q1_p_r, q2_p_r, q3_p_r, q4_p_r,
-															q1flag_r, q2flag_r, q3flag_r, q4flag_r,
-															index1_r,index2_r,index3_r,index4_r,
-															x1_p_r, x2_p_r, x3_p_r, x4_p_r,
-															y1_p_r, y2_p_r, y3_p_r, y4_p_r,
-															dudt_r, ududx_r, vdudy_r, dvdt_r, udvdx_r, vdvdy_r);
+	interpolateToGhostNodes(uhat);
+
+	//alpha, the interpolation stencil and the number of extra LHS2 entries of each hybrid node
+	int numNodes = hybridNodesP.size();
+	if (numNodes > 0)
+	{
+		double	*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
+				*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),
+				*uB0_r		= thrust::raw_pointer_cast ( &(B.uBk[0]) ),
+				*vB0_r		= thrust::raw_pointer_cast ( &(B.vBk[0]) ),
+				*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),
+				*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) ),
+				*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
+				*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
+				*alpha_r	= thrust::raw_pointer_cast( &(alpha[0]) ),
+				*Ainv_r		= thrust::raw_pointer_cast( &(Ainv[0]) ),
+				*body_intercept_p_x_r = thrust::raw_pointer_cast( &(body_intercept_p_x[0]) ),
+				*body_intercept_p_y_r = thrust::raw_pointer_cast( &(body_intercept_p_y[0]) ),
+				*image_point_p_x_r = thrust::raw_pointer_cast( &(image_point_p_x[0]) ),
+				*image_point_p_y_r = thrust::raw_pointer_cast( &(image_point_p_y[0]) ),
+				*q1_p_r = thrust::raw_pointer_cast ( &(q1_p[0]) ),
+				*q2_p_r = thrust::raw_pointer_cast ( &(q2_p[0]) ),
+				*q3_p_r = thrust::raw_pointer_cast ( &(q3_p[0]) ),
+				*q4_p_r = thrust::raw_pointer_cast ( &(q4_p[0]) );
+
+		int		*nodes_r		= thrust::raw_pointer_cast ( &(hybridNodesP[0]) ),
+				*count_r		= thrust::raw_pointer_cast ( &(hybridCountP[0]) ),
+				*index1_r = thrust::raw_pointer_cast ( &(index1[0]) ),
+				*index2_r = thrust::raw_pointer_cast ( &(index2[0]) ),
+				*index3_r = thrust::raw_pointer_cast ( &(index3[0]) ),
+				*index4_r = thrust::raw_pointer_cast ( &(index4[0]) );
+
+		unsigned char	*cellTypeP_r	= thrust::raw_pointer_cast ( &(cellTypeP[0]) );
+
+		bool	*q1flag_r = thrust::raw_pointer_cast ( &(q1flag[0]) ),
+				*q2flag_r = thrust::raw_pointer_cast ( &(q2flag[0]) ),
+				*q3flag_r = thrust::raw_pointer_cast ( &(q3flag[0]) ),
+				*q4flag_r = thrust::raw_pointer_cast ( &(q4flag[0]) );
+
+		double	dt = (*paramDB)["simulation"]["dt"].get<double>();
+
+		const int blocksize = 256;
+		dim3 grid( int( (numNodes-0.5)/blocksize ) +1, 1);
+		dim3 block(blocksize, 1);
+
+		kernels::hybridPressureSetup<<<grid,block>>>(Ainv_r, alpha_r, count_r, nodes_r, cellTypeP_r,
+													bx_r, by_r, uB_r, uB0_r, vB_r, vB0_r, xv_r, yu_r,
+													body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r,
+													q1_p_r, q2_p_r, q3_p_r, q4_p_r,
+													q1flag_r, q2flag_r, q3flag_r, q4flag_r,
+													index1_r, index2_r, index3_r, index4_r,
+													numNodes, domInfo->nx, domInfo->ny, dt, B.totalPoints);
+	}
 	NavierStokesSolver::logger.stopTimer("RHS2");
-}
\ No newline at end of file
+}
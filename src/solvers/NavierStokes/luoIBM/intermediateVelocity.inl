@@ -10,7 +10,7 @@
 #include <solvers/NavierStokes/NavierStokes/kernels/LHS1.h> //lhs_bc
 #include <solvers/NavierStokes/FadlunModified/kernels/intermediateVelocity.h> //updateboundary
 #include <solvers/NavierStokes/luoIBM/kernels/biLinearInterpolation.h> //interpolate
-#include <solvers/NavierStokes/luoIBM/kernels/weight.h>//weighting function
+#include <solvers/NavierStokes/luoIBM/kernels/boundaryNodes.h>//weighting function
 
 void luoIBM::generateRHS1()
 {
@@ -29,9 +29,6 @@ void luoIBM::generateRHS1()
 			*distance_between_nodes_at_IB_r	= thrust::raw_pointer_cast( &(distance_between_nodes_at_IB[0]) ),
 			*uv_r	= thrust::raw_pointer_cast( &(uv[0]) );
 	
-	int	*hybridTagsUV_r	= thrust::raw_pointer_cast( &(hybridTagsUV[0]) ),
-		*ghostTagsUV_r	= thrust::raw_pointer_cast( &(ghostTagsUV[0]) );
-	
 	parameterDB  &db = *paramDB;
 	double	nu = db["flow"]["nu"].get<double>();
 	double	dt = db["simulation"]["dt"].get<double>();
@@ -67,7 +64,7 @@ void luoIBM::generateRHS1()
 	
 	logger.startTimer("RHS1 Setup");
 	//sum rhs components
-	kernels::generateRHS<<<dimGridUV,dimBlockUV>>>(rhs_r, L_r, Nold_r, N_r, u_r, bc1_r, dt, nx, ny);
+	kernels::generateRHS<<<dimGridUV,dimBlockUV>>>(rhs_r, L_r, Nold_r, N_r, u_r, bc1_r, dt, dtRatio, nx, ny);
 	logger.stopTimer("RHS1 Setup");
 }
 
@@ -102,8 +99,8 @@ void luoIBM::generateLHS1()
 			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]));
 
 	int 	*row_r				= thrust::raw_pointer_cast( &(LHS1.row_indices[0])),
-			*col_r				= thrust::raw_pointer_cast( &(LHS1.column_indices[0])),
-			*ghostTagsUV_r		= thrust::raw_pointer_cast( &(ghostTagsUV[0]) );
+			*col_r				= thrust::raw_pointer_cast( &(LHS1.column_indices[0]));
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast( &(cellTypeUV[0]) );
 
 	double	nu = (*paramDB)["flow"]["nu"].get<double>();
 	double	dt = (*paramDB)["simulation"]["dt"].get<double>();
@@ -116,8 +113,8 @@ void luoIBM::generateLHS1()
 	dim3 gridV( int( (nx*(ny-1)-0.5)/blocksize ) +1, 1);
 	dim3 blockV(blocksize, 1);
 
-	kernels::LHS1_mid_luo_X<<<gridU,blockU>>>(row_r, col_r, val_r, ghostTagsUV_r, dx_r, dy_r, dt, nu, nx, ny);//flag lhs1 mid luo is the same as lhs1 mid nobody from NS
-	kernels::LHS1_mid_luo_Y<<<gridV,blockV>>>(row_r, col_r, val_r, ghostTagsUV_r, dx_r, dy_r, dt, nu, nx, ny);
+	kernels::LHS1_mid_luo_X<<<gridU,blockU>>>(row_r, col_r, val_r, cellTypeUV_r, dx_r, dy_r, dt, nu, nx, ny);//flag lhs1 mid luo is the same as lhs1 mid nobody from NS
+	kernels::LHS1_mid_luo_Y<<<gridV,blockV>>>(row_r, col_r, val_r, cellTypeUV_r, dx_r, dy_r, dt, nu, nx, ny);
 
 	kernels::LHS_BC_X<<<gridU,blockU>>>(row_r, col_r, val_r, dx_r, dy_r, dt, nu, nx, ny);
 	kernels::LHS_BC_Y<<<gridV,blockV>>>(row_r, col_r, val_r, dx_r, dy_r, dt, nu, nx, ny);
@@ -125,115 +122,69 @@ void luoIBM::generateLHS1()
 	NavierStokesSolver::logger.stopTimer("LHS1");
 }
 
-void luoIBM::weightUhat()
+/*
+ * Reassembles the rows of LHS1 listed by the last retag that changed any, see refreshLHS1
+ */
+void luoIBM::updateLHS1Rows()
 {
-	logger.startTimer("weightUhat");
-	double	*uhat_r 	= thrust::raw_pointer_cast ( &(uhat[0]) ),
-			*ustar_r	= thrust::raw_pointer_cast ( &(ustar[0]) ),
-			*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
-			*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
-			*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
-			*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
-			*body_intercept_x_r = thrust::raw_pointer_cast( &(body_intercept_x[0]) ),
-			*body_intercept_y_r = thrust::raw_pointer_cast( &(body_intercept_y[0]) ),
-			*image_point_x_r = thrust::raw_pointer_cast( &(image_point_x[0]) ),
-			*image_point_y_r = thrust::raw_pointer_cast( &(image_point_y[0]) );
-	
-	int 	*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) ),
-			*hybridTagsUV_r		= thrust::raw_pointer_cast ( &(hybridTagsUV[0]) );
+	NavierStokesSolver::logger.startTimer("LHS1");
 
-	int nx = domInfo ->nx,
-		ny = domInfo ->ny,
-		width_i = B.numCellsXHost, //flag this value is only moved to the host once (in B.initialise) if the body is moving too much this could break 
-		height_j=B.numCellsYHost,  //this is done because we need the value on the host to calculate the grid size, but copying it to the host every TS is expensive
-		derp = B.numCellsX[0];
+	double 	*val_r	= thrust::raw_pointer_cast( &(LHS1.values[0])),
+			*dx_r	= thrust::raw_pointer_cast( &(domInfo->dx[0])),
+			*dy_r	= thrust::raw_pointer_cast( &(domInfo->dy[0]));
+
+	int 	*row_r	= thrust::raw_pointer_cast( &(LHS1.row_indices[0])),
+			*col_r	= thrust::raw_pointer_cast( &(LHS1.column_indices[0])),
+			*rows_r	= thrust::raw_pointer_cast( &(changedRowsUV[0]) );
+
+	double	nu = (*paramDB)["flow"]["nu"].get<double>();
+	double	dt = (*paramDB)["simulation"]["dt"].get<double>();
 
-	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
-		*j_start_r = thrust::raw_pointer_cast ( &(B.startJ[0]) );
 	const int blocksize = 256;
-	dim3 grid( int( (width_i*height_j-0.5)/blocksize ) +1, 1);
+	dim3 grid( int( (listedRowsUV-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
-	
-	kernels::weightX<<<grid,block>>>(uhat_r, ustar_r, ghostTagsUV_r, hybridTagsUV_r, yu_r, xu_r,
-									body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-									i_start_r, j_start_r, width_i, nx, ny);
-	kernels::weightY<<<grid,block>>>(uhat_r, ustar_r, ghostTagsUV_r, hybridTagsUV_r, yv_r, xv_r,
-									body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-									i_start_r, j_start_r, width_i, nx, ny);
+
+	kernels::LHS1_rows_luo<<<grid,block>>>(row_r, col_r, val_r, rows_r, listedRowsUV, dx_r, dy_r, dt, nu, domInfo->nx, domInfo->ny);
+
+	NavierStokesSolver::logger.stopTimer("LHS1");
+}
+
+void luoIBM::weightUhat()
+{
+	logger.startTimer("weightUhat");
+	int numNodes = hybridNodesUV.size();
+	if (numNodes > 0)
+	{
+		double	*uhat_r 	= thrust::raw_pointer_cast ( &(uhat[0]) ),
+				*ustar_r	= thrust::raw_pointer_cast ( &(ustar[0]) ),
+				*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
+				*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
+				*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
+				*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
+				*body_intercept_x_r = thrust::raw_pointer_cast( &(body_intercept_x[0]) ),
+				*body_intercept_y_r = thrust::raw_pointer_cast( &(body_intercept_y[0]) );
+
+		int		*nodes_r		= thrust::raw_pointer_cast ( &(hybridNodesUV[0]) );
+		unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast ( &(cellTypeUV[0]) );
+
+		const int blocksize = 256;
+		dim3 grid( int( (numNodes-0.5)/blocksize ) +1, 1);
+		dim3 block(blocksize, 1);
+
+		kernels::weightUhat<<<grid,block>>>(uhat_r, ustar_r, cellTypeUV_r, nodes_r, xu_r, yu_r, xv_r, yv_r,
+											body_intercept_x_r, body_intercept_y_r, numNodes, domInfo->nx, domInfo->ny);
+	}
 	logger.stopTimer("weightUhat");
 }
 
 void luoIBM::preRHS1Interpolation()
 {
 	logger.startTimer("RHS1 Interpolation");
-	double	*u_r 		= thrust::raw_pointer_cast ( &(u[0]) ),
-			*ustar_r	= thrust::raw_pointer_cast ( &(ustar[0]) ),
-			*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),//not sure if these are on the host or not
-			*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) ),
-			*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
-			*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),
-			*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
-			*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
-			*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
-			*xv_r		= thrust::raw_pointer_cast ( &(domInfo->xv[0]) ),
-			*body_intercept_x_r = thrust::raw_pointer_cast( &(body_intercept_x[0]) ),
-			*body_intercept_y_r = thrust::raw_pointer_cast( &(body_intercept_y[0]) ),
-			*image_point_x_r = thrust::raw_pointer_cast( &(image_point_x[0]) ),
-			*image_point_y_r = thrust::raw_pointer_cast( &(image_point_y[0]) );
-	
-	double	*x1_r = thrust::raw_pointer_cast ( &(x1[0]) ),
-			*x2_r = thrust::raw_pointer_cast ( &(x2[0]) ),
-			*x3_r = thrust::raw_pointer_cast ( &(x3[0]) ),
-			*x4_r = thrust::raw_pointer_cast ( &(x4[0]) ),
-			*y1_r = thrust::raw_pointer_cast ( &(y1[0]) ),
-			*y2_r = thrust::raw_pointer_cast ( &(y2[0]) ),
-			*y3_r = thrust::raw_pointer_cast ( &(y3[0]) ),
-			*y4_r = thrust::raw_pointer_cast ( &(y4[0]) ),
-			*q1_r = thrust::raw_pointer_cast ( &(q1[0]) ),
-			*q2_r = thrust::raw_pointer_cast ( &(q2[0]) ),
-			*q3_r = thrust::raw_pointer_cast ( &(q3[0]) ),
-			*q4_r = thrust::raw_pointer_cast ( &(q4[0]) ),
-			*image_point_u_r = thrust::raw_pointer_cast( &(image_point_u[0]) );
-	
-	int 	*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) ),
-			*hybridTagsUV_r		= thrust::raw_pointer_cast ( &(hybridTagsUV[0]) );
-		
-	parameterDB  &db = *paramDB;
-	double	nu = db["flow"]["nu"].get<double>();
-	double	dt = db["simulation"]["dt"].get<double>();
-
-	int nx = domInfo ->nx,
-		ny = domInfo ->ny,
-		//width_i = B.numCellsX[0],
-		//height_j = B.numCellsY[0];
-		width_i = B.numCellsXHost, //flag this value is only moved to the host once (in B.initialise) if the body is moving too much this could break 
-		height_j=B.numCellsYHost;		//this is done because we need the value on the host to calculate the grid size, but copying it to the host every TS is expensive
-	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
-		*j_start_r = thrust::raw_pointer_cast ( &(B.startJ[0]) );
-	
-	const int blocksize = 256;
-	dim3 grid( int( (width_i*height_j-0.5)/blocksize ) +1, 1);
-	dim3 block(blocksize, 1);
 	//interpolate velocity to image point and ghost node
-	kernels::interpolateVelocityToGhostNodeX<<<grid,block>>>(u_r, ghostTagsUV_r, bx_r, by_r, uB_r, yu_r, xu_r,
-													body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-													i_start_r, j_start_r, width_i, nx, ny,
-													x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r,image_point_u_r);
-	kernels::interpolateVelocityToGhostNodeY<<<grid,block>>>(u_r, ghostTagsUV_r, bx_r, by_r, vB_r, yv_r, xv_r,
-													body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-													i_start_r, j_start_r, width_i, nx, ny,
-													x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r,image_point_u_r);
+	interpolateToGhostNodes(u);
 	zeroVelocity();
 	//interpolate velocity to hybrid node
-	//zero ustar
-	kernels::interpolateVelocityToHybridNodeX<<<grid,block>>>(u_r, ustar_r, hybridTagsUV_r, bx_r, by_r, uB_r, yu_r, xu_r,
-													body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-													i_start_r, j_start_r, width_i, nx, ny,
-													x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r, image_point_u_r);
-	kernels::interpolateVelocityToHybridNodeY<<<grid,block>>>(u_r, ustar_r, hybridTagsUV_r, bx_r, by_r, vB_r, yv_r, xv_r,
-													body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-													i_start_r, j_start_r, width_i, nx, ny,
-													x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r, image_point_u_r);
+	interpolateToHybridNodes();
 	//testInterpX();
 	//testInterpY();
 	logger.stopTimer("RHS1 Interpolation");
@@ -242,11 +193,11 @@ void luoIBM::preRHS1Interpolation()
 void luoIBM::zeroVelocity()
 {
 	double	*u_r 				= thrust::raw_pointer_cast ( &(u[0]) );
-	int 	*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) );
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast ( &(cellTypeUV[0]) );
 	int nx = domInfo ->nx,
 		ny = domInfo ->ny;
 	const int blocksize = 256;
 	dim3 grid( int( (nx*(ny-1) + (nx-1)*ny-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
-	kernels::zeroInside<<<grid,block>>>(ghostTagsUV_r, u_r, nx*(ny-1) + (nx-1)*ny);
+	kernels::zeroInside<<<grid,block>>>(cellTypeUV_r, u_r, nx*(ny-1) + (nx-1)*ny);
 }
\ No newline at end of file
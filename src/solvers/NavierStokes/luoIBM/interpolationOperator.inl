@@ -0,0 +1,130 @@
+/***************************************************************************//**
+ * \file interpolationOperator.inl
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief builds and applies the precomputed interpolation to the ghost and hybrid velocity nodes
+ */
+
+#include <solvers/NavierStokes/luoIBM/kernels/interpolationOperator.h>
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
+#include <cusp/multiply.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/count.h>
+#include <thrust/copy.h>
+#include <thrust/sequence.h>
+
+/*
+ * Lists the indices of the nodes with any of the bits in mask in increasing order
+ * param types cellTypeUV or cellTypeP
+ * param mask cellType bits to look for
+ * param nodes resized to the number of tagged nodes
+ */
+void luoIBM::compactTags(cusp::array1d<unsigned char, cusp::device_memory> &types, unsigned char mask, cusp::array1d<int, cusp::device_memory> &nodes)
+{
+	int numNodes = thrust::count_if(thrust::cuda::par(devicePool()), types.begin(), types.end(), kernels::hasCellType(mask));
+	nodes.resize(numNodes);
+	if (numNodes == 0)
+		return;
+	thrust::copy_if(thrust::cuda::par(devicePool()), thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(types.size()),
+					types.begin(), nodes.begin(), kernels::hasCellType(mask));
+}
+
+/*
+ * Builds one interpolation operator for the ghost nodes and one for the hybrid nodes
+ * The weights only depend on the tags, image points and body intercepts, so this only has to be called after tagPoints
+ */
+void luoIBM::buildInterpolationOperators()
+{
+	logger.startTimer("Interpolation Operator");
+	buildInterpolationOperator(ghostInterp, ghostNodesUV, ghostBodyCoef, cellType::GHOST, false);
+	buildInterpolationOperator(hybridInterp, hybridNodesUV, hybridBodyCoef, cellType::HYBRID, true);
+	logger.stopTimer("Interpolation Operator");
+}
+
+/*
+ * param W the operator, one row per tagged node with four entries each
+ * param nodes velocity index of each row
+ * param bodyCoef coefficient of the body velocity for each row
+ * param mask cellType::GHOST or cellType::HYBRID
+ * param hybrid true for the hybrid nodes
+ */
+void luoIBM::buildInterpolationOperator(cusp::csr_matrix<int, double, cusp::device_memory> &W, cusp::array1d<int, cusp::device_memory> &nodes,
+										cusp::array1d<double, cusp::device_memory> &bodyCoef, unsigned char mask, bool hybrid)
+{
+	int nx = domInfo->nx,
+		ny = domInfo->ny,
+		numUV = (nx-1)*ny + nx*(ny-1);
+
+	//compact the tagged nodes into a list of rows
+	compactTags(cellTypeUV, mask, nodes);
+	int numRows = nodes.size();
+	bodyCoef.resize(numRows);
+	W.resize(numRows, numUV, 4*numRows);
+	if (numRows == 0)
+		return;
+	thrust::sequence(W.row_offsets.begin(), W.row_offsets.end(), 0, 4);
+
+	double	*val_r	= thrust::raw_pointer_cast( &(W.values[0]) ),
+			*bodyCoef_r	= thrust::raw_pointer_cast( &(bodyCoef[0]) ),
+			*xu_r	= thrust::raw_pointer_cast( &(domInfo->xu[0]) ),
+			*yu_r	= thrust::raw_pointer_cast( &(domInfo->yu[0]) ),
+			*xv_r	= thrust::raw_pointer_cast( &(domInfo->xv[0]) ),
+			*yv_r	= thrust::raw_pointer_cast( &(domInfo->yv[0]) ),
+			*body_intercept_x_r = thrust::raw_pointer_cast( &(body_intercept_x[0]) ),
+			*body_intercept_y_r = thrust::raw_pointer_cast( &(body_intercept_y[0]) ),
+			*image_point_x_r = thrust::raw_pointer_cast( &(image_point_x[0]) ),
+			*image_point_y_r = thrust::raw_pointer_cast( &(image_point_y[0]) );
+	int		*col_r	= thrust::raw_pointer_cast( &(W.column_indices[0]) ),
+			*nodes_r= thrust::raw_pointer_cast( &(nodes[0]) );
+	unsigned char	*cellTypeUV_r = thrust::raw_pointer_cast( &(cellTypeUV[0]) );
+
+	const int blocksize = 256;
+	dim3 grid( int( (numRows-0.5)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	kernels::interpolationWeights<<<grid,block>>>(col_r, val_r, bodyCoef_r, nodes_r, cellTypeUV_r, hybrid,
+												xu_r, yu_r, xv_r, yv_r,
+												body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
+												numRows, nx, ny);
+}
+
+/*
+ * out[nodes] = W*vel + bodyCoef*uv, uv is the body velocity at the intercept of each node
+ * param vel velocity the operator reads from
+ * param out velocity array the interpolated values are written to, can be vel
+ */
+void luoIBM::applyInterpolationOperator(cusp::csr_matrix<int, double, cusp::device_memory> &W, cusp::array1d<int, cusp::device_memory> &nodes,
+										cusp::array1d<double, cusp::device_memory> &bodyCoef,
+										cusp::array1d<double, cusp::device_memory> &vel, cusp::array1d<double, cusp::device_memory> &out)
+{
+	int numRows = nodes.size();
+	if (numRows == 0)
+		return;
+	interpTemp.resize(numRows);
+	cusp::multiply(W, vel, interpTemp);
+
+	double	*out_r	= thrust::raw_pointer_cast( &(out[0]) ),
+			*Wu_r	= thrust::raw_pointer_cast( &(interpTemp[0]) ),
+			*bodyCoef_r	= thrust::raw_pointer_cast( &(bodyCoef[0]) ),
+			*uv_r	= thrust::raw_pointer_cast( &(uv[0]) );
+	int		*nodes_r= thrust::raw_pointer_cast( &(nodes[0]) );
+
+	const int blocksize = 256;
+	dim3 grid( int( (numRows-0.5)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	kernels::applyInterpolation<<<grid,block>>>(out_r, Wu_r, nodes_r, bodyCoef_r, uv_r, numRows);
+}
+
+/*
+ * Sets the ghost node velocities of vel from the velocity at their image points
+ */
+void luoIBM::interpolateToGhostNodes(cusp::array1d<double, cusp::device_memory> &vel)
+{
+	applyInterpolationOperator(ghostInterp, ghostNodesUV, ghostBodyCoef, vel, vel);
+}
+
+/*
+ * Interpolates u to the hybrid nodes and stores the result in ustar
+ */
+void luoIBM::interpolateToHybridNodes()
+{
+	applyInterpolationOperator(hybridInterp, hybridNodesUV, hybridBodyCoef, u, ustar);
+}
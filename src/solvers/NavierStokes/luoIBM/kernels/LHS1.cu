@@ -8,13 +8,13 @@
 
 namespace kernels
 {
-__global__
-void LHS1_mid_luo_X(int *row, int *col, double *val, int *ghostTagsUV, double *dx, double *dy, double dt, double nu, int nx, int ny)
+/*
+ * writes the 5 entries of the interior u row i at their fixed place in LHS1, boundary rows are left to LHS_BC_X
+ */
+__device__
+void LHS1_row_luo_X(int *row, int *col, double *val, int i, double *dx, double *dy, double dt, double nu, int nx, int ny)
 {
-	if (threadIdx.x + blockDim.x * blockIdx.x >= (nx-1)*ny)
-		return;
-	int i 	= threadIdx.x + blockDim.x * blockIdx.x,
-		I	= i % (nx-1),
+	int	I	= i % (nx-1),
 		J	= i / (nx-1);
 	if (I == 0 || I == nx-2 || J == 0 || J == ny-1)
 		return;
@@ -59,13 +59,13 @@ void LHS1_mid_luo_X(int *row, int *col, double *val, int *ghostTagsUV, double *d
 	numE++;
 }
 
-__global__
-void LHS1_mid_luo_Y(int *row, int *col, double *val, int *ghostTagsUV, double *dx, double *dy, double dt, double nu, int nx, int ny)
+/*
+ * writes the 5 entries of the interior v row ip (numbered from the first v node) at their fixed place in LHS1
+ */
+__device__
+void LHS1_row_luo_Y(int *row, int *col, double *val, int ip, double *dx, double *dy, double dt, double nu, int nx, int ny)
 {
-	if (threadIdx.x + blockDim.x * blockIdx.x >= nx*(ny-1))
-		return;
-	int ip 	= threadIdx.x + blockDim.x * blockIdx.x,
-		I	= ip % nx,
+	int	I	= ip % nx,
 		J	= ip / nx,
 		i = ip + (nx-1)*ny;
 	if (I == 0 || I == nx-1 || J == 0 || J == ny-2)
@@ -109,4 +109,39 @@ void LHS1_mid_luo_Y(int *row, int *col, double *val, int *ghostTagsUV, double *d
 	numE++;
 }
 
+__global__
+void LHS1_mid_luo_X(int *row, int *col, double *val, unsigned char *cellTypeUV, double *dx, double *dy, double dt, double nu, int nx, int ny)
+{
+	int i = threadIdx.x + blockDim.x * blockIdx.x;
+	if (i >= (nx-1)*ny)
+		return;
+	LHS1_row_luo_X(row, col, val, i, dx, dy, dt, nu, nx, ny);
+}
+
+__global__
+void LHS1_mid_luo_Y(int *row, int *col, double *val, unsigned char *cellTypeUV, double *dx, double *dy, double dt, double nu, int nx, int ny)
+{
+	int ip = threadIdx.x + blockDim.x * blockIdx.x;
+	if (ip >= nx*(ny-1))
+		return;
+	LHS1_row_luo_Y(row, col, val, ip, dx, dy, dt, nu, nx, ny);
+}
+
+/*
+ * reassembles the rows of LHS1 in the list rows (u and v numbering), the other entries are left as they are
+ * every row has a fixed place in LHS1, so a row can be rewritten without touching the rest of the matrix
+ */
+__global__
+void LHS1_rows_luo(int *row, int *col, double *val, int *rows, int numRows, double *dx, double *dy, double dt, double nu, int nx, int ny)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x;
+	if (idx >= numRows)
+		return;
+	int k = rows[idx];
+	if (k < (nx-1)*ny)
+		LHS1_row_luo_X(row, col, val, k, dx, dy, dt, nu, nx, ny);
+	else
+		LHS1_row_luo_Y(row, col, val, k - (nx-1)*ny, dx, dy, dt, nu, nx, ny);
+}
+
 }//end kernel
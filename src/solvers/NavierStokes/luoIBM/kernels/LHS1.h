@@ -3,8 +3,11 @@
 namespace kernels
 {
 __global__
-void LHS1_mid_luo_X(int *row, int *col, double *val, int *ghostTagsUV, double *dx, double *dy, double dt, double nu, int nx, int ny);
+void LHS1_mid_luo_X(int *row, int *col, double *val, unsigned char *cellTypeUV, double *dx, double *dy, double dt, double nu, int nx, int ny);
 
 __global__
-void LHS1_mid_luo_Y(int *row, int *col, double *val, int *ghostTagsUV, double *dx, double *dy, double dt, double nu, int nx, int ny);
+void LHS1_mid_luo_Y(int *row, int *col, double *val, unsigned char *cellTypeUV, double *dx, double *dy, double dt, double nu, int nx, int ny);
+
+__global__
+void LHS1_rows_luo(int *row, int *col, double *val, int *rows, int numRows, double *dx, double *dy, double dt, double nu, int nx, int ny);
 }
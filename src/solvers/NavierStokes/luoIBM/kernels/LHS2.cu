@@ -5,43 +5,36 @@
  */
 
 #include "LHS2.h"
+#include "cellType.h"
+#include <solvers/NavierStokes/NavierStokes/kernels/smallMatrix.h>
 
 namespace kernels
 {
-__global__
-void LHS2_mid_luo(int *row, int *col, double *val, double *dx, double *dy, int nx, int ny, double dt, int *count, double *stencilCoef, double *interpCoef,
-					double *detA, int *hybridTagsP, int *ghostTagsP, double *alpha,
-					double *xv, double *yu,
-					double *b11, double *b12, double *b13, double *b14, double *b21, double *b22, double *b23, double *b24,
-					double *b31, double *b32, double *b33, double *b34, double *b41, double *b42, double *b43, double *b44,
-					/*double *q1, double *q2, double *q3, double *q4,*/ //not used
-					bool *q1flag, bool *q2flag, bool *q3flag, bool *q4flag, //not currently used
-					/*double *x1, double *x2, double *x3, double *x4, //not used
-					double *y1, double *y2, double *y3, double *y4,*/ //not used
+/*
+ * computes the interior row ip of LHS2
+ * the 5 stencil entries go to stencilCol/stencilVal in the order the full assembly stores them (n e s w p at a hybrid node,
+ * e w n s p otherwise), the interpolation corners that aren't part of the stencil go to extraCol/extraVal
+ * returns the number of extra entries, writes stencilCoef[ip] at a hybrid node
+ */
+__device__
+int LHS2_row_luo(int ip, int *stencilCol, double *stencilVal, int *extraCol, double *extraVal,
+					double *dx, double *dy, int nx, double dt, double *stencilCoef,
+					double *Ainv, unsigned char *cellTypeP, double *alpha, double *xv, double *yu,
 					int *index1, int *index2, int *index3, int *index4)
 {
-	int ip 	= threadIdx.x + blockDim.x * blockIdx.x;
-	if (ip >= nx*ny)
-		return;
 	int	I	= ip % nx,
-		J	= ip / nx;
-
-	if (I == 0 || I == nx-1 || J == 0 || J == ny-1)
-		return;
-
-	int numE = nx*4-2 + (J-1)*(nx*5-2) + I*5-1;
+		J	= ip / nx,
+		numExtra = 0;
 	double	temp = 0;
 
-	if (hybridTagsP[ip]>0)//if were at hybrid node
+	if (cellType::isHybrid(cellTypeP[ip]))//if were at hybrid node
 	{
 	int index[4] = {index1[ip], index2[ip], index3[ip], index4[ip]};
 	int cardinal[5] = {ip+nx, ip+1, ip-nx, ip-1, ip};//n e s w p
 	double tempInterp[4];
 	double tempStencil[5];
 	bool interpMatch[4] = {false, false, false, false};
-	//bool qflag[4] = {q1flag[ip], q2flag[ip], q3flag[ip], q4flag[ip]};
-	double	x = xv[I],
-			y = yu[J];
+	double	phi[4];
 
 	//calculate the pressure coefficients for the stencil pressure calculation
 	tempStencil[0] = dt/(dy[J]*(dy[J]+dy[J+1])*0.5); //N
@@ -55,12 +48,9 @@ void LHS2_mid_luo(int *row, int *col, double *val, double *dx, double *dy, int n
 	for (int i=0;i<4;i++)
 		tempStencil[i] = (1-alpha[ip])*tempStencil[i]/tempStencil[4];
 
-	//calculate pressure coefficients for the interpolation pressure calculation	//is multiplied by pressure from corner:
-	//					a0        a1        a2        a3
-	tempInterp[0] = ( b11[ip] + b21[ip]*x + b31[ip]*y + b41[ip]*x*y )/detA[ip];			//1
-	tempInterp[1] = ( b12[ip] + b22[ip]*x + b32[ip]*y + b42[ip]*x*y )/detA[ip];			//2
-	tempInterp[2] = ( b13[ip] + b23[ip]*x + b33[ip]*y + b43[ip]*x*y )/detA[ip];			//3
-	tempInterp[3] = ( b14[ip] + b24[ip]*x + b34[ip]*y + b44[ip]*x*y )/detA[ip];			//4
+	//calculate pressure coefficients for the interpolation pressure calculation, tempInterp[k] is multiplied by the pressure at corner k
+	bilinearRow(xv[I], yu[J], phi);
+	applyTranspose<4>(&Ainv[16*ip], phi, tempInterp);
 
 	//figure out which interpolation term is being multiplied by pressure at ip
 	for (int i=0;i<4;i++)
@@ -94,73 +84,183 @@ void LHS2_mid_luo(int *row, int *col, double *val, double *dx, double *dy, int n
 			}
 		}
 	}
-	//add the 4 sides of the Poisson stencil to the sparse matrix
+	//the 4 sides of the Poisson stencil
 	for (int i=0;i<4;i++)
 	{
-		row[numE]=ip;
-		col[numE]=cardinal[i];
-		val[numE]=-tempStencil[i];
-		numE++;
+		stencilCol[i] = cardinal[i];
+		stencilVal[i] = -tempStencil[i];
 	}
-	//add the center of the poisson stencil to the sparse matrix
-	row[numE]=ip;
-	col[numE]=ip;
-	val[numE]=1;
-	//look at all of the nodes used for interpolation, if they are not coincident with any part of the poisson stencil, add them the the sparse matrix
-	//change numE so that the values are added to the end of the sparse matrix
-	numE = nx*ny*5 - nx*2 - ny*2 + count[ip]-1;
+	//the center of the poisson stencil
+	stencilCol[4] = ip;
+	stencilVal[4] = 1;
+	//look at all of the nodes used for interpolation, if they are not coincident with any part of the poisson stencil, they are extra entries
 	for (int j=0;j<4;j++)
 	{
 	//check that the value isn't at a stencil node
 	if (!interpMatch[j])
 	{
-		row[numE]=ip;
-		col[numE]=index[j];
-		val[numE]=-tempInterp[j];
-		numE++;
+		extraCol[numExtra] = index[j];
+		extraVal[numExtra] = -tempInterp[j];
+		numExtra++;
 	}
 	}
 	}
 	else //if were not at a hybrid node
 	{
 	//EAST
-	row[numE] = ip;
-	col[numE] = ip + 1;
-	val[numE] = -dt/(dx[I]*(dx[I]+dx[I+1])*0.5);
-	numE++;
+	stencilCol[0] = ip + 1;
+	stencilVal[0] = -dt/(dx[I]*(dx[I]+dx[I+1])*0.5);
 	temp 	  += dt/(dx[I]*(dx[I]+dx[I+1])*0.5);
 
 	//WEST
-	row[numE] = ip;
-	col[numE] = ip - 1;
-	val[numE] = -dt/(dx[I]*(dx[I]+dx[I-1])*0.5);
+	stencilCol[1] = ip - 1;
+	stencilVal[1] = -dt/(dx[I]*(dx[I]+dx[I-1])*0.5);
 	temp 	  += dt/(dx[I]*(dx[I]+dx[I-1])*0.5);
-	numE++;
 
 	//NORTH
-	row[numE] = ip;
-	col[numE] = ip + nx;
-	val[numE] = -dt/(dy[J]*(dy[J]+dy[J+1])*0.5);
+	stencilCol[2] = ip + nx;
+	stencilVal[2] = -dt/(dy[J]*(dy[J]+dy[J+1])*0.5);
 	temp += dt/(dy[J]*(dy[J]+dy[J+1])*0.5);
-	numE++;
 
 	//SOUTH
-	row[numE] = ip;
-	col[numE] = ip - nx;
-	val[numE] = -dt/(dy[J]*(dy[J]+dy[J-1])*0.5);
+	stencilCol[3] = ip - nx;
+	stencilVal[3] = -dt/(dy[J]*(dy[J]+dy[J-1])*0.5);
 	temp 	  += dt/(dy[J]*(dy[J]+dy[J-1])*0.5);
-	numE++;
+
 	//MID
-	row[numE] = ip;
-	col[numE] = ip;
-	val[numE] = temp;
+	stencilCol[4] = ip;
+	stencilVal[4] = temp;
 	}
+	return numExtra;
+}
+
+__global__
+void LHS2_mid_luo(int *row, int *col, double *val, double *dx, double *dy, int nx, int ny, double dt, int *count, double *stencilCoef, double *interpCoef,
+					double *Ainv, unsigned char *cellTypeP, double *alpha,
+					double *xv, double *yu,
+					/*double *q1, double *q2, double *q3, double *q4,*/ //not used
+					bool *q1flag, bool *q2flag, bool *q3flag, bool *q4flag, //not currently used
+					/*double *x1, double *x2, double *x3, double *x4, //not used
+					double *y1, double *y2, double *y3, double *y4,*/ //not used
+					int *index1, int *index2, int *index3, int *index4)
+{
+	int ip 	= threadIdx.x + blockDim.x * blockIdx.x;
+	if (ip >= nx*ny)
+		return;
+	int	I	= ip % nx,
+		J	= ip / nx;
+
+	if (I == 0 || I == nx-1 || J == 0 || J == ny-1)
+		return;
+
+	int		stencilCol[5],
+			extraCol[4];
+	double	stencilVal[5],
+			extraVal[4];
+	int numExtra = LHS2_row_luo(ip, stencilCol, stencilVal, extraCol, extraVal, dx, dy, nx, dt, stencilCoef,
+								Ainv, cellTypeP, alpha, xv, yu, index1, index2, index3, index4);
 
-	/*
-	//do some jank so the solver works, although this modifies the matricies it doesn't really change the results //flag
-	if(row[numE]==col[numE] && col[numE]==(ny/2)*nx+nx/2)
+	//the stencil has a fixed place in the matrix
+	int numE = nx*4-2 + (J-1)*(nx*5-2) + I*5-1;
+	for (int i=0;i<5;i++)
+	{
+		row[numE] = ip;
+		col[numE] = stencilCol[i];
+		val[numE] = stencilVal[i];
+		numE++;
+	}
+	//the extra interpolation entries are added to the end of the sparse matrix
+	numE = nx*ny*5 - nx*2 - ny*2 + count[ip];
+	for (int i=0;i<numExtra;i++)
+	{
+		row[numE] = ip;
+		col[numE] = extraCol[i];
+		val[numE] = extraVal[i];
+		numE++;
+	}
+}
+
+/*
+ * reassembles the rows of the sorted LHS2 in the list rows, the other entries are left as they are
+ * a row is rewritten in place in column order, which only works if it has as many entries as before,
+ * otherwise mismatch is set and LHS2 has to be assembled again
+ * param rowStart position of the first entry of each row in the sorted LHS2
+ */
+__global__
+void LHS2_rows_luo(int *col, double *val, int *rowStart, int *rows, int numRows, int *mismatch,
+					double *dx, double *dy, int nx, int ny, double dt, double *stencilCoef,
+					double *Ainv, unsigned char *cellTypeP, double *alpha, double *xv, double *yu,
+					int *index1, int *index2, int *index3, int *index4)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x;
+	if (idx >= numRows)
+		return;
+	int ip	= rows[idx],
+		I	= ip % nx,
+		J	= ip / nx;
+	//the boundary rows don't depend on the body
+	if (I == 0 || I == nx-1 || J == 0 || J == ny-1)
+		return;
+
+	int		c[9];
+	double	v[9];
+	int n = 5 + LHS2_row_luo(ip, c, v, c+5, v+5, dx, dy, nx, dt, stencilCoef,
+							Ainv, cellTypeP, alpha, xv, yu, index1, index2, index3, index4);
+	if (n != rowStart[ip+1] - rowStart[ip])
 	{
-		//val[numE] += val[numE];
-	}*/
+		*mismatch = 1;
+		return;
+	}
+
+	//insertion sort by column
+	for (int i=1;i<n;i++)
+	{
+		int		cc = c[i];
+		double	vv = v[i];
+		int j = i-1;
+		for (; j>=0 && c[j]>cc; j--)
+		{
+			c[j+1] = c[j];
+			v[j+1] = v[j];
+		}
+		c[j+1] = cc;
+		v[j+1] = vv;
+	}
+	for (int i=0;i<n;i++)
+	{
+		col[rowStart[ip]+i] = c[i];
+		val[rowStart[ip]+i] = v[i];
+	}
+}
+
+/*
+ * flags the entries of the sorted LHS2 whose row and column are both active pressure nodes
+ * param keep 1 if entry idx is copied to the reduced system
+ * param compactIndex position of each pressure node in the reduced system, -1 for solid nodes
+ */
+__global__
+void reduce_LHS2_count(int *keep, int *row, int *col, int *compactIndex, int numEntries)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x;
+	if (idx >= numEntries)
+		return;
+	keep[idx] = compactIndex[row[idx]] >= 0 && compactIndex[col[idx]] >= 0;
+}
+
+/*
+ * copies the kept entries of LHS2 into the reduced matrix and renumbers them
+ * the renumbering keeps the order of the nodes, so the reduced matrix stays sorted by row and column
+ * param offset exclusive scan of keep, the position of each kept entry in the reduced matrix
+ */
+__global__
+void reduce_LHS2(int *rowR, int *colR, double *valR, int *row, int *col, double *val, int *keep, int *offset, int *compactIndex, int numEntries)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x;
+	if (idx >= numEntries || !keep[idx])
+		return;
+	int k = offset[idx];
+	rowR[k] = compactIndex[row[idx]];
+	colR[k] = compactIndex[col[idx]];
+	valR[k] = val[idx];
 }
 }
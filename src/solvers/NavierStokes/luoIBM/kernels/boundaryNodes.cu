@@ -0,0 +1,348 @@
+/***************************************************************************//**
+ * \file boundaryNodes.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief immersed boundary corrections that run over the compact lists of tagged nodes
+ *        one thread per tagged node, the interpolation stencil and its geometry stay in registers
+ */
+
+#include "boundaryNodes.h"
+#include "cellType.h"
+#include <solvers/NavierStokes/NavierStokes/kernels/smallMatrix.h>
+
+namespace kernels
+{
+/*
+ * Du/Dt . n at a point on the body, Du/Dt is interpolated between the two closest body nodes
+ * param x, y point on the body
+ * param n_x, n_y unit normal
+ */
+__device__
+double normalAcceleration(double x, double y, double n_x, double n_y, double *bx, double *by,
+							double *uB, double *uB0, double *vB, double *vB0, double dt, int totalPoints)
+{
+	double	distance,
+			distance2,
+			min = 1,
+			min2 = 1;
+	int		bodyindex = 0,
+			bodyindex2 = 0;
+
+	//find two closest body nodes
+	for (int k=0; k<totalPoints; k++)
+	{
+		distance = sqrt(pow(bx[k]-x,2)+pow(by[k]-y,2));
+		if (distance<min)
+		{
+			min = distance;
+			bodyindex = k;
+		}
+	}
+	for (int k=0; k<totalPoints; k++)
+	{
+		distance = sqrt(pow(bx[k]-x,2)+pow(by[k]-y,2));
+		distance2 = sqrt(pow(bx[bodyindex]-bx[k],2)+pow(by[bodyindex]-bx[k],2));
+		if (distance<min2 && distance2>0)
+		{
+			min2 = distance;
+			bodyindex2 = k;
+		}
+	}
+
+	//calc Du/Dt at body nodes
+	double	matDi = (uB[bodyindex]-uB0[bodyindex])/dt,
+			matDj = (vB[bodyindex]-vB0[bodyindex])/dt,
+			matD2i = (uB[bodyindex2]-uB0[bodyindex2])/dt,
+			matD2j = (vB[bodyindex2]-vB0[bodyindex2])/dt;
+
+	//interp to BI
+	double	matDBIi = matDi + (matD2i-matDi)/(min+min2)*min,
+			matDBIj = matDj + (matD2j-matDj)/(min+min2)*min;
+	return matDBIi*n_x + matDBIj*n_y;
+}
+
+/*
+ * finds the four pressure nodes around a point
+ *   	(x3,y3)__________(x4,y4)
+ *   	|					   |
+ *   	|	 *(px,py)		   |
+ *   	|					   |
+ *   	(x1,y1)__________(x2,y2)
+ */
+__device__
+void pressureStencil(double px, double py, int I, int J, double *xv, double *yu, int nx, double *x, double *y, int *index)
+{
+	int	ii = I-5,
+		jj = J-5;
+	while (xv[ii] < px)
+		ii++;
+	while (yu[jj] < py)
+		jj++;
+	x[0] = xv[ii-1];	y[0] = yu[jj-1];	index[0] = (jj-1)*nx+ii-1;
+	x[1] = xv[ii];		y[1] = yu[jj-1];	index[1] = (jj-1)*nx+ii;
+	x[2] = xv[ii-1];	y[2] = yu[jj];		index[2] = jj*nx+ii-1;
+	x[3] = xv[ii];		y[3] = yu[jj];		index[3] = jj*nx+ii;
+}
+
+/*
+ * replaces a row of the bilinear system with the neumann condition df/dn = grad(f) . n at (x,y)
+ */
+__device__
+void neumannRow(double x, double y, double n_x, double n_y, double *row)
+{
+	row[0] = 0;
+	row[1] = n_x;
+	row[2] = n_y;
+	row[3] = n_y*x + n_x*y;
+}
+
+/*
+ * blends uhat at the hybrid velocity nodes with the interpolated velocity in ustar
+ * param nodes velocity index of each hybrid node (hybridNodesUV)
+ */
+__global__
+void weightUhat(double *uhat, double *ustar, unsigned char *cellTypeUV, int *nodes, double *xu, double *yu, double *xv, double *yv,
+				double *body_intercept_x, double *body_intercept_y, int numNodes, int nx, int ny)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numNodes)
+		return;
+
+	int numU = (nx-1)*ny,
+		node = nodes[k],
+		I, J, north;
+	double	*x, *y;
+	if (node < numU)
+	{
+		I = node % (nx-1);
+		J = node / (nx-1);
+		north = nx-1;
+		x = xu;
+		y = yu;
+	}
+	else
+	{
+		I = (node-numU) % nx;
+		J = (node-numU) / nx;
+		north = nx;
+		x = xv;
+		y = yv;
+	}
+
+	double  delta_1 = 0,
+			delta_2 = 0,
+			alpha,
+			dx = x[I]-x[I-1],
+			dy = y[J]-y[J-1];
+	//find ghost node in x direction
+	//west is inside
+	if (cellType::isGhost(cellTypeUV[node-1]))
+		delta_1 = sqrt( pow( body_intercept_x[node-1]-x[I-1],2 ) + pow( body_intercept_y[node-1]-y[J], 2 ) );
+	//east is inside
+	else if(cellType::isGhost(cellTypeUV[node+1]))
+		delta_1 = sqrt( pow( body_intercept_x[node+1]-x[I+1],2 ) + pow( body_intercept_y[node+1]-y[J], 2 ) );
+	//find ghost node in y direction
+	//south is inside
+	if (cellType::isGhost(cellTypeUV[node-north]))
+		delta_2 = sqrt( pow( body_intercept_x[node-north]-x[I],2 ) + pow( body_intercept_y[node-north]-y[J-1], 2 ) );
+	//north is inside
+	else if (cellType::isGhost(cellTypeUV[node+north]))
+		delta_2 = sqrt( pow( body_intercept_x[node+north]-x[I],2 ) + pow( body_intercept_y[node+north]-y[J+1], 2 ) );
+	//calculate alpha
+	alpha = sqrt( pow( delta_1/dx , 2 ) + pow( delta_2/dy , 2 ) );
+	//blend uhat
+	uhat[node] = (1-alpha)*uhat[node] + alpha*ustar[node];
+}
+
+/*
+ * everything the hybrid pressure nodes need for LHS2 and RHS2 in one pass:
+ * the blending weight alpha, the corners of the interpolation stencil, the inverse of the bilinear system
+ * with the node itself replaced by the neumann condition at the body intercept, and the number of corners
+ * that are not part of the 5 point poisson stencil
+ * param count number of extra LHS2 entries for each hybrid node
+ * param nodes pressure index of each hybrid node (hybridNodesP)
+ */
+__global__
+void hybridPressureSetup(double *Ainv, double *alpha, int *count, int *nodes, unsigned char *cellTypeP,
+						double *bx, double *by, double *uB, double *uB0, double *vB, double *vB0, double *xv, double *yu,
+						double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y,
+						double *q1, double *q2, double *q3, double *q4,
+						bool *q1flag, bool *q2flag, bool *q3flag, bool *q4flag,
+						int *index1, int *index2, int *index3, int *index4,
+						int numNodes, int nx, int ny, double dt, int totalPoints)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numNodes)
+		return;
+
+	int ip	= nodes[k],
+		I	= ip % nx,
+		J	= ip / nx;
+
+	//alpha
+	double  delta_1 = 0,
+			delta_2 = 0,
+			dx = xv[I]-xv[I-1],
+			dy = yu[J]-yu[J-1];
+	//west is inside
+	if (cellType::isGhost(cellTypeP[ip-1]))
+		delta_1 = sqrt( pow( body_intercept_p_x[ip-1]-xv[I-1],2 ) + pow( body_intercept_p_y[ip-1]-yu[J], 2 ) );
+	//east is inside
+	else if(cellType::isGhost(cellTypeP[ip+1]))
+		delta_1 = sqrt( pow( body_intercept_p_x[ip+1]-xv[I+1],2 ) + pow( body_intercept_p_y[ip+1]-yu[J], 2 ) );
+	//south is inside
+	if (cellType::isGhost(cellTypeP[ip-nx]))
+		delta_2 = sqrt( pow( body_intercept_p_x[ip-nx]-xv[I],2 ) + pow( body_intercept_p_y[ip-nx]-yu[J-1], 2 ) );
+	//north is inside
+	else if (cellType::isGhost(cellTypeP[ip+nx]))
+		delta_2 = sqrt( pow( body_intercept_p_x[ip+nx]-xv[I],2 ) + pow( body_intercept_p_y[ip+nx]-yu[J+1], 2 ) );
+	alpha[ip] = sqrt( pow( delta_1/dx , 2 ) + pow( delta_2/dy , 2 ) );
+
+	//corners of the stencil around the image point
+	double	x[4],
+			y[4],
+			q[4] = {0, 0, 0, 0},
+			A[16];
+	int		index[4];
+	bool	qflag[4] = {false, false, false, false};
+	pressureStencil(image_point_p_x[ip], image_point_p_y[ip], I, J, xv, yu, nx, x, y, index);
+	for (int c=0; c<4; c++)
+		bilinearRow(x[c], y[c], &A[4*c]);
+
+	//the corner that is this node is moved to the body intercept and gets the neumann condition
+	for (int c=0; c<4; c++)
+	{
+		if (index[c] != ip)
+			continue;
+		x[c] = body_intercept_p_x[ip];
+		y[c] = body_intercept_p_y[ip];
+		double	n_x = image_point_p_x[ip] - x[c],
+				n_y = image_point_p_y[ip] - y[c],
+				nl = sqrt(n_x*n_x+n_y*n_y);
+		q[c] = -normalAcceleration(x[c], y[c], n_x/nl, n_y/nl, bx, by, uB, uB0, vB, vB0, dt, totalPoints);
+		qflag[c] = true;
+		neumannRow(x[c], y[c], n_x/nl, n_y/nl, &A[4*c]);
+		break;
+	}
+	invert<4>(A, &Ainv[16*ip]);
+
+	//corners that are not on the poisson stencil become extra entries in LHS2
+	int extra = 0;
+	for (int c=0; c<4; c++)
+		if (index[c] != ip+nx && index[c] != ip-1 && index[c] != ip && index[c] != ip+1 && index[c] != ip-nx)
+			extra++;
+	count[k] = extra;
+
+	q1[ip] = q[0];	q1flag[ip] = qflag[0];	index1[ip] = index[0];
+	q2[ip] = q[1];	q2flag[ip] = qflag[1];	index2[ip] = index[1];
+	q3[ip] = q[2];	q3flag[ip] = qflag[2];	index3[ip] = index[2];
+	q4[ip] = q[3];	q4flag[ip] = qflag[3];	index4[ip] = index[3];
+}
+
+/*
+ * adds the neumann part of the hybrid node interpolation to the poisson right hand side
+ * param nodes pressure index of each hybrid node (hybridNodesP)
+ */
+__global__
+void hybridPressureRHS(double *rhs2, double *Ainv, double *alpha, double *stencilCoef, int *nodes, double *xv, double *yu,
+						double *q1, double *q2, double *q3, double *q4,
+						bool *q1flag, bool *q2flag, bool *q3flag, bool *q4flag,
+						int numNodes, int nx)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numNodes)
+		return;
+	int ip	= nodes[k],
+		I	= ip % nx,
+		J	= ip / nx;
+
+	double	temp = 0,
+			phi[4],
+			w[4];
+
+	//weight of each corner at the node, w = Ainv' phi
+	bilinearRow(xv[I], yu[J], phi);
+	applyTranspose<4>(&Ainv[16*ip], phi, w);
+
+	if (q1flag[ip])
+		temp = w[0]*q1[ip];
+	else if (q2flag[ip])
+		temp = w[1]*q2[ip];
+	else if (q3flag[ip])
+		temp = w[2]*q3[ip];
+	else if (q4flag[ip])
+		temp = w[3]*q4[ip];
+	rhs2[ip] = (1-alpha[ip])*rhs2[ip]/stencilCoef[ip] + alpha[ip]*temp;
+}
+
+/*
+ * sets the pressure at the ghost nodes from the pressure at the image point and the normal pressure gradient at the body
+ * corners inside the body and the corner closest to the body intercept are replaced by neumann conditions
+ * param body_intercept_p pressure at the body intercept, used for the force
+ * param nodes pressure index of each ghost node (ghostNodesP)
+ */
+__global__
+void ghostPressure(double *pressure, double *body_intercept_p, int *nodes, unsigned char *cellTypeP,
+					double *bx, double *by, double *uB, double *uB0, double *vB, double *vB0, double *xv, double *yu,
+					double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y,
+					int numNodes, int nx, int ny, double dt, int totalPoints)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numNodes)
+		return;
+	int ip	= nodes[k],
+		I	= ip % nx,
+		J	= ip / nx;
+
+	double	x[4],
+			y[4],
+			q[4],
+			A[16],
+			a[4],
+			matDClose = 0;
+	int		index[4],
+			close_index = -1;
+	pressureStencil(image_point_p_x[ip], image_point_p_y[ip], I, J, xv, yu, nx, x, y, index);
+	for (int c=0; c<4; c++)
+	{
+		q[c] = pressure[index[c]];
+		bilinearRow(x[c], y[c], &A[4*c]);
+	}
+
+	//find the closest node to the body intercept
+	double min = 1.0;
+	for (int c=0; c<4; c++)
+	{
+		double s = sqrt(pow(x[c]-body_intercept_p_x[ip],2) + pow(y[c]-body_intercept_p_y[ip],2));
+		if (s < min)
+		{
+			min = s;
+			close_index = index[c];
+		}
+	}
+
+	//if the node is inside the body, move it to the surface then set it to be a neuman condition
+	for (int c=0; c<4; c++)
+	{
+		if (cellType::isFluid(cellTypeP[index[c]]) && index[c] != close_index)
+			continue;
+		x[c] = body_intercept_p_x[index[c]];
+		y[c] = body_intercept_p_y[index[c]];
+		double	n_x = image_point_p_x[index[c]] - x[c],
+				n_y = image_point_p_y[index[c]] - y[c],
+				nl = sqrt(n_x*n_x+n_y*n_y),
+				dpdn = normalAcceleration(x[c], y[c], n_x/nl, n_y/nl, bx, by, uB, uB0, vB, vB0, dt, totalPoints);
+		if (index[c] == close_index)
+			matDClose = dpdn;
+		q[c] = -dpdn;
+		neumannRow(x[c], y[c], n_x/nl, n_y/nl, &A[4*c]);
+	}
+
+	//p = a0 + a1 x + a2 y + a3 x y
+	solve<4>(A, q, a);
+	double	image_point_pressure = a[0] + a[1]*image_point_p_x[ip] + a[2]*image_point_p_y[ip] + a[3]*image_point_p_x[ip]*image_point_p_y[ip];
+	body_intercept_p[ip] = a[0] + a[1]*body_intercept_p_x[ip] + a[2]*body_intercept_p_y[ip] + a[3]*body_intercept_p_x[ip]*body_intercept_p_y[ip]; //used for force calc
+
+	//extrapolate pressure to the ghost node
+	pressure[ip] = image_point_pressure + sqrt(pow(image_point_p_x[ip]-xv[I],2)+pow(image_point_p_y[ip]-yu[J],2))*matDClose;
+}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace kernels
+{
+__global__
+void weightUhat(double *uhat, double *ustar, unsigned char *cellTypeUV, int *nodes, double *xu, double *yu, double *xv, double *yv,
+				double *body_intercept_x, double *body_intercept_y, int numNodes, int nx, int ny);
+
+__global__
+void hybridPressureSetup(double *Ainv, double *alpha, int *count, int *nodes, unsigned char *cellTypeP,
+						double *bx, double *by, double *uB, double *uB0, double *vB, double *vB0, double *xv, double *yu,
+						double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y,
+						double *q1, double *q2, double *q3, double *q4,
+						bool *q1flag, bool *q2flag, bool *q3flag, bool *q4flag,
+						int *index1, int *index2, int *index3, int *index4,
+						int numNodes, int nx, int ny, double dt, int totalPoints);
+
+__global__
+void hybridPressureRHS(double *rhs2, double *Ainv, double *alpha, double *stencilCoef, int *nodes, double *xv, double *yu,
+						double *q1, double *q2, double *q3, double *q4,
+						bool *q1flag, bool *q2flag, bool *q3flag, bool *q4flag,
+						int numNodes, int nx);
+
+__global__
+void ghostPressure(double *pressure, double *body_intercept_p, int *nodes, unsigned char *cellTypeP,
+					double *bx, double *by, double *uB, double *uB0, double *vB, double *vB0, double *xv, double *yu,
+					double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y,
+					int numNodes, int nx, int ny, double dt, int totalPoints);
+}
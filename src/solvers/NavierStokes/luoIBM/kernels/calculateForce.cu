@@ -5,13 +5,14 @@
  */
 
 #include "calculateForce.h"
+#include "cellType.h"
 
 namespace kernels
 {
 __global__//kernel should be of size totalPoints
 void force_pressure(double *force_pressure, double *body_intercept_p,
 					double *body_intercept_p_x, double *body_intercept_p_y,
-					double *bx, double *by, double *xv, double *yu, int *ghostTagsP,
+					double *bx, double *by, double *xv, double *yu, unsigned char *cellTypeP,
 					int *i_start, int *j_start, int width, int height, int totalPoints, int nx, int ny, double midX, double midY)
 {
 	//initialise
@@ -61,7 +62,7 @@ void force_pressure(double *force_pressure, double *body_intercept_p,
 		{
 			ip = j*nx+i;
 
-			if (ghostTagsP[ip]>0)
+			if (cellType::isGhost(cellTypeP[ip]))
 			{
 				theta = asin((body_intercept_p_y[ip]-midY)/sqrt(pow(body_intercept_p_x[ip]-midX,2)+pow(body_intercept_p_y[ip]-midY,2)));
 				if (body_intercept_p_x[ip]<midX)
@@ -137,7 +138,7 @@ void force_velocity_x(double *force_dudx, double *uB, double *u,
 			ipu = botleft + botright + topleft + topright;
 
 	//calc normal derivative
-	force_dudx[idx] = (ipu-uB[0])/dn;
+	force_dudx[idx] = (ipu-uB[idx])/dn;
 }
 
 __global__
@@ -185,7 +186,7 @@ void force_velocity_y(double *force_dvdx, double *vB, double *u,
 			ipu = botleft + botright + topleft + topright;
 
 	//calc normal derivative
-	force_dvdx[idx] = (ipu-vB[0])/dn;
+	force_dvdx[idx] = (ipu-vB[idx])/dn;
 }
 
 __global__
@@ -5,7 +5,7 @@ namespace kernels
 __global__
 void force_pressure(double *force_pressure, double *body_intercept_p,
 					double *body_intercept_p_x, double *body_intercept_p_y,
-					double *bx, double *by, double *xv, double *yu, int *ghostTagsP,
+					double *bx, double *by, double *xv, double *yu, unsigned char *cellTypeP,
 					int *i_start, int *j_start, int width, int height, int totalPoints, int nx, int ny, double midX, double midY);
 __global__
 void force_velocity_x(double *force_dudx, double *uB, double *u,
@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * \file cellType.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief one byte classification of the velocity and pressure nodes used by luoIBM and fadlunModified
+ */
+
+#pragma once
+
+/*
+ * bits of cellTypeUV and cellTypeP, a node with no bits set is a fluid node
+ * a hybrid velocity node also has HYBRID2 set when the second node outside the body exists
+ */
+namespace cellType
+{
+enum
+{
+	FLUID	= 0,
+	GHOST	= 1,	///< just inside the boundary
+	HYBRID	= 2,	///< just outside the boundary
+	HYBRID2	= 4,	///< hybrid velocity node with a second node outside the boundary
+	SOLID	= 8		///< inside the boundary but not a ghost node, set by the zero kernels
+};
+
+__host__ __device__ inline
+bool isGhost(unsigned char type)
+{
+	return type & GHOST;
+}
+
+__host__ __device__ inline
+bool isHybrid(unsigned char type)
+{
+	return type & HYBRID;
+}
+
+__host__ __device__ inline
+bool isSolid(unsigned char type)
+{
+	return type & SOLID;
+}
+
+/*
+ * true for nodes that are neither ghost nodes nor inside the body
+ */
+__host__ __device__ inline
+bool isFluid(unsigned char type)
+{
+	return !(type & (GHOST | SOLID));
+}
+
+/*
+ * true for ghost nodes and nodes inside the body
+ */
+__host__ __device__ inline
+bool isInside(unsigned char type)
+{
+	return type & (GHOST | SOLID);
+}
+}
+
+namespace kernels
+{
+/*
+ * true for nodes with any of the bits in mask, used to compact the cell types into a list of nodes
+ */
+struct hasCellType
+{
+	unsigned char mask;
+
+	hasCellType(unsigned char _mask) : mask(_mask) {}
+
+	__host__ __device__
+	bool operator()(const unsigned char type) const
+	{
+		return type & mask;
+	}
+};
+
+/*
+ * true for nodes with none of the bits in mask, used to list the pressure nodes of the reduced poisson system
+ */
+struct lacksCellType
+{
+	unsigned char mask;
+
+	lacksCellType(unsigned char _mask) : mask(_mask) {}
+
+	__host__ __device__
+	bool operator()(const unsigned char type) const
+	{
+		return !(type & mask);
+	}
+};
+}
@@ -15,11 +15,11 @@
 namespace kernels
 {
 __global__
-void zeroInside(int *ghostTags, double *value, int points);
+void zeroInside(unsigned char *cellTypeUV, double *value, int points);
 
 __global__
-void updateRHS1_luo_X(int *hybridTagsUV, int *ghostTagsUV, double *rhs, double *a, double *b, double *uv, int nx, int ny);
+void updateRHS1_luo_X(unsigned char *cellTypeUV, double *rhs, double *a, double *b, double *uv, int nx, int ny);
 
 __global__
-void updateRHS1_luo_Y(int *hybridTagsUV, int *ghostTagsUV, double *rhs, double *a, double *b, double *uv, int nx, int ny);
+void updateRHS1_luo_Y(unsigned char *cellTypeUV, double *rhs, double *a, double *b, double *uv, int nx, int ny);
 } // end of namespace kernels
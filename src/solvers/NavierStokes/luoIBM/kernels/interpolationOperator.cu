@@ -0,0 +1,139 @@
+/***************************************************************************//**
+ * \file interpolationOperator.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief builds the bilinear interpolation to the ghost and hybrid velocity nodes as a sparse matrix
+ */
+
+#include "interpolationOperator.h"
+#include "cellType.h"
+#include <solvers/NavierStokes/NavierStokes/kernels/smallMatrix.h>
+
+namespace kernels
+{
+/*
+ * weights of the bilinear interpolant through four points, f(px,py) = w1 q1 + w2 q2 + w3 q3 + w4 q4
+ * f = phi . a with a = Ainv q, so w = Ainv' phi
+ */
+__device__
+void bilinearWeights(double *x, double *y, double px, double py, double *w)
+{
+	double	A[16],
+			phi[4];
+	for (int k=0; k<4; k++)
+		bilinearRow(x[k], y[k], &A[4*k]);
+	bilinearRow(px, py, phi);
+	solveTranspose<4>(A, phi, w);
+}
+
+/*
+ * Fills one row of the interpolation operator for each tagged node, every row has four entries
+ * ghost nodes:  u_gn = 2 uB - f(image point)
+ * hybrid nodes: u_hn = f(node)
+ * corners inside the body are moved to the body intercept, their weight goes into bodyCoef instead of the matrix
+ * param col, val column indices and values of the operator, 4 per row
+ * param bodyCoef coefficient of the body velocity for each row
+ * param nodes velocity index of each row
+ * param cellTypeUV cell type of the velocity nodes
+ * param hybrid true if the rows are hybrid nodes
+ * param numRows number of tagged nodes
+ */
+__global__
+void interpolationWeights(int *col, double *val, double *bodyCoef, int *nodes, unsigned char *cellTypeUV, bool hybrid,
+							double *xu, double *yu, double *xv, double *yv,
+							double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y,
+							int numRows, int nx, int ny)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numRows)
+		return;
+
+	int node = nodes[k],
+		numU = (nx-1)*ny;
+	bool isU = node < numU;
+	int width	= isU ? nx-1 : nx,
+		offset	= isU ? 0 : numU,
+		I		= (node-offset) % width,
+		J		= (node-offset) / width,
+		ii		= I-5,
+		jj		= J-5;
+	double	*xn	= isU ? xu : xv,
+			*yn	= isU ? yu : yv;
+
+	//the point being interpolated to
+	double	px = hybrid ? xn[I] : image_point_x[node],
+			py = hybrid ? yn[J] : image_point_y[node];
+
+	//find x and y of nodes that bound the image point
+	while (xn[ii] < image_point_x[node])
+		ii++;
+	while (yn[jj] < image_point_y[node])
+		jj++;
+
+	/*
+	 *   (x3,y3)__________(x4,y4)
+	 *   |						|
+	 *   | 		*(ip_x,ip_y)	|
+	 *   |						|
+	 *   (x1,y1)__________(x2,y2)
+	 */
+	int corner[4] = {(jj-1)*width + ii-1 + offset,
+					 (jj-1)*width + ii   + offset,
+					  jj   *width + ii-1 + offset,
+					  jj   *width + ii   + offset};
+	double	x[4] = {xn[ii-1], xn[ii], xn[ii-1], xn[ii]},
+			y[4] = {yn[jj-1], yn[jj-1], yn[jj], yn[jj]};
+	bool inside[4];
+	for (int l=0; l<4; l++)
+	{
+		inside[l] = hybrid ? corner[l] == node : cellType::isGhost(cellTypeUV[corner[l]]);
+		if (inside[l])
+		{
+			int bi = hybrid ? node : corner[l];
+			x[l] = body_intercept_x[bi];
+			y[l] = body_intercept_y[bi];
+		}
+	}
+
+	double w[4];
+	bilinearWeights(x, y, px, py, w);
+
+	double sign = hybrid ? 1 : -1,
+		   body = hybrid ? 0 : 2;
+	for (int l=0; l<4; l++)
+	{
+		if (inside[l])
+		{
+			body += sign*w[l];
+			col[4*k+l] = node;
+			val[4*k+l] = 0;
+		}
+		else
+		{
+			col[4*k+l] = corner[l];
+			val[4*k+l] = sign*w[l];
+		}
+	}
+	bodyCoef[k] = body;
+}
+
+/*
+ * Scatters the result of the interpolation SpMV back into the velocity array and adds the body velocity
+ * the body velocity of a row is the velocity of its own body at its intercept, set by the tagging kernels in uv,
+ * so every body moves with its own velocity. The intercepts of the other ghost nodes a ghost row uses are a cell away
+ * on the same body, they are given the velocity of the row's intercept, exact for a translating body.
+ * param u velocity array the rows are written to
+ * param Wu the interpolation operator times the velocity
+ * param nodes velocity index of each row
+ * param bodyCoef coefficient of the body velocity for each row
+ * param uv body velocity at the intercept of each velocity node
+ */
+__global__
+void applyInterpolation(double *u, double *Wu, int *nodes, double *bodyCoef, double *uv, int numRows)
+{
+	int k = threadIdx.x + blockDim.x * blockIdx.x;
+	if (k >= numRows)
+		return;
+	int node = nodes[k];
+	u[node] = Wu[k] + bodyCoef[k] * uv[node];
+}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace kernels
+{
+__global__
+void interpolationWeights(int *col, double *val, double *bodyCoef, int *nodes, unsigned char *cellTypeUV, bool hybrid,
+							double *xu, double *yu, double *xv, double *yv,
+							double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y,
+							int numRows, int nx, int ny);
+
+__global__
+void applyInterpolation(double *u, double *Wu, int *nodes, double *bodyCoef, double *uv, int numRows);
+}
@@ -7,23 +7,23 @@
  */
 
 #include "tagPoints.h"
+#include "cellType.h"
 
 namespace kernels
 {
-__global__
-void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
+/*
+ * tags the u node (I,J) against one closed body
+ * param first, last the body is made of the boundary points first to last-1
+ * param midX, midY centre of the body, tells which side of the body a crossing is on
+ */
+__device__
+void tag_u_body(unsigned char *cellTypeUV, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
 			double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y,
 			double *x1, double *y1, double *x2, double *y2, //testing
 			double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
-			int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY) //flag, distance from u to body not used for luo
+			int I, int J, int nx, int ny, int first, int last, double midX, double midY) //flag, distance from u to body not used for luo
 {
-	// calculate indices
-	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
-		i	= idx % (i_end-i_start),
-		j	= idx / (i_end-i_start),
-		I	= i_start + i,
-		J	= j_start + j,
-		iu = J*(nx-1) + I,
+	int iu = J*(nx-1) + I,
 		ip = J*nx + I;
 
 	// return if out of bounds of the array
@@ -31,8 +31,8 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 			return;
 
 	// initial indices of the points on the body that define the segment under consideration
-	int 	k = totalPoints-1,
-			l = 0;
+	int 	k = last-1,
+			l = first;
 
 	// logic for the segment
 	bool	outsideX = true,
@@ -61,7 +61,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 	distance_from_u_to_body[ip] = 0;
 	distance_from_u_to_body[ip] = 0;
 	// cycle through all the segments on the body surface
-	while(l<totalPoints && !flag)
+	while(l<last && !flag)
 	{
 		// figure out which of the two end points of the segment are at the bottom and the left
 		if (by[k] > by[l])
@@ -103,7 +103,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 				{
 					outsideX  = true;
 					bdryFlagX = iu;
-					ghostTagsUV[iu] = iu;
+					cellTypeUV[iu] = cellType::GHOST;
 					Xa        = 0.0;
 					Xb        = 1.0;
 					flag      = true; // flag is true when the point of intersection coincides with the grid point
@@ -121,7 +121,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					bdryFlag2X = iu+1;
 					if (x>midX+eps)
 					{
-						ghostTagsUV[iu-1]	= iu-1;
+						cellTypeUV[iu-1] = cellType::GHOST;
 						//calculate image point and body point for ghost node
 
 						x1[iu-1] = bx[l];
@@ -139,6 +139,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iu-1] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iu-1] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iu-1] = uB[k] + (uB[l]-uB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iu-1] = body_intercept_y[iu-1]+(body_intercept_y[iu-1]-yu[J]);//flag change so it doesn't access memory twice
 						image_point_x[iu-1] = body_intercept_x[iu-1]+(body_intercept_x[iu-1]-xu[I-1]);
 						//calculate ip and bp for hybrid node
@@ -174,7 +175,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					bdryFlag2X = iu-1;
 					if(x<midX-eps)
 					{
-						ghostTagsUV[iu+1]	= iu+1;
+						cellTypeUV[iu+1] = cellType::GHOST;
 						x1[iu+1] = bx[l];
 						y1[iu+1] = by[l];
 						x2[iu+1] = bx[k];
@@ -190,6 +191,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iu+1] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iu+1] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iu+1] = uB[k] + (uB[l]-uB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iu+1] = body_intercept_y[iu+1]+(body_intercept_y[iu+1]-yu[J]);
 						image_point_x[iu+1] = body_intercept_x[iu+1]+(body_intercept_x[iu+1]-xu[I+1]);
 						//calculate ip and bp for hybrid node
@@ -239,7 +241,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					outsideY  = true; // then the point is considered to be outside the grid
 					bdryFlagY = iu;    // the point is considered to be a forcing point, with index iu
 					bdryFlag2Y= iu;
-					ghostTagsUV[iu]=iu;
+					cellTypeUV[iu] = cellType::GHOST;
 					Ya        = 0.0;  // the coefficient for the linear interpolation during forcing
 					Yb        = 1.0;
 					flag      = true; // flag is true when the point of intersection coincides with the grid point
@@ -258,7 +260,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					//if (outsideY)
 					if(y>midY+eps)
 					{
-						ghostTagsUV[iu-(nx-1)]=iu-(nx-1);
+						cellTypeUV[iu-(nx-1)] = cellType::GHOST;
 						x1[iu-(nx-1)] = bx[l];
 						y1[iu-(nx-1)] = by[l];
 						x2[iu-(nx-1)] = bx[k];
@@ -274,6 +276,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iu-(nx-1)] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iu-(nx-1)] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iu-(nx-1)] = uB[k] + (uB[l]-uB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iu-(nx-1)] = body_intercept_y[iu-(nx-1)]+(body_intercept_y[iu-(nx-1)]-yu[J-1]);
 						image_point_x[iu-(nx-1)] = body_intercept_x[iu-(nx-1)]+(body_intercept_x[iu-(nx-1)]-xu[I]);
 						//calculate ip and bp for hybrid node
@@ -307,7 +310,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					//if (outsideY)
 					if (y<midY-eps)
 					{
-						ghostTagsUV[iu+(nx-1)]=iu+(nx-1);
+						cellTypeUV[iu+(nx-1)] = cellType::GHOST;
 						x1[iu+(nx-1)] = bx[l];
 						y1[iu+(nx-1)] = by[l];
 						x2[iu+(nx-1)] = bx[k];
@@ -323,6 +326,7 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iu+(nx-1)] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iu+(nx-1)] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iu+(nx-1)] = uB[k] + (uB[l]-uB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iu+(nx-1)] = body_intercept_y[iu+(nx-1)]+(body_intercept_y[iu+(nx-1)]-yu[J+1]);
 						image_point_x[iu+(nx-1)] = body_intercept_x[iu+(nx-1)]+(body_intercept_x[iu+(nx-1)]-xu[I]);
 						//calculate ip and bp for hybrid node
@@ -355,37 +359,30 @@ void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 	if (outsideX && bdryFlagX>=0)
 	{
-		ghostTagsUV[iu]	= -1;
-		hybridTagsUV[iu]	= bdryFlagX;
-		hybridTagsUV2[iu]	= bdryFlag2X;
+		cellTypeUV[iu] = cellType::HYBRID | (bdryFlag2X >= 0 ? cellType::HYBRID2 : cellType::FLUID);
 		distance_from_intersection_to_node[iu]		= Xa;
 		distance_between_nodes_at_IB[iu]		= Xb;
 		uv[iu]		= uvX;
 	}
 	else if (outsideY && bdryFlagY>=0)
 	{
-		ghostTagsUV[iu]	= -1;
-		hybridTagsUV[iu]	= bdryFlagY;
-		hybridTagsUV2[iu]	= bdryFlag2Y;
+		cellTypeUV[iu] = cellType::HYBRID | (bdryFlag2Y >= 0 ? cellType::HYBRID2 : cellType::FLUID);
 		distance_from_intersection_to_node[iu]		= Ya;
 		distance_between_nodes_at_IB[iu]		= Yb;
 		uv[iu]		= uvY;
 	}
 }
 
-__global__
-void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
+/*
+ * tags the v node (I,J) against one closed body, see tag_u_body
+ */
+__device__
+void tag_v_body(unsigned char *cellTypeUV, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
 				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
 				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
-				int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY)
+				int I, int J, int nx, int ny, int first, int last, double midX, double midY)
 {
-	// calculate indicies indices
-	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
-		i	= idx % (i_end-i_start),
-		j	= idx / (i_end-i_start),
-		I	= i_start + i,
-		J	= j_start + j,
-		iv	= J*nx + I + (nx-1)*ny,
+	int iv	= J*nx + I + (nx-1)*ny,
 		ip	= J*nx + I;
 
 	// return if out of bounds of the array
@@ -393,8 +390,8 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 			return;
 
 	// initial indices of the points on the body that define the segment under consideration
-	int 	k = totalPoints-1,
-			l = 0;
+	int 	k = last-1,
+			l = first;
 
 	// logic for the segment
 	bool	outsideX = true,
@@ -419,7 +416,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 			y,
 			p,o,b,a,
 			theta_321;
-	while(l<totalPoints)
+	while(l<last)
 	{
 		if (by[k] > by[l])
 		{
@@ -459,7 +456,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					outsideX   = true;
 					bdryFlagX = iv;
 					bdryFlag2X= iv;
-					ghostTagsUV[iv] = iv;
+					cellTypeUV[iv] = cellType::GHOST;
 					Xa        = 0.0;
 					Xb        = 1.0;
 					flag      = true;
@@ -475,7 +472,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					bdryFlag2X = iv+1;
 					if (x>midX+eps)
 					{
-						ghostTagsUV[iv-1] = iv-1;
+						cellTypeUV[iv-1] = cellType::GHOST;
 						//ghost node interpolation
 						x1[iv-1] = bx[l];
 						y1[iv-1] = by[l];
@@ -492,6 +489,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iv-1] = by[k] + (by[l]-by[k])/p * a/tan(theta_321); //body intercept point, forms a right angle with lines 1-2 and 4-3
 						body_intercept_x[iv-1] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iv-1] = vB[k] + (vB[l]-vB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iv-1] = body_intercept_y[iv-1]+(body_intercept_y[iv-1]-yv[J]); //image point, mirror the ghost node accross line 1-2
 						image_point_x[iv-1] = body_intercept_x[iv-1]+(body_intercept_x[iv-1]-xv[I-1]);
 						//hybrid node interpolation
@@ -523,7 +521,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					bdryFlag2X = iv-1;
 					if (x<midX-eps)
 					{
-						ghostTagsUV[iv+1] = iv+1;
+						cellTypeUV[iv+1] = cellType::GHOST;
 						x1[iv+1] = bx[l];
 						y1[iv+1] = by[l];
 						x2[iv+1] = bx[k];
@@ -539,6 +537,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iv+1] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iv+1] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iv+1] = vB[k] + (vB[l]-vB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iv+1] = body_intercept_y[iv+1]+(body_intercept_y[iv+1]-yv[J]);
 						image_point_x[iv+1] = body_intercept_x[iv+1]+(body_intercept_x[iv+1]-xv[I+1]);
 						//hybrid node interpolation
@@ -582,7 +581,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					outsideY   = true;
 					bdryFlagY = iv;
 					bdryFlag2Y= iv;
-					ghostTagsUV[iv] = iv;
+					cellTypeUV[iv] = cellType::GHOST;
 					Ya        = 0.0;
 					Yb        = 1.0;
 					flag      = true;
@@ -598,7 +597,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					bdryFlag2Y = iv+nx;
 					if (y>midY+eps)
 					{
-						ghostTagsUV[iv-nx] = iv-nx;
+						cellTypeUV[iv-nx] = cellType::GHOST;
 						x1[iv-nx] = bx[l];
 						y1[iv-nx] = by[l];
 						x2[iv-nx] = bx[k];
@@ -614,6 +613,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iv-nx] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iv-nx] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iv-nx] = vB[k] + (vB[l]-vB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iv-nx] = body_intercept_y[iv-nx]+(body_intercept_y[iv-nx]-yv[J-1]);
 						image_point_x[iv-nx] = body_intercept_x[iv-nx]+(body_intercept_x[iv-nx]-xv[I]);
 						//hybrid node interpolation
@@ -649,7 +649,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 					bdryFlag2Y = iv-nx;
 					if(y<midY-eps)
 					{
-						ghostTagsUV[iv+nx] = iv+nx;
+						cellTypeUV[iv+nx] = cellType::GHOST;
 						x1[iv+nx] = bx[l];
 						y1[iv+nx] = by[l];
 						x2[iv+nx] = bx[k];
@@ -665,6 +665,7 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 
 						body_intercept_y[iv+nx] = by[k] + (by[l]-by[k])/p * a/tan(theta_321);
 						body_intercept_x[iv+nx] = bx[k] + (bx[l]-bx[k])/p * a/tan(theta_321);
+						uv[iv+nx] = vB[k] + (vB[l]-vB[k])/p * a/tan(theta_321); //body velocity at the intercept
 						image_point_y[iv+nx] = body_intercept_y[iv+nx]+(body_intercept_y[iv+nx]-yv[J+1]);
 						image_point_x[iv+nx] = body_intercept_x[iv+nx]+(body_intercept_x[iv+nx]-xv[I]);
 						//hybrid node interpolation
@@ -699,44 +700,37 @@ void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *
 	}
 	if (outsideY && bdryFlagY>=0)
 	{
-		ghostTagsUV[iv] = -1;
-		hybridTagsUV[iv]    = bdryFlagY;
-		hybridTagsUV2[iv]   = bdryFlag2Y;
+		cellTypeUV[iv] = cellType::HYBRID | (bdryFlag2Y >= 0 ? cellType::HYBRID2 : cellType::FLUID);
 		distance_from_intersection_to_node[iv]  = Ya;
 		distance_between_nodes_at_IB[iv] = Yb;
 		uv[iv]      = uvY;
 	}
 	else if (outsideX && bdryFlagX>=0)
 	{
-		ghostTagsUV[iv] = -1;
-		hybridTagsUV[iv]    = bdryFlagX;
-		hybridTagsUV2[iv]   = bdryFlag2X;
+		cellTypeUV[iv] = cellType::HYBRID | (bdryFlag2X >= 0 ? cellType::HYBRID2 : cellType::FLUID);
 		distance_from_intersection_to_node[iv]  = Xa;
 		distance_between_nodes_at_IB[iv] = Xb;
 		uv[iv]      = uvX;
 	}
 }
 
-__global__
-void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double *yu, double *xv,
+/*
+ * tags the pressure node (I,J) against one closed body, see tag_u_body
+ */
+__device__
+void tag_p_body(unsigned char *cellTypeP, double *bx, double *by, double *yu, double *xv,
 				double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y, double *x1_p, double *y1_p, double *x2_p, double *y2_p,
-				int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY)
+				int I, int J, int nx, int ny, int first, int last, double midX, double midY)
 {
-	// calculate indicies indices
-	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
-		i	= idx % (i_end-i_start),
-		j	= idx / (i_end-i_start),
-		I	= i_start + i,
-		J	= j_start + j,
-		ip	= J*nx + I;
+	int ip	= J*nx + I;
 
 	// return if out of bounds of the array
 	if (ip >= nx*ny)
 			return;
 
 	// initial indices of the points on the body that define the segment under consideration
-	int 	k = totalPoints-1,
-			l = 0;
+	int 	k = last-1,
+			l = first;
 
 	// logic for the segment
 	bool	flag = false;
@@ -750,8 +744,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 			p,o,b,a,
 			theta_321;
 
-	//ghostTagsP[ip] = 1000;
-	while(l<totalPoints)
+	while(l<last)
 	{
 		if (by[k] > by[l])
 		{
@@ -786,7 +779,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				// just inside, right of mid
 				if (x > midX + eps && x > xv[I] + eps && x < xv[I+1] + eps)
 				{
-					ghostTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
 					x2_p[ip] = bx[k];
@@ -808,7 +801,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				// just inside, left of mid
 				else if (x < midX + eps && x < xv[I] +eps && x > xv[I-1])
 				{
-					ghostTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
 					x2_p[ip] = bx[k];
@@ -831,7 +824,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				// just inside, right of mid
 				if (x > midX + eps && x < xv[I] + eps && x > xv[I-1] + eps)
 				{
-					hybridTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 					//hybrid node interpolation
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
@@ -854,7 +847,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				// just inside, left of mid
 				else if (x < midX + eps && x > xv[I] +eps && x < xv[I+1] + eps)
 				{
-					hybridTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 					//hybrid node interpolation
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
@@ -893,7 +886,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				// just inside, north of mid
 				if (y > midY + eps && y > yu[J] +eps && y < yu[J+1])
 				{
-					ghostTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
 					x2_p[ip] = bx[k];
@@ -915,7 +908,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				//just inside, south of mid
 				else if (y < midY + eps && y < yu[J] +eps && y > yu[J-1] +eps)
 				{
-					ghostTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::GHOST;
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
 					x2_p[ip] = bx[k];
@@ -938,7 +931,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				// just inside, north of mid
 				if (y > midY + eps && y < yu[J] +eps && y > yu[J-1])
 				{
-					hybridTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 					//hybrid node interpolation
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
@@ -961,7 +954,7 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 				//just inside, south of mid
 				else if (y < midY + eps && y > yu[J] +eps && y < yu[J+1] +eps)
 				{
-					hybridTagsP[ip] = ip;
+					cellTypeP[ip] |= cellType::HYBRID;
 					//hybrid node interpolation
 					x1_p[ip] = bx[l];
 					y1_p[ip] = by[l];
@@ -988,151 +981,465 @@ void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double
 	}// end while
 }
 
+/*
+ * The tagging kernels run over a work list of boxes, 4 ints per box: first cell I, J and the width and height in cells.
+ * The boxes never overlap, so each cell is visited once however many bodies there are, and the cells far from
+ * every body are never visited. Thread idx takes the idx-th cell of the list, the boxes are taken in order.
+ * returns false if idx is past the last cell
+ */
+__device__ inline
+bool workCell(int idx, int *boxes, int numBoxes, int &I, int &J)
+{
+	for (int b=0; b<numBoxes; b++)
+	{
+		int	w = boxes[4*b+2],
+			n = w*boxes[4*b+3];
+		if (idx < n)
+		{
+			I = boxes[4*b] + idx % w;
+			J = boxes[4*b+1] + idx / w;
+			return true;
+		}
+		idx -= n;
+	}
+	return false;
+}
+
+/*
+ * row idx of the work list, the row runs from I = i0 to i1-1
+ */
+__device__ inline
+bool workRow(int idx, int *boxes, int numBoxes, int &i0, int &i1, int &J)
+{
+	for (int b=0; b<numBoxes; b++)
+	{
+		if (idx < boxes[4*b+3])
+		{
+			i0 = boxes[4*b];
+			i1 = i0 + boxes[4*b+2];
+			J = boxes[4*b+1] + idx;
+			return true;
+		}
+		idx -= boxes[4*b+3];
+	}
+	return false;
+}
+
+/*
+ * true if the cell (I,J) is in the box of body b, bodyBoxes holds the first and one past the last cell of each body: i0 j0 i1 j1
+ */
+__device__ inline
+bool inBodyBox(int *bodyBoxes, int b, int I, int J)
+{
+	return I >= bodyBoxes[4*b] && J >= bodyBoxes[4*b+1] && I < bodyBoxes[4*b+2] && J < bodyBoxes[4*b+3];
+}
+
+/*
+ * tags the u nodes of the work list against every body whose box holds the node
+ * where the boxes of two bodies overlap the node is tagged against each body in turn, a node that is a hybrid node
+ * of both keeps the tag, intercept and velocity of the last one. A ghost node is written by the thread of the node
+ * next to it, so a node that is a ghost node of one body and next to the surface of another is a race.
+ * Both only happen when two surfaces are less than two cells apart, bodies::initialise warns about that.
+ */
 __global__
-void zero_pressure_luo(int *ghostTagsP,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
+void tag_u_luo(unsigned char *cellTypeUV, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
+			double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y,
+			double *x1, double *y1, double *x2, double *y2,
+			double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
+			int *tagBoxes, int numBoxes, int *bodyBoxes, int *offsets, int *numPoints, double *centre, int numBodies, int nx, int ny)
 {
-	// calculate indicies indices
-	int j	= threadIdx.x + blockDim.x * blockIdx.x,
-		J	= j_start + j,
-		I;
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, tagBoxes, numBoxes, I, J))
+		return;
+	for (int b=0; b<numBodies; b++)
+		if (inBodyBox(bodyBoxes, b, I, J))
+			tag_u_body(cellTypeUV, bx, by, uB, vB, yu, xu, body_intercept_x, body_intercept_y, image_point_x, image_point_y,
+					x1, y1, x2, y2, distance_from_intersection_to_node, distance_between_nodes_at_IB, distance_from_u_to_body, distance_from_v_to_body, uv,
+					I, J, nx, ny, offsets[b], offsets[b]+numPoints[b], centre[2*b], centre[2*b+1]);
+}
 
-	if (J > j_end)
+/*
+ * tags the v nodes of the work list against every body whose box holds the node
+ */
+__global__
+void tag_v_luo(unsigned char *cellTypeUV, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
+				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
+				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
+				int *tagBoxes, int numBoxes, int *bodyBoxes, int *offsets, int *numPoints, double *centre, int numBodies, int nx, int ny)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, tagBoxes, numBoxes, I, J))
 		return;
+	for (int b=0; b<numBodies; b++)
+		if (inBodyBox(bodyBoxes, b, I, J))
+			tag_v_body(cellTypeUV, bx, by, uB, vB, yv, xv, body_intercept_x, body_intercept_y, image_point_x, image_point_y,
+					x1, y1, x2, y2, distance_from_intersection_to_node, distance_between_nodes_at_IB, distance_from_u_to_body, distance_from_v_to_body, uv,
+					I, J, nx, ny, offsets[b], offsets[b]+numPoints[b], centre[2*b], centre[2*b+1]);
+}
 
-	bool 	rowIsntDone = true,
-			flag 		= false;
+/*
+ * tags the pressure nodes of the work list against every body whose box holds the node
+ */
+__global__
+void tag_p_luo(unsigned char *cellTypeP, double *bx, double *by, double *yu, double *xv,
+				double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y, double *x1_p, double *y1_p, double *x2_p, double *y2_p,
+				int *tagBoxes, int numBoxes, int *bodyBoxes, int *offsets, int *numPoints, double *centre, int numBodies, int nx, int ny)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, tagBoxes, numBoxes, I, J))
+		return;
+	for (int b=0; b<numBodies; b++)
+		if (inBodyBox(bodyBoxes, b, I, J))
+			tag_p_body(cellTypeP, bx, by, yu, xv, body_intercept_p_x, body_intercept_p_y, image_point_p_x, image_point_p_y, x1_p, y1_p, x2_p, y2_p,
+					I, J, nx, ny, offsets[b], offsets[b]+numPoints[b], centre[2*b], centre[2*b+1]);
+}
 
-	for (int i=i_start; i<i_end; i++)
+/*
+ * marks the untagged runs of nodes first to first+n-1 that have a ghost node at both ends as solid
+ * a row through a body always starts and ends on a ghost node, the surface is crossed between it and its fluid neighbour,
+ * so the runs between bodies are left alone however many bodies are on the row
+ * uv, if given, is the body velocity of each node, the solid nodes take the velocity at the intercept of the ghost node
+ * at the left end of their run, which belongs to the same body
+ */
+__device__ inline
+void fill_row(unsigned char *types, double *uv, int first, int n)
+{
+	int left = -1;
+	for (int i=0; i<n; i++)
 	{
-		I = J*nx+i;
-		if (ghostTagsP[I-1] >= 0)
-		{
-			if (ghostTagsP[I]!=-1 && ghostTagsP[I-1]==0)
-			{
-				rowIsntDone = false;
-			}
-			if(ghostTagsP[I]==-1 && rowIsntDone)
+		unsigned char t = types[first+i];
+		if (t == cellType::FLUID)
+			continue;
+		if (left >= 0 && cellType::isGhost(types[first+left]) && cellType::isGhost(t))
+			for (int k=left+1; k<i; k++)
 			{
-				ghostTagsP[I]=0;
+				types[first+k] |= cellType::SOLID;
+				if (uv)
+					uv[first+k] = uv[first+left];
 			}
-			if(ghostTagsP[I]==0 && ghostTagsP[I-1] !=0)
-			{
-				int k = i;
-				while (k < nx)
-				{
-					k++;
-					if (ghostTagsP[J*nx+k] != -1 )
-					{
-						flag = true;
-					}
-				}
-				if (!flag)
-				{
-					ghostTagsP[I]=-1;
-					rowIsntDone = false;
-				}
-			}
-		}
+		left = i;
 	}
 }
 
+/*
+ * marks the pressure nodes inside the bodies as solid, one thread per row of the work list
+ */
 __global__
-void zero_x_luo(int *ghostTagsUV,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
+void zero_pressure_luo(unsigned char *cellTypeP, int *tagBoxes, int numBoxes, int nx, int ny)
 {
-	// calculate indicies indices
-	int j	= threadIdx.x + blockDim.x * blockIdx.x,
-		J	= j_start + j,
-		I;
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		i0, i1, J;
+	if (!workRow(idx, tagBoxes, numBoxes, i0, i1, J))
+		return;
+	fill_row(cellTypeP, 0, J*nx + i0, i1-i0);
+}
+
+/*
+ * marks the u nodes inside the bodies as solid, one thread per row of the work list
+ */
+__global__
+void zero_x_luo(unsigned char *cellTypeUV, double *uv, int *tagBoxes, int numBoxes, int nx, int ny)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		i0, i1, J;
+	if (!workRow(idx, tagBoxes, numBoxes, i0, i1, J))
+		return;
+	if (i1 > nx-1)
+		i1 = nx-1;
+	fill_row(cellTypeUV, uv, J*(nx-1) + i0, i1-i0);
+}
 
-	if (J > j_end)
+/*
+ * marks the v nodes inside the bodies as solid, one thread per row of the work list
+ */
+__global__
+void zero_y_luo(unsigned char *cellTypeUV, double *uv, int *tagBoxes, int numBoxes, int nx, int ny)
+{
+	int idx = threadIdx.x + blockDim.x * blockIdx.x,
+		i0, i1, J;
+	if (!workRow(idx, tagBoxes, numBoxes, i0, i1, J) || J >= ny-1)
 		return;
+	fill_row(cellTypeUV, uv, J*nx + i0 + (nx-1)*ny, i1-i0);
+}
 
-	bool 	rowIsntDone = true,
-			flag 		= false;
-	for (int i=i_start; i<i_end; i++)
+/*
+ * saves the cell types and image points of the nodes in the work list then resets them to their untagged values
+ * one thread per pressure cell of the work list, each thread handles the u, v and p node with the same I,J
+ */
+__global__
+void reset_tags_luo(unsigned char *cellTypeUV, unsigned char *cellTypeP, unsigned char *cellTypeUVOld, unsigned char *cellTypePOld,
+					double *image_point_x, double *image_point_y, double *image_point_p_x, double *image_point_p_y,
+					double *image_point_x_old, double *image_point_y_old, double *image_point_p_x_old, double *image_point_p_y_old,
+					double *body_intercept_x, double *body_intercept_y, double *x1, double *y1, double *x2, double *y2,
+					double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB,
+					int *boxes, int numBoxes, int nx, int ny)
+{
+	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, boxes, numBoxes, I, J))
+		return;
+	int	ip	= J*nx + I,
+		iu	= J*(nx-1) + I,
+		iv	= J*nx + I + (nx-1)*ny;
+
+	cellTypePOld[ip]		= cellTypeP[ip];
+	image_point_p_x_old[ip]	= image_point_p_x[ip];
+	image_point_p_y_old[ip]	= image_point_p_y[ip];
+	cellTypeP[ip]			= cellType::FLUID;
+
+	int n[2] = {iu, iv};
+	bool valid[2] = {I < nx-1, J < ny-1};
+	for (int m=0; m<2; m++)
 	{
-		I = J*(nx-1)+i;
+		if (!valid[m])
+			continue;
+		int k = n[m];
+		cellTypeUVOld[k]		= cellTypeUV[k];
+		image_point_x_old[k]	= image_point_x[k];
+		image_point_y_old[k]	= image_point_y[k];
+		cellTypeUV[k]			= cellType::FLUID;
+		distance_from_intersection_to_node[k]	= 1;
+		distance_between_nodes_at_IB[k]		= 1;
+		x1[k] = 0;
+		y1[k] = 0;
+		x2[k] = 0;
+		y2[k] = 0;
+		body_intercept_x[k]	= 0;
+		body_intercept_y[k]	= 0;
+		image_point_x[k]	= 0;
+		image_point_y[k]	= 0;
+	}
+}
 
-		if (ghostTagsUV[I-1] >= 0)
+/*
+ * lists the nodes in the work list whose cell types or image points differ from the values saved by reset_tags_luo
+ * these are the rows of LHS1 (changedRowsUV) and LHS2 (changedRowsP) that have to be reassembled, in no particular order
+ * numChanged holds the lengths of the two lists, a list is only complete if its length doesn't exceed its capacity
+ */
+__global__
+void mark_changed_luo(int *numChanged, int *changedRowsUV, int *changedRowsP, int capacityUV, int capacityP,
+					unsigned char *cellTypeUV, unsigned char *cellTypeP, unsigned char *cellTypeUVOld, unsigned char *cellTypePOld,
+					double *image_point_x, double *image_point_y, double *image_point_p_x, double *image_point_p_y,
+					double *image_point_x_old, double *image_point_y_old, double *image_point_p_x_old, double *image_point_p_y_old,
+					int *boxes, int numBoxes, int nx, int ny)
+{
+	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, boxes, numBoxes, I, J))
+		return;
+	int	ip	= J*nx + I,
+		iu	= J*(nx-1) + I,
+		iv	= J*nx + I + (nx-1)*ny;
+
+	bool tagged = (cellTypeP[ip] & (cellType::GHOST | cellType::HYBRID)) != 0;
+	if (cellTypeP[ip] != cellTypePOld[ip]
+		|| (tagged && (image_point_p_x[ip] != image_point_p_x_old[ip] || image_point_p_y[ip] != image_point_p_y_old[ip])))
+	{
+		int k = atomicAdd(&numChanged[1], 1);
+		if (k < capacityP)
+			changedRowsP[k] = ip;
+	}
+
+	int n[2] = {iu, iv};
+	bool valid[2] = {I < nx-1, J < ny-1};
+	for (int m=0; m<2; m++)
+	{
+		if (!valid[m])
+			continue;
+		int k = n[m];
+		if (cellTypeUV[k] != cellTypeUVOld[k] || image_point_x[k] != image_point_x_old[k] || image_point_y[k] != image_point_y_old[k])
 		{
-			if (ghostTagsUV[I]!=-1 && ghostTagsUV[I-1]==0)
-			{
-				rowIsntDone = false;
-			}
-			if(ghostTagsUV[I]==-1 && rowIsntDone)
-			{
-				ghostTagsUV[I]=0;
-			}
-			if(ghostTagsUV[I]==0 && ghostTagsUV[I-1] !=0)
-			{
-				int k = i;
-				while (k < nx-1)
-				{
-					k++;
-					if (ghostTagsUV[J*(nx-1)+k] != -1 )
-					{
-						flag = true;
-					}
-				}
-				if (!flag)
-				{
-					ghostTagsUV[I]=-1;
-					rowIsntDone = false;
-				}
-			}
+			int l = atomicAdd(&numChanged[0], 1);
+			if (l < capacityUV)
+				changedRowsUV[l] = k;
 		}
 	}
 }
 
-__global__
-void zero_y_luo(int *ghostTagsUV,  int i_start, int j_start, int i_end, int j_end, int nx, int ny)
+/*
+ * classifies the node (x,y) against the shape S using the rays along x and y through the node
+ * xm, xp, ym, yp are the coordinates of the neighbouring nodes of the same kind on the left, right, bottom and top
+ * a node inside the shape is a ghost node if the surface crosses one of its rays before the neighbouring node,
+ * a node outside the shape is a hybrid node under the same condition
+ * the choices follow tag_u_body and tag_v_body so both paths give the same tags:
+ * the ray along the velocity component is tried first (x for u and p, y for v) and a node the surface passes through
+ * is a hybrid node with Xa = 0 and Xb = 1, onSurfaceX is its type when that happens on the x ray (tag_u_body leaves out HYBRID2)
+ * param firstRay 0 to try the x ray first, 1 for the y ray
+ * param Xa distance from the crossing to the hybrid node
+ * param Xb distance from the hybrid node to the next node away from the body
+ * returns the cell type, bx by is the closest point on the surface if the node is tagged
+ */
+__device__ inline
+unsigned char classify_shape(const shape &S, double x, double y, double xm, double xp, double ym, double yp, double range,
+							int firstRay, unsigned char onSurfaceX, double &Xa, double &Xb, double &bx, double &by)
 {
-	// calculate indicies indices
-	int j	= threadIdx.x + blockDim.x * blockIdx.x,
-		J	= j_start + j,
-		I;
+	const double eps = 1.e-10;
+	double	t;
+	bool	inside = geometry::isInside(S, x, y);
+
+	//rays along x and along y, looking back towards the previous node and forward towards the next
+	double	u[2]	= {1, 0},
+			v[2]	= {0, 1},
+			back[2]	= {x-xm, y-ym},
+			front[2]= {xp-x, yp-y};
+	for (int n=0; n<2; n++)
+	{
+		int d = (n+firstRay)%2;
+		bool crossed = false;
+		if (geometry::firstCrossing(S, x, y, -u[d], -v[d], back[d]-eps, range, t))
+		{
+			crossed = true;
+			Xa = t;
+			Xb = front[d];
+		}
+		else if (geometry::firstCrossing(S, x, y, u[d], v[d], front[d]-eps, range, t))
+		{
+			crossed = true;
+			Xa = t;
+			Xb = back[d];
+		}
+		if (!crossed)
+			continue;
+		geometry::closestPoint(S, x, y, bx, by);
+		//the surface passes through the node
+		if (t < eps)
+		{
+			Xa = 0;
+			Xb = 1;
+			return (d == 0) ? onSurfaceX : (cellType::HYBRID | cellType::HYBRID2);
+		}
+		return inside ? cellType::GHOST : (cellType::HYBRID | cellType::HYBRID2);
+	}
+	return cellType::FLUID;
+}
 
-	if (J > j_end)
+/*
+ * tags the u nodes against an analytic shape, each thread only writes its own node
+ * uv is the rigid body velocity at the intercept, found from boundary point 0 and the angular velocity
+ * param range half length of the segment searched for crossings, see geometry::crossings
+ */
+__global__
+void tag_u_shape(unsigned char *cellTypeUV, shape S, double *uB, double *yB, double angVel, double *yu, double *xu,
+				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
+				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *uv,
+				int *tagBoxes, int numBoxes, int nx, int ny, double range)
+{
+	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, tagBoxes, numBoxes, I, J) || I > nx-3 || J > ny-2)
 		return;
+	int iu	= J*(nx-1) + I;
 
-	bool 	rowIsntDone = true,
-			flag 		= false;
+	double	Xa = 1, Xb = 1, bx, by;
+	unsigned char type = classify_shape(S, xu[I], yu[J], xu[I-1], xu[I+1], yu[J-1], yu[J+1], range,
+										0, cellType::HYBRID, Xa, Xb, bx, by);
+	if (type == cellType::FLUID)
+		return;
 
-	for (int i=i_start; i<i_end; i++)
+	cellTypeUV[iu]			= type;
+	body_intercept_x[iu]	= bx;
+	body_intercept_y[iu]	= by;
+	uv[iu]					= uB[0] - angVel*(by - yB[0]);
+	x1[iu] = bx;
+	y1[iu] = by;
+	x2[iu] = bx;
+	y2[iu] = by;
+	if (cellType::isGhost(type))
 	{
-		I = J*(nx)+i + (nx-1)*ny;
-		if (ghostTagsUV[I-1] >= 0)
-		{
-			if (ghostTagsUV[I]!=-1 && ghostTagsUV[I-1]==0)
-			{
-				rowIsntDone = false;
-			}
-			if(ghostTagsUV[I]==-1 && rowIsntDone)
-			{
-				ghostTagsUV[I]=0;
-			}
-			if(ghostTagsUV[I]==0 && ghostTagsUV[I-1] !=0)
-			{
-				int k = i;
-				while (k < nx-1)
-				{
-					k++;
-					if (ghostTagsUV[J*(nx)+k + (nx-1)*ny] != -1 )
-					{
-						flag = true;
-					}
-				}
-				if (!flag)
-				{
-					ghostTagsUV[I]=-1;
-					rowIsntDone = false;
-				}
-			}
-		}
+		image_point_x[iu] = 2*bx - xu[I];
+		image_point_y[iu] = 2*by - yu[J];
+	}
+	else
+	{
+		image_point_x[iu] = 2*xu[I] - bx;
+		image_point_y[iu] = 2*yu[J] - by;
+		distance_from_intersection_to_node[iu]	= Xa;
+		distance_between_nodes_at_IB[iu]		= Xb;
 	}
 }
 
+/*
+ * tags the v nodes against an analytic shape, see tag_u_shape
+ */
+__global__
+void tag_v_shape(unsigned char *cellTypeUV, shape S, double *vB, double *xB, double angVel, double *yv, double *xv,
+				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
+				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *uv,
+				int *tagBoxes, int numBoxes, int nx, int ny, double range)
+{
+	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, tagBoxes, numBoxes, I, J) || I > nx-2 || J > ny-3)
+		return;
+	int iv	= J*nx + I + (nx-1)*ny;
+
+	double	Xa = 1, Xb = 1, bx, by;
+	unsigned char type = classify_shape(S, xv[I], yv[J], xv[I-1], xv[I+1], yv[J-1], yv[J+1], range,
+										1, cellType::HYBRID | cellType::HYBRID2, Xa, Xb, bx, by);
+	if (type == cellType::FLUID)
+		return;
+
+	cellTypeUV[iv]			= type;
+	body_intercept_x[iv]	= bx;
+	body_intercept_y[iv]	= by;
+	uv[iv]					= vB[0] + angVel*(bx - xB[0]);
+	x1[iv] = bx;
+	y1[iv] = by;
+	x2[iv] = bx;
+	y2[iv] = by;
+	if (cellType::isGhost(type))
+	{
+		image_point_x[iv] = 2*bx - xv[I];
+		image_point_y[iv] = 2*by - yv[J];
+	}
+	else
+	{
+		image_point_x[iv] = 2*xv[I] - bx;
+		image_point_y[iv] = 2*yv[J] - by;
+		distance_from_intersection_to_node[iv]	= Xa;
+		distance_between_nodes_at_IB[iv]		= Xb;
+	}
+}
 
+/*
+ * tags the pressure nodes against an analytic shape, pressure nodes are only ghost or hybrid
+ */
+__global__
+void tag_p_shape(unsigned char *cellTypeP, shape S, double *yu, double *xv,
+				double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y, double *x1_p, double *y1_p, double *x2_p, double *y2_p,
+				int *tagBoxes, int numBoxes, int nx, int ny, double range)
+{
+	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
+		I, J;
+	if (!workCell(idx, tagBoxes, numBoxes, I, J) || I > nx-2 || J > ny-2)
+		return;
+	int ip	= J*nx + I;
 
+	double	Xa, Xb, bx, by;
+	unsigned char type = classify_shape(S, xv[I], yu[J], xv[I-1], xv[I+1], yu[J-1], yu[J+1], range,
+										0, cellType::HYBRID, Xa, Xb, bx, by);
+	if (type == cellType::FLUID)
+		return;
 
+	cellTypeP[ip] = cellType::isGhost(type) ? cellType::GHOST : cellType::HYBRID;
+	body_intercept_p_x[ip]	= bx;
+	body_intercept_p_y[ip]	= by;
+	x1_p[ip] = bx;
+	y1_p[ip] = by;
+	x2_p[ip] = bx;
+	y2_p[ip] = by;
+	if (cellType::isGhost(type))
+	{
+		image_point_p_x[ip] = 2*bx - xv[I];
+		image_point_p_y[ip] = 2*by - yu[J];
+	}
+	else
+	{
+		image_point_p_x[ip] = 2*xv[I] - bx;
+		image_point_p_y[ip] = 2*yu[J] - by;
+	}
+}
 }
@@ -1,34 +1,69 @@
 #pragma once
 
+#include <shape.h>
+
 namespace kernels
 {
+/*
+ * The kernels below run over a work list of boxes, 4 ints per box: first cell I, J, width and height in cells.
+ * bodyBoxes holds i0 j0 i1 j1 for each body, the cells a body can tag.
+ */
 __global__
-void tag_u_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
+void tag_u_luo(unsigned char *cellTypeUV, double *bx, double *by, double *uB, double *vB, double *yu, double *xu,
 				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y,
 				double *x1, double *y1, double *x2, double *y2, //testing
 				double *a, double *b, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
-				int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY);
+				int *tagBoxes, int numBoxes, int *bodyBoxes, int *offsets, int *numPoints, double *centre, int numBodies, int nx, int ny);
 
 __global__
-void tag_v_luo(int *hybridTagsUV, int *ghostTagsUV, int *hybridTagsUV2, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
+void tag_v_luo(unsigned char *cellTypeUV, double *bx, double *by, double *uB, double *vB, double *yv, double *xv,
 				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
 				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *distance_from_u_to_body, double *distance_from_v_to_body, double *uv,
-				int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY);
+				int *tagBoxes, int numBoxes, int *bodyBoxes, int *offsets, int *numPoints, double *centre, int numBodies, int nx, int ny);
 
 __global__
-void tag_p_luo(int *ghostTagsP, int *hybridTagsP, double *bx, double *by, double *yu, double *xv,
+void tag_p_luo(unsigned char *cellTypeP, double *bx, double *by, double *yu, double *xv,
 				double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y, double *x1_p, double *y1_p, double *x2_p, double *y2_p,
-				int i_start, int j_start, int i_end, int j_end, int nx, int ny, int totalPoints, double midX, double midY);
+				int *tagBoxes, int numBoxes, int *bodyBoxes, int *offsets, int *numPoints, double *centre, int numBodies, int nx, int ny);
+
+__global__
+void zero_pressure_luo(unsigned char *cellTypeP, int *tagBoxes, int numBoxes, int nx, int ny);
 
 __global__
-void zero_pressure_luo(int *ghostTagsP,  int i_start, int j_start, int i_end, int j_end, int nx, int ny);
+void zero_x_luo(unsigned char *cellTypeUV, double *uv, int *tagBoxes, int numBoxes, int nx, int ny);
 
 __global__
-void zero_x_luo(int *ghostTagsUV,  int i_start, int j_start, int i_end, int j_end, int nx, int ny);
+void zero_y_luo(unsigned char *cellTypeUV, double *uv, int *tagBoxes, int numBoxes, int nx, int ny);
 
 __global__
-void zero_y_luo(int *ghostTagsUV,  int i_start, int j_start, int i_end, int j_end, int nx, int ny);
+void reset_tags_luo(unsigned char *cellTypeUV, unsigned char *cellTypeP, unsigned char *cellTypeUVOld, unsigned char *cellTypePOld,
+					double *image_point_x, double *image_point_y, double *image_point_p_x, double *image_point_p_y,
+					double *image_point_x_old, double *image_point_y_old, double *image_point_p_x_old, double *image_point_p_y_old,
+					double *body_intercept_x, double *body_intercept_y, double *x1, double *y1, double *x2, double *y2,
+					double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB,
+					int *boxes, int numBoxes, int nx, int ny);
 
+__global__
+void mark_changed_luo(int *numChanged, int *changedRowsUV, int *changedRowsP, int capacityUV, int capacityP,
+					unsigned char *cellTypeUV, unsigned char *cellTypeP, unsigned char *cellTypeUVOld, unsigned char *cellTypePOld,
+					double *image_point_x, double *image_point_y, double *image_point_p_x, double *image_point_p_y,
+					double *image_point_x_old, double *image_point_y_old, double *image_point_p_x_old, double *image_point_p_y_old,
+					int *boxes, int numBoxes, int nx, int ny);
 
+__global__
+void tag_u_shape(unsigned char *cellTypeUV, shape S, double *uB, double *yB, double angVel, double *yu, double *xu,
+				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
+				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *uv,
+				int *tagBoxes, int numBoxes, int nx, int ny, double range);
 
+__global__
+void tag_v_shape(unsigned char *cellTypeUV, shape S, double *vB, double *xB, double angVel, double *yv, double *xv,
+				double *body_intercept_x, double *body_intercept_y, double *image_point_x, double *image_point_y, double *x1, double *y1, double *x2, double *y2,
+				double *distance_from_intersection_to_node, double *distance_between_nodes_at_IB, double *uv,
+				int *tagBoxes, int numBoxes, int nx, int ny, double range);
+
+__global__
+void tag_p_shape(unsigned char *cellTypeP, shape S, double *yu, double *xv,
+				double *body_intercept_p_x, double *body_intercept_p_y, double *image_point_p_x, double *image_point_p_y, double *x1_p, double *y1_p, double *x2_p, double *y2_p,
+				int *tagBoxes, int numBoxes, int nx, int ny, double range);
 }
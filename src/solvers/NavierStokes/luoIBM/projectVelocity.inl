@@ -37,6 +37,7 @@ void luoIBM::velocityProjection()
 			*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) ),
 			*uB_r		= thrust::raw_pointer_cast ( &(B.uB[0]) ),
 			*vB_r		= thrust::raw_pointer_cast ( &(B.vB[0]) ),
+			*uv_r		= thrust::raw_pointer_cast ( &(uv[0]) ),
 			*yu_r		= thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
 			*xu_r		= thrust::raw_pointer_cast ( &(domInfo->xu[0]) ),
 			*yv_r		= thrust::raw_pointer_cast ( &(domInfo->yv[0]) ),
@@ -60,7 +61,7 @@ void luoIBM::velocityProjection()
 			*q4_r = thrust::raw_pointer_cast ( &(q4[0]) ),
 			*image_point_u_r = thrust::raw_pointer_cast( &(image_point_u[0]) );
 	
-	int 	*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) );
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast ( &(cellTypeUV[0]) );
 		
 	double	nu = db["flow"]["nu"].get<double>();
 
@@ -71,17 +72,17 @@ void luoIBM::velocityProjection()
 	
 	dim3 grid( int( (width_i*height_j-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
-	kernels::interpolateVelocityToGhostNodeX<<<grid,block>>>(u_r, ghostTagsUV_r, bx_r, by_r, uB_r, yu_r, xu_r,
+	kernels::interpolateVelocityToGhostNodeX<<<grid,block>>>(u_r, cellTypeUV_r, bx_r, by_r, uv_r, yu_r, xu_r,
 													body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
 													i_start_r, j_start_r, width_i, nx, ny,
 													x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r, image_point_u_r);
-	kernels::interpolateVelocityToGhostNodeY<<<grid,block>>>(u_r, ghostTagsUV_r, bx_r, by_r, vB_r, yv_r, xv_r,
+	kernels::interpolateVelocityToGhostNodeY<<<grid,block>>>(u_r, cellTypeUV_r, bx_r, by_r, uv_r, yv_r, xv_r,
 													body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
 													i_start_r, j_start_r, width_i, nx, ny,
 													x1_r,x2_r,x3_r,x4_r,y1_r,y2_r,y3_r,y4_r,q1_r,q2_r,q3_r,q4_r, image_point_u_r);
 	
 	dim3 grid2( int( ((nx-1)*ny-0.5)/blocksize ) +1, 1);
-	kernels::setInsideVelocity<<<grid2,block>>>(ghostTagsUV_r, u_r, uB_r, vB_r, nx, ny);
+	kernels::setInsideVelocity<<<grid2,block>>>(cellTypeUV_r, u_r, uv_r, nx, ny);
 	//testInterpX();
 */
 	logger.stopTimer("Velocity Projection");
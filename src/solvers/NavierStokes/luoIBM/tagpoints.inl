@@ -10,21 +10,102 @@
  *        which the velocity interpolation is performed.
  */
 #include <solvers/NavierStokes/luoIBM/kernels/tagPoints.h>
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 #include <cusp/print.h>
 
+/*
+ * merges boxes that overlap, given as i0 j0 i1 j1, into their bounding box until no two boxes overlap
+ */
+static void mergeBoxes(std::vector<int> &boxes)
+{
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (size_t m=0; m<boxes.size() && !merged; m+=4)
+		{
+			for (size_t n=m+4; n<boxes.size() && !merged; n+=4)
+			{
+				if (boxes[m] < boxes[n+2] && boxes[n] < boxes[m+2] && boxes[m+1] < boxes[n+3] && boxes[n+1] < boxes[m+3])
+				{
+					boxes[m]	= std::min(boxes[m], boxes[n]);
+					boxes[m+1]	= std::min(boxes[m+1], boxes[n+1]);
+					boxes[m+2]	= std::max(boxes[m+2], boxes[n+2]);
+					boxes[m+3]	= std::max(boxes[m+3], boxes[n+3]);
+					boxes.erase(boxes.begin()+n, boxes.begin()+n+4);
+					merged = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+ * appends boxes given as i0 j0 i1 j1 to the work list as i0 j0 width height
+ * returns the number of cells
+ */
+static int appendWork(cusp::array1d<int, cusp::host_memory> &work, int &n, const std::vector<int> &boxes)
+{
+	int cells = 0;
+	for (size_t m=0; m<boxes.size(); m+=4)
+	{
+		work[n++] = boxes[m];
+		work[n++] = boxes[m+1];
+		work[n++] = boxes[m+2] - boxes[m];
+		work[n++] = boxes[m+3] - boxes[m+1];
+		cells += (boxes[m+2] - boxes[m])*(boxes[m+3] - boxes[m+1]);
+	}
+	return cells;
+}
+
 void luoIBM::tagPoints()
 {
 	logger.startTimer("tagPoints");
 	int  nx = NavierStokesSolver::domInfo->nx,
 		 ny = NavierStokesSolver::domInfo->ny,
-		 totalPoints = B.totalPoints,
-		 i_start = B.startI[0],
-		 j_start = B.startJ[0],
-		 width_i = B.numCellsX[0],
-		 height_j = B.numCellsY[0],
-		 i_end = i_start + width_i,
-		 j_end = j_start + height_j;
-	
+		 numBodies = B.numBodies;
+
+	//the cells each body can tag this step: its unscaled box plus a margin for the hybrid and image points
+	const int margin = 3;
+	std::vector<int> bodyBoxes(4*numBodies);
+	for (int k=0; k<numBodies; k++)
+	{
+		bodyBoxes[4*k]		= std::max(B.hostMeta.startI0[k] - margin, 1);
+		bodyBoxes[4*k+1]	= std::max(B.hostMeta.startJ0[k] - margin, 1);
+		bodyBoxes[4*k+2]	= std::min(B.hostMeta.startI0[k] + B.hostMeta.numCellsX0[k] + margin, nx-1);
+		bodyBoxes[4*k+3]	= std::min(B.hostMeta.startJ0[k] + B.hostMeta.numCellsY0[k] + margin, ny-1);
+	}
+
+	//the work list: the union of the body boxes without overlaps, so each cell is tagged once and the cells away from every body are skipped
+	//the nodes tagged last time are reset as well, they are in the union of this step's and last step's boxes
+	std::vector<int> tagBoxes1(bodyBoxes),
+					 resetBoxes(bodyBoxes);
+	mergeBoxes(tagBoxes1);
+	if (tagRegionValid)
+		resetBoxes.insert(resetBoxes.end(), tagBoxes0.begin(), tagBoxes0.end());
+	mergeBoxes(resetBoxes);
+
+	//one upload holds the work list, the reset list and the body boxes
+	int numTagBoxes = tagBoxes1.size()/4,
+		numResetBoxes = resetBoxes.size()/4,
+		n = 0;
+	cusp::array1d<int, cusp::host_memory> boxes_h(tagBoxes1.size() + resetBoxes.size() + bodyBoxes.size());
+	int tagCells = appendWork(boxes_h, n, tagBoxes1),
+		resetCells = appendWork(boxes_h, n, resetBoxes),
+		tagRows = 0;
+	for (int k=0; k<4*numBodies; k++)
+		boxes_h[n++] = bodyBoxes[k];
+	//the zero_*_luo kernels fill between the ghost nodes of a row, so they run one thread per row of the work list
+	for (int k=0; k<numTagBoxes; k++)
+		tagRows += boxes_h[4*k+3];
+	tagBoxes = boxes_h;
+	int	*tagBoxes_r		= thrust::raw_pointer_cast ( &(tagBoxes[0]) ),
+		*resetBoxes_r	= tagBoxes_r + 4*numTagBoxes,
+		*bodyBoxes_r	= resetBoxes_r + 4*numResetBoxes,
+		*offsets_r		= thrust::raw_pointer_cast ( &(B.offsets[0]) ),
+		*numPoints_r	= thrust::raw_pointer_cast ( &(B.numPoints[0]) );
+	double *centre_r	= thrust::raw_pointer_cast ( &(B.centre[0]) );
+
 	double	*pressure_r = thrust::raw_pointer_cast ( &(pressure[0]) ),
 			*bx_r		= thrust::raw_pointer_cast ( &(B.x[0]) ),//not sure if these are on the host or not
 			*by_r		= thrust::raw_pointer_cast ( &(B.y[0]) ),
@@ -56,58 +137,159 @@ void luoIBM::tagPoints()
 			*y1_p_r = thrust::raw_pointer_cast( &(y1_ip_p[0]) ),
 			*y2_p_r = thrust::raw_pointer_cast( &(y2_ip_p[0]) );
 	
-	int 	*ghostTagsUV_r		= thrust::raw_pointer_cast ( &(ghostTagsUV[0]) ),
-			*hybridTagsUV2_r	= thrust::raw_pointer_cast ( &(hybridTagsUV2[0]) ),
-			*hybridTagsUV_r		= thrust::raw_pointer_cast ( &(hybridTagsUV[0]) ),
-			*ghostTagsP_r		= thrust::raw_pointer_cast ( &(ghostTagsP[0]) ),
-			*hybridTagsP_r		= thrust::raw_pointer_cast ( &(hybridTagsP[0]) );
+	unsigned char	*cellTypeUV_r		= thrust::raw_pointer_cast ( &(cellTypeUV[0]) ),
+					*cellTypeP_r		= thrust::raw_pointer_cast ( &(cellTypeP[0]) ),
+					*cellTypeUVOld_r	= thrust::raw_pointer_cast ( &(cellTypeUVOld[0]) ),
+					*cellTypePOld_r		= thrust::raw_pointer_cast ( &(cellTypePOld[0]) );
 	
-	cusp::blas::fill(ghostTagsUV, -1);
-	cusp::blas::fill(ghostTagsP, -1);
-	cusp::blas::fill(hybridTagsUV, -1);
-	cusp::blas::fill(hybridTagsP, -1);
-	cusp::blas::fill(hybridTagsUV2, -1);
-	cusp::blas::fill(distance_from_intersection_to_node, 1);
-	cusp::blas::fill(distance_between_nodes_at_IB, 1);
-	cusp::blas::fill(x1_ip,0);
-	cusp::blas::fill(y1_ip,0);
-	cusp::blas::fill(x2_ip,0);
-	cusp::blas::fill(y2_ip,0);
-	cusp::blas::fill(body_intercept_x, 0);
-	cusp::blas::fill(body_intercept_y, 0);
-	cusp::blas::fill(image_point_x, 0);
-	cusp::blas::fill(image_point_y, 0);
-		
+	int		*changedRows_r	= thrust::raw_pointer_cast ( &(changedRows[0]) ),
+			*changedRowsUV_r	= thrust::raw_pointer_cast ( &(changedRowsUV[0]) ),
+			*changedRowsP_r		= thrust::raw_pointer_cast ( &(changedRowsP[0]) );
+
+	double	*image_point_x_old_r	= thrust::raw_pointer_cast( &(image_point_x_old[0]) ),
+			*image_point_y_old_r	= thrust::raw_pointer_cast( &(image_point_y_old[0]) ),
+			*image_point_p_x_old_r	= thrust::raw_pointer_cast( &(image_point_p_x_old[0]) ),
+			*image_point_p_y_old_r	= thrust::raw_pointer_cast( &(image_point_p_y_old[0]) );
+
 	const int blocksize = 256;
-	dim3 dimGrid( int( (width_i*height_j-0.5)/blocksize ) +1, 1);
 	dim3 dimBlock(blocksize, 1);
-	dim3 dimGrid0(int( (i_end-i_start-0.5)/blocksize ) +1, 1);
-	
-	//tag u direction nodes for tags, tagsout and hybridTagsUV2
-	kernels::tag_u_luo<<<dimGrid,dimBlock>>>(hybridTagsUV_r, ghostTagsUV_r, hybridTagsUV2_r, bx_r, by_r, uB_r, vB_r, yu_r, xu_r,
-											body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-											x1_r, y1_r, x2_r, y2_r,
-											a_r, b_r, dub_r, dvb_r, uv_r,
-											i_start, j_start, i_end, j_end, nx, ny, totalPoints, B.midX, B.midY);
-	//tag v direction nodes for tags, tagsout and tag2
-	kernels::tag_v_luo<<<dimGrid,dimBlock>>>(hybridTagsUV_r, ghostTagsUV_r, hybridTagsUV2_r, bx_r, by_r, uB_r, vB_r, yv_r, xv_r,
-											body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
-											x1_r, y1_r, x2_r, y2_r,
-											a_r, b_r, dub_r, dvb_r, uv_r, 
-											i_start, j_start, i_end, j_end, nx, ny, totalPoints, B.midX, B.midY);
-	//tag pressure nodes for ghostTagsP and hybridTagsP
-	kernels::tag_p_luo<<<dimGrid,dimBlock>>>(ghostTagsP_r, hybridTagsP_r,
-											bx_r, by_r, yu_r, xv_r,
-											body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r, x1_p_r, y1_p_r, x2_p_r, y2_p_r,
-											i_start, j_start, i_end, j_end, nx, ny, totalPoints, B.midX, B.midY);
-	//zero the inside of ghostTagsP
-	kernels::zero_pressure_luo<<<dimGrid0, dimBlock>>>(ghostTagsP_r, i_start, j_start, i_end, j_end, nx, ny);
-	//zero the inside of ghostTagsUVx
-	kernels::zero_x_luo<<<dimGrid0,dimBlock>>>(ghostTagsUV_r, i_start, j_start, i_end, j_end, nx, ny);
-	//zero the inside of ghostTagsUVy
-	kernels::zero_y_luo<<<dimGrid0,dimBlock>>>(ghostTagsUV_r, i_start, j_start, i_end, j_end, nx, ny);
+	dim3 dimGrid( int( (tagCells-0.5)/blocksize ) +1, 1);
+	dim3 dimGridR( int( (resetCells-0.5)/blocksize ) +1, 1);
+	dim3 dimGrid0( int( (tagRows-0.5)/blocksize ) +1, 1);
+
+	if (tagRegionValid)
+	{
+		//only the nodes in the union of last step's boxes and this step's boxes can change
+		kernels::reset_tags_luo<<<dimGridR,dimBlock>>>(cellTypeUV_r, cellTypeP_r, cellTypeUVOld_r, cellTypePOld_r,
+														image_point_x_r, image_point_y_r, image_point_p_x_r, image_point_p_y_r,
+														image_point_x_old_r, image_point_y_old_r, image_point_p_x_old_r, image_point_p_y_old_r,
+														body_intercept_x_r, body_intercept_y_r, x1_r, y1_r, x2_r, y2_r, a_r, b_r,
+														resetBoxes_r, numResetBoxes, nx, ny);
+	}
+	else
+	{
+		cusp::blas::fill(cellTypeUV, cellType::FLUID);
+		cusp::blas::fill(cellTypeP, cellType::FLUID);
+		cusp::blas::fill(distance_from_intersection_to_node, 1);
+		cusp::blas::fill(distance_between_nodes_at_IB, 1);
+		cusp::blas::fill(x1_ip,0);
+		cusp::blas::fill(y1_ip,0);
+		cusp::blas::fill(x2_ip,0);
+		cusp::blas::fill(y2_ip,0);
+		cusp::blas::fill(body_intercept_x, 0);
+		cusp::blas::fill(body_intercept_y, 0);
+		cusp::blas::fill(image_point_x, 0);
+		cusp::blas::fill(image_point_y, 0);
+	}
+
+	if (B.analytic)
+	{
+		//single body with an analytic surface or a distance field, every node is classified on its own without scanning the boundary points
+		shape S = B.currentShape();
+		double	range = 2*std::max(S.a, S.b),
+				angVel = B.motion_h[8];
+		kernels::tag_u_shape<<<dimGrid,dimBlock>>>(cellTypeUV_r, S, uB_r, by_r, angVel, yu_r, xu_r,
+												body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
+												x1_r, y1_r, x2_r, y2_r, a_r, b_r, uv_r,
+												tagBoxes_r, numTagBoxes, nx, ny, range);
+		kernels::tag_v_shape<<<dimGrid,dimBlock>>>(cellTypeUV_r, S, vB_r, bx_r, angVel, yv_r, xv_r,
+												body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
+												x1_r, y1_r, x2_r, y2_r, a_r, b_r, uv_r,
+												tagBoxes_r, numTagBoxes, nx, ny, range);
+		kernels::tag_p_shape<<<dimGrid,dimBlock>>>(cellTypeP_r, S, yu_r, xv_r,
+												body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r, x1_p_r, y1_p_r, x2_p_r, y2_p_r,
+												tagBoxes_r, numTagBoxes, nx, ny, range);
+	}
+	else
+	{
+		//tag u direction ghost, hybrid and hybrid2 nodes, each node against the bodies whose box holds it
+		kernels::tag_u_luo<<<dimGrid,dimBlock>>>(cellTypeUV_r, bx_r, by_r, uB_r, vB_r, yu_r, xu_r,
+												body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
+												x1_r, y1_r, x2_r, y2_r,
+												a_r, b_r, dub_r, dvb_r, uv_r,
+												tagBoxes_r, numTagBoxes, bodyBoxes_r, offsets_r, numPoints_r, centre_r, numBodies, nx, ny);
+		//tag v direction ghost, hybrid and hybrid2 nodes
+		kernels::tag_v_luo<<<dimGrid,dimBlock>>>(cellTypeUV_r, bx_r, by_r, uB_r, vB_r, yv_r, xv_r,
+												body_intercept_x_r, body_intercept_y_r, image_point_x_r, image_point_y_r,
+												x1_r, y1_r, x2_r, y2_r,
+												a_r, b_r, dub_r, dvb_r, uv_r,
+												tagBoxes_r, numTagBoxes, bodyBoxes_r, offsets_r, numPoints_r, centre_r, numBodies, nx, ny);
+		//tag pressure ghost and hybrid nodes
+		kernels::tag_p_luo<<<dimGrid,dimBlock>>>(cellTypeP_r,
+												bx_r, by_r, yu_r, xv_r,
+												body_intercept_p_x_r, body_intercept_p_y_r, image_point_p_x_r, image_point_p_y_r, x1_p_r, y1_p_r, x2_p_r, y2_p_r,
+												tagBoxes_r, numTagBoxes, bodyBoxes_r, offsets_r, numPoints_r, centre_r, numBodies, nx, ny);
+	}
+	//mark the pressure nodes inside the bodies as solid
+	kernels::zero_pressure_luo<<<dimGrid0, dimBlock>>>(cellTypeP_r, tagBoxes_r, numTagBoxes, nx, ny);
+	//mark the u nodes inside the bodies as solid
+	kernels::zero_x_luo<<<dimGrid0,dimBlock>>>(cellTypeUV_r, uv_r, tagBoxes_r, numTagBoxes, nx, ny);
+	//mark the v nodes inside the bodies as solid
+	kernels::zero_y_luo<<<dimGrid0,dimBlock>>>(cellTypeUV_r, uv_r, tagBoxes_r, numTagBoxes, nx, ny);
+
+	//list the rows of LHS1 and LHS2 that changed, everything has changed after a full tag
+	bool listed = tagRegionValid;
+	if (tagRegionValid)
+	{
+		cusp::blas::fill(changedRows, 0);
+		kernels::mark_changed_luo<<<dimGridR,dimBlock>>>(changedRows_r, changedRowsUV_r, changedRowsP_r, changedRowsUV.size(), changedRowsP.size(),
+														cellTypeUV_r, cellTypeP_r, cellTypeUVOld_r, cellTypePOld_r,
+														image_point_x_r, image_point_y_r, image_point_p_x_r, image_point_p_y_r,
+														image_point_x_old_r, image_point_y_old_r, image_point_p_x_old_r, image_point_p_y_old_r,
+														resetBoxes_r, numResetBoxes, nx, ny);
+		thrust::copy(changedRows.begin(), changedRows.begin()+2, changedRows_h.begin());
+		numChangedRowsUV = changedRows_h[0];
+		numChangedRowsP = changedRows_h[1];
+	}
+	else
+	{
+		numChangedRowsUV = (nx-1)*ny + nx*(ny-1);
+		numChangedRowsP = nx*ny;
+	}
+
+	tagBoxes0 = tagBoxes1;
+	tagRegionValid = true;
+
+	//the matrices and interpolation weights only change if a tag or an image point did
+	versions.built(dependency::TAGS_UV, numChangedRowsUV > 0);
+	versions.built(dependency::TAGS_P, numChangedRowsP > 0);
+	//a retag that changed nothing leaves the lists of the last one that did, a node listed twice (boxes that overlap) can overflow them
+	if (numChangedRowsUV > 0)
+	{
+		listedRowsUV = numChangedRowsUV;
+		listedVersionUV = listed && listedRowsUV <= (int)changedRowsUV.size() ? versions.current(dependency::TAGS_UV) : -1;
+	}
+	if (numChangedRowsP > 0)
+	{
+		listedRowsP = numChangedRowsP;
+		listedVersionP = listed && listedRowsP <= (int)changedRowsP.size() ? versions.current(dependency::TAGS_P) : -1;
+	}
+	if (versions.stale(dependency::INTERPOLATION_UV))
+	{
+		buildInterpolationOperators();
+		versions.built(dependency::INTERPOLATION_UV);
+	}
+	if (versions.stale(dependency::INTERPOLATION_P))
+	{
+		compactTags(cellTypeP, cellType::GHOST, ghostNodesP);
+		compactTags(cellTypeP, cellType::HYBRID, hybridNodesP);
+		hybridCountP.resize(hybridNodesP.size());
+		versions.built(dependency::INTERPOLATION_P);
+	}
 	
 	//testOutputX();
 	//testOutputY();
 	logger.stopTimer("tagPoints");
-}
\ No newline at end of file
+}
+
+/*
+ * true if the matrix n is only stale because of the tags in tags and the body pose, and the tags changed at most once
+ * since n was built, by the retag whose rows are listed in changedRowsUV or changedRowsP (listedVersion)
+ */
+bool luoIBM::rowsListed(int n, int tags, int listedVersion)
+{
+	using namespace dependency;
+	int changes = versions.changesSince(n, tags);
+	return versions.changesSince(n, DT) == 0 && versions.changesSince(n, NU) == 0 && versions.changesSince(n, GRID) == 0
+		&& (changes == 0 || (changes == 1 && listedVersion == versions.current(tags)));
+}
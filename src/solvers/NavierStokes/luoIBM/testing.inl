@@ -33,7 +33,7 @@ void luoIBM::divergence()
 			ip = J*nx + I;
 			iu = J*(nx-1)+I;
 			iv = J*nx + I + (nx-1)*ny;
-			if (hybridTagsP[ip]>0)
+			if (cellType::isHybrid(cellTypeP[ip]))
 			{
 				test_output <<-u[iv] << "\t";
 				test_output <<domInfo->dy[J] << "\t";
@@ -80,13 +80,13 @@ void luoIBM::outputPressure()
 		for (int I=i_start;  I<i_end;  I++)
 		{
 			ip = J*nx + I;
-			if (ghostTagsP[ip] > 0)
+			if (cellType::isGhost(cellTypeP[ip]))
 			{
 				inside << domInfo->xv[I]<<"\t";
 				inside << domInfo->yu[J]<<"\t";
 				inside << pressure[ip]<<"\n";
 			}
-			if (hybridTagsP[ip] > 0)
+			if (cellType::isHybrid(cellTypeP[ip]))
 			{
 				outside << domInfo->xv[I]<<"\t";
 				outside << domInfo->yu[J]<<"\t";
@@ -151,8 +151,8 @@ void luoIBM::testInterpX()//flag split this into ghost node and hybrid node func
 		for (int I=i_start;  I<i_end;  I++)
 		{
 			iu = J*(nx-1) + I;
-			//if (ghostTagsUV[iu] >0)//for inside
-			if (hybridTagsUV[iu] >0)//for outside
+			//if (cellType::isGhost(cellTypeUV[iu]))//for inside
+			if (cellType::isHybrid(cellTypeUV[iu]))//for outside
 			{
 				body_nodes << x1_ip[iu]<<"\t";
 				body_nodes << y1_ip[iu]<<"\t";
@@ -232,8 +232,8 @@ void luoIBM::testInterpY()
 		for (int I=i_start;  I<i_end;  I++)
 		{
 			iv = J*nx + I  +  ny*(nx-1);
-			if (ghostTagsUV[iv] >0)//for inside
-			//if (hybridTagsUV[iv] >0)//for outside
+			if (cellType::isGhost(cellTypeUV[iv]))//for inside
+			//if (cellType::isHybrid(cellTypeUV[iv]))//for outside
 			{
 				//std::cout<<I<<"\t"<<J<<"\t"<<iv<<"\n";
 				body_nodes << x1_ip[iv]<<"\t";
@@ -324,8 +324,8 @@ void luoIBM::testInterpP()
 		for (int I=i_start;  I<i_end;  I++)
 		{
 			ip = J*nx + I;
-			//if (ghostTagsP[ip] >0)//for inside
-			if (hybridTagsP[ip] >0)//for outside
+			//if (cellType::isGhost(cellTypeP[ip]))//for inside
+			if (cellType::isHybrid(cellTypeP[ip]))//for outside
 			{
 				//std::cout<<I<<"\t"<<J<<"\t"<<iv<<"\n";
 				body_nodes << x1_ip_p[ip]<<"\t";
@@ -391,8 +391,8 @@ void luoIBM::testOutputX()
 		for (int I=i_start;  I<i_end;  I++)
 		{
 			iu = J*(nx-1) + I;
-			if (hybridTagsUV[iu] >0) //for testing outside interpolation
-			//if (ghostTagsUV[iu] >0) //for testing inside interpolation
+			if (cellType::isHybrid(cellTypeUV[iu])) //for testing outside interpolation
+			//if (cellType::isGhost(cellTypeUV[iu])) //for testing inside interpolation
 			{
 				std::cout<<iu<<std::endl;
 				body_nodes << x1_ip[iu]<<"\t";
@@ -430,15 +430,15 @@ void luoIBM::testOutputY()
 		out << folder << "/body_nodesY.csv";
 		body_nodes.open(out.str().c_str());
 		body_nodes << "x1\ty1\tx2\ty2\tg_x\tg_y\tbi_x\tbi_y\tip_x\tip_y\n";
-		arrayprint(ghostTagsUV,"gnuvY","y",-1);
-		arrayprint(ghostTagsUV,"gnuvX","x",-1);
+		arrayprint(cellTypeUV,"cellTypeY","y",-1);
+		arrayprint(cellTypeUV,"cellTypeX","x",-1);
 		for (int J=j_start;  J<j_end;  J++)
 		{
 			for (int I=i_start;  I<i_end;  I++)
 			{
 				iv = J*(nx) + I + ny*(nx-1);
-				if (hybridTagsUV[iv] >0) //for testing outside interpolation
-				//if (ghostTagsUV[iv] >0) //for testing inside interpolation
+				if (cellType::isHybrid(cellTypeUV[iv])) //for testing outside interpolation
+				//if (cellType::isGhost(cellTypeUV[iv])) //for testing inside interpolation
 				{
 					std::cout<<iv<<std::endl;
 					body_nodes << x1_ip[iv]<<"\t";
@@ -505,4 +505,67 @@ void luoIBM::testForce_dudn()
 		body_nodes << B.force_y[i] <<"\n";
 	}
 	body_nodes.close();
-}
\ No newline at end of file
+}
+/*
+ * Checks the reduced poisson system against the full one, called after solvePoisson when PoissonSolve: testReducedSystem is set
+ * The solid pressures are recovered from the reduced solution, p_s = inv(A_ss) (b_s - A_sa p_a), and the residual of the full
+ * system has to match the residual of the reduced one, which it does when the elimination is exact. LHS2 is also solved
+ * with a diagonal preconditioned BiCGSTAB and the largest difference over the active nodes is printed.
+ */
+void luoIBM::testReducedPoisson()
+{
+	if (!reducedPoisson)
+		return;
+	parameterDB  &db = *NavierStokesSolver::paramDB;
+	int numP = domInfo->nx * domInfo->ny,
+		numSolid = solidP_h.size();
+
+	//fill in the solid nodes, pressure is zero there so A p is A_sa p_a in the solid rows
+	cusp::array1d<double, cusp::device_memory> p(pressure), Ap(numP);
+	cusp::multiply(LHS2, p, Ap);
+	cusp::array1d<double, cusp::host_memory>	p_h(p),
+												Ap_h(Ap),
+												rhs2_h(rhs2);
+	std::vector<double> w(numSolid);
+	for (int k=0; k<numSolid; k++)
+		w[k] = rhs2_h[solidP_h[k]] - Ap_h[solidP_h[k]];
+	if (numSolid > 0)
+		solidSolver.solve(&w[0], &w[0]);
+	for (int k=0; k<numSolid; k++)
+		p_h[solidP_h[k]] = w[k];
+	p = p_h;
+
+	cusp::array1d<double, cusp::device_memory> r(numP), rR(rhs2r.size());
+	cusp::multiply(LHS2, p, r);
+	cusp::blas::axpby(rhs2, r, r, 1.0, -1.0);
+	cusp::multiply(LHS2r, pressureR, rR);
+	cusp::blas::axpby(rhs2r, rR, rR, 1.0, -1.0);
+	double	residual = cusp::blas::nrm2(r),
+			residualR = cusp::blas::nrm2(rR),
+			scale = cusp::blas::nrm2(rhs2);
+	bool passed = fabs(residual - residualR) <= 1e-8*scale;
+
+	//an independent full solve
+	cusp::array1d<double, cusp::device_memory> full(p);
+	krylovSolver KS;
+	preconditioner< cusp::coo_matrix<int, double, cusp::device_memory> > M(LHS2, DIAGONAL);
+	KS.checkInterval = db["PoissonSolve"]["residualCheckInterval"].get<int>();
+	KS.solve(LHS2, full, rhs2, M, "BICGSTAB", db["PoissonSolve"]["maxIterations"].get<int>(), db["PoissonSolve"]["tolerance"].get<double>());
+
+	cusp::array1d<double, cusp::host_memory>	full_h(full);
+	cusp::array1d<unsigned char, cusp::host_memory> type_h(cellTypeP);
+	double maxDiff = 0,
+		   maxP = 0;
+	for (int ip=0; ip<numP; ip++)
+	{
+		if (cellType::isSolid(type_h[ip]))
+			continue;
+		maxDiff = std::max(maxDiff, fabs(full_h[ip] - p_h[ip]));
+		maxP = std::max(maxP, fabs(full_h[ip]));
+	}
+	std::cout << "Reduced poisson check at time step " << timeStep << ": " << (passed ? "PASSED" : "FAILED")
+			  << ", residual of the full system " << residual << ", of the reduced system " << residualR << std::endl;
+	std::cout << "    full solve " << (KS.converged() ? "converged" : "did not converge") << " in " << KS.iteration_count()
+			  << " iterations, max |p_full - p_reduced| over the active nodes " << maxDiff
+			  << ", relative " << (maxP > 0 ? maxDiff/maxP : 0) << std::endl;
+}
@@ -12,6 +12,9 @@
  */
 newPrecon::newPrecon()
 {
+	PC1 = NULL;
+	PC2 = NULL;
+	setupIterations2 = -1;
 }
 
 /*
@@ -21,8 +24,11 @@ newPrecon::newPrecon()
  * param type1 the type of preconditioner desired for the velocity solve
  * param type2 the type of preconditioner desired for the poisson solve
  */
-void newPrecon::generate(cusp::coo_matrix<int, double, cusp::device_memory>LHS1, cusp::coo_matrix<int, double, cusp::device_memory>LHS2, preconditionerType type1, preconditionerType type2)
+void newPrecon::generate(const cusp::coo_matrix<int, double, cusp::device_memory> &LHS1, const cusp::coo_matrix<int, double, cusp::device_memory> &LHS2, preconditionerType type1, preconditionerType type2)
 {
+	delete PC1;
+	delete PC2;
+	setupIterations2 = -1;
 	PC1 = new preconditioner< cusp::coo_matrix<int, double, cusp::device_memory> >(LHS1, type1);
 	PC2 = new preconditioner< cusp::coo_matrix<int, double, cusp::device_memory> >(LHS2, type2);
 }
@@ -32,8 +38,34 @@ void newPrecon::generate(cusp::coo_matrix<int, double, cusp::device_memory>LHS1,
  * param coo_matrix LHS1 the left hand side matrix for the velocity solve
  * param coo_matrix LHS1 the left hand side matrix for the poisson solve
  */
-void newPrecon::update(cusp::coo_matrix<int, double, cusp::device_memory>LHS1, cusp::coo_matrix<int, double, cusp::device_memory>LHS2)
+void newPrecon::update(const cusp::coo_matrix<int, double, cusp::device_memory> &LHS1, const cusp::coo_matrix<int, double, cusp::device_memory> &LHS2)
 {
 	PC1->update(LHS1);
 	PC2->update(LHS2);
 }
+
+/*
+ * Records the iterations of a poisson solve, the first solve after a full setup is the reference for degraded
+ * param iterationCount2 iterations taken by the poisson solve that just finished
+ */
+void newPrecon::solved(int iterationCount2)
+{
+	if (setupIterations2 < 0)
+		setupIterations2 = iterationCount2;
+}
+
+/*
+ * Decides if the preconditioners need a full setup instead of an update
+ * Once a solve takes much longer than the first one after the last full setup, the
+ * reused setup (e.g. the AMG aggregates) doesn't fit the matrix anymore
+ * param iterationCount2 iterations taken by the last poisson solve
+ */
+bool newPrecon::degraded(int iterationCount2)
+{
+	if (PC1 == NULL || PC2 == NULL)
+		return true;
+	//no solve since the last full setup, nothing to compare with
+	if (setupIterations2 < 0)
+		return false;
+	return iterationCount2 > 1.5*setupIterations2 + 5;
+}
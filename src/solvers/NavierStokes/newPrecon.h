@@ -15,7 +15,11 @@ class newPrecon
 		*PC1,		///< preconditioner for the intermediate flux solver
 		*PC2;		///< preconditioner for the Poisson solver
 
+	int setupIterations2;	///< iterations of the first Poisson solve after the last full setup, -1 if there hasn't been a solve yet
+
 	newPrecon();
-	void generate(cusp::coo_matrix<int, double, cusp::device_memory>LHS1, cusp::coo_matrix<int, double, cusp::device_memory>LHS2, preconditionerType type1, preconditionerType type2);
-	void update(cusp::coo_matrix<int, double, cusp::device_memory>LHS1, cusp::coo_matrix<int, double, cusp::device_memory>LHS2);
+	void generate(const cusp::coo_matrix<int, double, cusp::device_memory> &LHS1, const cusp::coo_matrix<int, double, cusp::device_memory> &LHS2, preconditionerType type1, preconditionerType type2);
+	void update(const cusp::coo_matrix<int, double, cusp::device_memory> &LHS1, const cusp::coo_matrix<int, double, cusp::device_memory> &LHS2);
+	void solved(int iterationCount2);
+	bool degraded(int iterationCount2);
 };
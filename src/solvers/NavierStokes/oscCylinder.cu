@@ -26,20 +26,14 @@ oscCylinder::oscCylinder(parameterDB *pDB, domain *dInfo)
  */
 void oscCylinder::writeData()
 {
-	parameterDB  &db = *paramDB;
-	double dt  = db["simulation"]["dt"].get<double>();
 	logger.startTimer("output");
 	writeCommon();
 	if (timeStep == 0)
 		forceFile<<"timestep\tFx\tFy\n";
-	//forceFile << timeStep*dt << '\t' << B.forceX << '\t' << B.forceY << std::endl;
-	forceFile	<< timeStep*dt << "\t"
-				<< B.forceX << "\t"
-				<< fxx << "\t"
-				<< fxy << "\t"
-				<< fxu << "\t"
-				<< B.forceY << std::endl;
 	logger.stopTimer("output");
+	//the forces are calculated in stepTime once the body is released
+	if (forceSlot == forceInterval)
+		writeForces();
 }
 
 /**
@@ -70,18 +64,21 @@ void oscCylinder::writeCommon()
  * Calculates new cell indices
  * Calculates new body bounding boxes
  * Tags Points
- * Remakes LHS matricies
- * updates Preconditioners
+ * each only if the body moved since it was last done
  */
 void oscCylinder::updateSolver()
 {
-	logger.startTimer("Bounding Boxes");
-	B.calculateBoundingBoxes(*paramDB, *domInfo);//flag this isn't really needed because the body never moves out of the bounding box
-	logger.stopTimer("Bounding Boxes");
+	if (versions.stale(dependency::BOUNDING_BOXES))
+	{
+		logger.startTimer("Bounding Boxes");
+		B.calculateBoundingBoxes(*paramDB, *domInfo);
+		versions.built(dependency::BOUNDING_BOXES);
+		logger.stopTimer("Bounding Boxes");
+	}
 
-	tagPoints();
-	generateLHS1();//is this needed?
-	//generateLHS2();
+	if (versions.stale(dependency::TAGS_UV) || versions.stale(dependency::TAGS_P))
+		tagPoints();
+	//LHS1 and LHS2 are rebuilt at the start of the next step if the tags changed
 }
 
 /*
@@ -96,17 +93,14 @@ void oscCylinder::moveBody()
 	//luoForce();
 
 	logger.startTimer("moveBody");
-	double *x_r	= thrust::raw_pointer_cast( &(B.x[0]) ),
-		   *uB_r= thrust::raw_pointer_cast( &(B.uB[0]) );
 	double	dt	= db["simulation"]["dt"].get<double>(),
 			nu	= db["flow"]["nu"].get<double>(),
-			t = dt*timeStep,
+			t = simulationTime,
 			f = B.frequency,
 			xCoeff = B.xCoeff,
 			uCoeff = B.uCoeff,
 			xPhase = B.xPhase,
 			uPhase = B.uPhase,
-			totalPoints=B.totalPoints,
 			xold= B.midX,
 			unew,
 			xnew;
@@ -119,11 +113,9 @@ void oscCylinder::moveBody()
 	B.centerVelocityU = unew;
 	B.midX = xnew;
 
-	const int blocksize = 256;
-	dim3 grid( int( (totalPoints)/blocksize ) +1, 1);
-	dim3 block(blocksize, 1);
 	B.uBk = B.uB;
-	kernels::update_body_viv<<<grid,block>>>(x_r, uB_r, xnew-xold, unew, totalPoints);
+	B.translate(xnew-xold, 0, unew, 0);
+	versions.touch(dependency::BODY_POSE);
 	logger.stopTimer("moveBody");
 }
 
@@ -133,7 +125,6 @@ void oscCylinder::moveBody()
 void oscCylinder::initialise()
 {
 	luoIBM::initialise();
-	cfl.resize(domInfo->nx*domInfo->ny);
 	distance.resize((domInfo->nx-1)*domInfo->ny + (domInfo->ny-1)*domInfo->nx);
 	cfl_max = 0;
 
@@ -144,12 +135,10 @@ void oscCylinder::initialise()
 	outPosition << folder <<"/midPosition";
 	midPositionFile.open(outPosition.str().c_str());
 
-	double *x_r	= thrust::raw_pointer_cast( &(B.x[0]) ),
-		   *uB_r= thrust::raw_pointer_cast( &(B.uB[0]) ),
-		   *uB0_r=thrust::raw_pointer_cast( &(B.uBk[0]) );
+	double *uB0_r=thrust::raw_pointer_cast( &(B.uBk[0]) );
 	double	dt	= db["simulation"]["dt"].get<double>(),
 			nu	= db["flow"]["nu"].get<double>(),
-			t = dt*timeStep,
+			t = simulationTime,
 			//D = 0.2,
 			//uMax = 1,
 			f = B.frequency,
@@ -179,10 +168,50 @@ void oscCylinder::initialise()
 	dim3 block(blocksize, 1);
 	B.uBk = B.uB;
 	//update position/velocity for current values
-	kernels::update_body_viv<<<grid,block>>>(x_r, uB_r, xnew-xold, unew, totalPoints);
+	B.translate(xnew-xold, 0, unew, 0);
+	versions.touch(dependency::BODY_POSE);
 	//set position/velocity for old values
 	kernels::initialise_old<<<grid,block>>>(uB0_r,unew,totalPoints);//flag not sure if this should be done or not, as it is it simulates the body being in motion before we actually start, and it is technically more like an impulsivly started motion
 																	//it effects du/dt for the calcualtion of the material derivative in the bilinear interp functions, its overall effect is pretty minimal
+
+	bodyFixedFrame = db["simulation"]["bodyFixedFrame"].get<bool>();
+	frameAcceleration = 0;
+	fluidArea = 0;
+	if (bodyFixedFrame)
+		initialiseFrame();
+}
+
+/*
+ * Jumps to time t, the body is placed where the prescribed motion puts it at t and the tags follow
+ * As in initialise uBk is set to the new body velocity. In the body frame the body stays put and the far field
+ * takes the frame velocity at t instead, the fluid velocity is already relative to the body.
+ */
+void oscCylinder::setTime(double t)
+{
+	simulationTime = t;
+	double	*uB0_r	= thrust::raw_pointer_cast( &(B.uBk[0]) );
+	double	f	= B.frequency,
+			unew= B.uCoeff*cos(2*M_PI*f*t + B.uPhase),
+			xnew= B.xCoeff*sin(2*M_PI*f*t + B.xPhase);
+
+	if (bodyFixedFrame)
+	{
+		shiftFarfield(B.centerVelocityU - unew);
+		frameAcceleration = 0;
+	}
+	else
+	{
+		const int blocksize = 256;
+		dim3 grid( int( (B.totalPoints)/blocksize ) +1, 1);
+		dim3 block(blocksize, 1);
+		B.translate(xnew-B.midX, 0, unew, 0);
+		versions.touch(dependency::BODY_POSE);
+		kernels::initialise_old<<<grid,block>>>(uB0_r, unew, B.totalPoints);
+		updateSolver();
+	}
+	B.centerVelocityU = unew;
+	B.midX = xnew;
+	zeroVelocity();
 }
 
 /**
@@ -190,41 +219,61 @@ void oscCylinder::initialise()
  */
 void oscCylinder::stepTime()
 {
+	adaptTimeStep();
+	refreshLHS1();
 	generateRHS1();
+	if (bodyFixedFrame)
+		addFrameForce();
 	solveIntermediateVelocity();
 	weightUhat();
 
 	preRHS2();
-	sizeLHS2();
-	generateLHS2();
+	//LHS2 only depends on the position of the body, which doesn't change in the body frame
+	bool newLHS2 = versions.stale(dependency::LHS2_MATRIX);
+	if (newLHS2)
+		assembleLHS2();
 	generateRHS2();
-	logger.startTimer("sort LHS2");
-	LHS2.sort_by_row_and_column();
-	logger.stopTimer("sort LHS2");
-	//print(LHS2);
-	//printLHS();
+	if (newLHS2)
+	{
+		//print(LHS2);
+		//printLHS();
+		reducePoisson();
+		versions.built(dependency::LHS2_MATRIX);
+	}
+	if (versions.stale(dependency::PRECONDITIONER))
+		updatePreconditioners();
 
 	solvePoisson();
+	if ((*paramDB)["PoissonSolve"]["testReducedSystem"].get<bool>())
+		testReducedPoisson();
 
 	interpPGN();
 	velocityProjection();
 
 	std::cout<<timeStep<<std::endl;
 	timeStep++;
+	simulationTime += (*paramDB)["simulation"]["dt"].get<double>();
 	if (timeStep == 1000)
 	{
 		arrayprint(uhat,"uhat","x",-1);
 		arrayprint(pressure,"p","p",-1);
 		arrayprint(u,"u","x",-1);
-		arrayprint(ghostTagsP,"ghostp","p",-1);
-		arrayprint(ghostTagsUV,"ghostu","x",-1);
-		arrayprint(hybridTagsP,"hybridp","p",-1);
+		arrayprint(cellTypeP,"cellTypep","p",-1);
+		arrayprint(cellTypeUV,"cellTypeu","x",-1);
 	}
 	//Release the body after a certain timestep
 	if (timeStep >= (*paramDB)["simulation"]["startStep"].get<int>())
 	{
-		moveBody();
-		updateSolver();
+		if (bodyFixedFrame)
+		{
+			frameForce();
+			updateFrame();
+		}
+		else
+		{
+			moveBody();
+			updateSolver();
+		}
 		CFL();
 	}
 
@@ -252,3 +301,4 @@ void oscCylinder::shutDown()
 
 #include "oscCylinder/intermediateVelocity.inl"
 #include "oscCylinder/CFL.inl"
+#include "oscCylinder/frame.inl"
@@ -14,13 +14,16 @@ class oscCylinder : public luoIBM
 {
 protected:
 	std::ofstream midPositionFile;
-	cusp::array1d<double, cusp::device_memory> cfl,
-												distance;
+	cusp::array1d<double, cusp::device_memory> distance;
 	double	cfl_max,
 			cfl_I,
 			cfl_J,
 			cfl_ts;
 
+	bool	bodyFixedFrame;		///< solve in the frame of the body instead of moving it through the grid
+	double	frameAcceleration,	///< acceleration of the body frame over the current step
+			fluidArea;			///< area of fluid inside the force control volume
+
 	//////////////////////////
 	//oscCylinder.h
 	//////////////////////////
@@ -37,6 +40,15 @@ protected:
 	//////////////////////////
 	void CFL();
 	void calcDistance();
+
+	//////////////////////////
+	//frame.inl
+	//////////////////////////
+	void initialiseFrame();
+	void shiftFarfield(double du);
+	void updateFrame();
+	void addFrameForce();
+	void frameForce();
 public:
 	//////////////////////////
 	//oscCylinder.cu
@@ -47,6 +59,7 @@ public:
 	virtual void writeData();
 	virtual void writeCommon();
 	virtual void shutDown();
+	virtual void setTime(double t);
 
 	//////////////////////////
 	//IntermediateVelocity.inl
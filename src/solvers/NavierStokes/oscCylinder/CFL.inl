@@ -6,28 +6,15 @@
 
 #include <solvers/NavierStokes/oscCylinder/kernels/CFL.h>
 
+/*
+ * Keeps track of the largest CFL number of the run and where it happened
+ */
 void oscCylinder::CFL()
 {
 	logger.startTimer("CFL");
-	double	*u_r = thrust::raw_pointer_cast ( &(u[0]) ),
-			*cfl_r = thrust::raw_pointer_cast ( &(cfl[0]) ),
-			*dx_r = thrust::raw_pointer_cast ( &(domInfo->dx[0]) ),
-			*dy_r = thrust::raw_pointer_cast ( &(domInfo->dy[0]) );
-			
-	double	dt = (*paramDB)["simulation"]["dt"].get<double>();
-		
 	int nx = domInfo ->nx,
-		ny = domInfo ->ny;
-	
-	const int blocksize = 256;
-	dim3 grid( int( (nx*ny-0.5)/blocksize ) +1, 1);
-	dim3 block(blocksize, 1);
-	
-	kernels::calculateCFL<<<grid,block>>>(cfl_r, u_r, dx_r, dy_r, nx, ny, dt);
-	
-	thrust::device_vector<double>::iterator iter = thrust::max_element(cfl.begin(),cfl.end());
-	unsigned int position = iter - cfl.begin();
-	double max_val = *iter;
+		position;
+	double max_val = maxCFL(position);
 	if (max_val > cfl_max)
 	{
 		cfl_max = max_val;
@@ -46,12 +33,12 @@ void oscCylinder::calcDistance()
 			*yu_r = thrust::raw_pointer_cast ( &(domInfo->yu[0]) ),
 			*yv_r = thrust::raw_pointer_cast ( &(domInfo->yv[0]) );
 	
-	int	*ghostTagsUV_r = thrust::raw_pointer_cast ( &(ghostTagsUV[0]) ),
-		*ghostTagsP_r  = thrust::raw_pointer_cast ( &(ghostTagsP[0]) );
+	unsigned char	*cellTypeUV_r = thrust::raw_pointer_cast ( &(cellTypeUV[0]) ),
+					*cellTypeP_r  = thrust::raw_pointer_cast ( &(cellTypeP[0]) );
 			
 	int nx = domInfo ->nx,
 		ny = domInfo ->ny,
-		width_i = B.numCellsXHost, //flag this value is only moved to the host once (in B.initialise) if the body is moving too much this could break 
+		width_i = B.numCellsXHost, //host copy, refreshed by B.updateMetadata whenever the bounding boxes are recalculated
 		height_j=B.numCellsYHost;  //this is done because we need the value on the host to calculate the grid size, but copying it to the host every TS is expensive
 	
 	int *i_start_r = thrust::raw_pointer_cast ( &(B.startI[0]) ),
@@ -62,7 +49,7 @@ void oscCylinder::calcDistance()
 	dim3 grid( int( (width_i*height_j-0.5)/blocksize ) +1, 1);
 	dim3 block(blocksize, 1);
 	
-	kernels::testDistance<<<grid,block>>>(distance_r, ghostTagsUV_r, ghostTagsP_r, xu_r, xv_r, yu_r, yv_r, B.midX, B.midY,
+	kernels::testDistance<<<grid,block>>>(distance_r, cellTypeUV_r, cellTypeP_r, xu_r, xv_r, yu_r, yv_r, B.midX, B.midY,
 											i_start_r, j_start_r, width_i, nx, ny);
 	arrayprint(distance,"distance","p",-1);
 }
@@ -0,0 +1,140 @@
+/***************************************************************************//**
+ * \file frame.inl
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief solves the prescribed oscillation in the frame of reference of the body
+ *
+ * The body stays where it starts on the grid and the fluid velocity is stored relative to it.
+ * The far field velocity and the right hand side of the velocity solve pick up the motion of the body instead,
+ * so the tags, LHS1, LHS2 and the preconditioners only have to be built once.
+ */
+
+#include <solvers/NavierStokes/oscCylinder/kernels/frame.h>
+#include <solvers/NavierStokes/oscCylinder/kernels/structure.h>
+
+/*
+ * Moves the initial condition and the boundary conditions into the frame of the body
+ * Calculates the area of fluid in the force control volume, the control volume doesn't move in this frame so it is only done once
+ */
+void oscCylinder::initialiseFrame()
+{
+	double	*uB0_r	= thrust::raw_pointer_cast( &(B.uBk[0]) ),
+			*u_r	= thrust::raw_pointer_cast( &(u[0]) );
+	int		nx = domInfo->nx,
+			ny = domInfo->ny,
+			totalPoints = B.totalPoints;
+
+	const int blocksize = 256;
+	dim3 grid( int( (totalPoints)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	dim3 gridU( int( ((nx-1)*ny-0.5)/blocksize ) +1, 1);
+
+	//the body is at rest in its own frame
+	B.translate(0, 0, 0, 0);
+	kernels::initialise_old<<<grid,block>>>(uB0_r, 0, totalPoints);
+
+	//subtract the body velocity from the fluid
+	kernels::shiftVelocity<<<gridU,block>>>(u_r, -B.centerVelocityU, (nx-1)*ny);
+	shiftFarfield(-B.centerVelocityU);
+	setVelocityInside();
+	uold = u;
+	frameAcceleration = 0;
+
+	//fluid area in the control volume used by calculateForce
+	cusp::array1d<double, cusp::host_memory>	xh(totalPoints),
+												yh(totalPoints);
+	thrust::copy(B.x.begin(), B.x.begin()+totalPoints, xh.begin());
+	thrust::copy(B.y.begin(), B.y.begin()+totalPoints, yh.begin());
+	double bodyArea = 0;
+	for (int k=0; k<totalPoints; k++)
+	{
+		int l = (k+1)%totalPoints;
+		bodyArea += xh[k]*yh[l] - xh[l]*yh[k];
+	}
+	bodyArea = fabs(bodyArea)/2;
+	int i0 = B.hostMeta.startI[0],
+		j0 = B.hostMeta.startJ[0];
+	double	width	= thrust::reduce(domInfo->dx.begin()+i0, domInfo->dx.begin()+i0+B.hostMeta.numCellsX[0]),
+			height	= thrust::reduce(domInfo->dy.begin()+j0, domInfo->dy.begin()+j0+B.hostMeta.numCellsY[0]);
+	fluidArea = width*height - bodyArea;
+}
+
+/*
+ * Adds du to the u velocity on every boundary that takes a velocity value
+ */
+void oscCylinder::shiftFarfield(double du)
+{
+	boundaryCondition **bcInfo = (*paramDB)["flow"]["boundaryConditions"].get<boundaryCondition **>();
+	int nx = domInfo->nx,
+		ny = domInfo->ny;
+	int numU[4];
+	numU[XMINUS] = ny;
+	numU[XPLUS]  = ny;
+	numU[YMINUS] = nx-1;
+	numU[YPLUS]  = nx-1;
+
+	const int blocksize = 256;
+	dim3 block(blocksize, 1);
+	for (int l=0; l<4; l++)
+	{
+		if (bcInfo[l][0].type != DIRICHLET && bcInfo[l][0].type != CONVECTIVE)
+			continue;
+		double *bc_r = thrust::raw_pointer_cast( &(bc[l][0]) );
+		dim3 grid( int( (numU[l]-0.5)/blocksize ) +1, 1);
+		kernels::shiftVelocity<<<grid,block>>>(bc_r, du, numU[l]);
+	}
+}
+
+/*
+ * Advances the prescribed motion to the current time step
+ * The change in body velocity comes off the far field and is applied to the fluid as a body force over the next step
+ * uBk is set so that (uB-uBk)/dt is the acceleration of the frame, which is what the pressure condition at the body needs
+ */
+void oscCylinder::updateFrame()
+{
+	logger.startTimer("moveBody");
+	parameterDB  &db = *paramDB;
+	double	*uB0_r	= thrust::raw_pointer_cast( &(B.uBk[0]) );
+	double	dt	= db["simulation"]["dt"].get<double>(),
+			t	= simulationTime,
+			f	= B.frequency,
+			unew= B.uCoeff*cos(2*M_PI*f*t + B.uPhase),
+			xnew= B.xCoeff*sin(2*M_PI*f*t + B.xPhase),
+			du	= unew - B.centerVelocityU;
+
+	B.centerVelocityU = unew;
+	B.midX = xnew;
+	frameAcceleration = du/dt;
+	shiftFarfield(-du);
+
+	const int blocksize = 256;
+	dim3 grid( int( (B.totalPoints)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	kernels::initialise_old<<<grid,block>>>(uB0_r, -du, B.totalPoints);
+	logger.stopTimer("moveBody");
+}
+
+/*
+ * Adds the fictitious force of the accelerating frame to rhs1
+ */
+void oscCylinder::addFrameForce()
+{
+	double	dt	= (*paramDB)["simulation"]["dt"].get<double>(),
+			*rhs_r	= thrust::raw_pointer_cast( &(rhs1[0]) );
+	unsigned char	*cellTypeUV_r	= thrust::raw_pointer_cast( &(cellTypeUV[0]) );
+	int		nx = domInfo->nx,
+			ny = domInfo->ny;
+
+	const int blocksize = 256;
+	dim3 grid( int( ((nx-1)*ny-0.5)/blocksize ) +1, 1);
+	dim3 block(blocksize, 1);
+	kernels::addFrameAcceleration<<<grid,block>>>(rhs_r, cellTypeUV_r, dt*frameAcceleration, nx, ny);
+}
+
+/*
+ * The control volume force is measured in the accelerating frame, the fictitious force on the fluid inside the
+ * control volume is removed so the force matches the force on the moving body
+ */
+void oscCylinder::frameForce()
+{
+	calculateForce(frameAcceleration*fluidArea);
+}
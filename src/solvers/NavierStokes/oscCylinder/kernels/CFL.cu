@@ -6,6 +6,7 @@
 
 
 #include "CFL.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 
 /**
  * \namespace kernels
@@ -14,24 +15,8 @@
 
 namespace kernels
 {
-//size p
 __global__
-void calculateCFL(double *cfl, double *u, double *dx, double *dy,
-		int nx, int ny, double dt)
-{
-	if (threadIdx.x + blockDim.x * blockIdx.x >= nx*ny)
-		return;
-	int ip 	= threadIdx.x + blockDim.x * blockIdx.x,
-		I	= ip % nx,
-		J	= ip / nx,
-		iu	= (nx-1)*J + I,
-		iv	= (nx-1)*ny  +  nx*J +I;
-
-	cfl[ip] = dt*(abs(u[iu])/dx[I] + abs(u[iv])/dy[J]);
-}
-
-__global__
-void testDistance(double *distance,int *ghostTagsUV, int *ghostTagsP, double *xu, double *xv, double *yu, double *yv, double midX, double midY,
+void testDistance(double *distance,unsigned char *cellTypeUV, unsigned char *cellTypeP, double *xu, double *xv, double *yu, double *yv, double midX, double midY,
 					int *i_start, int *j_start, int width, int nx, int ny)
 {
 	int idx	= threadIdx.x + blockDim.x * blockIdx.x,
@@ -44,7 +29,7 @@ void testDistance(double *distance,int *ghostTagsUV, int *ghostTagsP, double *xu
 		ip = nx*J +I;
 	if (idx >= (ny-1)*(nx-1)) //return if we're out of bound
 		return;
-	if (ghostTagsP[ip]==-1) //return if we're outside body
+	if (cellType::isFluid(cellTypeP[ip])) //return if we're outside body
 		return;
 	distance[ip] = sqrt(pow(xv[I]-midX,2) + pow(yu[J]-midY,2));
 }
@@ -13,9 +13,6 @@
 namespace kernels
 {
 __global__
-void calculateCFL(double *cfl, double *u, double *dx, double *dy,
-		int nx, int ny, double dt);
-__global__
-void testDistance(double *distance,int *ghostTagsUV, int *ghostTagsP, double *xu, double *xv, double *yu, double *yv, double midX, double midY,
+void testDistance(double *distance,unsigned char *cellTypeUV, unsigned char *cellTypeP, double *xu, double *xv, double *yu, double *yv, double midX, double midY,
 					int *i_start, int *j_start, int width, int nx, int ny);
 }
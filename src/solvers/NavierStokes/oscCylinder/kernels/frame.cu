@@ -0,0 +1,43 @@
+/***************************************************************************//**
+ * \file frame.cu
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ * \brief kernels for solving in the frame of reference of the oscillating body
+ */
+
+
+#include "frame.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
+
+namespace kernels
+{
+/*
+ * Adds the fictitious force of the accelerating frame to the u rows of rhs1
+ * nodes inside the body are skipped, their velocity is set by the body
+ * param rhs right hand side of the velocity solve
+ * param cellTypeUV cell type of the velocity nodes
+ * param dta dt times the acceleration of the frame
+ * param nx number of cells in x direction
+ * param ny number of cells in y direction
+ */
+__global__
+void addFrameAcceleration(double *rhs, unsigned char *cellTypeUV, double dta, int nx, int ny)
+{
+	int i	= threadIdx.x + (blockDim.x * blockIdx.x);
+	if (i >= (nx-1)*ny)
+		return;
+	if (cellType::isFluid(cellTypeUV[i]))
+		rhs[i] -= dta;
+}
+
+/*
+ * Adds du to the first n values of u
+ */
+__global__
+void shiftVelocity(double *u, double du, int n)
+{
+	int i	= threadIdx.x + (blockDim.x * blockIdx.x);
+	if (i >= n)
+		return;
+	u[i] += du;
+}
+}
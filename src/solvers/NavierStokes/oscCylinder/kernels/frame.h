@@ -0,0 +1,19 @@
+/***************************************************************************//**
+ * \file frame.h
+ * \author Christopher Minar (minarc@oregonstate.edu)
+ */
+
+#pragma once
+
+/**
+ * \namespace kernels
+ * \brief Contains all the custom-written CUDA kernels.
+ */
+
+namespace kernels
+{
+__global__
+void addFrameAcceleration(double *rhs, unsigned char *cellTypeUV, double dta, int nx, int ny);
+__global__
+void shiftVelocity(double *u, double du, int n);
+}
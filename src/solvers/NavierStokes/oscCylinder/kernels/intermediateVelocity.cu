@@ -6,6 +6,7 @@
 
 
 #include "intermediateVelocity.h"
+#include <solvers/NavierStokes/luoIBM/kernels/cellType.h>
 
 /**
  * \namespace kernels
@@ -14,8 +15,12 @@
 
 namespace kernels
 {
+/*
+ * sets the velocity of the solid nodes to the velocity of the body they are in
+ * param uv body velocity of each velocity node, set for the solid nodes by zero_x_luo and zero_y_luo
+ */
 __global__
-void setInsideVelocity(int *ghostTags, double *u, double *uB, double *vB, int nx, int ny) //flag doesn't need to cover whole domain, could only span over the bounding box
+void setInsideVelocity(unsigned char *cellTypeUV, double *u, double *uv, int nx, int ny) //flag doesn't need to cover whole domain, could only span over the bounding box
 {																  //flag kernel could mess up if the body is too close to the edge because were doing the x values and y values in the same kernel
 	int 	i 	= threadIdx.x + (blockDim.x * blockIdx.x),
 			I	= i % (nx-1),
@@ -26,7 +31,7 @@ void setInsideVelocity(int *ghostTags, double *u, double *uB, double *vB, int nx
 	if (iu >= (nx-1)*ny) //flag indexing is janky for doing x and y at the same time
 			return;
 	//			 not at inside edge             at inside edge
-	u[iu] = (ghostTags[iu] != 0) * u[iu] + (ghostTags[iu] == 0) * uB[0];//flag won't work for rotating bodies because were not getting a local body velocity
-	u[iv] = (ghostTags[iv] != 0) * u[iv] + (ghostTags[iv] == 0) * vB[0];
+	u[iu] = !cellType::isSolid(cellTypeUV[iu]) * u[iu] + cellType::isSolid(cellTypeUV[iu]) * uv[iu];
+	u[iv] = !cellType::isSolid(cellTypeUV[iv]) * u[iv] + cellType::isSolid(cellTypeUV[iv]) * uv[iv];
 }
 }
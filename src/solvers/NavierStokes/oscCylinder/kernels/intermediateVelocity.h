@@ -13,5 +13,5 @@
 namespace kernels
 {
 __global__
-void setInsideVelocity(int *ghostTags, double *u, double *uB, double *vB, int nx, int ny);
+void setInsideVelocity(unsigned char *cellTypeUV, double *u, double *uv, int nx, int ny);
 }